@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/bench/Bench.hpp"
+#include "sf/core/MemOps.hpp"
+
+namespace Sf
+{
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Maximum number of benchmarks that may be registered.
+///
+static constexpr U32 gMaxBenchmarks = 256;
+
+///
+/// @brief Registered benchmark.
+///
+struct Benchmark final
+{
+    const char* group;
+    const char* name;
+    Bench::Function func;
+};
+
+///
+/// @brief Registered benchmarks.
+///
+static Benchmark gBenchmarks[gMaxBenchmarks];
+
+///
+/// @brief Number of registered benchmarks.
+///
+static U32 gBenchmarkCnt = 0;
+
+/////////////////////////////////// Public /////////////////////////////////////
+
+Bench::Registrar::Registrar(const char* const kGroup,
+                            const char* const kName,
+                            const Function kFunc)
+{
+    if (gBenchmarkCnt < gMaxBenchmarks)
+    {
+        gBenchmarks[gBenchmarkCnt++] = {kGroup, kName, kFunc};
+    }
+}
+
+U32 Bench::runAll(const char* const kGroup)
+{
+    U32 cnt = 0;
+    for (U32 i = 0; i < gBenchmarkCnt; ++i)
+    {
+        const Benchmark& bench = gBenchmarks[i];
+        if ((kGroup == nullptr) || (MemOps::strcmp(kGroup, bench.group) == 0))
+        {
+            Console::printf("%s%s.%s%s\n",
+                            Console::cyan,
+                            bench.group,
+                            bench.name,
+                            Console::reset);
+            bench.func();
+            ++cnt;
+        }
+    }
+
+    return cnt;
+}
+
+void Bench::report(const char* const kLabel, const U64 kOps, const U64 kNs)
+{
+    const F64 nsPerOp = ((kOps > 0) ? (static_cast<F64>(kNs) / kOps) : 0.0);
+    Console::printf("    %-40s %12llu ops %14.2f ns/op\n",
+                    kLabel,
+                    static_cast<unsigned long long>(kOps),
+                    nsPerOp);
+}
+
+} // namespace Sf
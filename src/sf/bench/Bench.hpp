@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/bench/Bench.hpp
+/// @brief Microbenchmark helpers. This should be the last include at the top of
+///        every benchmark file.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_BENCH_HPP
+#define SF_BENCH_HPP
+
+#include "sf/core/BasicTypes.hpp"
+#include "sf/pal/Clock.hpp"
+#include "sf/pal/Console.hpp"
+
+namespace Sf
+{
+
+///
+/// @brief Microbenchmark helpers.
+///
+namespace Bench
+{
+    ///
+    /// @brief Benchmark function.
+    ///
+    typedef void (*Function)();
+
+    ///
+    /// @brief Registers a benchmark to be run by the benchmark entry point.
+    /// Benchmarks are registered with the BENCH macro rather than directly.
+    ///
+    class Registrar final
+    {
+    public:
+
+        ///
+        /// @brief Constructor.
+        ///
+        /// @param[in] kGroup  Benchmark group name.
+        /// @param[in] kName   Benchmark name.
+        /// @param[in] kFunc   Benchmark function.
+        ///
+        Registrar(const char* const kGroup,
+                  const char* const kName,
+                  const Function kFunc);
+    };
+
+    ///
+    /// @brief Runs all registered benchmarks, or only those in a group.
+    ///
+    /// @param[in] kGroup  Group to run, or null to run all groups.
+    ///
+    /// @returns Number of benchmarks run.
+    ///
+    U32 runAll(const char* const kGroup);
+
+    ///
+    /// @brief Prints the result of a timed measurement.
+    ///
+    /// @param[in] kLabel  Measurement label.
+    /// @param[in] kOps    Number of operations performed.
+    /// @param[in] kNs     Total nanoseconds elapsed.
+    ///
+    void report(const char* const kLabel, const U64 kOps, const U64 kNs);
+
+    ///
+    /// @brief Consumes a value so that the compiler cannot optimize away the
+    /// computation that produced it.
+    ///
+    /// @param[in] kVal  Value to consume.
+    ///
+    template<typename T>
+    inline void consume(const T& kVal)
+    {
+        static volatile T sink;
+        sink = kVal;
+    }
+}
+
+} // namespace Sf
+
+///
+/// @brief Defines and registers a benchmark.
+///
+/// @param[in] kGroup  Benchmark group name.
+/// @param[in] kName   Benchmark name.
+///
+#define BENCH(kGroup, kName)                                                   \
+    static void bench##kGroup##kName();                                        \
+    static const Sf::Bench::Registrar                                          \
+        gBenchReg##kGroup##kName(#kGroup, #kName, &bench##kGroup##kName);      \
+    static void bench##kGroup##kName()
+
+#endif
@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/bench/BenchClock.cpp
+/// @brief Benchmarks for clock read cost and periodic wakeup jitter.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <time.h>
+
+#include "sf/bench/Bench.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Number of clock reads per read benchmark.
+///
+static constexpr U32 gReadCnt = 1000000;
+
+///
+/// @brief Number of wakeups per jitter benchmark.
+///
+static constexpr U32 gWakeCnt = 1000;
+
+///
+/// @brief Period of jitter benchmark loops in nanoseconds (1 kHz).
+///
+static constexpr U64 gPeriodNs = (Clock::NS_IN_S / 1000);
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Times reading a Linux clock directly with clock_gettime().
+///
+/// @param[in] kLabel    Report label.
+/// @param[in] kClockId  Clock ID.
+///
+static void benchClockGettime(const char* const kLabel,
+                              const clockid_t kClockId)
+{
+    timespec ts = {0, 0};
+    const U64 startNs = Clock::nanoTime();
+    for (U32 i = 0; i < gReadCnt; ++i)
+    {
+        (void) clock_gettime(kClockId, &ts);
+        Bench::consume(ts.tv_nsec);
+    }
+    Bench::report(kLabel, gReadCnt, (Clock::nanoTime() - startNs));
+}
+
+///
+/// @brief Runs a periodic loop and reports the mean and max lateness of each
+/// wakeup relative to its deadline.
+///
+/// @param[in] kSpin  If true, spinwait for each deadline instead of sleeping.
+///
+static void benchWakeJitter(const bool kSpin)
+{
+    U64 sumNs = 0;
+    U64 maxNs = 0;
+    U64 deadlineNs = Clock::nanoTime();
+    for (U32 i = 0; i < gWakeCnt; ++i)
+    {
+        deadlineNs += gPeriodNs;
+        if (kSpin)
+        {
+            while (Clock::nanoTime() < deadlineNs);
+        }
+        else
+        {
+            Clock::sleepUntil(deadlineNs);
+        }
+
+        const U64 lateNs = (Clock::nanoTime() - deadlineNs);
+        sumNs += lateNs;
+        if (lateNs > maxNs)
+        {
+            maxNs = lateNs;
+        }
+    }
+
+    Bench::report("mean lateness", gWakeCnt, sumNs);
+    Bench::report("max lateness", 1, maxNs);
+}
+
+/////////////////////////////////// Benchmarks /////////////////////////////////
+
+///
+/// @brief Cost of Clock::nanoTime() compared to reading each Linux clock
+/// directly.
+///
+BENCH(Clock, Read)
+{
+    const U64 startNs = Clock::nanoTime();
+    for (U32 i = 0; i < gReadCnt; ++i)
+    {
+        Bench::consume(Clock::nanoTime());
+    }
+    Bench::report("Clock::nanoTime", gReadCnt, (Clock::nanoTime() - startNs));
+
+    benchClockGettime("CLOCK_MONOTONIC", CLOCK_MONOTONIC);
+    benchClockGettime("CLOCK_MONOTONIC_RAW", CLOCK_MONOTONIC_RAW);
+    benchClockGettime("CLOCK_REALTIME", CLOCK_REALTIME);
+}
+
+///
+/// @brief Wakeup lateness of a 1 kHz loop using Clock::sleepUntil().
+///
+BENCH(Clock, SleepUntilJitter)
+{
+    benchWakeJitter(false);
+}
+
+///
+/// @brief Wakeup lateness of a 1 kHz loop that spinwaits for each deadline, as
+/// a baseline for Clock::sleepUntil() at the cost of a fully busy CPU.
+///
+BENCH(Clock, SpinJitter)
+{
+    benchWakeJitter(true);
+}
@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/bench/BenchCompiler.cpp
+/// @brief Benchmarks for state machine compile time, assembly heap usage and
+///        assembly image load time.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <malloc.h>
+#include <sstream>
+
+#include "sf/config/AssemblyImage.hpp"
+#include "sf/config/StateMachineCompiler.hpp"
+#include "sf/config/StateVectorCompiler.hpp"
+#include "sf/bench/Bench.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Number of F64 elements in the generated state vector.
+///
+static constexpr U32 gElemCnt = 200;
+
+///
+/// @brief Number of states in the generated state machine.
+///
+static constexpr U32 gStateCnt = 100;
+
+///
+/// @brief Number of times the state machine is compiled.
+///
+static constexpr U32 gCompileCnt = 20;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Generates a large state vector config and a state machine config
+/// that uses it. Every state assigns, branches on and takes stats of
+/// expressions over a different mix of elements, so that few subexpressions
+/// are shared between states.
+///
+/// @param[out] kSv  State vector config.
+/// @param[out] kSm  State machine config.
+///
+static void makeConfigs(String& kSv, String& kSm)
+{
+    std::stringstream sv;
+    std::stringstream sm;
+    sv << "[Foo]\nU32 state\nU64 time\n";
+    sm << "[state_vector]\nU32 state @alias S\nU64 time @alias G\n";
+    for (U32 i = 0; i < gElemCnt; ++i)
+    {
+        sv << "F64 x" << i << "\n";
+        sm << "F64 x" << i << "\n";
+    }
+
+    sm << "\n[local]\nF64 acc = 0\n";
+    for (U32 s = 0; s < gStateCnt; ++s)
+    {
+        const U32 next = ((s + 1) % gStateCnt);
+        sm << "\n[S" << s << "]\n.entry\n    acc = 0\n.step\n";
+        for (U32 j = 0; j < 10; ++j)
+        {
+            const U32 a = (((s * 31) + (j * 7)) % gElemCnt);
+            const U32 b = (((s * 17) + (j * 13) + 1) % gElemCnt);
+            const U32 c = (((s * 11) + (j * 3) + 2) % gElemCnt);
+            sm << "    x" << a << " = x" << b << " * " << (j + 2)
+               << " + x" << c << " / (x" << a << " - " << s << ".5)\n";
+            sm << "    x" << b << " > x" << c << " and x" << a << " < " << j
+               << " {\n        acc = acc + roll_avg(x" << c << ", " << (j + 2)
+               << ")\n    }\n    else: acc = acc - x" << b << "\n";
+        }
+        sm << "    T > " << (s + 10) << " or acc > 1000000: -> S" << next << "\n"
+           << ".exit\n    x" << s % gElemCnt << " = acc\n";
+    }
+
+    kSv = sv.str();
+    kSm = sm.str();
+}
+
+/////////////////////////////////// Benchmarks /////////////////////////////////
+
+///
+/// @brief Compiling a state machine with 100 states and 200 elements from its
+/// parse, and the heap held by the resulting assembly.
+///
+BENCH(Compiler, StateMachine)
+{
+    String svSrc;
+    String smSrc;
+    makeConfigs(svSrc, smSrc);
+
+    // Compile state vector and parse state machine once; only the state
+    // machine compiler phase is timed.
+    std::stringstream svSs(svSrc);
+    Ref<const StateVectorAssembly> svAsm;
+    ErrorInfo err;
+    if (StateVectorCompiler::compile(svSs, svAsm, &err) != SUCCESS)
+    {
+        Console::printf("%s\n", err.prettifyError().c_str());
+        return;
+    }
+
+    Vec<Token> toks;
+    std::stringstream smSs(smSrc);
+    Ref<const StateMachineParse> parse;
+    if ((Tokenizer::tokenize(smSs, toks, &err) != SUCCESS)
+        || (StateMachineParser::parse(toks, parse, &err) != SUCCESS))
+    {
+        Console::printf("%s\n", err.prettifyError().c_str());
+        return;
+    }
+
+    U64 ns = 0;
+    U64 heapBytes = 0;
+    for (U32 i = 0; i < gCompileCnt; ++i)
+    {
+        const U64 heapStart = mallinfo2().uordblks;
+        Ref<const StateMachineAssembly> smAsm;
+        const U64 startNs = Clock::nanoTime();
+        const Result res =
+            StateMachineCompiler::compile(parse, svAsm, smAsm, &err);
+        ns += (Clock::nanoTime() - startNs);
+        if (res != SUCCESS)
+        {
+            Console::printf("%s\n", err.prettifyError().c_str());
+            return;
+        }
+        heapBytes = (mallinfo2().uordblks - heapStart);
+    }
+
+    Bench::report("compile", gCompileCnt, ns);
+    Console::printf("    %llu bytes of heap held by assembly\n",
+                    static_cast<unsigned long long>(heapBytes));
+}
+
+///
+/// @brief Compiling the state vector and state machine from source versus
+/// loading them from an assembly image.
+///
+BENCH(Compiler, AssemblyImage)
+{
+    String svSrc;
+    String smSrc;
+    makeConfigs(svSrc, smSrc);
+
+    U64 compileNs = 0;
+    Ref<const StateMachineAssembly> smAsm;
+    ErrorInfo err;
+    for (U32 i = 0; i < gCompileCnt; ++i)
+    {
+        std::stringstream svSs(svSrc);
+        std::stringstream smSs(smSrc);
+        Ref<const StateVectorAssembly> svAsm;
+        const U64 startNs = Clock::nanoTime();
+        Result res = StateVectorCompiler::compile(svSs, svAsm, &err);
+        if (res == SUCCESS)
+        {
+            res = StateMachineCompiler::compile(smSs, svAsm, smAsm, &err);
+        }
+        compileNs += (Clock::nanoTime() - startNs);
+        if (res != SUCCESS)
+        {
+            Console::printf("%s\n", err.prettifyError().c_str());
+            return;
+        }
+    }
+
+    std::stringstream imgSs;
+    if (AssemblyImage::write(imgSs, smAsm) != SUCCESS)
+    {
+        Console::printf("failed to write image\n");
+        return;
+    }
+    const String img = imgSs.str();
+
+    U64 loadNs = 0;
+    for (U32 i = 0; i < gCompileCnt; ++i)
+    {
+        Ref<const StateVectorAssembly> imgSvAsm;
+        Ref<const StateMachineAssembly> imgSmAsm;
+        const U64 startNs = Clock::nanoTime();
+        const Result res = AssemblyImage::load(img.data(),
+                                               img.size(),
+                                               imgSvAsm,
+                                               imgSmAsm);
+        loadNs += (Clock::nanoTime() - startNs);
+        if (res != SUCCESS)
+        {
+            Console::printf("failed to load image\n");
+            return;
+        }
+    }
+
+    Bench::report("compile from source", gCompileCnt, compileNs);
+    Bench::report("load image", gCompileCnt, loadNs);
+    Console::printf("    %llu byte image\n",
+                    static_cast<unsigned long long>(img.size()));
+}
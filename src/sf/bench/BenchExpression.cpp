@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/bench/BenchExpression.cpp
+/// @brief Benchmarks for expression evaluation with each expression compiler
+///        backend.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <sstream>
+
+#include "sf/config/ExpressionCompiler.hpp"
+#include "sf/config/Tokenizer.hpp"
+#include "sf/bench/Bench.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Number of times each benchmark evaluates the expression.
+///
+static constexpr U32 gEvalCnt = 1000000;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Elements referenced by benchmark expressions.
+///
+struct BenchElements final
+{
+    I32 a;
+    I64 b;
+    F64 c;
+    bool d;
+    Element<I32> elemA;
+    Element<I64> elemB;
+    Element<F64> elemC;
+    Element<bool> elemD;
+    Map<String, IElement*> bindings;
+
+    BenchElements() :
+        a(0),
+        b(0),
+        c(0.0),
+        d(false),
+        elemA(a),
+        elemB(b),
+        elemC(c),
+        elemD(d),
+        bindings({{"a", &elemA}, {"b", &elemB}, {"c", &elemC}, {"d", &elemD}})
+    {
+    }
+};
+
+///
+/// @brief Times evaluating a guard expression.
+///
+/// @param[in] kLabel    Measurement label.
+/// @param[in] kSrc      Expression source.
+/// @param[in] kBackend  Expression compiler backend.
+///
+static void benchEval(const char* const kLabel,
+                      const char* const kSrc,
+                      const ExpressionCompiler::Backend kBackend)
+{
+    // Compile expression.
+    BenchElements be;
+    Vec<Token> toks;
+    std::stringstream ss(kSrc);
+    Ref<const ExpressionParse> parse;
+    Ref<const ExpressionAssembly> exprAsm;
+    if (Tokenizer::tokenize(ss, toks, nullptr) != SUCCESS)
+    {
+        Console::printf("expression tokenize failed\n");
+        return;
+    }
+
+    TokenIterator it(toks.begin(), toks.end());
+    if ((ExpressionParser::parse(it, parse, nullptr) != SUCCESS)
+        || (ExpressionCompiler::compile(parse,
+                                        be.bindings,
+                                        ElementType::BOOL,
+                                        exprAsm,
+                                        nullptr,
+                                        kBackend) != SUCCESS))
+    {
+        Console::printf("expression compile failed\n");
+        return;
+    }
+
+    IExprNode<bool>* const root =
+        dynamic_cast<IExprNode<bool>*>(exprAsm->root().get());
+    const Vec<Ref<IExpressionStats>> stats = exprAsm->stats();
+
+    // Evaluate expression while varying its inputs.
+    const U64 startNs = Clock::nanoTime();
+    for (U32 i = 0; i < gEvalCnt; ++i)
+    {
+        be.elemA.write(static_cast<I32>(i & 0xFF));
+        be.elemB.write(i);
+        be.elemC.write(i * 0.5);
+        be.elemD.write((i & 1) == 0);
+        for (const Ref<IExpressionStats>& stat : stats)
+        {
+            stat->update();
+        }
+        Bench::consume(root->evaluate());
+    }
+
+    const U64 ns = (Clock::nanoTime() - startNs);
+    Bench::report(kLabel, gEvalCnt, ns);
+}
+
+/////////////////////////////////// Benchmarks /////////////////////////////////
+
+///
+/// @brief A guard with arithmetic, relational and logical operators on
+/// elements of several types.
+///
+BENCH(Expression, Guard)
+{
+    const char* const src =
+        "(a + 3) * 2 > b / 4 - c and not d or a * a + b == c + 10";
+    benchEval("tree", src, ExpressionCompiler::TREE);
+    benchEval("bytecode", src, ExpressionCompiler::BYTECODE);
+}
+
+///
+/// @brief A guard combining stats functions with arithmetic.
+///
+BENCH(Expression, StatsGuard)
+{
+    const char* const src =
+        "roll_avg(c, 8) - roll_min(a, 8) * 2 > roll_max(b, 8) / 3";
+    benchEval("tree", src, ExpressionCompiler::TREE);
+    benchEval("bytecode", src, ExpressionCompiler::BYTECODE);
+}
+
+///
+/// @brief A guard on integer elements only, which evaluates entirely in I64.
+///
+BENCH(Expression, IntegerGuard)
+{
+    const char* const src = "(a + 3) * 2 > b - 4 and not d or a * a != b";
+    benchEval("tree", src, ExpressionCompiler::TREE);
+    benchEval("bytecode", src, ExpressionCompiler::BYTECODE);
+}
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/bench/BenchExpressionStats.cpp
+/// @brief Benchmarks for ExpressionStats rolling window stats across window
+///        sizes.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+
+#include "sf/config/StlTypes.hpp"
+#include "sf/core/ExpressionStats.hpp"
+#include "sf/bench/Bench.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Window sizes benchmarked.
+///
+static const U32 gWindowSizes[] = {10, 100, 1000, 10000};
+
+///
+/// @brief Number of updates each benchmark performs per window size.
+///
+static constexpr U32 gUpdateCnt = 200000;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Times updating an ExpressionStats with pseudorandom values and
+/// querying a stat after each update, for each window size.
+///
+/// @param[in] kStat  Stat to query.
+///
+static void benchStat(F64 (IExpressionStats::*kStat)())
+{
+    for (const U32 size : gWindowSizes)
+    {
+        F64 val = 0.0;
+        Element<F64> elem(val);
+        ElementExprNode<F64> expr(elem);
+        Vec<F64> arrA(size);
+        Vec<U32> arrB(4 * size);
+        ExpressionStats<F64> stats(expr, arrA.data(), arrB.data(), size);
+
+        // Fill the window so that every measured update evicts a value.
+        U32 rng = 1;
+        for (U32 i = 0; i < size; ++i)
+        {
+            rng = ((rng * 1103515245) + 12345);
+            elem.write(static_cast<F64>(rng >> 16));
+            stats.update();
+        }
+
+        const U64 startNs = Clock::nanoTime();
+        for (U32 i = 0; i < gUpdateCnt; ++i)
+        {
+            rng = ((rng * 1103515245) + 12345);
+            elem.write(static_cast<F64>(rng >> 16));
+            stats.update();
+            Bench::consume((stats.*kStat)());
+        }
+
+        const U64 ns = (Clock::nanoTime() - startNs);
+        const String label = ("window " + std::to_string(size));
+        Bench::report(label.c_str(), gUpdateCnt, ns);
+    }
+}
+
+/////////////////////////////////// Benchmarks /////////////////////////////////
+
+///
+/// @brief Update followed by a rolling median.
+///
+BENCH(ExpressionStats, Median)
+{
+    benchStat(&IExpressionStats::median);
+}
+
+///
+/// @brief Update followed by a rolling mean, as a baseline for the cost of the
+/// update alone.
+///
+BENCH(ExpressionStats, Mean)
+{
+    benchStat(&IExpressionStats::mean);
+}
+
+///
+/// @brief Update followed by a rolling range, which queries both the min and
+/// the max.
+///
+BENCH(ExpressionStats, Range)
+{
+    benchStat(&IExpressionStats::range);
+}
@@ -0,0 +1,38 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/bench/BenchMain.cpp
+/// @brief Benchmark entry point. Pass a group name as the first argument to
+///        run only the benchmarks in that group.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/bench/Bench.hpp"
+
+using namespace Sf;
+
+int main(int argc, char* argv[])
+{
+    const char* const group = ((argc > 1) ? argv[1] : nullptr);
+    if (Bench::runAll(group) == 0)
+    {
+        Console::printf("no benchmarks were run\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/bench/BenchMemOps.cpp
+/// @brief Benchmarks for MemOps::memcpy() against a bytewise copy and libc
+///        memcpy, across copy sizes and alignments.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <string>
+
+#include "sf/config/StlTypes.hpp"
+#include "sf/core/MemOps.hpp"
+#include "sf/bench/Bench.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Copy sizes benchmarked, in bytes.
+///
+static const U32 gCopySizes[] = {64, 1024, 4096, 65536};
+
+///
+/// @brief Total number of bytes each benchmark copies per copy size.
+///
+static constexpr U64 gTotalBytes = (1ULL << 30);
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Copy function signature shared by the benchmarked implementations.
+///
+typedef void* (*CopyFunction)(void*, const void*, U32);
+
+///
+/// @brief Bytewise copy, which was the MemOps::memcpy() implementation before
+/// it copied words.
+///
+static void* bytewiseMemcpy(void* kDest, const void* kSrc, const U32 kBytes)
+{
+    volatile U8* const dest = static_cast<U8*>(kDest);
+    const U8* const src = static_cast<const U8*>(kSrc);
+    for (U32 i = 0; i < kBytes; ++i)
+    {
+        dest[i] = src[i];
+    }
+
+    return kDest;
+}
+
+///
+/// @brief libc memcpy.
+///
+static void* libcMemcpy(void* kDest, const void* kSrc, const U32 kBytes)
+{
+    return std::memcpy(kDest, kSrc, kBytes);
+}
+
+///
+/// @brief MemOps::memcpy().
+///
+static void* sfMemcpy(void* kDest, const void* kSrc, const U32 kBytes)
+{
+    return MemOps::memcpy(kDest, kSrc, kBytes);
+}
+
+///
+/// @brief Times copying between two buffers for each copy size.
+///
+/// @param[in] kLabel      Measurement label prefix.
+/// @param[in] kFunc       Copy function.
+/// @param[in] kSrcOffset  Byte offset of source from a word-aligned address.
+///
+static void benchCopy(const char* const kLabel,
+                      const CopyFunction kFunc,
+                      const U32 kSrcOffset)
+{
+    for (const U32 size : gCopySizes)
+    {
+        Vec<U64> srcBuf(((size + kSrcOffset) / sizeof(U64)) + 1, 1);
+        Vec<U64> destBuf((size / sizeof(U64)) + 1, 0);
+        const U8* const src =
+            (reinterpret_cast<const U8*>(srcBuf.data()) + kSrcOffset);
+        U8* const dest = reinterpret_cast<U8*>(destBuf.data());
+        const U64 copies = (gTotalBytes / size);
+
+        const U64 startNs = Clock::nanoTime();
+        for (U64 i = 0; i < copies; ++i)
+        {
+            Bench::consume(kFunc(dest, src, size));
+        }
+
+        const U64 ns = (Clock::nanoTime() - startNs);
+        const String label =
+            (String(kLabel) + " " + std::to_string(size) + " B");
+        Bench::report(label.c_str(), copies, ns);
+    }
+}
+
+/////////////////////////////////// Benchmarks /////////////////////////////////
+
+///
+/// @brief Copies between word-aligned buffers, as in Region reads and writes of
+/// state vector regions.
+///
+BENCH(MemOps, MemcpyAligned)
+{
+    benchCopy("bytewise", bytewiseMemcpy, 0);
+    benchCopy("MemOps", sfMemcpy, 0);
+    benchCopy("libc", libcMemcpy, 0);
+}
+
+///
+/// @brief Copies from a source that is misaligned relative to the destination.
+///
+BENCH(MemOps, MemcpyMisaligned)
+{
+    benchCopy("bytewise", bytewiseMemcpy, 3);
+    benchCopy("MemOps", sfMemcpy, 3);
+    benchCopy("libc", libcMemcpy, 3);
+}
@@ -0,0 +1,240 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/bench/BenchSocket.cpp
+/// @brief Benchmarks for UDP throughput and socket multiplexing on loopback.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/pal/SocketPoller.hpp"
+#include "sf/bench/Bench.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Sender and receiver addresses.
+///
+static const Ipv4Address gSendIp = {127, 0, 0, 1};
+static const Ipv4Address gRecvIp = {127, 0, 0, 2};
+
+///
+/// @brief Port used by benchmark sockets.
+///
+static constexpr U16 gPort = 7800;
+
+///
+/// @brief Number of datagrams sent per burst. Each burst is received before
+/// the next is sent so that the receive buffer does not overflow.
+///
+static constexpr U32 gBurstSize = 256;
+
+///
+/// @brief Number of bursts per throughput benchmark.
+///
+static constexpr U32 gBurstCnt = 400;
+
+///
+/// @brief Datagram payload size in bytes.
+///
+static constexpr U32 gPayloadSize = 64;
+
+///
+/// @brief Number of sockets waited on by multiplexing benchmarks.
+///
+static constexpr U32 gMuxSockCnt = 64;
+
+///
+/// @brief Number of waits per multiplexing benchmark.
+///
+static constexpr U32 gWaitCnt = 100000;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Opens the sender and receiver sockets.
+///
+/// @param[in] kSend  Sender socket.
+/// @param[in] kRecv  Receiver socket.
+///
+/// @returns Whether both sockets were opened.
+///
+static bool openPair(Socket& kSend, Socket& kRecv)
+{
+    if ((Socket::init(gSendIp, gPort, Socket::UDP, kSend) != SUCCESS)
+        || (Socket::init(gRecvIp, gPort, Socket::UDP, kRecv) != SUCCESS))
+    {
+        Console::printf("socket init failed\n");
+        return false;
+    }
+
+    return true;
+}
+
+/////////////////////////////////// Benchmarks /////////////////////////////////
+
+///
+/// @brief Loopback throughput sending and receiving 1 datagram per call.
+///
+BENCH(Socket, Throughput)
+{
+    Socket send;
+    Socket recv;
+    if (!openPair(send, recv))
+    {
+        return;
+    }
+
+    U8 buf[gPayloadSize] = {};
+    const U64 startNs = Clock::nanoTime();
+    for (U32 i = 0; i < gBurstCnt; ++i)
+    {
+        for (U32 j = 0; j < gBurstSize; ++j)
+        {
+            (void) send.send(gRecvIp, gPort, buf, sizeof(buf), nullptr);
+        }
+
+        for (U32 j = 0; j < gBurstSize; ++j)
+        {
+            (void) recv.recv(buf, sizeof(buf), nullptr);
+        }
+    }
+
+    Bench::report("send/recv",
+                  (gBurstCnt * gBurstSize),
+                  (Clock::nanoTime() - startNs));
+}
+
+///
+/// @brief Loopback throughput sending and receiving each burst with batch
+/// calls.
+///
+BENCH(Socket, BatchThroughput)
+{
+    Socket send;
+    Socket recv;
+    if (!openPair(send, recv))
+    {
+        return;
+    }
+
+    static U8 bufs[gBurstSize][gPayloadSize];
+    static Socket::Datagram dgrams[gBurstSize];
+    for (U32 i = 0; i < gBurstSize; ++i)
+    {
+        dgrams[i] = {gRecvIp, gPort, bufs[i], gPayloadSize, 0};
+    }
+
+    const U64 startNs = Clock::nanoTime();
+    for (U32 i = 0; i < gBurstCnt; ++i)
+    {
+        U32 n = 0;
+        (void) send.sendBatch(dgrams, gBurstSize, n);
+
+        U32 numRecvd = 0;
+        while (numRecvd < gBurstSize)
+        {
+            if (recv.recvBatch(&dgrams[numRecvd],
+                               (gBurstSize - numRecvd),
+                               n)
+                != SUCCESS)
+            {
+                break;
+            }
+            numRecvd += n;
+        }
+
+        // Receiving overwrote the destination addresses.
+        for (U32 j = 0; j < gBurstSize; ++j)
+        {
+            dgrams[j].ip = gRecvIp;
+            dgrams[j].port = gPort;
+        }
+    }
+
+    Bench::report("sendBatch/recvBatch",
+                  (gBurstCnt * gBurstSize),
+                  (Clock::nanoTime() - startNs));
+}
+
+///
+/// @brief Cost of waiting on many sockets, one of which has data available,
+/// with Socket::select() and SocketPoller.
+///
+BENCH(Socket, Multiplex)
+{
+    static Socket socks[gMuxSockCnt];
+    Socket* sockPtrs[gMuxSockCnt];
+    SocketPoller poller;
+    if (SocketPoller::init(poller) != SUCCESS)
+    {
+        Console::printf("poller init failed\n");
+        return;
+    }
+
+    for (U32 i = 0; i < gMuxSockCnt; ++i)
+    {
+        const U16 port = static_cast<U16>(gPort + 1 + i);
+        if ((Socket::init(gRecvIp, port, Socket::UDP, socks[i]) != SUCCESS)
+            || (poller.add(socks[i]) != SUCCESS))
+        {
+            Console::printf("socket init failed\n");
+            return;
+        }
+        sockPtrs[i] = &socks[i];
+    }
+
+    // Make the last socket ready. Its data is never read, so it stays ready.
+    const U64 msg = 0;
+    (void) socks[0].send(gRecvIp,
+                         static_cast<U16>(gPort + gMuxSockCnt),
+                         &msg,
+                         sizeof(msg),
+                         nullptr);
+
+    bool ready[gMuxSockCnt];
+    U64 startNs = Clock::nanoTime();
+    for (U32 i = 0; i < gWaitCnt; ++i)
+    {
+        for (bool& flag : ready)
+        {
+            flag = false;
+        }
+        U32 timeoutUs = 1000;
+        (void) Socket::select(sockPtrs, ready, gMuxSockCnt, timeoutUs);
+        Bench::consume(ready[gMuxSockCnt - 1]);
+    }
+    U64 ns = (Clock::nanoTime() - startNs);
+    Bench::report("Socket::select", gWaitCnt, ns);
+
+    Socket* readySocks[gMuxSockCnt];
+    startNs = Clock::nanoTime();
+    for (U32 i = 0; i < gWaitCnt; ++i)
+    {
+        U32 numReady = 0;
+        (void) poller.wait(readySocks, gMuxSockCnt, 1000, numReady);
+        Bench::consume(numReady);
+    }
+    ns = (Clock::nanoTime() - startNs);
+    Bench::report("SocketPoller::wait", gWaitCnt, ns);
+
+    for (Socket& sock : socks)
+    {
+        (void) sock.close();
+    }
+}
@@ -0,0 +1,165 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/bench/BenchStateVector.cpp
+/// @brief Benchmarks for StateVector initialization and lookups, with and
+///        without lookup indices.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/config/StlTypes.hpp"
+#include "sf/core/StateVector.hpp"
+#include "sf/bench/Bench.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Number of elements in the benchmark state vector.
+///
+static constexpr U32 gElemCnt = 2000;
+
+///
+/// @brief Number of times each lookup benchmark looks up every element.
+///
+static constexpr U32 gLookupPasses = 50;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Data for a state vector of gElemCnt U32 elements in one region.
+///
+struct BenchStateVector final
+{
+    Vec<U32> backing;
+    Vec<String> names;
+    Vec<Ref<Element<U32>>> elems;
+    Vec<StateVector::ElementConfig> elemConfigs;
+    Vec<const StateVector::ElementConfig*> elemIndex;
+    Region region;
+    Vec<StateVector::RegionConfig> regionConfigs;
+    Vec<const StateVector::RegionConfig*> regionIndex;
+
+    BenchStateVector() :
+        backing(gElemCnt),
+        region(backing.data(), (gElemCnt * sizeof(U32))),
+        regionIndex(1)
+    {
+        for (U32 i = 0; i < gElemCnt; ++i)
+        {
+            // Hash the element number into the name so that config order
+            // differs from name order.
+            names.push_back("elem" + std::to_string((i * 7919) % 10007));
+            elems.push_back(Ref<Element<U32>>(new Element<U32>(backing[i])));
+        }
+
+        for (U32 i = 0; i < gElemCnt; ++i)
+        {
+            elemConfigs.push_back({names[i].c_str(), elems[i].get()});
+        }
+
+        elemConfigs.push_back({nullptr, nullptr});
+        elemIndex.resize(gElemCnt);
+        regionConfigs.push_back({"region", &region});
+        regionConfigs.push_back({nullptr, nullptr});
+    }
+
+    StateVector::Config config(const bool kIndexed)
+    {
+        return {elemConfigs.data(),
+                regionConfigs.data(),
+                (kIndexed ? elemIndex.data() : nullptr),
+                (kIndexed ? regionIndex.data() : nullptr)};
+    }
+};
+
+///
+/// @brief Times initializing a state vector.
+///
+/// @param[in] kLabel    Measurement label.
+/// @param[in] kIndexed  Whether to use lookup indices.
+///
+static void benchInit(const char* const kLabel, const bool kIndexed)
+{
+    BenchStateVector bsv;
+    const StateVector::Config config = bsv.config(kIndexed);
+    const U32 iters = 10;
+    U64 ns = 0;
+    for (U32 i = 0; i < iters; ++i)
+    {
+        StateVector sv;
+        const U64 startNs = Clock::nanoTime();
+        const Result res = StateVector::init(config, sv);
+        ns += (Clock::nanoTime() - startNs);
+        Bench::consume(res);
+    }
+
+    Bench::report(kLabel, iters, ns);
+}
+
+///
+/// @brief Times looking up every element in a state vector by name.
+///
+/// @param[in] kLabel    Measurement label.
+/// @param[in] kIndexed  Whether to use lookup indices.
+///
+static void benchLookup(const char* const kLabel, const bool kIndexed)
+{
+    BenchStateVector bsv;
+    StateVector sv;
+    if (StateVector::init(bsv.config(kIndexed), sv) != SUCCESS)
+    {
+        Console::printf("state vector init failed\n");
+        return;
+    }
+
+    const U64 startNs = Clock::nanoTime();
+    for (U32 i = 0; i < gLookupPasses; ++i)
+    {
+        for (const String& name : bsv.names)
+        {
+            Element<U32>* elem = nullptr;
+            Bench::consume(sv.getElement(name.c_str(), elem));
+            Bench::consume(elem);
+        }
+    }
+
+    const U64 ns = (Clock::nanoTime() - startNs);
+    Bench::report(kLabel, (gLookupPasses * gElemCnt), ns);
+}
+
+/////////////////////////////////// Benchmarks /////////////////////////////////
+
+///
+/// @brief Initializing a state vector with 2000 elements, which includes the
+/// duplicate name check.
+///
+BENCH(StateVector, Init)
+{
+    benchInit("linear (2000 elems)", false);
+    benchInit("indexed (2000 elems)", true);
+}
+
+///
+/// @brief Looking up every element of a state vector with 2000 elements.
+///
+BENCH(StateVector, Lookup)
+{
+    benchLookup("linear (2000 elems)", false);
+    benchLookup("indexed (2000 elems)", true);
+}
@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/bench/BenchStateVectorLocks.cpp
+/// @brief Benchmarks for state vector element access with different locking
+///        layouts and access modes, uncontended and as threads are added.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <sstream>
+#include <string>
+
+#include "sf/config/StateVectorCompiler.hpp"
+#include "sf/pal/AdaptiveLock.hpp"
+#include "sf/pal/Spinlock.hpp"
+#include "sf/pal/Thread.hpp"
+#include "sf/bench/Bench.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Thread counts benchmarked. Each thread accesses its own region.
+///
+static const U32 gThreadCnts[] = {1, 2, 4, 8};
+
+///
+/// @brief Maximum number of threads.
+///
+static constexpr U32 gMaxThreads = 8;
+
+///
+/// @brief Number of element write/read pairs each thread performs.
+///
+static constexpr U32 gAccessCnt = 100000;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Arguments for a benchmark thread.
+///
+struct AccessArgs final
+{
+    Element<U64>* elem; ///< Element the thread accesses.
+    const U32* go;      ///< Nonzero once all threads may start.
+};
+
+///
+/// @brief Benchmark thread which writes and reads an element repeatedly.
+///
+/// @param[in] kArgs  AccessArgs pointer.
+///
+/// @retval SUCCESS  Always succeeds.
+///
+static Result accessThread(void* kArgs)
+{
+    const AccessArgs* const args = static_cast<const AccessArgs*>(kArgs);
+
+    // Wait for all threads to be created so they start at the same time.
+    while (__atomic_load_n(args->go, __ATOMIC_ACQUIRE) == 0)
+    {
+    }
+
+    for (U32 i = 0; i < gAccessCnt; ++i)
+    {
+        args->elem->write(i);
+        Bench::consume(args->elem->read());
+    }
+
+    return SUCCESS;
+}
+
+///
+/// @brief Times threads concurrently accessing elements in separate regions of
+/// a state vector, for each thread count.
+///
+/// @param[in] kLabel    Locking layout label.
+/// @param[in] kOptions  State vector options section body.
+///
+static void benchContention(const char* const kLabel,
+                            const char* const kOptions)
+{
+    // Compile a state vector with one region of one element per thread.
+    std::stringstream src;
+    src << "[options]\n" << kOptions << "\n";
+    for (U32 i = 0; i < gMaxThreads; ++i)
+    {
+        src << "[R" << i << "]\nU64 e" << i << "\n";
+    }
+
+    Ref<const StateVectorAssembly> svAsm;
+    if (StateVectorCompiler::compile(src, svAsm, nullptr) != SUCCESS)
+    {
+        Console::printf("state vector compile failed\n");
+        return;
+    }
+
+    AccessArgs args[gMaxThreads];
+    U32 go = 0;
+    for (U32 i = 0; i < gMaxThreads; ++i)
+    {
+        const String name = ("e" + std::to_string(i));
+        (void) svAsm->get().getElement(name.c_str(), args[i].elem);
+        args[i].go = &go;
+    }
+
+    for (const U32 threadCnt : gThreadCnts)
+    {
+        __atomic_store_n(&go, 0, __ATOMIC_RELEASE);
+        Thread threads[gMaxThreads];
+        for (U32 i = 0; i < threadCnt; ++i)
+        {
+            if (Thread::init(accessThread,
+                             &args[i],
+                             Thread::FAIR_MIN_PRI,
+                             Thread::FAIR,
+                             Thread::ALL_CORES,
+                             threads[i]) != SUCCESS)
+            {
+                Console::printf("thread init failed\n");
+                return;
+            }
+        }
+
+        // Release the threads and time until they all finish.
+        const U64 startNs = Clock::nanoTime();
+        __atomic_store_n(&go, 1, __ATOMIC_RELEASE);
+        for (U32 i = 0; i < threadCnt; ++i)
+        {
+            (void) threads[i].await(nullptr);
+        }
+
+        const U64 ns = (Clock::nanoTime() - startNs);
+        const String label =
+            (String(kLabel) + ", " + std::to_string(threadCnt) + " threads");
+        Bench::report(label.c_str(), (threadCnt * gAccessCnt), ns);
+    }
+}
+
+///
+/// @brief Times writing and reading an element from a single thread.
+///
+/// @param[in] kLabel  Measurement label.
+/// @param[in] kElem   Element to access.
+///
+static void benchAccess(const char* const kLabel, const Element<U64>& kElem)
+{
+    const U64 startNs = Clock::nanoTime();
+    for (U32 i = 0; i < gAccessCnt; ++i)
+    {
+        kElem.write(i);
+        Bench::consume(kElem.read());
+    }
+
+    const U64 ns = (Clock::nanoTime() - startNs);
+    Bench::report(kLabel, gAccessCnt, ns);
+}
+
+/////////////////////////////////// Benchmarks /////////////////////////////////
+
+///
+/// @brief Uncontended element write/read pairs for each element access mode.
+///
+BENCH(StateVectorLocks, Access)
+{
+    U64 backing = 0;
+
+    Element<U64> elemUnsynced(backing);
+    benchAccess("unsynchronized", elemUnsynced);
+
+    Spinlock lock;
+    if (Spinlock::init(lock) != SUCCESS)
+    {
+        Console::printf("spinlock init failed\n");
+        return;
+    }
+
+    Element<U64> elemLock(backing, &lock);
+    benchAccess("spinlock", elemLock);
+
+    AdaptiveLock adaptiveLock;
+    if (AdaptiveLock::init(adaptiveLock) != SUCCESS)
+    {
+        Console::printf("adaptive lock init failed\n");
+        return;
+    }
+
+    Element<U64> elemAdaptiveLock(backing, &adaptiveLock);
+    benchAccess("adaptive lock", elemAdaptiveLock);
+
+    SeqLock seqLock;
+    Element<U64> elemSeqLock(backing, seqLock);
+    benchAccess("seqlock", elemSeqLock);
+
+    Element<U64> elemAtomic(backing, AtomicAccess());
+    benchAccess("atomic", elemAtomic);
+}
+
+///
+/// @brief Threads writing and reading elements in their own regions. Reported
+/// time is wall time per access pair across all threads, so it falls as
+/// threads are added when accesses proceed in parallel.
+///
+BENCH(StateVectorLocks, Contention)
+{
+    benchContention("one lock", "lock");
+    benchContention("region locks", "lock region_locks");
+    benchContention("one adaptive lock", "adaptive_lock");
+    benchContention("region adaptive locks", "adaptive_lock region_locks");
+    benchContention("seqlocks", "seqlock");
+}
@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/bench/BenchTokenizer.cpp
+/// @brief Benchmarks for config file tokenization throughput.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "sf/config/Tokenizer.hpp"
+#include "sf/bench/Bench.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief State machine config tokenized by benchmarks. It exercises most of
+/// the config language syntax.
+///
+static const char* const gSmPath =
+    SF_REPO_PATH "/src/sf/config/utest/utest-sm-autocoder-harness/configs/"
+    "nonsense.sm";
+
+///
+/// @brief Number of copies of the config concatenated into the benchmark
+/// input, making it tens of thousands of lines long like a large generated
+/// config.
+///
+static constexpr U32 gCopyCnt = 100;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Builds the benchmark input from copies of the config.
+///
+/// @param[out] kSrc      On success, contains benchmark input.
+/// @param[out] kLineCnt  On success, contains number of lines in input.
+///
+/// @returns Whether the config was read.
+///
+static bool makeInput(String& kSrc, U64& kLineCnt)
+{
+    std::ifstream ifs(gSmPath);
+    if (!ifs.is_open())
+    {
+        Console::printf("failed to open %s\n", gSmPath);
+        return false;
+    }
+    std::stringstream copy;
+    copy << ifs.rdbuf();
+
+    kSrc.clear();
+    for (U32 i = 0; i < gCopyCnt; ++i)
+    {
+        kSrc += copy.str();
+    }
+
+    kLineCnt = 0;
+    for (const char c : kSrc)
+    {
+        if (c == '\n')
+        {
+            ++kLineCnt;
+        }
+    }
+
+    return true;
+}
+
+///
+/// @brief Reports a tokenization time.
+///
+/// @param[in] kLabel    Label.
+/// @param[in] kLineCnt  Number of lines tokenized.
+/// @param[in] kNs       Elapsed time in nanoseconds.
+///
+static void reportLines(const char* const kLabel,
+                        const U64 kLineCnt,
+                        const U64 kNs)
+{
+    Bench::report(kLabel, kLineCnt, kNs);
+    Console::printf("    %.0f lines/s\n",
+                    ((static_cast<F64>(kLineCnt) * Clock::NS_IN_S) / kNs));
+}
+
+/////////////////////////////////// Benchmarks /////////////////////////////////
+
+///
+/// @brief Tokenizing a large config. Operations are input lines.
+///
+BENCH(Tokenizer, Lines)
+{
+    String src;
+    U64 lineCnt = 0;
+    if (!makeInput(src, lineCnt))
+    {
+        return;
+    }
+
+    std::stringstream ss(src);
+    Vec<Token> toks;
+    const U64 startNs = Clock::nanoTime();
+    if (Tokenizer::tokenize(ss, toks, nullptr) != SUCCESS)
+    {
+        Console::printf("tokenize failed\n");
+        return;
+    }
+    const U64 ns = (Clock::nanoTime() - startNs);
+    Bench::consume(toks.size());
+    reportLines("lines", lineCnt, ns);
+}
+
+///
+/// @brief Tokenizing a large config file read through a file stream versus
+/// mapped into memory by the file path entry point. Operations are input
+/// lines.
+///
+BENCH(Tokenizer, File)
+{
+    String src;
+    U64 lineCnt = 0;
+    if (!makeInput(src, lineCnt))
+    {
+        return;
+    }
+
+    const char* const path = "bench-tokenizer.tmp";
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << src;
+    }
+
+    // File stream, as config files were read before being mapped.
+    std::ifstream ifs(path);
+    Vec<Token> toks;
+    U64 startNs = Clock::nanoTime();
+    const Result resStream = Tokenizer::tokenize(ifs, toks, nullptr);
+    U64 ns = (Clock::nanoTime() - startNs);
+    Bench::consume(toks.size());
+    toks.clear();
+
+    // Mapped file.
+    startNs = Clock::nanoTime();
+    const Result resMap = Tokenizer::tokenize(path, toks, nullptr);
+    const U64 nsMap = (Clock::nanoTime() - startNs);
+    Bench::consume(toks.size());
+
+    (void) std::remove(path);
+    if ((resStream != SUCCESS) || (resMap != SUCCESS))
+    {
+        Console::printf("tokenize failed\n");
+        return;
+    }
+
+    reportLines("ifstream", lineCnt, ns);
+    reportLines("mmap", lineCnt, nsMap);
+}
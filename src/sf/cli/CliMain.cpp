@@ -25,6 +25,7 @@
 #include "sf/cli/CliUtil.hpp"
 #include "sf/cli/StateMachineCommand.hpp"
 #include "sf/cli/StateVectorCommand.hpp"
+#include "sf/config/CompileCache.hpp"
 #include "sf/core/Assert.hpp"
 #include "sf/core/BasicTypes.hpp"
 
@@ -77,6 +78,15 @@ static void printHelpMsg()
               << "    " << Console::yellow
               << "=> run state script" << Console::reset << "\n";
 
+    // Options.
+    std::cout << "\noptions:\n";
+
+    std::cout << "  " << CompileCache::NO_CACHE_OPT << "\n"
+              << "    " << Console::yellow
+              << "=> bypass the compile cache in `sm` commands; the cache is "
+              << "stored in\n       $SF_CACHE_DIR, $XDG_CACHE_HOME/surefire or "
+              << "~/.cache/surefire" << Console::reset << "\n";
+
     std::cout << std::flush;
 }
 
@@ -17,9 +17,11 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <fstream>
+#include <sstream>
 
 #include "sf/cli/CliUtil.hpp"
 #include "sf/cli/StateMachineCommand.hpp"
+#include "sf/config/CompileCache.hpp"
 #include "sf/config/StateMachineAutocoder.hpp"
 #include "sf/config/StateMachineCompiler.hpp"
 #include "sf/config/StateScriptCompiler.hpp"
@@ -62,79 +64,108 @@ I32 Cli::sm(const Vec<String> kArgs)
 
 I32 Cli::smCheck(const Vec<String> kArgs)
 {
+    Vec<String> args = kArgs;
+    const CompileCache cache(args);
+
     // Check that correct number of arguments was passed.
-    if (kArgs.size() != 2)
+    if (args.size() != 2)
     {
         Cli::error() << "`sm check` expects 2 arguments" << std::endl;
         return EXIT_FAILURE;
     }
 
-    const String& svFile = kArgs[0];
-    const String& smFile = kArgs[1];
-
-    // Compile state vector.
-    Ref<const StateVectorAssembly> svAsm;
-    ErrorInfo err;
-    Result res = StateVectorCompiler::compile(svFile, svAsm, &err);
+    const String& svFile = args[0];
+    const String& smFile = args[1];
 
-    if (res != SUCCESS)
+    // Get the expression node counts of configs that were already found to be
+    // valid from the cache.
+    String key;
+    String cached;
+    U32 srcNodeCnt = 0;
+    U32 nodeCnt = 0;
+    bool hit = false;
+    const bool cacheable = cache.key("check", {svFile, smFile}, {}, key);
+    if (cacheable && cache.read(key, cached))
     {
-        // State vector config is invalid.
-        std::cout << err.prettifyError() << std::endl;
-        return EXIT_FAILURE;
+        std::stringstream cachedSs(cached);
+        hit = static_cast<bool>(cachedSs >> srcNodeCnt >> nodeCnt);
     }
 
-    // Compile state machine.
-    err = ErrorInfo();
-    Ref<const StateMachineAssembly> smAsm;
-    res = StateMachineCompiler::compile(smFile, svAsm, smAsm, &err);
-
-    if (res != SUCCESS)
+    if (!hit)
     {
-        // State machine config is invalid.
-        std::cout << err.prettifyError() << std::endl;
-        return EXIT_FAILURE;
+        // Compile state vector.
+        Ref<const StateVectorAssembly> svAsm;
+        ErrorInfo err;
+        Result res = cache.compileStateVector(svFile, svAsm, &err);
+
+        if (res != SUCCESS)
+        {
+            // State vector config is invalid.
+            std::cout << err.prettifyError() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // Compile state machine.
+        err = ErrorInfo();
+        Ref<const StateMachineAssembly> smAsm;
+        res = StateMachineCompiler::compile(smFile, svAsm, smAsm, &err);
+
+        if (res != SUCCESS)
+        {
+            // State machine config is invalid.
+            std::cout << err.prettifyError() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const Ref<const ExpressionCache> exprCache = smAsm->exprCache();
+        SF_ASSERT(exprCache != nullptr);
+        srcNodeCnt = exprCache->srcNodeCount();
+        nodeCnt = exprCache->nodeCount();
+        if (cacheable)
+        {
+            cache.write(key, (std::to_string(srcNodeCnt) + " "
+                              + std::to_string(nodeCnt)));
+        }
     }
 
-    std::cout << Console::green << "state machine config is valid"
-              << Console::reset << std::endl;
+    // Config is valid; print the effect of folding and sharing expressions.
+    std::cout << Console::green << "state machine config is valid\n"
+              << Console::reset;
+
+    const U32 reductionPct =
+        ((srcNodeCnt == 0) ? 0 : ((100 * (srcNodeCnt - nodeCnt)) / srcNodeCnt));
+    std::cout << "expression nodes: " << Console::cyan << srcNodeCnt
+              << Console::reset << " -> " << Console::cyan << nodeCnt
+              << Console::reset << " (" << reductionPct << "% reduction)"
+              << std::endl;
 
     return EXIT_SUCCESS;
 }
 
 I32 Cli::smTest(const Vec<String> kArgs)
 {
+    Vec<String> args = kArgs;
+    const CompileCache cache(args);
+
     // Check that correct number of arguments was passed.
-    if (kArgs.size() != 3)
+    if (args.size() != 3)
     {
         Cli::error() << "`sm test` expects 3 arguments" << std::endl;
         return EXIT_FAILURE;
     }
 
-    const String& svFile = kArgs[0];
-    const String& smFile = kArgs[1];
-    const String& ssFile = kArgs[2];
+    const String& svFile = args[0];
+    const String& smFile = args[1];
+    const String& ssFile = args[2];
 
-    // Compile state vector.
+    // Compile state vector and state machine, specifying not to rake the
+    // state machine assembly. This is required to compile a state script
+    // using the state machine assembly.
     Ref<const StateVectorAssembly> svAsm;
-    ErrorInfo err;
-    Result res = StateVectorCompiler::compile(svFile, svAsm, &err);
-    if (res != SUCCESS)
-    {
-        std::cout << err.prettifyError() << std::endl;
-        return EXIT_FAILURE;
-    }
-
-    // Compile state machine, specifying not to rake the assembly. This is
-    // required to compile a state script using the state machine assembly.
-    err = ErrorInfo();
     Ref<const StateMachineAssembly> smAsm;
-    res = StateMachineCompiler::compile(smFile,
-                                        svAsm,
-                                        smAsm,
-                                        &err,
-                                        StateMachineCompiler::FIRST_STATE,
-                                        false);
+    ErrorInfo err;
+    Result res =
+        cache.compileStateMachine(svFile, smFile, svAsm, smAsm, &err, false);
     if (res != SUCCESS)
     {
         std::cout << err.prettifyError() << std::endl;
@@ -171,39 +202,67 @@ I32 Cli::smTest(const Vec<String> kArgs)
 
 I32 Cli::smAutocode(const Vec<String> kArgs)
 {
+    Vec<String> args = kArgs;
+    const CompileCache cache(args);
+
     // Check that correct number of arguments was passed.
-    if (kArgs.size() != 4)
+    if (args.size() != 4)
     {
         Cli::error() << "`sm autocode` expects 4 arguments" << std::endl;
         return EXIT_FAILURE;
     }
 
-    const String& svFile = kArgs[0];
-    const String& smFile = kArgs[1];
-    const String& autocodeFile = kArgs[2];
-    const String& smName = kArgs[3];
+    const String& svFile = args[0];
+    const String& smFile = args[1];
+    const String& autocodeFile = args[2];
+    const String& smName = args[3];
 
-    // Compile state vector.
-    Ref<const StateVectorAssembly> svAsm;
-    ErrorInfo err;
-    Result res = StateVectorCompiler::compile(svFile, svAsm, &err);
-    if (res != SUCCESS)
+    // Get the autocode of unchanged configs from the cache.
+    String key;
+    String autocode;
+    const bool cacheable =
+        cache.key("autocode", {svFile, smFile}, {smName}, key);
+    if (!cacheable || !cache.read(key, autocode))
     {
-        std::cout << err.prettifyError() << std::endl;
-        return EXIT_FAILURE;
-    }
+        // Compile state vector.
+        Ref<const StateVectorAssembly> svAsm;
+        ErrorInfo err;
+        Result res = cache.compileStateVector(svFile, svAsm, &err);
+        if (res != SUCCESS)
+        {
+            std::cout << err.prettifyError() << std::endl;
+            return EXIT_FAILURE;
+        }
 
-    // Compile state machine.
-    err = ErrorInfo();
-    Ref<const StateMachineAssembly> smAsm;
-    res = StateMachineCompiler::compile(smFile, svAsm, smAsm, &err);
-    if (res != SUCCESS)
-    {
-        std::cout << err.prettifyError() << std::endl;
-        return EXIT_FAILURE;
+        // Compile state machine. The autocoder walks expression trees, so the
+        // state machine is always compiled rather than loaded from an image.
+        err = ErrorInfo();
+        Ref<const StateMachineAssembly> smAsm;
+        res = StateMachineCompiler::compile(smFile, svAsm, smAsm, &err);
+        if (res != SUCCESS)
+        {
+            std::cout << err.prettifyError() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // Invoke autocoder.
+        std::stringstream autocodeSs;
+        res = StateMachineAutocoder::code(autocodeSs, smName, smAsm);
+        if (res != SUCCESS)
+        {
+            Cli::error() << "autocoder failed with internal error " << res
+                         << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        autocode = autocodeSs.str();
+        if (cacheable)
+        {
+            cache.write(key, autocode);
+        }
     }
 
-    // Open autocode output file.
+    // Write autocode output file.
     std::ofstream ofs(autocodeFile, std::fstream::out);
     if (!ofs.is_open())
     {
@@ -211,15 +270,7 @@ I32 Cli::smAutocode(const Vec<String> kArgs)
                      << std::endl;
         return EXIT_FAILURE;
     }
-
-    // Invoke autocoder.
-    res = StateMachineAutocoder::code(ofs, smName, smAsm);
-    if (res != SUCCESS)
-    {
-        Cli::error() << "autocoder failed with internal error " << res
-                     << std::endl;
-        return EXIT_FAILURE;
-    }
+    ofs << autocode;
 
     std::cout << Console::green << "successfully generated autocode"
               << Console::reset << std::endl;
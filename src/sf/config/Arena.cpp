@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/config/Arena.hpp"
+#include "sf/core/Assert.hpp"
+
+namespace Sf
+{
+
+/////////////////////////////////// Public /////////////////////////////////////
+
+Arena::Arena() :
+    mCur(nullptr),
+    mFree(0),
+    mNextBlockSize(MIN_BLOCK_SIZE),
+    mBytesUsed(0),
+    mBytesReserved(0)
+{
+}
+
+Arena::~Arena()
+{
+    // Destroy objects in reverse order of creation, so that objects are
+    // destroyed before any objects created before them that they may
+    // reference.
+    for (auto it = mDtors.rbegin(); it != mDtors.rend(); ++it)
+    {
+        (*it).destroy((*it).obj);
+    }
+
+    for (U8* const block : mBlocks)
+    {
+        delete[] block;
+    }
+}
+
+void* Arena::allocate(const U64 kSize, const U64 kAlign)
+{
+    SF_ASSERT((kAlign != 0) && ((kAlign & (kAlign - 1)) == 0));
+
+    // Pad the allocation to the requested alignment.
+    U64 pad = ((kAlign - (reinterpret_cast<uintptr_t>(mCur) & (kAlign - 1)))
+               & (kAlign - 1));
+    if ((mCur == nullptr) || ((pad + kSize) > mFree))
+    {
+        // Allocate a new block large enough for the allocation at any
+        // alignment. Blocks from new[] are aligned for any fundamental type.
+        U64 blockSize = mNextBlockSize;
+        if ((kSize + kAlign) > blockSize)
+        {
+            blockSize = (kSize + kAlign);
+        }
+        else if (mNextBlockSize < MAX_BLOCK_SIZE)
+        {
+            mNextBlockSize *= 2;
+        }
+
+        mBlocks.push_back(new U8[blockSize]);
+        mCur = mBlocks.back();
+        mFree = blockSize;
+        mBytesReserved += blockSize;
+        pad = ((kAlign - (reinterpret_cast<uintptr_t>(mCur) & (kAlign - 1)))
+               & (kAlign - 1));
+    }
+
+    void* const mem = (mCur + pad);
+    mCur += (pad + kSize);
+    mFree -= (pad + kSize);
+    mBytesUsed += (pad + kSize);
+
+    return mem;
+}
+
+U64 Arena::bytesUsed() const
+{
+    return mBytesUsed;
+}
+
+U64 Arena::bytesReserved() const
+{
+    return mBytesReserved;
+}
+
+} // namespace Sf
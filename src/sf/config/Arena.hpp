@@ -0,0 +1,228 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/config/Arena.hpp
+/// @brief Bump allocator for compiled config objects.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_ARENA_HPP
+#define SF_ARENA_HPP
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "sf/config/StlTypes.hpp"
+#include "sf/core/BasicTypes.hpp"
+
+namespace Sf
+{
+
+///
+/// @brief Bump allocator that owns the many small objects making up a
+/// compiled config, e.g., expression nodes and state machine actions. Objects
+/// are carved out of large blocks, so allocating one costs a pointer bump
+/// rather than a malloc and a shared pointer control block. Objects cannot be
+/// freed individually; they are destroyed in reverse order of creation and
+/// their memory released when the arena destructs.
+///
+/// @remark Assemblies hold their arena by Ref, and Refs to arena objects are
+/// made with Arena::share(), which shares ownership of the arena rather than
+/// allocating a control block per object.
+///
+class Arena final
+{
+public:
+
+    ///
+    /// @brief Size of the first block allocated by an arena. Each subsequent
+    /// block doubles in size up to MAX_BLOCK_SIZE, so small assemblies stay
+    /// small and large ones make few allocations.
+    ///
+    static constexpr U64 MIN_BLOCK_SIZE = 512;
+
+    ///
+    /// @brief Maximum size of a block, excluding blocks allocated for single
+    /// allocations larger than this.
+    ///
+    static constexpr U64 MAX_BLOCK_SIZE = (64 * 1024);
+
+    ///
+    /// @brief Creates a Ref that views an object in an arena and shares
+    /// ownership of the arena.
+    ///
+    /// @param[in] kArena  Arena containing object.
+    /// @param[in] kObj    Object.
+    ///
+    /// @returns Ref to object.
+    ///
+    template<typename T>
+    static Ref<T> share(const Ref<Arena>& kArena, T* const kObj)
+    {
+        return Ref<T>(kArena, kObj);
+    }
+
+    ///
+    /// @brief Constructor.
+    ///
+    Arena();
+
+    ///
+    /// @brief Destructor. Destroys all objects in the arena and frees its
+    /// blocks.
+    ///
+    ~Arena();
+
+    ///
+    /// @brief Constructs an object in the arena.
+    ///
+    /// @tparam T      Object type.
+    /// @tparam TArgs  Constructor argument types.
+    ///
+    /// @param[in] kArgs  Constructor arguments.
+    ///
+    /// @returns Pointer to object, valid for the lifetime of the arena.
+    ///
+    template<typename T, typename... TArgs>
+    T* create(TArgs&&... kArgs)
+    {
+        void* const mem = this->allocate(sizeof(T), alignof(T));
+        T* const obj = new (mem) T(std::forward<TArgs>(kArgs)...);
+        if (!std::is_trivially_destructible<T>::value)
+        {
+            mDtors.push_back({obj, &Arena::destroy<T>});
+        }
+        return obj;
+    }
+
+    ///
+    /// @brief Allocates a value-initialized array in the arena.
+    ///
+    /// @tparam T  Element type. Must be trivially destructible.
+    ///
+    /// @param[in] kCnt  Number of elements.
+    ///
+    /// @returns Pointer to first element, valid for the lifetime of the
+    /// arena.
+    ///
+    template<typename T>
+    T* createArray(const U64 kCnt)
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena arrays are not destroyed");
+        T* const arr = static_cast<T*>(
+            this->allocate((kCnt * sizeof(T)), alignof(T)));
+        for (U64 i = 0; i < kCnt; ++i)
+        {
+            new (&arr[i]) T();
+        }
+        return arr;
+    }
+
+    ///
+    /// @brief Allocates uninitialized memory in the arena.
+    ///
+    /// @param[in] kSize   Number of bytes.
+    /// @param[in] kAlign  Alignment in bytes. Must be a power of 2.
+    ///
+    /// @returns Pointer to memory, valid for the lifetime of the arena.
+    ///
+    void* allocate(const U64 kSize, const U64 kAlign);
+
+    ///
+    /// @brief Gets the number of bytes allocated from the arena, including
+    /// alignment padding.
+    ///
+    /// @returns Bytes allocated.
+    ///
+    U64 bytesUsed() const;
+
+    ///
+    /// @brief Gets the total size of the blocks owned by the arena.
+    ///
+    /// @returns Bytes reserved.
+    ///
+    U64 bytesReserved() const;
+
+    Arena(const Arena&) = delete;
+    Arena(Arena&&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena& operator=(Arena&&) = delete;
+
+private:
+
+    ///
+    /// @brief Destructor of an object in the arena.
+    ///
+    struct Dtor final
+    {
+        void* obj;                    ///< Object to destroy.
+        void (*destroy)(void* kObj);  ///< Function that destroys object.
+    };
+
+    ///
+    /// @brief Destroys an object of a given type.
+    ///
+    /// @param[in] kObj  Object to destroy.
+    ///
+    template<typename T>
+    static void destroy(void* const kObj)
+    {
+        static_cast<T*>(kObj)->~T();
+    }
+
+    ///
+    /// @brief Blocks owned by the arena.
+    ///
+    Vec<U8*> mBlocks;
+
+    ///
+    /// @brief Destructors of non-trivially destructible objects in the arena,
+    /// in order of creation.
+    ///
+    Vec<Dtor> mDtors;
+
+    ///
+    /// @brief Next free byte in the current block.
+    ///
+    U8* mCur;
+
+    ///
+    /// @brief Number of free bytes in the current block.
+    ///
+    U64 mFree;
+
+    ///
+    /// @brief Size of the next block to allocate.
+    ///
+    U64 mNextBlockSize;
+
+    ///
+    /// @brief Bytes allocated from the arena.
+    ///
+    U64 mBytesUsed;
+
+    ///
+    /// @brief Total size of blocks.
+    ///
+    U64 mBytesReserved;
+};
+
+} // namespace Sf
+
+#endif
@@ -0,0 +1,1595 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include <cstring>
+
+#include "sf/config/AssemblyImage.hpp"
+#include "sf/config/LanguageConstants.hpp"
+#include "sf/config/MappedFile.hpp"
+#include "sf/core/Assert.hpp"
+
+namespace Sf
+{
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Stats dependency state count which indicates that the stats are
+/// used by all states.
+///
+static constexpr U32 gAllStates = 0xFFFFFFFF;
+
+///
+/// @brief Map of binary operator functions to the opcodes that evaluate them.
+///
+static const Map<const void*, ExpressionVm::Opcode> gBinOpcodes =
+{
+    {reinterpret_cast<const void*>(&ExprOpFuncs::mult<I64>),
+     ExpressionVm::MULT_I},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::mult<F64>),
+     ExpressionVm::MULT_F},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::div<F64>),
+     ExpressionVm::DIV_F},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::add<I64>),
+     ExpressionVm::ADD_I},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::add<F64>),
+     ExpressionVm::ADD_F},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::sub<I64>),
+     ExpressionVm::SUB_I},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::sub<F64>),
+     ExpressionVm::SUB_F},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::lt<I64>),
+     ExpressionVm::LT_I},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::lt<F64>),
+     ExpressionVm::LT_F},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::lte<I64>),
+     ExpressionVm::LTE_I},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::lte<F64>),
+     ExpressionVm::LTE_F},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::gt<I64>),
+     ExpressionVm::GT_I},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::gt<F64>),
+     ExpressionVm::GT_F},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::gte<I64>),
+     ExpressionVm::GTE_I},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::gte<F64>),
+     ExpressionVm::GTE_F},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::eq<I64>),
+     ExpressionVm::EQ_I},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::eq<F64>),
+     ExpressionVm::EQ_F},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::neq<I64>),
+     ExpressionVm::NEQ_I},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::neq<F64>),
+     ExpressionVm::NEQ_F},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::land<I64>),
+     ExpressionVm::AND_I},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::land<F64>),
+     ExpressionVm::AND_F},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::lor<I64>),
+     ExpressionVm::OR_I},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::lor<F64>),
+     ExpressionVm::OR_F}
+};
+
+///
+/// @brief Map of unary operator functions to the opcodes that evaluate them,
+/// excluding the casts that wrap element nodes.
+///
+static const Map<const void*, ExpressionVm::Opcode> gUnaryOpcodes =
+{
+    {reinterpret_cast<const void*>(&ExprOpFuncs::lnot<I64>),
+     ExpressionVm::NOT_I},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::lnot<F64>),
+     ExpressionVm::NOT_F},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<F64, I64>),
+     ExpressionVm::I2F_LHS}
+};
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Appends a value to a buffer.
+///
+/// @tparam T  Value type.
+///
+/// @param[out] kBuf  Buffer.
+/// @param[in]  kVal  Value.
+///
+template<typename T>
+static void put(String& kBuf, const T kVal)
+{
+    kBuf.append(reinterpret_cast<const char*>(&kVal), sizeof(T));
+}
+
+///
+/// @brief Appends a string to a buffer, prefixed by its length.
+///
+/// @param[out] kBuf  Buffer.
+/// @param[in]  kStr  String.
+///
+static void putString(String& kBuf, const String& kStr)
+{
+    put<U32>(kBuf, kStr.size());
+    kBuf.append(kStr);
+}
+
+///
+/// @brief Appends a bytecode program to a buffer, prefixed by its length.
+///
+/// @param[out] kBuf     Buffer.
+/// @param[in]  kInstrs  Program instructions.
+///
+static void putInstrs(String& kBuf,
+                      const Vec<ExpressionVm::Instruction>& kInstrs)
+{
+    put<U32>(kBuf, kInstrs.size());
+    for (const ExpressionVm::Instruction& instr : kInstrs)
+    {
+        put<U8>(kBuf, instr.op);
+        put<ExpressionVm::Value>(kBuf, instr.val);
+    }
+}
+
+///
+/// @brief Creates a token for a parse built from an image. Tokens built from
+/// images have no position.
+///
+/// @param[in] kType  Token type.
+/// @param[in] kStr   Token text.
+///
+/// @returns Token.
+///
+static Token makeToken(const Token::Type kType, const String& kStr)
+{
+    return {kType, kStr, -1, -1, nullptr, nullptr};
+}
+
+///
+/// @brief Creates a node which runs an expression VM.
+///
+/// @param[in] kArena  Arena to allocate node in.
+/// @param[in] kType   Expression evaluation type.
+/// @param[in] kVm     VM that runs the expression bytecode.
+///
+/// @returns Bytecode node, or null if the type is invalid.
+///
+static IExpression* makeBytecodeNode(Arena& kArena,
+                                     const ElementType kType,
+                                     ExpressionVm& kVm)
+{
+    switch (kType)
+    {
+        case ElementType::INT8:
+            return kArena.create<BytecodeExprNode<I8>>(kVm, nullptr);
+
+        case ElementType::INT16:
+            return kArena.create<BytecodeExprNode<I16>>(kVm, nullptr);
+
+        case ElementType::INT32:
+            return kArena.create<BytecodeExprNode<I32>>(kVm, nullptr);
+
+        case ElementType::INT64:
+            return kArena.create<BytecodeExprNode<I64>>(kVm, nullptr);
+
+        case ElementType::UINT8:
+            return kArena.create<BytecodeExprNode<U8>>(kVm, nullptr);
+
+        case ElementType::UINT16:
+            return kArena.create<BytecodeExprNode<U16>>(kVm, nullptr);
+
+        case ElementType::UINT32:
+            return kArena.create<BytecodeExprNode<U32>>(kVm, nullptr);
+
+        case ElementType::UINT64:
+            return kArena.create<BytecodeExprNode<U64>>(kVm, nullptr);
+
+        case ElementType::FLOAT32:
+            return kArena.create<BytecodeExprNode<F32>>(kVm, nullptr);
+
+        case ElementType::FLOAT64:
+            return kArena.create<BytecodeExprNode<F64>>(kVm, nullptr);
+
+        case ElementType::BOOL:
+            return kArena.create<BytecodeExprNode<bool>>(kVm, nullptr);
+
+        default:
+            return nullptr;
+    }
+}
+
+///
+/// @brief Creates an assignment action.
+///
+/// @tparam T  Element and expression type.
+///
+/// @param[in] kArena  Arena to allocate action in.
+/// @param[in] kElem   Element to assign. Must have type T.
+/// @param[in] kExpr   Expression to assign. Must evaluate to T.
+///
+/// @returns Assignment action.
+///
+template<typename T>
+static IAction* makeAssignmentAction(Arena& kArena,
+                                     IElement& kElem,
+                                     IExpression& kExpr)
+{
+    return kArena.create<AssignmentAction<T>>(
+        *static_cast<Element<T>*>(&kElem),
+        dynamic_cast<IExprNode<T>&>(kExpr));
+}
+
+///
+/// @brief Creates an assignment action of the element's type.
+///
+/// @param[in] kArena  Arena to allocate action in.
+/// @param[in] kElem   Element to assign.
+/// @param[in] kExpr   Expression to assign. Must have the element's type.
+///
+/// @returns Assignment action, or null if the type is invalid.
+///
+static IAction* makeAssignmentAction(Arena& kArena,
+                                     IElement& kElem,
+                                     IExpression& kExpr)
+{
+    switch (kElem.type())
+    {
+        case ElementType::INT8:
+            return makeAssignmentAction<I8>(kArena, kElem, kExpr);
+
+        case ElementType::INT16:
+            return makeAssignmentAction<I16>(kArena, kElem, kExpr);
+
+        case ElementType::INT32:
+            return makeAssignmentAction<I32>(kArena, kElem, kExpr);
+
+        case ElementType::INT64:
+            return makeAssignmentAction<I64>(kArena, kElem, kExpr);
+
+        case ElementType::UINT8:
+            return makeAssignmentAction<U8>(kArena, kElem, kExpr);
+
+        case ElementType::UINT16:
+            return makeAssignmentAction<U16>(kArena, kElem, kExpr);
+
+        case ElementType::UINT32:
+            return makeAssignmentAction<U32>(kArena, kElem, kExpr);
+
+        case ElementType::UINT64:
+            return makeAssignmentAction<U64>(kArena, kElem, kExpr);
+
+        case ElementType::FLOAT32:
+            return makeAssignmentAction<F32>(kArena, kElem, kExpr);
+
+        case ElementType::FLOAT64:
+            return makeAssignmentAction<F64>(kArena, kElem, kExpr);
+
+        case ElementType::BOOL:
+            return makeAssignmentAction<bool>(kArena, kElem, kExpr);
+
+        default:
+            return nullptr;
+    }
+}
+
+/////////////////////////////////// Public /////////////////////////////////////
+
+Result AssemblyImage::write(std::ostream& kOs,
+                            const Ref<const StateMachineAssembly> kSmAsm)
+{
+    // Check that state machine is non-null.
+    if (kSmAsm == nullptr)
+    {
+        return E_IMG_NULL;
+    }
+
+    const StateMachineAssembly::Workspace& smWs = kSmAsm->mWs;
+    SF_SAFE_ASSERT(smWs.svAsm != nullptr);
+    SF_SAFE_ASSERT(smWs.svAsm->parse() != nullptr);
+    SF_SAFE_ASSERT(smWs.localSvAsm != nullptr);
+    SF_SAFE_ASSERT(smWs.localSvAsm->parse() != nullptr);
+    SF_SAFE_ASSERT(smWs.smConfig.states != nullptr);
+
+    AssemblyImage::WriteWorkspace ws;
+    ws.smAsm = kSmAsm;
+
+    // Number the elements of the state vector followed by the elements of the
+    // local state vector, in config order. The loader numbers the elements of
+    // the state vectors it compiles from the same layouts in the same order.
+    const StateVector::Config svConfigs[2] =
+        {smWs.svAsm->config(), smWs.localSvAsm->config()};
+    for (const StateVector::Config& svConfig : svConfigs)
+    {
+        for (const StateVector::ElementConfig* elem = svConfig.elems;
+             elem->name != nullptr;
+             ++elem)
+        {
+            const U32 id = ws.elemIds.size();
+            ws.elemIds[elem->elem] = id;
+        }
+    }
+
+    // Write state vector layouts.
+    String body;
+    AssemblyImage::writeStateVector(*smWs.svAsm->parse(), body);
+    AssemblyImage::writeStateVector(*smWs.localSvAsm->parse(), body);
+
+    // Write local element initial values. The local state vector has a single
+    // region, so this is the contents of that region.
+    const StateVector::Config& localSvConfig = svConfigs[1];
+    SF_SAFE_ASSERT(localSvConfig.regions != nullptr);
+    SF_SAFE_ASSERT(localSvConfig.regions[0].region != nullptr);
+    const Region& localRegion = *localSvConfig.regions[0].region;
+    put<U32>(body, localRegion.size());
+    body.append(static_cast<const char*>(localRegion.addr()),
+                localRegion.size());
+
+    // Write symbol tables if the state machine was not raked.
+    put<U8>(body, (smWs.raked ? 0 : 1));
+    if (!smWs.raked)
+    {
+        put<U32>(body, smWs.elems.size());
+        for (const auto& elem : smWs.elems)
+        {
+            auto idIt = ws.elemIds.find(elem.second);
+            SF_SAFE_ASSERT(idIt != ws.elemIds.end());
+            putString(body, elem.first);
+            put<U32>(body, (*idIt).second);
+        }
+
+        put<U32>(body, smWs.stateIds.size());
+        for (const auto& state : smWs.stateIds)
+        {
+            putString(body, state.first);
+            put<U32>(body, state.second);
+        }
+
+        put<U32>(body, smWs.readOnlyElems.size());
+        for (const String& elemName : smWs.readOnlyElems)
+        {
+            putString(body, elemName);
+        }
+    }
+
+    // Write states. This numbers and writes the expressions, stats and actions
+    // that the state labels use into their own sections.
+    String states;
+    U32 stateCnt = 0;
+    Result res = SUCCESS;
+    for (const StateMachine::StateConfig* state = smWs.smConfig.states;
+         state->id != StateMachine::NO_STATE;
+         ++state)
+    {
+        put<U32>(states, state->id);
+        res = AssemblyImage::writeLabel(state->entry, ws, states);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        res = AssemblyImage::writeLabel(state->step, ws, states);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        res = AssemblyImage::writeLabel(state->exit, ws, states);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        ++stateCnt;
+    }
+
+    // Write the stats updated by the state machine and their dependencies.
+    String statsDeps;
+    U32 statsDepCnt = 0;
+    for (U32 i = 0;
+         ((smWs.smConfig.stats != nullptr)
+          && (smWs.smConfig.stats[i] != nullptr));
+         ++i)
+    {
+        U32 id = 0;
+        res = AssemblyImage::statsId(*smWs.smConfig.stats[i], ws, id);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+        put<U32>(statsDeps, id);
+
+        const StateMachine::StatsDeps* const deps =
+            ((smWs.smConfig.statsDeps != nullptr)
+             ? &smWs.smConfig.statsDeps[i]
+             : nullptr);
+        const bool sampleInactive = ((deps != nullptr) && deps->sampleInactive);
+        put<U8>(statsDeps, (sampleInactive ? 1 : 0));
+        if ((deps == nullptr) || (deps->states == nullptr))
+        {
+            put<U32>(statsDeps, gAllStates);
+        }
+        else
+        {
+            U32 depStateCnt = 0;
+            while (deps->states[depStateCnt] != StateMachine::NO_STATE)
+            {
+                ++depStateCnt;
+            }
+
+            put<U32>(statsDeps, depStateCnt);
+            for (U32 j = 0; j < depStateCnt; ++j)
+            {
+                put<U32>(statsDeps, deps->states[j]);
+            }
+        }
+
+        ++statsDepCnt;
+    }
+
+    // Assemble the sections in the order they are loaded. Stats come before
+    // the expressions that use them, and expressions before the actions that
+    // use them.
+    put<U32>(body, ws.statsIds.size());
+    body.append(ws.stats);
+    put<U32>(body, ws.exprIds.size());
+    body.append(ws.exprs);
+    put<U32>(body, ws.actionIds.size());
+    body.append(ws.actions);
+    put<U32>(body, stateCnt);
+    body.append(states);
+    put<U32>(body, statsDepCnt);
+    body.append(statsDeps);
+
+    // Write the built-in state machine elements and the initial state.
+    const IElement* const builtinElems[3] =
+    {
+        smWs.smConfig.elemState,
+        smWs.smConfig.elemStateTime,
+        smWs.smConfig.elemGlobalTime
+    };
+    for (const IElement* const elem : builtinElems)
+    {
+        auto idIt = ws.elemIds.find(elem);
+        SF_SAFE_ASSERT(idIt != ws.elemIds.end());
+        put<U32>(body, (*idIt).second);
+    }
+    put<U32>(body, smWs.smConfig.elemState->read());
+
+    AssemblyImage::writeImage(kOs, AssemblyImage::MAGIC, body);
+
+    return SUCCESS;
+}
+
+Result AssemblyImage::write(std::ostream& kOs,
+                            const Ref<const StateVectorAssembly> kSvAsm)
+{
+    // Check that state vector is non-null.
+    if (kSvAsm == nullptr)
+    {
+        return E_IMG_NULL;
+    }
+
+    SF_SAFE_ASSERT(kSvAsm->parse() != nullptr);
+    String body;
+    AssemblyImage::writeStateVector(*kSvAsm->parse(), body);
+    AssemblyImage::writeImage(kOs, AssemblyImage::SV_MAGIC, body);
+
+    return SUCCESS;
+}
+
+Result AssemblyImage::load(const String kFilePath,
+                           Ref<const StateVectorAssembly>& kSvAsm,
+                           Ref<const StateMachineAssembly>& kSmAsm,
+                           const bool kRake)
+{
+    // Map the image and load it in place.
+    MappedFile file;
+    const Result res = MappedFile::init(kFilePath, file);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    return AssemblyImage::load(file.data(), file.size(), kSvAsm, kSmAsm, kRake);
+}
+
+Result AssemblyImage::load(const void* const kBuf,
+                           const U64 kSize,
+                           Ref<const StateVectorAssembly>& kSvAsm,
+                           Ref<const StateMachineAssembly>& kSmAsm,
+                           const bool kRake)
+{
+    AssemblyImage::Reader r = {static_cast<const U8*>(kBuf),
+                               (static_cast<const U8*>(kBuf) + kSize)};
+
+    // Check the header and verify the body against the checksum.
+    Result res = AssemblyImage::readHeader(r, AssemblyImage::MAGIC);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    // Initialize a blank workspace. Loaded expressions are bytecode.
+    AssemblyImage::LoadWorkspace ws;
+    StateMachineAssembly::Workspace& smWs = ws.smWs;
+    smWs.arena.reset(new Arena());
+    smWs.raked = true;
+    smWs.exprBackend = ExpressionCompiler::BYTECODE;
+    Arena& arena = *smWs.arena;
+
+    // Compile the state vector layouts.
+    res = AssemblyImage::readStateVector(r, smWs.svAsm);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    res = AssemblyImage::readStateVector(r, smWs.localSvAsm);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    // Number the elements in the same order as the writer.
+    const StateVector::Config svConfigs[2] =
+        {smWs.svAsm->config(), smWs.localSvAsm->config()};
+    for (const StateVector::Config& svConfig : svConfigs)
+    {
+        for (const StateVector::ElementConfig* elem = svConfig.elems;
+             elem->name != nullptr;
+             ++elem)
+        {
+            ws.elems.push_back(elem->elem);
+        }
+    }
+
+    // Load local element initial values.
+    U32 localSize = 0;
+    if (!AssemblyImage::get(r, localSize)
+        || (localSize > static_cast<U64>(r.end - r.pos)))
+    {
+        return E_IMG_FORMAT;
+    }
+    const StateVector::Config& localSvConfig = svConfigs[1];
+    SF_SAFE_ASSERT(localSvConfig.regions != nullptr);
+    SF_SAFE_ASSERT(localSvConfig.regions[0].region != nullptr);
+    if (localSvConfig.regions[0].region->write(r.pos, localSize) != SUCCESS)
+    {
+        return E_IMG_REF;
+    }
+    r.pos += localSize;
+
+    // Load symbol tables if present.
+    U8 hasSymbols = 0;
+    if (!AssemblyImage::get(r, hasSymbols))
+    {
+        return E_IMG_FORMAT;
+    }
+
+    if (hasSymbols != 0)
+    {
+        U32 cnt = 0;
+        if (!AssemblyImage::getCount(r, cnt))
+        {
+            return E_IMG_FORMAT;
+        }
+
+        for (U32 i = 0; i < cnt; ++i)
+        {
+            String name;
+            U32 id = 0;
+            if (!AssemblyImage::getString(r, name)
+                || !AssemblyImage::get(r, id))
+            {
+                return E_IMG_FORMAT;
+            }
+
+            if (id >= ws.elems.size())
+            {
+                return E_IMG_REF;
+            }
+            smWs.elems[name] = ws.elems[id];
+        }
+
+        if (!AssemblyImage::getCount(r, cnt))
+        {
+            return E_IMG_FORMAT;
+        }
+
+        for (U32 i = 0; i < cnt; ++i)
+        {
+            String name;
+            U32 id = 0;
+            if (!AssemblyImage::getString(r, name)
+                || !AssemblyImage::get(r, id))
+            {
+                return E_IMG_FORMAT;
+            }
+            smWs.stateIds[name] = id;
+        }
+
+        if (!AssemblyImage::getCount(r, cnt))
+        {
+            return E_IMG_FORMAT;
+        }
+
+        for (U32 i = 0; i < cnt; ++i)
+        {
+            String name;
+            if (!AssemblyImage::getString(r, name))
+            {
+                return E_IMG_FORMAT;
+            }
+            smWs.readOnlyElems.insert(name);
+        }
+
+        smWs.raked = false;
+    }
+
+    // Load stats. Each stats may only use stats loaded before it.
+    U32 statsCnt = 0;
+    if (!AssemblyImage::getCount(r, statsCnt))
+    {
+        return E_IMG_FORMAT;
+    }
+
+    for (U32 i = 0; i < statsCnt; ++i)
+    {
+        U32 windowSize = 0;
+        if (!AssemblyImage::get(r, windowSize))
+        {
+            return E_IMG_FORMAT;
+        }
+
+        if ((windowSize == 0) || (windowSize > LangConst::rollWindowMaxSize))
+        {
+            return E_IMG_REF;
+        }
+
+        ExpressionVm* vm = nullptr;
+        res = AssemblyImage::readBytecode(r, ws, vm);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        // Stats are calculated in F64.
+        if (vm->resultType() != ElementType::FLOAT64)
+        {
+            return E_IMG_REF;
+        }
+
+        BytecodeExprNode<F64>* const node =
+            arena.create<BytecodeExprNode<F64>>(*vm, nullptr);
+        ws.stats.push_back(arena.create<ExpressionStats<F64>>(
+            *node,
+            arena.createArray<F64>(windowSize),
+            arena.createArray<U32>(4 * windowSize),
+            windowSize));
+    }
+
+    // Load expressions.
+    U32 exprCnt = 0;
+    if (!AssemblyImage::getCount(r, exprCnt))
+    {
+        return E_IMG_FORMAT;
+    }
+
+    for (U32 i = 0; i < exprCnt; ++i)
+    {
+        U8 type = 0;
+        if (!AssemblyImage::get(r, type))
+        {
+            return E_IMG_FORMAT;
+        }
+
+        ExpressionVm* vm = nullptr;
+        res = AssemblyImage::readBytecode(r, ws, vm);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        IExpression* const node =
+            makeBytecodeNode(arena, static_cast<ElementType>(type), *vm);
+        if (node == nullptr)
+        {
+            return E_IMG_REF;
+        }
+        ws.exprs.push_back(node);
+    }
+
+    // Load actions.
+    U32 actionCnt = 0;
+    if (!AssemblyImage::getCount(r, actionCnt))
+    {
+        return E_IMG_FORMAT;
+    }
+
+    for (U32 i = 0; i < actionCnt; ++i)
+    {
+        U32 destState = StateMachine::NO_STATE;
+        if (!AssemblyImage::get(r, destState))
+        {
+            return E_IMG_FORMAT;
+        }
+
+        if (destState != StateMachine::NO_STATE)
+        {
+            ws.actions.push_back(arena.create<TransitionAction>(destState));
+            continue;
+        }
+
+        U32 elemId = 0;
+        U32 exprId = 0;
+        if (!AssemblyImage::get(r, elemId) || !AssemblyImage::get(r, exprId))
+        {
+            return E_IMG_FORMAT;
+        }
+
+        if ((elemId >= ws.elems.size())
+            || (exprId >= ws.exprs.size())
+            || (ws.elems[elemId]->type() != ws.exprs[exprId]->type()))
+        {
+            return E_IMG_REF;
+        }
+
+        IAction* const action =
+            makeAssignmentAction(arena, *ws.elems[elemId], *ws.exprs[exprId]);
+        SF_SAFE_ASSERT(action != nullptr);
+        ws.actions.push_back(action);
+    }
+
+    // Load states.
+    U32 stateCnt = 0;
+    if (!AssemblyImage::getCount(r, stateCnt))
+    {
+        return E_IMG_FORMAT;
+    }
+
+    smWs.stateConfigs.reset(new Vec<StateMachine::StateConfig>());
+    for (U32 i = 0; i < stateCnt; ++i)
+    {
+        StateMachine::StateConfig state = {StateMachine::NO_STATE,
+                                           nullptr,
+                                           nullptr,
+                                           nullptr};
+        if (!AssemblyImage::get(r, state.id))
+        {
+            return E_IMG_FORMAT;
+        }
+
+        res = AssemblyImage::readLabel(r, ws, state.entry);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        res = AssemblyImage::readLabel(r, ws, state.step);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        res = AssemblyImage::readLabel(r, ws, state.exit);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        smWs.stateConfigs->push_back(state);
+    }
+    smWs.stateConfigs->push_back({StateMachine::NO_STATE,
+                                  nullptr,
+                                  nullptr,
+                                  nullptr});
+
+    // Load the stats updated by the state machine and their dependencies.
+    U32 statsDepCnt = 0;
+    if (!AssemblyImage::getCount(r, statsDepCnt))
+    {
+        return E_IMG_FORMAT;
+    }
+
+    smWs.exprStatArr.reset(new Vec<IExpressionStats*>());
+    smWs.statsDeps.reset(new Vec<StateMachine::StatsDeps>());
+    for (U32 i = 0; i < statsDepCnt; ++i)
+    {
+        U32 id = 0;
+        U8 sampleInactive = 0;
+        U32 depStateCnt = 0;
+        if (!AssemblyImage::get(r, id)
+            || !AssemblyImage::get(r, sampleInactive)
+            || !AssemblyImage::get(r, depStateCnt))
+        {
+            return E_IMG_FORMAT;
+        }
+
+        if (id >= ws.stats.size())
+        {
+            return E_IMG_REF;
+        }
+
+        U32* states = nullptr;
+        if (depStateCnt != gAllStates)
+        {
+            if (depStateCnt > static_cast<U64>(r.end - r.pos))
+            {
+                return E_IMG_FORMAT;
+            }
+
+            states = arena.createArray<U32>(depStateCnt + 1);
+            for (U32 j = 0; j < depStateCnt; ++j)
+            {
+                if (!AssemblyImage::get(r, states[j]))
+                {
+                    return E_IMG_FORMAT;
+                }
+            }
+            states[depStateCnt] = StateMachine::NO_STATE;
+        }
+
+        smWs.exprStatArr->push_back(ws.stats[id]);
+        smWs.statsDeps->push_back({states, (sampleInactive != 0)});
+    }
+    smWs.exprStatArr->push_back(nullptr);
+
+    // Load the built-in state machine elements and the initial state.
+    U32 builtinIds[3] = {0, 0, 0};
+    U32 initState = StateMachine::NO_STATE;
+    if (!AssemblyImage::get(r, builtinIds[0])
+        || !AssemblyImage::get(r, builtinIds[1])
+        || !AssemblyImage::get(r, builtinIds[2])
+        || !AssemblyImage::get(r, initState)
+        || (r.pos != r.end))
+    {
+        return E_IMG_FORMAT;
+    }
+
+    const ElementType builtinTypes[3] =
+        {ElementType::UINT32, ElementType::UINT64, ElementType::UINT64};
+    for (U32 i = 0; i < 3; ++i)
+    {
+        if ((builtinIds[i] >= ws.elems.size())
+            || (ws.elems[builtinIds[i]]->type() != builtinTypes[i]))
+        {
+            return E_IMG_REF;
+        }
+    }
+
+    smWs.smConfig =
+    {
+        static_cast<Element<U32>*>(ws.elems[builtinIds[0]]),
+        static_cast<Element<U64>*>(ws.elems[builtinIds[1]]),
+        static_cast<Element<U64>*>(ws.elems[builtinIds[2]]),
+        smWs.stateConfigs->data(),
+        smWs.exprStatArr->data(),
+        smWs.statsDeps->data()
+    };
+
+    // Create the state machine. Initialization validates the labels and
+    // transitions loaded from the image.
+    smWs.smConfig.elemState->write(initState);
+    smWs.sm.reset(new StateMachine());
+    res = StateMachine::init(smWs.smConfig, *smWs.sm);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    // If the rake option was specified, clear the symbol tables.
+    if (kRake)
+    {
+        smWs.elems.clear();
+        smWs.stateIds.clear();
+        smWs.readOnlyElems.clear();
+        smWs.raked = true;
+    }
+
+    // Create the final assemblies.
+    kSvAsm = smWs.svAsm;
+    kSmAsm.reset(new StateMachineAssembly(smWs));
+
+    return SUCCESS;
+}
+
+Result AssemblyImage::load(const String kFilePath,
+                           Ref<const StateVectorAssembly>& kSvAsm)
+{
+    // Map the image and load it in place.
+    MappedFile file;
+    const Result res = MappedFile::init(kFilePath, file);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    return AssemblyImage::load(file.data(), file.size(), kSvAsm);
+}
+
+Result AssemblyImage::load(const void* const kBuf,
+                           const U64 kSize,
+                           Ref<const StateVectorAssembly>& kSvAsm)
+{
+    AssemblyImage::Reader r = {static_cast<const U8*>(kBuf),
+                               (static_cast<const U8*>(kBuf) + kSize)};
+
+    // Check the header and verify the body against the checksum.
+    Result res = AssemblyImage::readHeader(r, AssemblyImage::SV_MAGIC);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    // Compile the state vector layout, which is the entire body.
+    Ref<const StateVectorAssembly> svAsm;
+    res = AssemblyImage::readStateVector(r, svAsm);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    if (r.pos != r.end)
+    {
+        return E_IMG_FORMAT;
+    }
+
+    kSvAsm = svAsm;
+
+    return SUCCESS;
+}
+
+U64 AssemblyImage::checksum(const void* const kBuf,
+                            const U64 kSize,
+                            const U64 kSeed)
+{
+    const U8* const buf = static_cast<const U8*>(kBuf);
+    U64 hash = kSeed;
+    for (U64 i = 0; i < kSize; ++i)
+    {
+        hash ^= buf[i];
+        hash *= 0x100000001B3;
+    }
+
+    return hash;
+}
+
+/////////////////////////////////// Private ////////////////////////////////////
+
+void AssemblyImage::writeImage(std::ostream& kOs,
+                               const U32 kMagic,
+                               const String& kBody)
+{
+    String header;
+    put<U32>(header, kMagic);
+    put<U32>(header, AssemblyImage::VERSION);
+    put<U64>(header, kBody.size());
+    put<U64>(header, AssemblyImage::checksum(kBody.data(), kBody.size()));
+    kOs.write(header.data(), header.size());
+    kOs.write(kBody.data(), kBody.size());
+}
+
+Result AssemblyImage::readHeader(AssemblyImage::Reader& kReader,
+                                 const U32 kMagic)
+{
+    U32 magic = 0;
+    U32 version = 0;
+    U64 bodySize = 0;
+    U64 bodyChecksum = 0;
+    if ((kReader.pos == nullptr)
+        || !AssemblyImage::get(kReader, magic)
+        || !AssemblyImage::get(kReader, version)
+        || !AssemblyImage::get(kReader, bodySize)
+        || !AssemblyImage::get(kReader, bodyChecksum)
+        || (magic != kMagic)
+        || (version != AssemblyImage::VERSION)
+        || (bodySize != static_cast<U64>(kReader.end - kReader.pos)))
+    {
+        return E_IMG_FORMAT;
+    }
+
+    if (AssemblyImage::checksum(kReader.pos, bodySize) != bodyChecksum)
+    {
+        return E_IMG_CHECKSUM;
+    }
+
+    return SUCCESS;
+}
+
+template<typename T>
+bool AssemblyImage::get(AssemblyImage::Reader& kReader, T& kVal)
+{
+    if (static_cast<U64>(kReader.end - kReader.pos) < sizeof(T))
+    {
+        return false;
+    }
+
+    std::memcpy(&kVal, kReader.pos, sizeof(T));
+    kReader.pos += sizeof(T);
+    return true;
+}
+
+bool AssemblyImage::getString(AssemblyImage::Reader& kReader, String& kStr)
+{
+    U32 size = 0;
+    if (!AssemblyImage::getCount(kReader, size))
+    {
+        return false;
+    }
+
+    kStr.assign(reinterpret_cast<const char*>(kReader.pos), size);
+    kReader.pos += size;
+    return true;
+}
+
+bool AssemblyImage::getCount(AssemblyImage::Reader& kReader, U32& kCnt)
+{
+    return (AssemblyImage::get(kReader, kCnt)
+            && (kCnt <= static_cast<U64>(kReader.end - kReader.pos)));
+}
+
+void AssemblyImage::writeStateVector(const StateVectorParse& kParse,
+                                     String& kBuf)
+{
+    put<U8>(kBuf, kParse.opts.lock);
+    put<U8>(kBuf, kParse.opts.seqLock);
+    put<U8>(kBuf, kParse.opts.regionLocks);
+    put<U8>(kBuf, kParse.opts.adaptiveLock);
+
+    put<U32>(kBuf, kParse.regions.size());
+    for (const StateVectorParse::RegionParse& region : kParse.regions)
+    {
+        putString(kBuf, region.tokName.str);
+        putString(kBuf, region.plainName);
+        putString(kBuf, region.tokLockGroup.str);
+        put<U32>(kBuf, region.elems.size());
+        for (const StateVectorParse::ElementParse& elem : region.elems)
+        {
+            SF_ASSERT(elem.tokType.typeInfo != nullptr);
+            put<U8>(kBuf, elem.tokType.typeInfo->enumVal);
+            putString(kBuf, elem.tokName.str);
+            put<U8>(kBuf, elem.atomic);
+        }
+    }
+}
+
+Result AssemblyImage::lower(const IExpression* const kNode,
+                            Vec<ExpressionVm::Instruction>& kInstrs,
+                            AssemblyImage::WriteWorkspace& kWs)
+{
+    SF_SAFE_ASSERT(kNode != nullptr);
+
+    ExpressionVm::Instruction instr = {};
+    switch (kNode->nodeType())
+    {
+        case IExpression::CONST:
+        {
+            // Constants are folded into the I64 or F64 domain.
+            const ConstExprNode<I64>* const nodeI64 =
+                dynamic_cast<const ConstExprNode<I64>*>(kNode);
+            const ConstExprNode<F64>* const nodeF64 =
+                dynamic_cast<const ConstExprNode<F64>*>(kNode);
+            if (nodeI64 != nullptr)
+            {
+                instr.op = ExpressionVm::PUSH_I;
+                instr.val.i64 = nodeI64->val();
+            }
+            else if (nodeF64 != nullptr)
+            {
+                instr.op = ExpressionVm::PUSH_F;
+                instr.val.f64 = nodeF64->val();
+            }
+            else
+            {
+                return E_IMG_EXPR;
+            }
+            break;
+        }
+
+        case IExpression::ELEMENT:
+        {
+            // Load opcodes have the same values as element types.
+            const IElementExprNode* const node =
+                dynamic_cast<const IElementExprNode*>(kNode);
+            SF_SAFE_ASSERT(node != nullptr);
+            auto idIt = kWs.elemIds.find(&node->elem());
+            SF_SAFE_ASSERT(idIt != kWs.elemIds.end());
+            instr.op = static_cast<ExpressionVm::Opcode>(node->elem().type());
+            instr.val.i64 = (*idIt).second;
+            break;
+        }
+
+        case IExpression::UNARY_OP:
+        {
+            const IOpExprNode* const node =
+                dynamic_cast<const IOpExprNode*>(kNode);
+            SF_SAFE_ASSERT(node != nullptr);
+            SF_SAFE_ASSERT(node->rhs() != nullptr);
+
+            // Element nodes are wrapped in a cast to the I64 or F64 domain,
+            // which the load instruction performs itself.
+            if (node->rhs()->nodeType() == IExpression::ELEMENT)
+            {
+                return AssemblyImage::lower(node->rhs(), kInstrs, kWs);
+            }
+
+            auto opIt = gUnaryOpcodes.find(node->op());
+            if (opIt == gUnaryOpcodes.end())
+            {
+                return E_IMG_EXPR;
+            }
+
+            const Result res = AssemblyImage::lower(node->rhs(), kInstrs, kWs);
+            if (res != SUCCESS)
+            {
+                return res;
+            }
+            instr.op = (*opIt).second;
+            break;
+        }
+
+        case IExpression::BIN_OP:
+        {
+            const IOpExprNode* const node =
+                dynamic_cast<const IOpExprNode*>(kNode);
+            SF_SAFE_ASSERT(node != nullptr);
+            auto opIt = gBinOpcodes.find(node->op());
+            if (opIt == gBinOpcodes.end())
+            {
+                return E_IMG_EXPR;
+            }
+
+            // Binary operators pop their LHS first, so the RHS is pushed
+            // first.
+            Result res = AssemblyImage::lower(node->rhs(), kInstrs, kWs);
+            if (res != SUCCESS)
+            {
+                return res;
+            }
+
+            res = AssemblyImage::lower(node->lhs(), kInstrs, kWs);
+            if (res != SUCCESS)
+            {
+                return res;
+            }
+            instr.op = (*opIt).second;
+            break;
+        }
+
+        case IExpression::ROLL_AVG:
+        case IExpression::ROLL_MEDIAN:
+        case IExpression::ROLL_MIN:
+        case IExpression::ROLL_MAX:
+        case IExpression::ROLL_RANGE:
+        {
+            const IExprStatsNode* const node =
+                dynamic_cast<const IExprStatsNode*>(kNode);
+            SF_SAFE_ASSERT(node != nullptr);
+            U32 id = 0;
+            const Result res = AssemblyImage::statsId(node->stats(), kWs, id);
+            if (res != SUCCESS)
+            {
+                return res;
+            }
+
+            // Stats node types and stats opcodes are in the same order.
+            instr.op = static_cast<ExpressionVm::Opcode>(
+                ExpressionVm::ROLL_AVG
+                + (kNode->nodeType() - IExpression::ROLL_AVG));
+            instr.val.i64 = id;
+            break;
+        }
+
+        default:
+            return E_IMG_EXPR;
+    }
+
+    kInstrs.push_back(instr);
+    return SUCCESS;
+}
+
+Result AssemblyImage::statsId(const IExpressionStats& kStats,
+                              AssemblyImage::WriteWorkspace& kWs,
+                              U32& kId)
+{
+    auto idIt = kWs.statsIds.find(&kStats);
+    if (idIt != kWs.statsIds.end())
+    {
+        kId = (*idIt).second;
+        return SUCCESS;
+    }
+
+    // Stats are calculated in F64.
+    if (kStats.expr().type() != ElementType::FLOAT64)
+    {
+        return E_IMG_EXPR;
+    }
+
+    // Lower the stats expression. This adds any stats it uses first, so that
+    // the loader creates stats after the stats they depend on.
+    Vec<ExpressionVm::Instruction> instrs;
+    const Result res = AssemblyImage::lower(&kStats.expr(), instrs, kWs);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    put<U32>(kWs.stats, kStats.size());
+    putInstrs(kWs.stats, instrs);
+    kId = kWs.statsIds.size();
+    kWs.statsIds[&kStats] = kId;
+
+    return SUCCESS;
+}
+
+Result AssemblyImage::exprId(const IExpression* const kRoot,
+                             AssemblyImage::WriteWorkspace& kWs,
+                             U32& kId)
+{
+    SF_SAFE_ASSERT(kRoot != nullptr);
+
+    auto idIt = kWs.exprIds.find(kRoot);
+    if (idIt != kWs.exprIds.end())
+    {
+        kId = (*idIt).second;
+        return SUCCESS;
+    }
+
+    // Expressions compiled to bytecode are lowered again from their tree so
+    // that stats and element references can be numbered.
+    const IExpression* node = kRoot;
+    if (node->nodeType() == IExpression::BYTECODE)
+    {
+        const IBytecodeExprNode* const bcNode =
+            dynamic_cast<const IBytecodeExprNode*>(node);
+        SF_SAFE_ASSERT(bcNode != nullptr);
+        node = bcNode->src();
+        if (node == nullptr)
+        {
+            return E_IMG_EXPR;
+        }
+    }
+
+    // The root node casts the expression from the domain it was evaluated in
+    // to its evaluation type. The loaded bytecode node performs the same cast,
+    // so only the operand of the cast is lowered.
+    const IOpExprNode* const castNode = dynamic_cast<const IOpExprNode*>(node);
+    if ((node->nodeType() != IExpression::UNARY_OP) || (castNode == nullptr))
+    {
+        return E_IMG_EXPR;
+    }
+
+    Vec<ExpressionVm::Instruction> instrs;
+    const Result res = AssemblyImage::lower(castNode->rhs(), instrs, kWs);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    put<U8>(kWs.exprs, kRoot->type());
+    putInstrs(kWs.exprs, instrs);
+    kId = kWs.exprIds.size();
+    kWs.exprIds[kRoot] = kId;
+
+    return SUCCESS;
+}
+
+Result AssemblyImage::actionId(const IAction* const kAction,
+                               AssemblyImage::WriteWorkspace& kWs,
+                               U32& kId)
+{
+    SF_SAFE_ASSERT(kAction != nullptr);
+
+    auto idIt = kWs.actionIds.find(kAction);
+    if (idIt != kWs.actionIds.end())
+    {
+        kId = (*idIt).second;
+        return SUCCESS;
+    }
+
+    // Transition actions are identified by their destination state, and
+    // assignment actions have no destination state.
+    put<U32>(kWs.actions, kAction->destState);
+    if (kAction->destState == StateMachine::NO_STATE)
+    {
+        const IAssignmentAction* const asgAction =
+            dynamic_cast<const IAssignmentAction*>(kAction);
+        SF_SAFE_ASSERT(asgAction != nullptr);
+        auto elemIdIt = kWs.elemIds.find(&asgAction->elem());
+        SF_SAFE_ASSERT(elemIdIt != kWs.elemIds.end());
+
+        // Number the RHS expression before writing the rest of the action,
+        // since this may write to the action section.
+        U32 exprId = 0;
+        const Result res =
+            AssemblyImage::exprId(&asgAction->expr(), kWs, exprId);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        put<U32>(kWs.actions, (*elemIdIt).second);
+        put<U32>(kWs.actions, exprId);
+    }
+
+    kId = kWs.actionIds.size();
+    kWs.actionIds[kAction] = kId;
+
+    return SUCCESS;
+}
+
+Result AssemblyImage::writeLabel(const StateMachine::Instruction* const kLabel,
+                                 AssemblyImage::WriteWorkspace& kWs,
+                                 String& kBuf)
+{
+    put<U8>(kBuf, ((kLabel != nullptr) ? 1 : 0));
+    if (kLabel == nullptr)
+    {
+        return SUCCESS;
+    }
+
+    U32 instrCnt = 0;
+    while (kLabel[instrCnt].op != StateMachine::Instruction::END)
+    {
+        ++instrCnt;
+    }
+
+    // Guards and actions are written as expression and action indices.
+    put<U32>(kBuf, instrCnt);
+    for (U32 i = 0; i < instrCnt; ++i)
+    {
+        const StateMachine::Instruction& instr = kLabel[i];
+        U32 id = 0;
+        Result res = SUCCESS;
+        if (instr.op == StateMachine::Instruction::GUARD)
+        {
+            res = AssemblyImage::exprId(instr.guard, kWs, id);
+        }
+        else if (instr.op == StateMachine::Instruction::ACTION)
+        {
+            res = AssemblyImage::actionId(instr.action, kWs, id);
+        }
+
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        put<U8>(kBuf, instr.op);
+        put<U32>(kBuf, instr.offset);
+        put<U32>(kBuf, id);
+    }
+
+    return SUCCESS;
+}
+
+Result AssemblyImage::readStateVector(AssemblyImage::Reader& kReader,
+                                      Ref<const StateVectorAssembly>& kAsm)
+{
+    // Load options.
+    U8 opts[4] = {0, 0, 0, 0};
+    for (U8& opt : opts)
+    {
+        if (!AssemblyImage::get(kReader, opt))
+        {
+            return E_IMG_FORMAT;
+        }
+    }
+
+    // Load regions and elements into a parse.
+    U32 regionCnt = 0;
+    if (!AssemblyImage::getCount(kReader, regionCnt))
+    {
+        return E_IMG_FORMAT;
+    }
+
+    Vec<StateVectorParse::RegionParse> regions(regionCnt);
+    for (StateVectorParse::RegionParse& region : regions)
+    {
+        String sectionName;
+        String lockGroup;
+        U32 elemCnt = 0;
+        if (!AssemblyImage::getString(kReader, sectionName)
+            || !AssemblyImage::getString(kReader, region.plainName)
+            || !AssemblyImage::getString(kReader, lockGroup)
+            || !AssemblyImage::getCount(kReader, elemCnt))
+        {
+            return E_IMG_FORMAT;
+        }
+
+        region.tokName = makeToken(Token::SECTION, sectionName);
+        region.tokLockGroup = makeToken(Token::IDENTIFIER, lockGroup);
+        region.elems.resize(elemCnt);
+        for (StateVectorParse::ElementParse& elem : region.elems)
+        {
+            U8 type = 0;
+            String name;
+            U8 atomic = 0;
+            if (!AssemblyImage::get(kReader, type)
+                || !AssemblyImage::getString(kReader, name)
+                || !AssemblyImage::get(kReader, atomic))
+            {
+                return E_IMG_FORMAT;
+            }
+
+            auto typeInfoIt =
+                TypeInfo::fromEnum.find(static_cast<ElementType>(type));
+            if (typeInfoIt == TypeInfo::fromEnum.end())
+            {
+                return E_IMG_REF;
+            }
+
+            elem.tokType = makeToken(Token::IDENTIFIER,
+                                     (*typeInfoIt).second.name);
+            elem.tokType.typeInfo = &(*typeInfoIt).second;
+            elem.tokName = makeToken(Token::IDENTIFIER, name);
+            elem.atomic = (atomic != 0);
+        }
+    }
+
+    // Compile the state vector. The layout was validated when the image was
+    // written, so this only fails on a corrupt image that passed the checksum.
+    const StateVectorParse::Options parseOpts =
+        {(opts[0] != 0), (opts[1] != 0), (opts[2] != 0), (opts[3] != 0)};
+    const Ref<const StateVectorParse> parse(
+        new StateVectorParse(regions, parseOpts));
+    return StateVectorCompiler::compile(parse, kAsm, nullptr);
+}
+
+Result AssemblyImage::readBytecode(AssemblyImage::Reader& kReader,
+                                   AssemblyImage::LoadWorkspace& kWs,
+                                   ExpressionVm*& kVm)
+{
+    U32 instrCnt = 0;
+    if (!AssemblyImage::getCount(kReader, instrCnt))
+    {
+        return E_IMG_FORMAT;
+    }
+
+    // Load instructions and relocate element and stats indices to pointers.
+    Arena& arena = *kWs.smWs.arena;
+    ExpressionVm::Instruction* const instrs =
+        arena.createArray<ExpressionVm::Instruction>(instrCnt);
+    for (U32 i = 0; i < instrCnt; ++i)
+    {
+        U8 op = 0;
+        ExpressionVm::Value val = {};
+        if (!AssemblyImage::get(kReader, op)
+            || !AssemblyImage::get(kReader, val))
+        {
+            return E_IMG_FORMAT;
+        }
+
+        ExpressionVm::Instruction& instr = instrs[i];
+        instr.op = static_cast<ExpressionVm::Opcode>(op);
+        if ((op >= ExpressionVm::LOAD_I8) && (op <= ExpressionVm::LOAD_BOOL))
+        {
+            if ((val.i64 < 0)
+                || (static_cast<U64>(val.i64) >= kWs.elems.size()))
+            {
+                return E_IMG_REF;
+            }
+            instr.elem = kWs.elems[val.i64];
+        }
+        else if ((op >= ExpressionVm::ROLL_AVG)
+                 && (op <= ExpressionVm::ROLL_RANGE))
+        {
+            if ((val.i64 < 0)
+                || (static_cast<U64>(val.i64) >= kWs.stats.size()))
+            {
+                return E_IMG_REF;
+            }
+            instr.stats = kWs.stats[val.i64];
+        }
+        else
+        {
+            instr.val = val;
+        }
+    }
+
+    // Create the VM, which type-checks the program. Each instruction pushes
+    // at most one value, so a stack with one slot per instruction never
+    // overflows.
+    kVm = arena.create<ExpressionVm>();
+    const ExpressionVm::Config vmConfig =
+    {
+        instrs,
+        instrCnt,
+        arena.createArray<ExpressionVm::Value>(instrCnt),
+        instrCnt
+    };
+    if (ExpressionVm::init(vmConfig, *kVm) != SUCCESS)
+    {
+        return E_IMG_REF;
+    }
+
+    return SUCCESS;
+}
+
+Result AssemblyImage::readLabel(AssemblyImage::Reader& kReader,
+                                AssemblyImage::LoadWorkspace& kWs,
+                                StateMachine::Instruction*& kLabel)
+{
+    U8 hasLabel = 0;
+    if (!AssemblyImage::get(kReader, hasLabel))
+    {
+        return E_IMG_FORMAT;
+    }
+
+    if (hasLabel == 0)
+    {
+        kLabel = nullptr;
+        return SUCCESS;
+    }
+
+    U32 instrCnt = 0;
+    if (!AssemblyImage::getCount(kReader, instrCnt))
+    {
+        return E_IMG_FORMAT;
+    }
+
+    // The label array is value-initialized, so its last instruction is END.
+    StateMachine::Instruction* const label =
+        kWs.smWs.arena->createArray<StateMachine::Instruction>(instrCnt + 1);
+    for (U32 i = 0; i < instrCnt; ++i)
+    {
+        U8 op = 0;
+        U32 id = 0;
+        StateMachine::Instruction& instr = label[i];
+        if (!AssemblyImage::get(kReader, op)
+            || !AssemblyImage::get(kReader, instr.offset)
+            || !AssemblyImage::get(kReader, id))
+        {
+            return E_IMG_FORMAT;
+        }
+
+        // Jump offsets are checked by StateMachine::init().
+        instr.op = static_cast<StateMachine::Instruction::Opcode>(op);
+        switch (instr.op)
+        {
+            case StateMachine::Instruction::GUARD:
+                if ((id >= kWs.exprs.size())
+                    || (kWs.exprs[id]->type() != ElementType::BOOL))
+                {
+                    return E_IMG_REF;
+                }
+                instr.guard = dynamic_cast<IExprNode<bool>*>(kWs.exprs[id]);
+                break;
+
+            case StateMachine::Instruction::JUMP:
+                break;
+
+            case StateMachine::Instruction::ACTION:
+                if (id >= kWs.actions.size())
+                {
+                    return E_IMG_REF;
+                }
+                instr.action = kWs.actions[id];
+                break;
+
+            default:
+                return E_IMG_REF;
+        }
+    }
+
+    kLabel = label;
+    return SUCCESS;
+}
+
+} // namespace Sf
@@ -0,0 +1,394 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/config/AssemblyImage.hpp
+/// @brief Binary images of compiled state machines.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_ASSEMBLY_IMAGE_HPP
+#define SF_ASSEMBLY_IMAGE_HPP
+
+#include <ostream>
+
+#include "sf/config/StateMachineCompiler.hpp"
+
+namespace Sf
+{
+
+///
+/// @brief Writes and loads binary images of compiled state machines. An image
+/// is a flat record of everything needed to reconstruct a state machine and
+/// its state vector: the state vector layout, local element initial values,
+/// state labels, actions, and every expression lowered to ExpressionVm
+/// bytecode. Loading an image skips tokenizing, parsing and compiling config
+/// files, so it takes a small fraction of the time of compiling them. Images
+/// of a state vector alone record only its layout.
+///
+/// @remark Images refer to elements, expressions, stats and actions by index.
+/// The loader relocates the indices to objects it allocates in the arena of
+/// the loaded assembly. Loaded expressions always use the bytecode backend,
+/// and each bytecode program is checked by ExpressionVm::init() on load.
+///
+/// @remark An image records the current values of the state machine's state
+/// and local elements as their initial values, so it should be written from a
+/// freshly compiled assembly. Stats windows are not recorded and start empty.
+///
+/// @warning Images are a cache format, not an interchange format. They are
+/// written in host byte order and are only loadable by the framework version
+/// that wrote them.
+///
+class AssemblyImage final
+{
+public:
+
+    ///
+    /// @brief Magic number at the start of every image.
+    ///
+    static constexpr U32 MAGIC = 0x4D494653;
+
+    ///
+    /// @brief Magic number at the start of every state vector image.
+    ///
+    static constexpr U32 SV_MAGIC = 0x56494653;
+
+    ///
+    /// @brief Image format version. This is incremented when the format
+    /// changes, and images of other versions fail to load.
+    ///
+    static constexpr U32 VERSION = 1;
+
+    ///
+    /// @brief Initial hash of AssemblyImage::checksum().
+    ///
+    static constexpr U64 CHECKSUM_SEED = 0xCBF29CE484222325;
+
+    ///
+    /// @brief Writes an image of a state machine and its state vector.
+    ///
+    /// @param[in] kOs     Image output stream. This should be opened in binary
+    ///                    mode.
+    /// @param[in] kSmAsm  State machine to write.
+    ///
+    /// @retval SUCCESS     Successfully wrote image.
+    /// @retval E_IMG_NULL  kSmAsm is null.
+    /// @retval E_IMG_EXPR  An expression contains a node that cannot be
+    ///                     lowered to bytecode.
+    ///
+    static Result write(std::ostream& kOs,
+                        const Ref<const StateMachineAssembly> kSmAsm);
+
+    ///
+    /// @brief Writes an image of a state vector.
+    ///
+    /// @param[in] kOs     Image output stream. This should be opened in binary
+    ///                    mode.
+    /// @param[in] kSvAsm  State vector to write.
+    ///
+    /// @retval SUCCESS     Successfully wrote image.
+    /// @retval E_IMG_NULL  kSvAsm is null.
+    ///
+    static Result write(std::ostream& kOs,
+                        const Ref<const StateVectorAssembly> kSvAsm);
+
+    ///
+    /// @brief Loads an image from a file. The file is mapped into memory and
+    /// read in place.
+    ///
+    /// @param[in]  kFilePath  Path to image file.
+    /// @param[out] kSvAsm     On success, points to loaded state vector.
+    /// @param[out] kSmAsm     On success, points to loaded state machine.
+    /// @param[in]  kRake      If the loaded state machine should be raked. See
+    ///                        StateMachineCompiler::compile(). Images written
+    ///                        from raked state machines always load raked.
+    ///
+    /// @retval SUCCESS         Successfully loaded image.
+    /// @retval E_MAP_OPEN      Failed to open image file.
+    /// @retval E_MAP_MAP       Failed to map image file.
+    /// @retval E_IMG_FORMAT    Image is truncated or malformed, or has the
+    ///                         wrong magic number or version.
+    /// @retval E_IMG_CHECKSUM  Image contents do not match the checksum.
+    /// @retval E_IMG_REF       Image contains an invalid reference or type.
+    /// @retval [other]         Image failed validation by the state vector
+    ///                         compiler or the state machine.
+    ///
+    static Result load(const String kFilePath,
+                       Ref<const StateVectorAssembly>& kSvAsm,
+                       Ref<const StateMachineAssembly>& kSmAsm,
+                       const bool kRake = true);
+
+    ///
+    /// @brief Loads an image from a buffer.
+    ///
+    /// @see AssemblyImage::load(String, ...)
+    ///
+    /// @param[in] kBuf   Image buffer. Need not be aligned.
+    /// @param[in] kSize  Image size in bytes.
+    ///
+    static Result load(const void* const kBuf,
+                       const U64 kSize,
+                       Ref<const StateVectorAssembly>& kSvAsm,
+                       Ref<const StateMachineAssembly>& kSmAsm,
+                       const bool kRake = true);
+
+    ///
+    /// @brief Loads a state vector image from a file.
+    ///
+    /// @see AssemblyImage::load(String, ...)
+    ///
+    static Result load(const String kFilePath,
+                       Ref<const StateVectorAssembly>& kSvAsm);
+
+    ///
+    /// @brief Loads a state vector image from a buffer.
+    ///
+    /// @see AssemblyImage::load(const void*, ...)
+    ///
+    static Result load(const void* const kBuf,
+                       const U64 kSize,
+                       Ref<const StateVectorAssembly>& kSvAsm);
+
+    ///
+    /// @brief Computes the 64-bit FNV-1a hash that images are checksummed
+    /// with. Hashing a buffer with the hash of the preceding buffer as the
+    /// seed gives the hash of the buffers concatenated.
+    ///
+    /// @param[in] kBuf   Buffer.
+    /// @param[in] kSize  Buffer size in bytes.
+    /// @param[in] kSeed  Initial hash.
+    ///
+    /// @returns Hash.
+    ///
+    static U64 checksum(const void* const kBuf,
+                        const U64 kSize,
+                        const U64 kSeed = CHECKSUM_SEED);
+
+    AssemblyImage() = delete;
+
+private:
+
+    ///
+    /// @brief Cursor into an image being loaded.
+    ///
+    struct Reader final
+    {
+        const U8* pos; ///< Next byte to read.
+        const U8* end; ///< End of image.
+    };
+
+    ///
+    /// @brief Intermediate data used in writing an image.
+    ///
+    struct WriteWorkspace final
+    {
+        Ref<const StateMachineAssembly> smAsm;       ///< State machine.
+        Map<const IElement*, U32> elemIds;           ///< Element indices.
+        Map<const IExpressionStats*, U32> statsIds;  ///< Stats indices.
+        Map<const IExpression*, U32> exprIds;        ///< Expression indices.
+        Map<const IAction*, U32> actionIds;          ///< Action indices.
+        String stats;                                ///< Stats section.
+        String exprs;                                ///< Expression section.
+        String actions;                              ///< Action section.
+    };
+
+    ///
+    /// @brief Intermediate data used in loading an image.
+    ///
+    struct LoadWorkspace final
+    {
+        StateMachineAssembly::Workspace smWs;  ///< Loaded state machine.
+        Vec<IElement*> elems;                  ///< Elements by index.
+        Vec<IExpressionStats*> stats;          ///< Stats by index.
+        Vec<IExpression*> exprs;               ///< Expressions by index.
+        Vec<IAction*> actions;                 ///< Actions by index.
+    };
+
+    ///
+    /// @brief Reads a value from an image.
+    ///
+    /// @tparam T  Value type.
+    ///
+    /// @param[in]  kReader  Image reader.
+    /// @param[out] kVal     On success, contains value.
+    ///
+    /// @returns Whether the value was read, i.e., the image was not truncated.
+    ///
+    template<typename T>
+    static bool get(AssemblyImage::Reader& kReader, T& kVal);
+
+    ///
+    /// @brief Reads a string from an image.
+    ///
+    /// @see AssemblyImage::get()
+    ///
+    static bool getString(AssemblyImage::Reader& kReader, String& kStr);
+
+    ///
+    /// @brief Reads a count of items from an image. Since every item occupies
+    /// at least one byte, counts larger than the rest of the image are
+    /// rejected before anything is allocated for them.
+    ///
+    /// @see AssemblyImage::get()
+    ///
+    static bool getCount(AssemblyImage::Reader& kReader, U32& kCnt);
+
+    ///
+    /// @brief Writes an image header followed by an image body.
+    ///
+    /// @param[in] kOs     Image output stream.
+    /// @param[in] kMagic  Image magic number.
+    /// @param[in] kBody   Image body.
+    ///
+    static void writeImage(std::ostream& kOs,
+                           const U32 kMagic,
+                           const String& kBody);
+
+    ///
+    /// @brief Reads an image header and verifies the image body against it.
+    ///
+    /// @param[in] kReader  Image reader positioned at the start of the image.
+    ///                     On success, positioned at the start of the body.
+    /// @param[in] kMagic   Expected magic number.
+    ///
+    /// @retval SUCCESS         Header is valid.
+    /// @retval E_IMG_FORMAT    Header is truncated or has the wrong magic
+    ///                         number, version or body size.
+    /// @retval E_IMG_CHECKSUM  Image body does not match the checksum.
+    ///
+    static Result readHeader(AssemblyImage::Reader& kReader, const U32 kMagic);
+
+    ///
+    /// @brief Writes a state vector layout.
+    ///
+    /// @param[in]  kParse  Parse of state vector.
+    /// @param[out] kBuf    Buffer to append to.
+    ///
+    static void writeStateVector(const StateVectorParse& kParse, String& kBuf);
+
+    ///
+    /// @brief Lowers an expression tree to bytecode. LOAD and ROLL operands
+    /// are element and stats indices rather than pointers.
+    ///
+    /// @param[in]  kNode    Expression root node.
+    /// @param[out] kInstrs  Vector to append instructions to.
+    /// @param[in]  kWs      Writer workspace.
+    ///
+    /// @returns See AssemblyImage::write().
+    ///
+    static Result lower(const IExpression* const kNode,
+                        Vec<ExpressionVm::Instruction>& kInstrs,
+                        AssemblyImage::WriteWorkspace& kWs);
+
+    ///
+    /// @brief Gets the index of a stats, adding it and any stats its
+    /// expression uses to the stats section if not already added.
+    ///
+    /// @param[in]  kStats  Stats.
+    /// @param[in]  kWs     Writer workspace.
+    /// @param[out] kId     On success, contains stats index.
+    ///
+    /// @returns See AssemblyImage::write().
+    ///
+    static Result statsId(const IExpressionStats& kStats,
+                          AssemblyImage::WriteWorkspace& kWs,
+                          U32& kId);
+
+    ///
+    /// @brief Gets the index of an expression, adding it to the expression
+    /// section if not already added.
+    ///
+    /// @param[in]  kRoot  Expression root node.
+    /// @param[in]  kWs    Writer workspace.
+    /// @param[out] kId    On success, contains expression index.
+    ///
+    /// @returns See AssemblyImage::write().
+    ///
+    static Result exprId(const IExpression* const kRoot,
+                         AssemblyImage::WriteWorkspace& kWs,
+                         U32& kId);
+
+    ///
+    /// @brief Gets the index of an action, adding it to the action section if
+    /// not already added.
+    ///
+    /// @param[in]  kAction  Action.
+    /// @param[in]  kWs      Writer workspace.
+    /// @param[out] kId      On success, contains action index.
+    ///
+    /// @returns See AssemblyImage::write().
+    ///
+    static Result actionId(const IAction* const kAction,
+                           AssemblyImage::WriteWorkspace& kWs,
+                           U32& kId);
+
+    ///
+    /// @brief Writes a label.
+    ///
+    /// @param[in]  kLabel  Label, or null if none.
+    /// @param[in]  kWs     Writer workspace.
+    /// @param[out] kBuf    Buffer to append to.
+    ///
+    /// @returns See AssemblyImage::write().
+    ///
+    static Result writeLabel(const StateMachine::Instruction* const kLabel,
+                             AssemblyImage::WriteWorkspace& kWs,
+                             String& kBuf);
+
+    ///
+    /// @brief Loads a state vector layout and compiles it.
+    ///
+    /// @param[in]  kReader  Image reader.
+    /// @param[out] kAsm     On success, points to compiled state vector.
+    ///
+    /// @returns See AssemblyImage::load().
+    ///
+    static Result readStateVector(AssemblyImage::Reader& kReader,
+                                  Ref<const StateVectorAssembly>& kAsm);
+
+    ///
+    /// @brief Loads a bytecode program, relocates its operands, and creates a
+    /// VM to run it. The program may reference any element and any stats
+    /// loaded so far.
+    ///
+    /// @param[in]  kReader  Image reader.
+    /// @param[in]  kWs      Loader workspace.
+    /// @param[out] kVm      On success, points to initialized VM.
+    ///
+    /// @returns See AssemblyImage::load().
+    ///
+    static Result readBytecode(AssemblyImage::Reader& kReader,
+                               AssemblyImage::LoadWorkspace& kWs,
+                               ExpressionVm*& kVm);
+
+    ///
+    /// @brief Loads a label.
+    ///
+    /// @param[in]  kReader  Image reader.
+    /// @param[in]  kWs      Loader workspace.
+    /// @param[out] kLabel   On success, points to END-terminated label, or is
+    ///                      null if the state has no such label.
+    ///
+    /// @returns See AssemblyImage::load().
+    ///
+    static Result readLabel(AssemblyImage::Reader& kReader,
+                            AssemblyImage::LoadWorkspace& kWs,
+                            StateMachine::Instruction*& kLabel);
+};
+
+} // namespace Sf
+
+#endif
@@ -0,0 +1,345 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifdef SF_PLATFORM_LINUX
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include "sf/config/AssemblyImage.hpp"
+#include "sf/config/CompileCache.hpp"
+#include "sf/config/MappedFile.hpp"
+#include "sf/config/StateVectorCompiler.hpp"
+
+namespace Sf
+{
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+const char* const CompileCache::NO_CACHE_OPT = "--no-cache";
+
+///
+/// @brief Version of the cache layout. This is incremented when the format of
+/// cached command results changes.
+///
+static constexpr U32 gCacheVersion = 1;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Hashes a value into a running hash.
+///
+/// @tparam T  Value type.
+///
+/// @param[in] kVal   Value.
+/// @param[in] kSeed  Running hash.
+///
+/// @returns New running hash.
+///
+template<typename T>
+static U64 hashValue(const T kVal, const U64 kSeed)
+{
+    return AssemblyImage::checksum(&kVal, sizeof(T), kSeed);
+}
+
+///
+/// @brief Hashes a buffer into a running hash. The buffer size is hashed
+/// first, so that adjacent buffers hash differently than their concatenation.
+///
+/// @param[in] kBuf   Buffer.
+/// @param[in] kSize  Buffer size in bytes.
+/// @param[in] kSeed  Running hash.
+///
+/// @returns New running hash.
+///
+static U64 hashBuffer(const void* const kBuf,
+                      const U64 kSize,
+                      const U64 kSeed)
+{
+    return AssemblyImage::checksum(kBuf, kSize, hashValue(kSize, kSeed));
+}
+
+#ifdef SF_PLATFORM_LINUX
+
+///
+/// @brief Gets the cache directory from the environment.
+///
+/// @returns Cache directory, or empty if none could be determined.
+///
+static String cacheDir()
+{
+    const char* const dir = std::getenv("SF_CACHE_DIR");
+    if ((dir != nullptr) && (*dir != '\0'))
+    {
+        return dir;
+    }
+
+    const char* const xdgDir = std::getenv("XDG_CACHE_HOME");
+    if ((xdgDir != nullptr) && (*xdgDir != '\0'))
+    {
+        return (String(xdgDir) + "/surefire");
+    }
+
+    const char* const homeDir = std::getenv("HOME");
+    if ((homeDir != nullptr) && (*homeDir != '\0'))
+    {
+        return (String(homeDir) + "/.cache/surefire");
+    }
+
+    return "";
+}
+
+///
+/// @brief Creates a directory and any missing parent directories.
+///
+/// @param[in] kPath  Directory path.
+///
+/// @returns Whether the directory exists.
+///
+static bool makeDirs(const String& kPath)
+{
+    for (std::size_t i = 1; i <= kPath.size(); ++i)
+    {
+        if ((i == kPath.size()) || (kPath[i] == '/'))
+        {
+            const String dir = kPath.substr(0, i);
+            if ((mkdir(dir.c_str(), 0755) != 0) && (errno != EEXIST))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+#endif
+
+/////////////////////////////////// Public /////////////////////////////////////
+
+CompileCache::CompileCache(Vec<String>& kArgs) :
+    mDir(), mSeed(AssemblyImage::CHECKSUM_SEED)
+{
+    // Remove the option that bypasses the cache.
+    bool bypass = false;
+    for (auto it = kArgs.begin(); it != kArgs.end();)
+    {
+        if (*it == NO_CACHE_OPT)
+        {
+            bypass = true;
+            it = kArgs.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (bypass)
+    {
+        return;
+    }
+
+#ifdef SF_PLATFORM_LINUX
+
+    // Create the cache directory. If this fails, the cache is bypassed.
+    mDir = cacheDir();
+    if (mDir.empty() || !makeDirs(mDir))
+    {
+        mDir.clear();
+        return;
+    }
+
+    // Seed keys with the formats of cache entries and the identity of the
+    // running executable.
+    mSeed = hashValue(gCacheVersion, mSeed);
+    mSeed = hashValue(AssemblyImage::VERSION, mSeed);
+    struct stat st;
+    if (stat("/proc/self/exe", &st) == 0)
+    {
+        mSeed = hashValue(static_cast<U64>(st.st_size), mSeed);
+        mSeed = hashValue(static_cast<I64>(st.st_mtime), mSeed);
+    }
+
+#endif
+}
+
+Result CompileCache::compileStateVector(
+    const String& kSvFile,
+    Ref<const StateVectorAssembly>& kSvAsm,
+    ErrorInfo* const kErr) const
+{
+    // Load the state vector if its config is unchanged.
+    String key;
+    const bool cacheable = this->key("sv", {kSvFile}, {}, key);
+    if (cacheable
+        && (AssemblyImage::load(this->path(key), kSvAsm) == SUCCESS))
+    {
+        return SUCCESS;
+    }
+
+    // Otherwise, compile and cache it.
+    const Result res = StateVectorCompiler::compile(kSvFile, kSvAsm, kErr);
+    if ((res == SUCCESS) && cacheable)
+    {
+        std::stringstream img;
+        if (AssemblyImage::write(img, kSvAsm) == SUCCESS)
+        {
+            this->write(key, img.str());
+        }
+    }
+
+    return res;
+}
+
+Result CompileCache::compileStateMachine(
+    const String& kSvFile,
+    const String& kSmFile,
+    Ref<const StateVectorAssembly>& kSvAsm,
+    Ref<const StateMachineAssembly>& kSmAsm,
+    ErrorInfo* const kErr,
+    const bool kRake) const
+{
+    // Load the state vector and state machine if their configs are unchanged.
+    String key;
+    const bool cacheable = this->key((kRake ? "sm" : "sm-unraked"),
+                                     {kSvFile, kSmFile},
+                                     {},
+                                     key);
+    if (cacheable
+        && (AssemblyImage::load(this->path(key), kSvAsm, kSmAsm, kRake)
+            == SUCCESS))
+    {
+        return SUCCESS;
+    }
+
+    // Otherwise, compile and cache them. The state machine is cached before
+    // it is used, since the image records its current element values.
+    Result res = this->compileStateVector(kSvFile, kSvAsm, kErr);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    res = StateMachineCompiler::compile(kSmFile,
+                                        kSvAsm,
+                                        kSmAsm,
+                                        kErr,
+                                        StateMachineCompiler::FIRST_STATE,
+                                        kRake);
+    if ((res == SUCCESS) && cacheable)
+    {
+        std::stringstream img;
+        if (AssemblyImage::write(img, kSmAsm) == SUCCESS)
+        {
+            this->write(key, img.str());
+        }
+    }
+
+    return res;
+}
+
+bool CompileCache::key(const String& kKind,
+                       const Vec<String>& kFiles,
+                       const Vec<String>& kStrs,
+                       String& kKey) const
+{
+    // Check that the cache is not bypassed.
+    if (mDir.empty())
+    {
+        return false;
+    }
+
+    // Hash the result kind, then the contents of each file, then each string.
+    U64 hash = hashBuffer(kKind.data(), kKind.size(), mSeed);
+    for (const String& filePath : kFiles)
+    {
+        MappedFile file;
+        if (MappedFile::init(filePath, file) != SUCCESS)
+        {
+            return false;
+        }
+        hash = hashBuffer(file.data(), file.size(), hash);
+    }
+
+    for (const String& str : kStrs)
+    {
+        hash = hashBuffer(str.data(), str.size(), hash);
+    }
+
+    std::stringstream ss;
+    ss << kKind << "-" << std::hex << std::setw(16) << std::setfill('0')
+       << hash;
+    kKey = ss.str();
+
+    return true;
+}
+
+bool CompileCache::read(const String& kKey, String& kData) const
+{
+    MappedFile file;
+    if (mDir.empty() || (MappedFile::init(this->path(kKey), file) != SUCCESS))
+    {
+        return false;
+    }
+
+    kData.assign(file.data(), file.size());
+
+    return true;
+}
+
+void CompileCache::write(const String& kKey, const String& kData) const
+{
+    if (mDir.empty())
+    {
+        return;
+    }
+
+    // Write the entry to a file private to this process, then rename it into
+    // place so that other processes never read a partial entry.
+    const String entryPath = this->path(kKey);
+#ifdef SF_PLATFORM_LINUX
+    const String tmpPath = (entryPath + "." + std::to_string(getpid())
+                            + ".tmp");
+#else
+    const String tmpPath = (entryPath + ".tmp");
+#endif
+    std::ofstream ofs(tmpPath, std::ios::binary);
+    ofs.write(kData.data(), kData.size());
+    ofs.close();
+    if (!ofs.good() || (std::rename(tmpPath.c_str(), entryPath.c_str()) != 0))
+    {
+        (void) std::remove(tmpPath.c_str());
+    }
+}
+
+/////////////////////////////////// Private ////////////////////////////////////
+
+String CompileCache::path(const String& kKey) const
+{
+    return (mDir + "/" + kKey);
+}
+
+} // namespace Sf
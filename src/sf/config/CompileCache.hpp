@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/config/CompileCache.hpp
+/// @brief On-disk cache of config compile results.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_COMPILE_CACHE_HPP
+#define SF_COMPILE_CACHE_HPP
+
+#include "sf/config/StateMachineCompiler.hpp"
+#include "sf/config/StlTypes.hpp"
+#include "sf/core/BasicTypes.hpp"
+
+namespace Sf
+{
+
+///
+/// @brief On-disk cache of compile results, keyed by a hash of the
+/// contents of the config files they were compiled from. State vectors
+/// and state machines are cached as AssemblyImages, so that a command
+/// run against unchanged config files loads them instead of compiling
+/// them, and a command run after only the state machine config changed
+/// still loads the state vector. Commands may also cache their own
+/// results, e.g., generated autocode.
+///
+/// @remark Entries are stored in the directory named by the SF_CACHE_DIR
+/// environment variable, or else in `surefire` under XDG_CACHE_HOME or
+/// `~/.cache`. Keys include the size and modification time of the running
+/// executable where available, so that rebuilding the CLI invalidates
+/// the cache. Only successful compiles are cached, so errors are always
+/// reported by the compilers.
+///
+/// @remark The cache is only available on Linux. On other platforms it is
+/// always bypassed, and configs are compiled on every command.
+///
+/// @remark The cache is best-effort: entries that fail to load are
+/// recompiled and overwritten, and failures to write entries are
+/// ignored. Entries are written to a temporary file and renamed into
+/// place, so concurrent CLI invocations may share a cache.
+///
+class CompileCache final
+{
+public:
+
+    ///
+    /// @brief Command option which bypasses the cache.
+    ///
+    static const char* const NO_CACHE_OPT;
+
+    ///
+    /// @brief Constructor. Removes the option that bypasses the cache from
+    /// command arguments.
+    ///
+    /// @param[in, out] kArgs  Command arguments.
+    ///
+    explicit CompileCache(Vec<String>& kArgs);
+
+    ///
+    /// @brief Compiles a state vector, or loads it from the cache.
+    ///
+    /// @see StateVectorCompiler::compile(String, ...)
+    ///
+    Result compileStateVector(const String& kSvFile,
+                              Ref<const StateVectorAssembly>& kSvAsm,
+                              ErrorInfo* const kErr) const;
+
+    ///
+    /// @brief Compiles a state vector and a state machine that uses it, or
+    /// loads them from the cache. State machines loaded from the cache
+    /// have no parse or expression cache.
+    ///
+    /// @see StateMachineCompiler::compile(String, ...)
+    ///
+    /// @param[in]  kSvFile  State vector config path.
+    /// @param[in]  kSmFile  State machine config path.
+    /// @param[out] kSvAsm   On success, points to state vector.
+    /// @param[out] kSmAsm   On success, points to state machine.
+    /// @param[out] kErr     On error, if non-null, contains error info.
+    /// @param[in]  kRake    If the state machine should be raked.
+    ///
+    Result compileStateMachine(const String& kSvFile,
+                               const String& kSmFile,
+                               Ref<const StateVectorAssembly>& kSvAsm,
+                               Ref<const StateMachineAssembly>& kSmAsm,
+                               ErrorInfo* const kErr,
+                               const bool kRake) const;
+
+    ///
+    /// @brief Computes the key of a command result.
+    ///
+    /// @param[in]  kKind   Kind of result, e.g., the command name.
+    /// @param[in]  kFiles  Paths of the config files the result depends
+    ///                     on.
+    /// @param[in]  kStrs   Command arguments the result depends on.
+    /// @param[out] kKey    On success, contains key.
+    ///
+    /// @returns Whether the key was computed. This fails if the cache is
+    /// bypassed or a file could not be read.
+    ///
+    bool key(const String& kKind,
+             const Vec<String>& kFiles,
+             const Vec<String>& kStrs,
+             String& kKey) const;
+
+    ///
+    /// @brief Reads a command result.
+    ///
+    /// @param[in]  kKey   Result key.
+    /// @param[out] kData  On success, contains result.
+    ///
+    /// @returns Whether the result was cached.
+    ///
+    bool read(const String& kKey, String& kData) const;
+
+    ///
+    /// @brief Writes a command result.
+    ///
+    /// @param[in] kKey   Result key.
+    /// @param[in] kData  Result.
+    ///
+    void write(const String& kKey, const String& kData) const;
+
+    CompileCache(const CompileCache&) = delete;
+    CompileCache(CompileCache&&) = delete;
+    CompileCache& operator=(const CompileCache&) = delete;
+    CompileCache& operator=(CompileCache&&) = delete;
+
+private:
+
+    ///
+    /// @brief Gets the path of a cache entry.
+    ///
+    /// @param[in] kKey  Entry key.
+    ///
+    /// @returns Entry path.
+    ///
+    String path(const String& kKey) const;
+
+    ///
+    /// @brief Cache directory, or empty if the cache is bypassed.
+    ///
+    String mDir;
+
+    ///
+    /// @brief Hash of the executable build, which seeds every key.
+    ///
+    U64 mSeed;
+};
+
+} // namespace Sf
+
+#endif
@@ -25,6 +25,49 @@
 namespace Sf
 {
 
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Extracts a line from source text.
+///
+/// @param[in]  kSrc      Source text.
+/// @param[in]  kLineNum  1-based number of line to extract.
+/// @param[out] kLine     On success, contains the line without its newline.
+///
+/// @returns Whether the line exists.
+///
+static bool getLine(const String& kSrc, const I32 kLineNum, String& kLine)
+{
+    if (kLineNum < 1)
+    {
+        return false;
+    }
+
+    // Skip past the newlines preceding the line.
+    std::size_t start = 0;
+    for (I32 i = 1; i < kLineNum; ++i)
+    {
+        start = kSrc.find('\n', start);
+        if (start == String::npos)
+        {
+            return false;
+        }
+        ++start;
+    }
+
+    // A newline at the very end of the source does not begin another line.
+    if (start >= kSrc.size())
+    {
+        return false;
+    }
+
+    const std::size_t end = kSrc.find('\n', start);
+    kLine = kSrc.substr(start, ((end == String::npos) ? end : (end - start)));
+    return true;
+}
+
+/////////////////////////////////// Public /////////////////////////////////////
+
 void ErrorInfo::set(ErrorInfo* const kErr,
                     const Token& kTokErr,
                     const String kText,
@@ -58,7 +101,8 @@ String ErrorInfo::prettifyError() const
     }
 
     // Check that line number is in range.
-    if ((lineNum - 1) >= static_cast<I32>(lines.size()))
+    String line;
+    if ((lineNum >= 1) && !getLine(source, lineNum, line))
     {
         return "`ErrorInfo::lineNum` out of range";
     }
@@ -70,7 +114,7 @@ String ErrorInfo::prettifyError() const
         std::stringstream ss;
         ss << Console::red << text << Console::reset << " @ " << filePath << ":"
            << lineNum << ":" << colNum << ":\n" << Console::cyan << "  | "
-           << Console::reset << lines[lineNum - 1] << "\n" << Console::cyan
+           << Console::reset << line << "\n" << Console::cyan
            << "  | ";
 
         U32 i = 0;
@@ -79,8 +123,7 @@ String ErrorInfo::prettifyError() const
             ss << " ";
         }
 
-        for (; (i < lines[lineNum - 1].size())
-               && std::isspace(lines[lineNum - 1][i]); ++i)
+        for (; (i < line.size()) && std::isspace(line[i]); ++i)
         {
             ss << " ";
         }
@@ -77,11 +77,11 @@ struct ErrorInfo final
     String subtext;
 
     ///
-    /// @brief Contents of file containing error. This will be procedurally
-    /// populated as the ErrorInfo passes through the parsing phase of a
-    /// compilation process.
+    /// @brief Contents of file containing error. This is populated by the
+    /// tokenizer at the start of a compilation process, and lines are
+    /// extracted from it on demand when prettifying an error.
     ///
-    Vec<String> lines;
+    String source;
 
     ///
     /// @brief Constructor.
@@ -95,7 +95,8 @@ struct ErrorInfo final
     /// Three types of error messages are possible, depending on member values:
     ///
     ///   1. lineNum and colNum are non-negative - Error implicates a specific
-    ///      token in a file. Assumes filePath and lines are also populated.
+    ///      token in a file. Assumes filePath and source are also
+    ///      populated.
     ///   2. lineNum and colNum are negative, filePath is populated - Error
     ///      implicates a file in general.
     ///   3. lineNum and colNum are negative, filePath is empty - General error
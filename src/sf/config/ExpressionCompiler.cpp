@@ -16,8 +16,13 @@
 /// IN THE SOFTWARE.
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdlib>
 #include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
 
 #include "sf/config/ExpressionCompiler.hpp"
 #include "sf/config/LanguageConstants.hpp"
@@ -33,13 +38,179 @@ namespace Sf
 ///
 static const char* const gErrText = "expression error";
 
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Creates a node which safe-casts an expression evaluated in I64 or
+/// F64 to the expression's final evaluation type.
+///
+/// @tparam T  Final evaluation type.
+///
+/// @param[in] kArena  Arena to allocate node in.
+/// @param[in] kNode   Expression root node. Must evaluate to I64 or F64.
+///
+/// @returns Cast node.
+///
+template<typename T>
+static IExpression* makeCastNode(Arena& kArena, IExpression& kNode)
+{
+    if (kNode.type() == ElementType::INT64)
+    {
+        return kArena.create<UnaryOpExprNode<T, I64>>(
+            ExprOpFuncs::safeCast<T, I64>,
+            dynamic_cast<IExprNode<I64>&>(kNode));
+    }
+
+    return kArena.create<UnaryOpExprNode<T, F64>>(
+        ExprOpFuncs::safeCast<T, F64>,
+        dynamic_cast<IExprNode<F64>&>(kNode));
+}
+
+///
+/// @brief Creates a node which runs an expression VM.
+///
+/// @tparam T  Expression evaluation type.
+///
+/// @param[in] kArena  Arena to allocate node in.
+/// @param[in] kVm     VM that runs the expression bytecode.
+/// @param[in] kSrc    Tree root node that the bytecode was compiled from.
+///
+/// @returns Bytecode node.
+///
+template<typename T>
+static IExpression* makeBytecodeNode(Arena& kArena,
+                                     ExpressionVm& kVm,
+                                     const IExpression* const kSrc)
+{
+    return kArena.create<BytecodeExprNode<T>>(kVm, kSrc);
+}
+
+///
+/// @brief Adds the nodes of an expression tree to a set of counted nodes.
+///
+/// @param[in]      kNode     Expression root node, or null.
+/// @param[in, out] kCounted  Set of counted nodes.
+///
+static void countNodes(const IExpression* const kNode,
+                       Set<const IExpression*>& kCounted)
+{
+    // Stop at null nodes and nodes shared with an expression already counted.
+    if ((kNode == nullptr) || (kCounted.find(kNode) != kCounted.end()))
+    {
+        return;
+    }
+
+    kCounted.insert(kNode);
+    const IOpExprNode* const opNode = dynamic_cast<const IOpExprNode*>(kNode);
+    const IExprStatsNode* const statsNode =
+        dynamic_cast<const IExprStatsNode*>(kNode);
+    const IBytecodeExprNode* const bcNode =
+        dynamic_cast<const IBytecodeExprNode*>(kNode);
+    if (opNode != nullptr)
+    {
+        countNodes(opNode->lhs(), kCounted);
+        countNodes(opNode->rhs(), kCounted);
+    }
+    else if (statsNode != nullptr)
+    {
+        countNodes(&statsNode->stats().expr(), kCounted);
+    }
+    else if (bcNode != nullptr)
+    {
+        countNodes(bcNode->src(), kCounted);
+    }
+}
+
+///
+/// @brief Gets the canonical string of an I64 constant.
+///
+/// @param[in] kVal  Constant value.
+///
+/// @returns Canonical string.
+///
+static String constKey(const I64 kVal)
+{
+    std::stringstream ss;
+    ss << "i" << kVal;
+    return ss.str();
+}
+
+///
+/// @brief Gets the canonical string of an F64 constant.
+///
+/// @param[in] kVal  Constant value.
+///
+/// @returns Canonical string.
+///
+static String constKey(const F64 kVal)
+{
+    // Hex float format is exact, so distinct values have distinct keys.
+    std::stringstream ss;
+    ss << "f" << std::hexfloat << kVal;
+    return ss.str();
+}
+
+///
+/// @brief Creates a binary operator node which evaluates in I64 or F64.
+///
+/// @param[in] kArena  Arena to allocate node in.
+/// @param[in] kOpI64  Operator function to use if operands are I64.
+/// @param[in] kOpF64  Operator function to use if operands are F64.
+/// @param[in] kLhs    LHS root node.
+/// @param[in] kRhs    RHS root node. Must have the same type as the LHS.
+///
+/// @returns Operator node.
+///
+static IExpression* makeBinOpNode(Arena& kArena,
+                                  const BinOpExprNode<I64>::Operator kOpI64,
+                                  const BinOpExprNode<F64>::Operator kOpF64,
+                                  IExpression& kLhs,
+                                  IExpression& kRhs)
+{
+    if (kLhs.type() == ElementType::INT64)
+    {
+        return kArena.create<BinOpExprNode<I64>>(
+            kOpI64,
+            dynamic_cast<IExprNode<I64>&>(kLhs),
+            dynamic_cast<IExprNode<I64>&>(kRhs));
+    }
+
+    return kArena.create<BinOpExprNode<F64>>(
+        kOpF64,
+        dynamic_cast<IExprNode<F64>&>(kLhs),
+        dynamic_cast<IExprNode<F64>&>(kRhs));
+}
+
+///
+/// @brief Creates a node which reads an element and casts it to I64 or F64.
+/// U64 and floating elements are cast to F64, and all other elements to I64.
+///
+/// @tparam T     Element type.
+/// @tparam TDom  Evaluation domain, I64 or F64.
+///
+/// @param[in] kArena  Arena to allocate nodes in.
+/// @param[in] kElem   Element.
+///
+/// @returns Cast node.
+///
+template<typename T, typename TDom>
+static IExpression* makeElementNode(Arena& kArena, const IElement& kElem)
+{
+    ElementExprNode<T>* const nodeElem = kArena.create<ElementExprNode<T>>(
+        *static_cast<const Element<T>*>(&kElem));
+    return kArena.create<UnaryOpExprNode<TDom, T>>(
+        ExprOpFuncs::safeCast<TDom, T>, *nodeElem);
+}
+
 /////////////////////////////////// Public /////////////////////////////////////
 
 Result ExpressionCompiler::compile(const Ref<const ExpressionParse> kParse,
                                    const Map<String, IElement*> kBindings,
                                    const ElementType kEvalType,
                                    Ref<const ExpressionAssembly>& kAsm,
-                                   ErrorInfo* const kErr)
+                                   ErrorInfo* const kErr,
+                                   const ExpressionCompiler::Backend kBackend,
+                                   const Ref<ExpressionCache> kCache)
 {
     // Check that expression parse is non-null.
     if (kParse == nullptr)
@@ -47,79 +218,80 @@ Result ExpressionCompiler::compile(const Ref<const ExpressionParse> kParse,
         return E_EXC_NULL;
     }
 
-    // Compile expression starting at root.
+    // Compile expression starting at root. Bytecode for the expression is
+    // emitted alongside the tree.
+    // Nodes are allocated in the cache arena when compiling with a cache so
+    // that they may be shared with other expressions.
     ExpressionAssembly::Workspace ws;
-    Ref<IExprNode<F64>> root = nullptr;
-    const Result res = ExpressionCompiler::compileImpl(kParse,
-                                                       kBindings,
-                                                       root,
-                                                       ws,
-                                                       kErr);
+    ws.arena = ((kCache != nullptr) ? kCache->mArena : Ref<Arena>(new Arena()));
+    ws.rootNode = nullptr;
+    ws.instrs.reset(new Vec<ExpressionVm::Instruction>());
+    ws.vm = nullptr;
+    ws.cache = kCache;
+    ws.srcNodeCnt = 0;
+    IExpression* root = nullptr;
+    Result res = ExpressionCompiler::compileImpl(kParse,
+                                                 kBindings,
+                                                 root,
+                                                 ws,
+                                                 kErr);
     if (res != SUCCESS)
     {
         return res;
     }
 
-    // Add cast to target evaluation type. We do this even when both types are
-    // F64 so that NaNs can be eliminated by safe-casting.
-    Ref<IExpression> newRoot = nullptr;
+    // Add cast from the I64 or F64 domain that the expression was evaluated in
+    // to the target evaluation type. We do this even when both types are the
+    // same so that NaNs can be eliminated by safe-casting.
+    IExpression* newRoot = nullptr;
+    Arena& arena = *ws.arena;
     SF_SAFE_ASSERT(root != nullptr);
-    SF_SAFE_ASSERT(root->type() == ElementType::FLOAT64);
+    SF_SAFE_ASSERT((root->type() == ElementType::INT64)
+                   || (root->type() == ElementType::FLOAT64));
     switch (kEvalType)
     {
         case ElementType::INT8:
-            newRoot.reset(new UnaryOpExprNode<I8, F64>(
-                ExprOpFuncs::safeCast<I8, F64>, *root));
+            newRoot = makeCastNode<I8>(arena, *root);
             break;
 
         case ElementType::INT16:
-            newRoot.reset(new UnaryOpExprNode<I16, F64>(
-                ExprOpFuncs::safeCast<I16, F64>, *root));
+            newRoot = makeCastNode<I16>(arena, *root);
             break;
 
         case ElementType::INT32:
-            newRoot.reset(new UnaryOpExprNode<I32, F64>(
-                ExprOpFuncs::safeCast<I32, F64>, *root));
+            newRoot = makeCastNode<I32>(arena, *root);
             break;
 
         case ElementType::INT64:
-            newRoot.reset(new UnaryOpExprNode<I64, F64>(
-                ExprOpFuncs::safeCast<I64, F64>, *root));
+            newRoot = makeCastNode<I64>(arena, *root);
             break;
 
         case ElementType::UINT8:
-            newRoot.reset(new UnaryOpExprNode<U8, F64>(
-                ExprOpFuncs::safeCast<U8, F64>, *root));
+            newRoot = makeCastNode<U8>(arena, *root);
             break;
 
         case ElementType::UINT16:
-            newRoot.reset(new UnaryOpExprNode<U16, F64>(
-                ExprOpFuncs::safeCast<U16, F64>, *root));
+            newRoot = makeCastNode<U16>(arena, *root);
             break;
 
         case ElementType::UINT32:
-            newRoot.reset(new UnaryOpExprNode<U32, F64>(
-                ExprOpFuncs::safeCast<U32, F64>, *root));
+            newRoot = makeCastNode<U32>(arena, *root);
             break;
 
         case ElementType::UINT64:
-            newRoot.reset(new UnaryOpExprNode<U64, F64>(
-                ExprOpFuncs::safeCast<U64, F64>, *root));
+            newRoot = makeCastNode<U64>(arena, *root);
             break;
 
         case ElementType::FLOAT32:
-            newRoot.reset(new UnaryOpExprNode<F32, F64>(
-                ExprOpFuncs::safeCast<F32, F64>, *root));
+            newRoot = makeCastNode<F32>(arena, *root);
             break;
 
         case ElementType::FLOAT64:
-            newRoot.reset(new UnaryOpExprNode<F64, F64>(
-                ExprOpFuncs::safeCast<F64, F64>, *root));
+            newRoot = makeCastNode<F64>(arena, *root);
             break;
 
         case ElementType::BOOL:
-            newRoot.reset(new UnaryOpExprNode<bool, F64>(
-                ExprOpFuncs::safeCast<bool, F64>, *root));
+            newRoot = makeCastNode<bool>(arena, *root);
             break;
 
         default:
@@ -127,9 +299,102 @@ Result ExpressionCompiler::compile(const Ref<const ExpressionParse> kParse,
             SF_SAFE_ASSERT(false);
     }
 
-    // Add root node to workspace.
-    ws.exprNodes.push_back(newRoot);
     ws.rootNode = newRoot;
+    ++ws.srcNodeCnt;
+
+    if (kBackend == BYTECODE)
+    {
+        // Create the VM that will run the expression bytecode. Each
+        // instruction pushes at most one value, so a stack with one slot per
+        // instruction never overflows.
+        // The bytecode is moved into the arena alongside the VM.
+        const U32 instrCnt = ws.instrs->size();
+        ExpressionVm::Instruction* const instrs =
+            arena.createArray<ExpressionVm::Instruction>(instrCnt);
+        std::copy(ws.instrs->begin(), ws.instrs->end(), instrs);
+        ws.vm = arena.create<ExpressionVm>();
+        const ExpressionVm::Config vmConfig =
+        {
+            instrs,
+            instrCnt,
+            arena.createArray<ExpressionVm::Value>(instrCnt),
+            instrCnt
+        };
+        res = ExpressionVm::init(vmConfig, *ws.vm);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        // Replace the root node with a node that runs the VM. The tree root
+        // is kept as the source of the bytecode.
+        const IExpression* const src = ws.rootNode;
+        switch (kEvalType)
+        {
+            case ElementType::INT8:
+                newRoot = makeBytecodeNode<I8>(arena, *ws.vm, src);
+                break;
+
+            case ElementType::INT16:
+                newRoot = makeBytecodeNode<I16>(arena, *ws.vm, src);
+                break;
+
+            case ElementType::INT32:
+                newRoot = makeBytecodeNode<I32>(arena, *ws.vm, src);
+                break;
+
+            case ElementType::INT64:
+                newRoot = makeBytecodeNode<I64>(arena, *ws.vm, src);
+                break;
+
+            case ElementType::UINT8:
+                newRoot = makeBytecodeNode<U8>(arena, *ws.vm, src);
+                break;
+
+            case ElementType::UINT16:
+                newRoot = makeBytecodeNode<U16>(arena, *ws.vm, src);
+                break;
+
+            case ElementType::UINT32:
+                newRoot = makeBytecodeNode<U32>(arena, *ws.vm, src);
+                break;
+
+            case ElementType::UINT64:
+                newRoot = makeBytecodeNode<U64>(arena, *ws.vm, src);
+                break;
+
+            case ElementType::FLOAT32:
+                newRoot = makeBytecodeNode<F32>(arena, *ws.vm, src);
+                break;
+
+            case ElementType::FLOAT64:
+                newRoot = makeBytecodeNode<F64>(arena, *ws.vm, src);
+                break;
+
+            case ElementType::BOOL:
+                newRoot = makeBytecodeNode<bool>(arena, *ws.vm, src);
+                break;
+
+            default:
+                // Unreachable.
+                SF_SAFE_ASSERT(false);
+        }
+
+        // The bytecode node is not added to the cache since it references
+        // the VM of this assembly.
+        ws.rootNode = newRoot;
+        ++ws.srcNodeCnt;
+    }
+
+    // Bytecode is no longer needed in the workspace.
+    ws.instrs.reset();
+
+    // Update cache node counts.
+    if (kCache != nullptr)
+    {
+        kCache->mSrcNodeCnt += ws.srcNodeCnt;
+        countNodes(ws.rootNode, kCache->mCounted);
+    }
 
     // Create the final assembly.
     kAsm.reset(new ExpressionAssembly(ws));
@@ -137,14 +402,45 @@ Result ExpressionCompiler::compile(const Ref<const ExpressionParse> kParse,
     return SUCCESS;
 }
 
+ExpressionCache::ExpressionCache() : ExpressionCache(Ref<Arena>(new Arena()))
+{
+}
+
+ExpressionCache::ExpressionCache(const Ref<Arena> kArena) :
+    mArena(kArena), mSrcNodeCnt(0)
+{
+    SF_ASSERT(mArena != nullptr);
+}
+
+U32 ExpressionCache::srcNodeCount() const
+{
+    return mSrcNodeCnt;
+}
+
+U32 ExpressionCache::nodeCount() const
+{
+    return mCounted.size();
+}
+
 Ref<IExpression> ExpressionAssembly::root() const
 {
-    return mWs.rootNode;
+    return Arena::share(mWs.arena, mWs.rootNode);
 }
 
 Vec<Ref<IExpressionStats>> ExpressionAssembly::stats() const
 {
-    return mWs.exprStats;
+    Vec<Ref<IExpressionStats>> stats;
+    for (IExpressionStats* const exprStats : mWs.exprStats)
+    {
+        stats.push_back(Arena::share(mWs.arena, exprStats));
+    }
+
+    return stats;
+}
+
+Vec<bool> ExpressionAssembly::statsSampleInactive() const
+{
+    return mWs.statsSampleInactive;
 }
 
 /////////////////////////////////// Private ////////////////////////////////////
@@ -179,10 +475,190 @@ Result ExpressionCompiler::tokenToF64(const Token& kTok,
     return SUCCESS;
 }
 
+bool ExpressionCompiler::tokenToI64(const Token& kTok, I64& kRet)
+{
+    // Only constants without a decimal point are integers.
+    if (kTok.str.find('.') != String::npos)
+    {
+        return false;
+    }
+
+    // Convert string to I64. Integers outside the I64 range are left to
+    // become F64.
+    const char* const str = kTok.str.c_str();
+    char* end = nullptr;
+    errno = 0;
+    const long long val = std::strtoll(str, &end, 10);
+    if ((end == str) || (*end != '\0') || (errno == ERANGE))
+    {
+        return false;
+    }
+
+    kRet = static_cast<I64>(val);
+
+    return true;
+}
+
+void ExpressionCompiler::promote(IExpression*& kNode,
+                                 ExpressionAssembly::Workspace& kWs)
+{
+    if (kNode->type() == ElementType::INT64)
+    {
+        ++kWs.srcNodeCnt;
+        const String key = ("f64(" + ExpressionCompiler::keyOf(kNode, kWs)
+                            + ")");
+        if (!ExpressionCompiler::lookup(key, kNode, kWs))
+        {
+            kNode = kWs.arena->create<UnaryOpExprNode<F64, I64>>(
+                ExprOpFuncs::safeCast<F64, I64>,
+                dynamic_cast<IExprNode<I64>&>(*kNode));
+
+            // Fold the conversion of a constant. The conversion instruction
+            // is emitted by the caller, so no instructions are replaced.
+            ExpressionCompiler::fold(kNode, kWs.instrs->size(), kWs);
+            ExpressionCompiler::insert(key, kNode, nullptr, kWs);
+        }
+    }
+}
+
+bool ExpressionCompiler::lookup(const String& kKey,
+                                IExpression*& kNode,
+                                ExpressionAssembly::Workspace& kWs)
+{
+    if (kWs.cache == nullptr)
+    {
+        return false;
+    }
+
+    const auto entryIt = kWs.cache->mEntries.find(kKey);
+    if (entryIt == kWs.cache->mEntries.end())
+    {
+        return false;
+    }
+
+    kNode = (*entryIt).second.node;
+
+    return true;
+}
+
+void ExpressionCompiler::insert(const String& kKey,
+                                IExpression* const kNode,
+                                IExpressionStats* const kStats,
+                                ExpressionAssembly::Workspace& kWs)
+{
+    if (kWs.cache == nullptr)
+    {
+        return;
+    }
+
+    // A folded node may already be cached under its constant's string, so
+    // only the first string of a node is kept as its canonical string.
+    ExpressionCache& cache = *kWs.cache;
+    cache.mEntries.insert({kKey, {kNode, kStats}});
+    cache.mKeys.insert({kNode, kKey});
+}
+
+String ExpressionCompiler::keyOf(IExpression* const kNode,
+                                 ExpressionAssembly::Workspace& kWs)
+{
+    if (kWs.cache == nullptr)
+    {
+        return "";
+    }
+
+    const auto keyIt = kWs.cache->mKeys.find(kNode);
+    SF_ASSERT(keyIt != kWs.cache->mKeys.end());
+
+    return (*keyIt).second;
+}
+
+void ExpressionCompiler::fold(IExpression*& kNode,
+                              const U32 kInstrCnt,
+                              ExpressionAssembly::Workspace& kWs)
+{
+    if (kWs.cache == nullptr)
+    {
+        return;
+    }
+
+    if (kNode->nodeType() != IExpression::CONST)
+    {
+        // Only fold operators whose operands are all constant.
+        const IOpExprNode* const opNode =
+            dynamic_cast<const IOpExprNode*>(kNode);
+        if ((opNode == nullptr)
+            || ((opNode->lhs() != nullptr)
+                && (opNode->lhs()->nodeType() != IExpression::CONST))
+            || (opNode->rhs()->nodeType() != IExpression::CONST))
+        {
+            return;
+        }
+
+        // Evaluate the operator. Results which the autocoder cannot print
+        // exactly are not folded, so that autocode evaluates the same as the
+        // compiled expression. The constant is shared with any identical
+        // cached constant.
+        if (kNode->type() == ElementType::INT64)
+        {
+            const I64 val =
+                dynamic_cast<IExprNode<I64>&>(*kNode).evaluate();
+            if (val == Limits::min<I64>())
+            {
+                return;
+            }
+
+            const String key = constKey(val);
+            if (!ExpressionCompiler::lookup(key, kNode, kWs))
+            {
+                kNode = kWs.arena->create<ConstExprNode<I64>>(val);
+                ExpressionCompiler::insert(key, kNode, nullptr, kWs);
+            }
+        }
+        else
+        {
+            const F64 val =
+                dynamic_cast<IExprNode<F64>&>(*kNode).evaluate();
+            std::stringstream ss;
+            ss << std::setprecision(std::numeric_limits<F64>::digits10)
+               << val;
+            if (!std::isfinite(val) || (std::strtod(ss.str().c_str(), nullptr)
+                                        != val))
+            {
+                return;
+            }
+
+            const String key = constKey(val);
+            if (!ExpressionCompiler::lookup(key, kNode, kWs))
+            {
+                kNode = kWs.arena->create<ConstExprNode<F64>>(val);
+                ExpressionCompiler::insert(key, kNode, nullptr, kWs);
+            }
+        }
+    }
+
+    // Replace the instructions which computed the constant with a push.
+    if (kInstrCnt < kWs.instrs->size())
+    {
+        kWs.instrs->resize(kInstrCnt);
+        ExpressionVm::Instruction instr;
+        if (kNode->type() == ElementType::INT64)
+        {
+            instr.op = ExpressionVm::PUSH_I;
+            instr.val.i64 = dynamic_cast<IExprNode<I64>&>(*kNode).evaluate();
+        }
+        else
+        {
+            instr.op = ExpressionVm::PUSH_F;
+            instr.val.f64 = dynamic_cast<IExprNode<F64>&>(*kNode).evaluate();
+        }
+        kWs.instrs->push_back(instr);
+    }
+}
+
 Result ExpressionCompiler::compileStatsFunc(
     const Ref<const ExpressionParse> kParse,
     const Map<String, IElement*>& kBindings,
-    Ref<IExprNode<F64>>& kNode,
+    IExpression*& kNode,
     ExpressionAssembly::Workspace& kWs,
     ErrorInfo* const kErr)
 {
@@ -197,11 +673,11 @@ Result ExpressionCompiler::compileStatsFunc(
         node = node->left;
     }
 
-    // Check function arity.
-    if (argNodes.size() != 2)
+    // Check function arity. The third argument is optional.
+    if ((argNodes.size() != 2) && (argNodes.size() != 3))
     {
         std::stringstream ss;
-        ss << "`" << kParse->data.str << + "` expects 2 arguments, got "
+        ss << "`" << kParse->data.str << + "` expects 2 or 3 arguments, got "
            << argNodes.size();
         ErrorInfo::set(kErr, kParse->data, gErrText, ss.str());
         return E_EXC_ARITY;
@@ -209,7 +685,8 @@ Result ExpressionCompiler::compileStatsFunc(
 
     // Compile first argument expression; the expression which stats are being
     // calculated for.
-    Ref<IExprNode<F64>> arg1Node = nullptr;
+    IExpression* arg1Node = nullptr;
+    const U32 instrCnt = kWs.instrs->size();
     Result res = ExpressionCompiler::compileImpl(argNodes[0]->right,
                                                  kBindings,
                                                  arg1Node,
@@ -220,6 +697,13 @@ Result ExpressionCompiler::compileStatsFunc(
         return res;
     }
 
+    // The first argument expression is evaluated by the expression stats when
+    // it updates, not when the function is evaluated, so discard its bytecode.
+    kWs.instrs->resize(instrCnt);
+
+    // Expression stats are calculated in F64.
+    ExpressionCompiler::promote(arg1Node, kWs);
+
     // Compile second argument expression, the rolling window size. This one
     // gets passed through the entire compilation process so that we can
     // evaluate it here and get a constant value for the window size.
@@ -259,49 +743,108 @@ Result ExpressionCompiler::compileStatsFunc(
         return E_EXC_WIN;
     }
 
-    // Allocate storage arrays needed by expression stats and add them to the
-    // workspace.
-    const U32 statsArrSizeBytes = (windowSize * sizeof(F64));
-    Ref<Vec<U8>> statsArrA(new Vec<U8>(statsArrSizeBytes));
-    Ref<Vec<U8>> statsArrB(new Vec<U8>(statsArrSizeBytes));
-    kWs.statArrs.push_back(statsArrA);
-    kWs.statArrs.push_back(statsArrB);
+    // Compile the optional third argument expression, whether the stats keep
+    // sampling while inactive, and evaluate it like the window size.
+    bool sampleInactive = true;
+    if (argNodes.size() == 3)
+    {
+        Ref<const ExpressionAssembly> arg3Asm;
+        res = ExpressionCompiler::compile(argNodes[2]->right,
+                                          kBindings,
+                                          ElementType::BOOL,
+                                          arg3Asm,
+                                          kErr);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
 
-    // Create expression stats for first argument expression and add it to the
-    // workspace. The expression stats is given raw pointers to the arrays we
-    // just allocated.
-    SF_SAFE_ASSERT(arg1Node != nullptr);
-    const Ref<ExpressionStats<F64>> exprStats(
-        new ExpressionStats<F64>(*arg1Node,
-                                 reinterpret_cast<F64*>(statsArrA->data()),
-                                 reinterpret_cast<F64*>(statsArrB->data()),
-                                 windowSize));
-    kWs.exprStats.push_back(exprStats);
+        SF_SAFE_ASSERT(arg3Asm != nullptr);
+        SF_SAFE_ASSERT(arg3Asm->root() != nullptr);
+        SF_SAFE_ASSERT(arg3Asm->root()->type() == ElementType::BOOL);
+        sampleInactive =
+            dynamic_cast<IExprNode<bool>*>(arg3Asm->root().get())->evaluate();
+    }
 
-    // Create node which returns the desired stat.
+    // Get the instruction which returns the desired stat.
+    ExpressionVm::Instruction instr;
     if (kParse->data.str == LangConst::funcRollAvg)
     {
-        kNode.reset(new RollAvgNode(*exprStats));
+        instr.op = ExpressionVm::ROLL_AVG;
     }
     else if (kParse->data.str == LangConst::funcRollMedian)
     {
-        kNode.reset(new RollMedianNode(*exprStats));
+        instr.op = ExpressionVm::ROLL_MEDIAN;
     }
     else if (kParse->data.str == LangConst::funcRollMin)
     {
-        kNode.reset(new RollMinNode(*exprStats));
+        instr.op = ExpressionVm::ROLL_MIN;
     }
     else if (kParse->data.str == LangConst::funcRollMax)
     {
-        kNode.reset(new RollMaxNode(*exprStats));
+        instr.op = ExpressionVm::ROLL_MAX;
     }
     else
     {
-        kNode.reset(new RollRangeNode(*exprStats));
+        instr.op = ExpressionVm::ROLL_RANGE;
+    }
+
+    // Use identical cached stats if they exist. The cached stats are already
+    // in the workspace of the expression that created them, so they are not
+    // added to this workspace and are only updated once per step.
+    ++kWs.srcNodeCnt;
+    std::stringstream keySs;
+    keySs << kParse->data.str << "("
+          << ExpressionCompiler::keyOf(arg1Node, kWs) << "," << windowSize
+          << "," << sampleInactive << ")";
+    if (ExpressionCompiler::lookup(keySs.str(), kNode, kWs))
+    {
+        instr.stats = kWs.cache->mEntries[keySs.str()].stats;
+        kWs.instrs->push_back(instr);
+        return SUCCESS;
+    }
+
+    // Create expression stats for first argument expression and add it to the
+    // workspace. The stats storage arrays are allocated in the arena; the
+    // second array holds 4 indices per window value.
+    SF_SAFE_ASSERT(arg1Node != nullptr);
+    Arena& arena = *kWs.arena;
+    IExprNode<F64>& arg1NodeFp = dynamic_cast<IExprNode<F64>&>(*arg1Node);
+    ExpressionStats<F64>* const exprStats = arena.create<ExpressionStats<F64>>(
+        arg1NodeFp,
+        arena.createArray<F64>(windowSize),
+        arena.createArray<U32>(4 * windowSize),
+        windowSize);
+    kWs.exprStats.push_back(exprStats);
+    kWs.statsSampleInactive.push_back(sampleInactive);
+
+    // Create node which returns the desired stat and emit its instruction.
+    switch (instr.op)
+    {
+        case ExpressionVm::ROLL_AVG:
+            kNode = arena.create<RollAvgNode>(*exprStats);
+            break;
+
+        case ExpressionVm::ROLL_MEDIAN:
+            kNode = arena.create<RollMedianNode>(*exprStats);
+            break;
+
+        case ExpressionVm::ROLL_MIN:
+            kNode = arena.create<RollMinNode>(*exprStats);
+            break;
+
+        case ExpressionVm::ROLL_MAX:
+            kNode = arena.create<RollMaxNode>(*exprStats);
+            break;
+
+        default:
+            kNode = arena.create<RollRangeNode>(*exprStats);
     }
+    instr.stats = exprStats;
+    kWs.instrs->push_back(instr);
 
-    // Add compiled function node to workspace.
-    kWs.exprNodes.push_back(kNode);
+    // Add compiled function node to cache.
+    ExpressionCompiler::insert(keySs.str(), kNode, exprStats, kWs);
 
     return SUCCESS;
 }
@@ -309,7 +852,7 @@ Result ExpressionCompiler::compileStatsFunc(
 Result ExpressionCompiler::compileFunction(
     const Ref<const ExpressionParse> kParse,
     const Map<String, IElement*>& kBindings,
-    Ref<IExprNode<F64>>& kNode,
+    IExpression*& kNode,
     ExpressionAssembly::Workspace& kWs,
     ErrorInfo* const kErr)
 {
@@ -340,7 +883,7 @@ Result ExpressionCompiler::compileFunction(
 Result ExpressionCompiler::compileOperator(
     const Ref<const ExpressionParse> kParse,
     const Map<String, IElement*>& kBindings,
-    Ref<IExprNode<F64>>& kNode,
+    IExpression*& kNode,
     ExpressionAssembly::Workspace& kWs,
     ErrorInfo* const kErr)
 {
@@ -349,9 +892,10 @@ Result ExpressionCompiler::compileOperator(
     // Get operator info.
     SF_SAFE_ASSERT(kParse->data.opInfo != nullptr);
     const OpInfo& opInfo = *kParse->data.opInfo;
+    const U32 instrCnt = kWs.instrs->size();
 
     // Compile right subtree.
-    Ref<IExprNode<F64>> nodeRight;
+    IExpression* nodeRight = nullptr;
     Result res = ExpressionCompiler::compileImpl(kParse->right,
                                                  kBindings,
                                                  nodeRight,
@@ -363,134 +907,187 @@ Result ExpressionCompiler::compileOperator(
     }
     SF_SAFE_ASSERT(nodeRight != nullptr);
 
-    // If a binary operator, compile left subtree.
-    Ref<IExprNode<F64>> nodeLeft;
-    if (!opInfo.unary)
+    // Logical NOT evaluates in the same domain as its operand.
+    ExpressionVm::Instruction instr;
+    ++kWs.srcNodeCnt;
+    if (opInfo.enumVal == OpInfo::Type::NOT)
     {
-        res = ExpressionCompiler::compileImpl(kParse->left,
-                                              kBindings,
-                                              nodeLeft,
-                                              kWs,
-                                              kErr);
-        if (res != SUCCESS)
+        const String key = ("(" + kParse->data.str + " "
+                            + ExpressionCompiler::keyOf(nodeRight, kWs) + ")");
+        const bool fp = (nodeRight->type() == ElementType::FLOAT64);
+        instr.op = (fp ? ExpressionVm::NOT_F : ExpressionVm::NOT_I);
+        kWs.instrs->push_back(instr);
+        if (!ExpressionCompiler::lookup(key, kNode, kWs))
         {
-            return res;
+            if (fp)
+            {
+                kNode = kWs.arena->create<UnaryOpExprNode<F64>>(
+                    ExprOpFuncs::lnot<F64>,
+                    dynamic_cast<IExprNode<F64>&>(*nodeRight));
+            }
+            else
+            {
+                kNode = kWs.arena->create<UnaryOpExprNode<I64>>(
+                    ExprOpFuncs::lnot<I64>,
+                    dynamic_cast<IExprNode<I64>&>(*nodeRight));
+            }
         }
-        SF_SAFE_ASSERT(nodeLeft != nullptr);
+        ExpressionCompiler::fold(kNode, instrCnt, kWs);
+        ExpressionCompiler::insert(key, kNode, nullptr, kWs);
+        return SUCCESS;
     }
 
-    // Create operator node.
-    switch (opInfo.enumVal)
+    // Operator is binary, so compile left subtree.
+    SF_SAFE_ASSERT(!opInfo.unary);
+    IExpression* nodeLeft = nullptr;
+    res = ExpressionCompiler::compileImpl(kParse->left,
+                                          kBindings,
+                                          nodeLeft,
+                                          kWs,
+                                          kErr);
+    if (res != SUCCESS)
     {
-        case OpInfo::Type::NOT:
-        {
-            kNode.reset(new UnaryOpExprNode<F64>(ExprOpFuncs::lnot<F64>,
-                                                 *nodeRight));
-            break;
-        }
+        return res;
+    }
+    SF_SAFE_ASSERT(nodeLeft != nullptr);
+
+    // Operators evaluate in I64 if both operands are I64 and in F64 otherwise,
+    // so promote any I64 operand when the other operand is F64. Division
+    // always evaluates in F64 so that, e.g., `1 / 2` is 0.5 and not 0.
+    const bool fp = ((opInfo.enumVal == OpInfo::Type::DIV)
+                     || (nodeLeft->type() == ElementType::FLOAT64)
+                     || (nodeRight->type() == ElementType::FLOAT64));
+    if (fp && (nodeLeft->type() == ElementType::INT64))
+    {
+        ExpressionCompiler::promote(nodeLeft, kWs);
+        instr.op = ExpressionVm::I2F_LHS;
+        kWs.instrs->push_back(instr);
+    }
+
+    if (fp && (nodeRight->type() == ElementType::INT64))
+    {
+        ExpressionCompiler::promote(nodeRight, kWs);
+        instr.op = ExpressionVm::I2F_RHS;
+        kWs.instrs->push_back(instr);
+    }
+
+    // Get canonical string of the operator. Operands of commutative operators
+    // are ordered so that, e.g., `a + b` and `b + a` are shared.
+    String keyLeft = ExpressionCompiler::keyOf(nodeLeft, kWs);
+    String keyRight = ExpressionCompiler::keyOf(nodeRight, kWs);
+    const bool commutative = ((opInfo.enumVal == OpInfo::Type::MULT)
+                              || (opInfo.enumVal == OpInfo::Type::ADD)
+                              || (opInfo.enumVal == OpInfo::Type::EQ)
+                              || (opInfo.enumVal == OpInfo::Type::NEQ)
+                              || (opInfo.enumVal == OpInfo::Type::AND)
+                              || (opInfo.enumVal == OpInfo::Type::OR));
+    if (commutative && (keyRight < keyLeft))
+    {
+        std::swap(keyLeft, keyRight);
+    }
+    const String key =
+        ("(" + kParse->data.str + " " + keyLeft + " " + keyRight + ")");
 
+    // Get operator functions and instruction.
+    BinOpExprNode<I64>::Operator opI64 = nullptr;
+    BinOpExprNode<F64>::Operator opF64 = nullptr;
+    switch (opInfo.enumVal)
+    {
         case OpInfo::Type::MULT:
-            kNode.reset(new BinOpExprNode<F64>(ExprOpFuncs::mult<F64>,
-                                               *nodeLeft,
-                                               *nodeRight));
+            opI64 = ExprOpFuncs::mult<I64>;
+            opF64 = ExprOpFuncs::mult<F64>;
+            instr.op = (fp ? ExpressionVm::MULT_F : ExpressionVm::MULT_I);
             break;
 
         case OpInfo::Type::DIV:
-            kNode.reset(new BinOpExprNode<F64>(ExprOpFuncs::div<F64>,
-                                               *nodeLeft,
-                                               *nodeRight));
+            opF64 = ExprOpFuncs::div<F64>;
+            instr.op = ExpressionVm::DIV_F;
             break;
 
         case OpInfo::Type::ADD:
-            kNode.reset(new BinOpExprNode<F64>(ExprOpFuncs::add<F64>,
-                                               *nodeLeft,
-                                               *nodeRight));
+            opI64 = ExprOpFuncs::add<I64>;
+            opF64 = ExprOpFuncs::add<F64>;
+            instr.op = (fp ? ExpressionVm::ADD_F : ExpressionVm::ADD_I);
             break;
 
         case OpInfo::Type::SUB:
-            kNode.reset(new BinOpExprNode<F64>(ExprOpFuncs::sub<F64>,
-                                               *nodeLeft,
-                                               *nodeRight));
+            opI64 = ExprOpFuncs::sub<I64>;
+            opF64 = ExprOpFuncs::sub<F64>;
+            instr.op = (fp ? ExpressionVm::SUB_F : ExpressionVm::SUB_I);
             break;
 
         case OpInfo::Type::LT:
-        {
-            kNode.reset(new BinOpExprNode<F64>(ExprOpFuncs::lt<F64>,
-                                               *nodeLeft,
-                                               *nodeRight));
+            opI64 = ExprOpFuncs::lt<I64>;
+            opF64 = ExprOpFuncs::lt<F64>;
+            instr.op = (fp ? ExpressionVm::LT_F : ExpressionVm::LT_I);
             break;
-        }
 
         case OpInfo::Type::LTE:
-        {
-            kNode.reset(new BinOpExprNode<F64>(ExprOpFuncs::lte<F64>,
-                                               *nodeLeft,
-                                               *nodeRight));
+            opI64 = ExprOpFuncs::lte<I64>;
+            opF64 = ExprOpFuncs::lte<F64>;
+            instr.op = (fp ? ExpressionVm::LTE_F : ExpressionVm::LTE_I);
             break;
-        }
 
         case OpInfo::Type::GT:
-        {
-            kNode.reset(new BinOpExprNode<F64>(ExprOpFuncs::gt<F64>,
-                                               *nodeLeft,
-                                               *nodeRight));
+            opI64 = ExprOpFuncs::gt<I64>;
+            opF64 = ExprOpFuncs::gt<F64>;
+            instr.op = (fp ? ExpressionVm::GT_F : ExpressionVm::GT_I);
             break;
-        }
 
         case OpInfo::Type::GTE:
-        {
-            kNode.reset(new BinOpExprNode<F64>(ExprOpFuncs::gte<F64>,
-                                               *nodeLeft,
-                                               *nodeRight));
+            opI64 = ExprOpFuncs::gte<I64>;
+            opF64 = ExprOpFuncs::gte<F64>;
+            instr.op = (fp ? ExpressionVm::GTE_F : ExpressionVm::GTE_I);
             break;
-        }
 
         case OpInfo::Type::EQ:
-        {
-            kNode.reset(new BinOpExprNode<F64>(ExprOpFuncs::eq<F64>,
-                                               *nodeLeft,
-                                               *nodeRight));
+            opI64 = ExprOpFuncs::eq<I64>;
+            opF64 = ExprOpFuncs::eq<F64>;
+            instr.op = (fp ? ExpressionVm::EQ_F : ExpressionVm::EQ_I);
             break;
-        }
 
         case OpInfo::Type::NEQ:
-        {
-            kNode.reset(new BinOpExprNode<F64>(ExprOpFuncs::neq<F64>,
-                                               *nodeLeft,
-                                               *nodeRight));
+            opI64 = ExprOpFuncs::neq<I64>;
+            opF64 = ExprOpFuncs::neq<F64>;
+            instr.op = (fp ? ExpressionVm::NEQ_F : ExpressionVm::NEQ_I);
             break;
-        }
 
         case OpInfo::Type::AND:
-        {
-            kNode.reset(new BinOpExprNode<F64>(ExprOpFuncs::land<F64>,
-                                               *nodeLeft,
-                                               *nodeRight));
+            opI64 = ExprOpFuncs::land<I64>;
+            opF64 = ExprOpFuncs::land<F64>;
+            instr.op = (fp ? ExpressionVm::AND_F : ExpressionVm::AND_I);
             break;
-        }
 
         case OpInfo::Type::OR:
-        {
-            kNode.reset(new BinOpExprNode<F64>(ExprOpFuncs::lor<F64>,
-                                               *nodeLeft,
-                                               *nodeRight));
+            opI64 = ExprOpFuncs::lor<I64>;
+            opF64 = ExprOpFuncs::lor<F64>;
+            instr.op = (fp ? ExpressionVm::OR_F : ExpressionVm::OR_I);
             break;
-        }
 
         default:
             // Unreachable.
             SF_SAFE_ASSERT(false);
     }
 
-    // Add compiled node to workspace.
-    kWs.exprNodes.push_back(kNode);
+    // Emit operator instruction. The operands were compiled RHS first, so the
+    // LHS is on top of the VM stack as the instruction expects.
+    kWs.instrs->push_back(instr);
+
+    // Use an identical cached node if one exists, or else create the operator
+    // node. Then fold the node if its operands are constant.
+    if (!ExpressionCompiler::lookup(key, kNode, kWs))
+    {
+        kNode = makeBinOpNode(*kWs.arena, opI64, opF64, *nodeLeft, *nodeRight);
+    }
+    ExpressionCompiler::fold(kNode, instrCnt, kWs);
+    ExpressionCompiler::insert(key, kNode, nullptr, kWs);
 
     return SUCCESS;
 }
 
 Result ExpressionCompiler::compileImpl(const Ref<const ExpressionParse> kParse,
                                        const Map<String, IElement*>& kBindings,
-                                       Ref<IExprNode<F64>>& kNode,
+                                       IExpression*& kNode,
                                        ExpressionAssembly::Workspace& kWs,
                                        ErrorInfo* const kErr)
 {
@@ -517,33 +1114,55 @@ Result ExpressionCompiler::compileImpl(const Ref<const ExpressionParse> kParse,
         SF_SAFE_ASSERT(kParse->left == nullptr);
         SF_SAFE_ASSERT(kParse->right == nullptr);
 
+        // Booleans and integers evaluate in I64, and all other numbers in
+        // F64.
+        ExpressionVm::Instruction instr;
+        instr.op = ExpressionVm::PUSH_I;
         if (kParse->data.str == LangConst::constantTrue)
         {
             // True boolean constant.
-            kNode.reset(new ConstExprNode<F64>(1.0));
+            instr.val.i64 = 1;
         }
         else if (kParse->data.str == LangConst::constantFalse)
         {
             // False boolean constant.
-            kNode.reset(new ConstExprNode<F64>(0.0));
+            instr.val.i64 = 0;
         }
-        else
+        else if (!ExpressionCompiler::tokenToI64(kParse->data, instr.val.i64))
         {
-            // Numeric constant.
-            F64 val = 0.0;
+            // Non-integer constant.
             const Result res = ExpressionCompiler::tokenToF64(kParse->data,
-                                                              val,
+                                                              instr.val.f64,
                                                               kErr);
             if (res != SUCCESS)
             {
                 return res;
             }
 
-            kNode.reset(new ConstExprNode<F64>(val));
+            instr.op = ExpressionVm::PUSH_F;
         }
 
-        // Add compiled node to workspace.
-        kWs.exprNodes.push_back(kNode);
+        // Share the constant with any identical cached constant, or else
+        // create the constant node. Then emit constant push.
+        ++kWs.srcNodeCnt;
+        const bool fp = (instr.op == ExpressionVm::PUSH_F);
+        const String key = ((kWs.cache == nullptr)
+                            ? ""
+                            : (fp ? constKey(instr.val.f64)
+                                  : constKey(instr.val.i64)));
+        if (!ExpressionCompiler::lookup(key, kNode, kWs))
+        {
+            if (fp)
+            {
+                kNode = kWs.arena->create<ConstExprNode<F64>>(instr.val.f64);
+            }
+            else
+            {
+                kNode = kWs.arena->create<ConstExprNode<I64>>(instr.val.i64);
+            }
+            ExpressionCompiler::insert(key, kNode, nullptr, kWs);
+        }
+        kWs.instrs->push_back(instr);
     }
     else if (kParse->data.type == Token::IDENTIFIER)
     {
@@ -568,127 +1187,81 @@ Result ExpressionCompiler::compileImpl(const Ref<const ExpressionParse> kParse,
             return E_EXC_ELEM_NULL;
         }
 
+        // Emit element load. Load opcodes have the same values as the element
+        // types.
+        ExpressionVm::Instruction instr;
+        instr.op = static_cast<ExpressionVm::Opcode>(elemObj->type());
+        instr.elem = elemObj;
+        kWs.instrs->push_back(instr);
+
+        // Share the element with any cached node reading the same element.
+        kWs.srcNodeCnt += ((elemObj->type() == ElementType::INT64) ? 1 : 2);
+        std::stringstream keySs;
+        keySs << "e" << static_cast<const void*>(elemObj);
+        if (ExpressionCompiler::lookup(keySs.str(), kNode, kWs))
+        {
+            return SUCCESS;
+        }
+
         // Narrow the element pointer to a template instantiation of the
-        // element's type.
+        // element's type. U64 and floating elements are cast to F64, and all
+        // other elements to I64.
+        Arena& arena = *kWs.arena;
         switch (elemObj->type())
         {
             case ElementType::INT8:
-            {
-                const Ref<IExprNode<I8>> nodeElem(new ElementExprNode<I8>(
-                    *static_cast<const Element<I8>*>(elemObj)));
-                kNode.reset(new UnaryOpExprNode<F64, I8>(
-                    ExprOpFuncs::safeCast<F64, I8>, *nodeElem));
-                kWs.exprNodes.push_back(nodeElem);
+                kNode = makeElementNode<I8, I64>(arena, *elemObj);
                 break;
-            }
 
             case ElementType::INT16:
-            {
-                const Ref<IExprNode<I16>> nodeElem(new ElementExprNode<I16>(
-                    *static_cast<const Element<I16>*>(elemObj)));
-                kNode.reset(new UnaryOpExprNode<F64, I16>(
-                    ExprOpFuncs::safeCast<F64, I16>, *nodeElem));
-                kWs.exprNodes.push_back(nodeElem);
+                kNode = makeElementNode<I16, I64>(arena, *elemObj);
                 break;
-            }
 
             case ElementType::INT32:
-            {
-                const Ref<IExprNode<I32>> nodeElem(new ElementExprNode<I32>(
-                    *static_cast<const Element<I32>*>(elemObj)));
-                kNode.reset(new UnaryOpExprNode<F64, I32>(
-                    ExprOpFuncs::safeCast<F64, I32>, *nodeElem));
-                kWs.exprNodes.push_back(nodeElem);
+                kNode = makeElementNode<I32, I64>(arena, *elemObj);
                 break;
-            }
 
             case ElementType::INT64:
-            {
-                const Ref<IExprNode<I64>> nodeElem(new ElementExprNode<I64>(
-                    *static_cast<const Element<I64>*>(elemObj)));
-                kNode.reset(new UnaryOpExprNode<F64, I64>(
-                    ExprOpFuncs::safeCast<F64, I64>, *nodeElem));
-                kWs.exprNodes.push_back(nodeElem);
+                // Element is already in the I64 domain, so no cast is needed.
+                kNode = arena.create<ElementExprNode<I64>>(
+                    *static_cast<const Element<I64>*>(elemObj));
                 break;
-            }
 
             case ElementType::UINT8:
-            {
-                const Ref<IExprNode<U8>> nodeElem(new ElementExprNode<U8>(
-                    *static_cast<const Element<U8>*>(elemObj)));
-                kNode.reset(new UnaryOpExprNode<F64, U8>(
-                    ExprOpFuncs::safeCast<F64, U8>, *nodeElem));
-                kWs.exprNodes.push_back(nodeElem);
+                kNode = makeElementNode<U8, I64>(arena, *elemObj);
                 break;
-            }
 
             case ElementType::UINT16:
-            {
-                const Ref<IExprNode<U16>> nodeElem(new ElementExprNode<U16>(
-                    *static_cast<const Element<U16>*>(elemObj)));
-                kNode.reset(new UnaryOpExprNode<F64, U16>(
-                    ExprOpFuncs::safeCast<F64, U16>, *nodeElem));
-                kWs.exprNodes.push_back(nodeElem);
+                kNode = makeElementNode<U16, I64>(arena, *elemObj);
                 break;
-            }
 
             case ElementType::UINT32:
-            {
-                const Ref<IExprNode<U32>> nodeElem(new ElementExprNode<U32>(
-                    *static_cast<const Element<U32>*>(elemObj)));
-                kNode.reset(new UnaryOpExprNode<F64, U32>(
-                    ExprOpFuncs::safeCast<F64, U32>, *nodeElem));
-                kWs.exprNodes.push_back(nodeElem);
+                kNode = makeElementNode<U32, I64>(arena, *elemObj);
                 break;
-            }
 
             case ElementType::UINT64:
-            {
-                const Ref<IExprNode<U64>> nodeElem(new ElementExprNode<U64>(
-                    *static_cast<const Element<U64>*>(elemObj)));
-                kNode.reset(new UnaryOpExprNode<F64, U64>(
-                    ExprOpFuncs::safeCast<F64, U64>, *nodeElem));
-                kWs.exprNodes.push_back(nodeElem);
+                kNode = makeElementNode<U64, F64>(arena, *elemObj);
                 break;
-            }
 
             case ElementType::FLOAT32:
-            {
-                const Ref<IExprNode<F32>> nodeElem(new ElementExprNode<F32>(
-                    *static_cast<const Element<F32>*>(elemObj)));
-                kNode.reset(new UnaryOpExprNode<F64, F32>(
-                    ExprOpFuncs::safeCast<F64, F32>, *nodeElem));
-                kWs.exprNodes.push_back(nodeElem);
+                kNode = makeElementNode<F32, F64>(arena, *elemObj);
                 break;
-            }
 
             case ElementType::FLOAT64:
-            {
-                const Ref<IExprNode<F64>> nodeElem(new ElementExprNode<F64>(
-                    *static_cast<const Element<F64>*>(elemObj)));
-                kNode.reset(new UnaryOpExprNode<F64, F64>(
-                    ExprOpFuncs::safeCast<F64, F64>, *nodeElem));
-                kWs.exprNodes.push_back(nodeElem);
+                kNode = makeElementNode<F64, F64>(arena, *elemObj);
                 break;
-            }
 
             case ElementType::BOOL:
-            {
-                const Ref<IExprNode<bool>> nodeElem(new ElementExprNode<bool>(
-                    *static_cast<const Element<bool>*>(elemObj)));
-                kNode.reset(new UnaryOpExprNode<F64, bool>(
-                    ExprOpFuncs::safeCast<F64, bool>, *nodeElem));
-                kWs.exprNodes.push_back(nodeElem);
+                kNode = makeElementNode<bool, I64>(arena, *elemObj);
                 break;
-            }
 
             default:
                 // Unreachable.
                 SF_SAFE_ASSERT(false);
         }
 
-        // Add compiled node to workspace.
-        kWs.exprNodes.push_back(kNode);
+        // Add compiled node to cache.
+        ExpressionCompiler::insert(keySs.str(), kNode, nullptr, kWs);
     }
     else
     {
@@ -23,15 +23,113 @@
 #ifndef SF_EXPRESSION_COMPILER_HPP
 #define SF_EXPRESSION_COMPILER_HPP
 
+#include "sf/config/Arena.hpp"
 #include "sf/config/ExpressionParser.hpp"
 #include "sf/config/StlTypes.hpp"
 #include "sf/core/Expression.hpp"
 #include "sf/core/ExpressionStats.hpp"
+#include "sf/core/ExpressionVm.hpp"
 #include "sf/core/StateVector.hpp"
 
 namespace Sf
 {
 
+///
+/// @brief Subexpressions shared between expressions compiled with the same
+/// cache. Compiling with a cache also folds constant subexpressions. Identical
+/// subexpressions, including stats functions, are compiled once and shared by
+/// every expression that uses them, so each stats function is updated once
+/// per step no matter how many expressions use it.
+///
+/// @remark Shared nodes are still evaluated once per reference. Elements may
+/// change between the evaluations of different expressions in a step, e.g.,
+/// when an action writes an element, so values are not memoized.
+///
+/// @warning Shared stats are only returned by ExpressionAssembly::stats() of
+/// the first expression that used them, so the user must update the stats of
+/// every expression compiled with a cache.
+///
+class ExpressionCache final
+{
+public:
+
+    ///
+    /// @brief Constructor. The cache allocates nodes in its own arena.
+    ///
+    ExpressionCache();
+
+    ///
+    /// @brief Constructor.
+    ///
+    /// @param[in] kArena  Arena to allocate nodes of expressions compiled with
+    ///                    the cache in, e.g., the arena of the state machine
+    ///                    assembly that the expressions belong to.
+    ///
+    explicit ExpressionCache(const Ref<Arena> kArena);
+
+    ///
+    /// @brief Gets the total number of nodes that expressions compiled with
+    /// the cache would have had without folding or sharing.
+    ///
+    /// @returns Unoptimized node count.
+    ///
+    U32 srcNodeCount() const;
+
+    ///
+    /// @brief Gets the number of distinct nodes in expressions compiled with
+    /// the cache.
+    ///
+    /// @returns Optimized node count.
+    ///
+    U32 nodeCount() const;
+
+    ExpressionCache(const ExpressionCache&) = delete;
+    ExpressionCache(ExpressionCache&&) = delete;
+    ExpressionCache& operator=(const ExpressionCache&) = delete;
+    ExpressionCache& operator=(ExpressionCache&&) = delete;
+
+private:
+
+    friend class ExpressionCompiler;
+
+    ///
+    /// @brief A cached subexpression.
+    ///
+    struct Entry final
+    {
+        IExpression* node;        ///< Subexpression root node.
+        IExpressionStats* stats;  ///< Stats if node is a stats function.
+    };
+
+    ///
+    /// @brief Map of canonical subexpression strings to cached subexpressions.
+    ///
+    Map<String, Entry> mEntries;
+
+    ///
+    /// @brief Map of cached nodes to their canonical strings.
+    ///
+    Map<const IExpression*, String> mKeys;
+
+    ///
+    /// @brief Arena containing all nodes and stats of expressions compiled
+    /// with the cache. Cached nodes reference their operands, which may belong
+    /// to other expressions, so every expression compiled with the cache
+    /// shares ownership of the arena.
+    ///
+    Ref<Arena> mArena;
+
+    ///
+    /// @brief Nodes counted by nodeCount().
+    ///
+    Set<const IExpression*> mCounted;
+
+    ///
+    /// @brief Unoptimized node count.
+    ///
+    U32 mSrcNodeCnt;
+};
+
 ///
 /// @brief Compiled expression.
 ///
@@ -54,6 +152,17 @@ public:
     ///
     Vec<Ref<IExpressionStats>> stats() const;
 
+    ///
+    /// @brief Gets whether each expression stats used by the expression keeps
+    /// sampling while in a state that does not use it, as set by the optional
+    /// third argument of its stats function.
+    ///
+    /// @see StateMachine::StatsDeps::sampleInactive
+    ///
+    /// @returns Vector of flags parallel to the vector returned by stats().
+    ///
+    Vec<bool> statsSampleInactive() const;
+
 private:
 
     friend class ExpressionCompiler;
@@ -63,10 +172,14 @@ private:
     ///
     struct Workspace
     {
-        Vec<Ref<IExpression>> exprNodes;
-        Vec<Ref<IExpressionStats>> exprStats;
-        Vec<Ref<Vec<U8>>> statArrs;
-        Ref<IExpression> rootNode;
+        Ref<Arena> arena;
+        Vec<IExpressionStats*> exprStats;
+        Vec<bool> statsSampleInactive;
+        IExpression* rootNode;
+        Ref<Vec<ExpressionVm::Instruction>> instrs;
+        ExpressionVm* vm;
+        Ref<ExpressionCache> cache;
+        U32 srcNodeCnt;
     };
 
     ///
@@ -85,10 +198,38 @@ private:
 ///
 /// @brief Expression compiler.
 ///
+/// @remark Expressions are evaluated in one of two domains. Integer and bool
+/// elements and constants evaluate in I64, and floating elements and
+/// constants evaluate in F64. An operator evaluates in I64 if all of its
+/// operands are I64, and otherwise promotes any I64 operands to F64. Division
+/// and stats functions always evaluate in F64. The expression result is
+/// safe-casted from its domain to the expression evaluation type. This keeps
+/// integer expressions exact, e.g., I64 counters above 2^53. I64 arithmetic
+/// saturates. U64 elements evaluate in F64, since I64 cannot represent values
+/// above the I64 maximum; like floating elements, they are exact up to 2^53.
+///
 class ExpressionCompiler final
 {
 public:
 
+    ///
+    /// @brief Expression compiler backends.
+    ///
+    enum Backend : U8
+    {
+        ///
+        /// @brief Expression is evaluated by a tree of IExprNode.
+        ///
+        TREE = 0,
+
+        ///
+        /// @brief Expression is lowered to bytecode and evaluated by an
+        /// ExpressionVm. The expression tree is still compiled and reachable
+        /// from the root node for the benefit of autocoders.
+        ///
+        BYTECODE = 1
+    };
+
     ///
     /// @brief Compiler entry point.
     ///
@@ -97,6 +238,10 @@ public:
     /// @param[in]  kEvalType  Expression evaluation type.
     /// @param[out] kAsm       On success, points to compiled expression.
     /// @param[out] kErr       On error, if non-null, contains error info.
+    /// @param[in]  kBackend   Expression backend.
+    /// @param[in]  kCache     Cache to fold constants and share subexpressions
+    ///                        with, or null to compile the expression as
+    ///                        written.
     ///
     /// @retval SUCCESS          Successfully compiled expression.
     /// @retval E_EXC_NULL       kParse is null.
@@ -112,7 +257,9 @@ public:
                           const Map<String, IElement*> kBindings,
                           const ElementType kEvalType,
                           Ref<const ExpressionAssembly>& kAsm,
-                          ErrorInfo* const kErr);
+                          ErrorInfo* const kErr,
+                          const ExpressionCompiler::Backend kBackend = TREE,
+                          const Ref<ExpressionCache> kCache = nullptr);
 
     ExpressionCompiler() = delete;
 
@@ -132,7 +279,85 @@ private:
                              ErrorInfo* const kErr);
 
     ///
-    /// @brief Compiles a stats function call.
+    /// @brief Converts a constant token to I64 if it is an integer.
+    ///
+    /// @param[in]  kTok  Token to convert.
+    /// @param[out] kRet  If the token is an integer in the I64 range, contains
+    ///                   converted value.
+    ///
+    /// @returns Whether the token was converted.
+    ///
+    static bool tokenToI64(const Token& kTok, I64& kRet);
+
+    ///
+    /// @brief Promotes an expression that evaluates in I64 to F64 by adding a
+    /// cast node. Expressions that already evaluate in F64 are unchanged.
+    ///
+    /// @param[in, out] kNode  Expression root node.
+    /// @param[in, out] kWs    Compilation workspace.
+    ///
+    static void promote(IExpression*& kNode,
+                        ExpressionAssembly::Workspace& kWs);
+
+    ///
+    /// @brief Replaces a node with an identical cached node, if one exists.
+    ///
+    /// @param[in]      kKey   Canonical string of node.
+    /// @param[in, out] kNode  On hit, contains cached node.
+    /// @param[in, out] kWs    Compilation workspace.
+    ///
+    /// @returns Whether a cached node was found. Always false when compiling
+    /// without a cache.
+    ///
+    static bool lookup(const String& kKey,
+                       IExpression*& kNode,
+                       ExpressionAssembly::Workspace& kWs);
+
+    ///
+    /// @brief Adds a node to the cache, if compiling with one.
+    ///
+    /// @param[in]      kKey    Canonical string of node.
+    /// @param[in]      kNode   Node to add.
+    /// @param[in]      kStats  Stats evaluated by the node, or null if none.
+    /// @param[in, out] kWs     Compilation workspace.
+    ///
+    static void insert(const String& kKey,
+                       IExpression* const kNode,
+                       IExpressionStats* const kStats,
+                       ExpressionAssembly::Workspace& kWs);
+
+    ///
+    /// @brief Gets the canonical string of a node compiled with a cache.
+    ///
+    /// @param[in] kNode  Node.
+    /// @param[in] kWs    Compilation workspace.
+    ///
+    /// @returns Canonical string.
+    ///
+    static String keyOf(IExpression* const kNode,
+                        ExpressionAssembly::Workspace& kWs);
+
+    ///
+    /// @brief Replaces an operator node whose operands are all constant with
+    /// a constant node, if compiling with a cache.
+    ///
+    /// @param[in, out] kNode      Operator node.
+    /// @param[in]      kInstrCnt  Number of instructions emitted before the
+    ///                            operator's operands.
+    /// @param[in, out] kWs        Compilation workspace.
+    ///
+    static void fold(IExpression*& kNode,
+                     const U32 kInstrCnt,
+                     ExpressionAssembly::Workspace& kWs);
+
+    ///
+    /// @brief Compiles a stats function call. Stats functions take the
+    /// expression to compute stats for, the rolling window size, and an
+    /// optional boolean which sets whether the stats keep sampling while in a
+    /// state that does not use them (true if omitted), e.g.,
+    /// `roll_avg(foo, 10, false)`.
+    ///
+    /// @see StateMachine::StatsDeps::sampleInactive
     ///
     /// @param[in]       kParse     Parse tree rooted at function call.
     /// @param[in]       kBindings  Element symbol table.
@@ -144,7 +369,7 @@ private:
     ///
     static Result compileStatsFunc(const Ref<const ExpressionParse> kParse,
                                    const Map<String, IElement*>& kBindings,
-                                   Ref<IExprNode<F64>>& kNode,
+                                   IExpression*& kNode,
                                    ExpressionAssembly::Workspace& kWs,
                                    ErrorInfo* const kErr);
 
@@ -161,7 +386,7 @@ private:
     ///
     static Result compileFunction(const Ref<const ExpressionParse> kParse,
                                   const Map<String, IElement*>& kBindings,
-                                  Ref<IExprNode<F64>>& kNode,
+                                  IExpression*& kNode,
                                   ExpressionAssembly::Workspace& kWs,
                                   ErrorInfo* const kErr);
 
@@ -178,7 +403,7 @@ private:
     ///
     static Result compileOperator(const Ref<const ExpressionParse> kParse,
                                   const Map<String, IElement*>& kBindings,
-                                  Ref<IExprNode<F64>>& kNode,
+                                  IExpression*& kNode,
                                   ExpressionAssembly::Workspace& kWs,
                                   ErrorInfo* const kErr);
 
@@ -187,7 +412,8 @@ private:
     ///
     /// @param[in]       kParse     Expression parse.
     /// @param[in]       kBindings  Element symbol table.
-    /// @param[out]      kNode      On success, contains compiled expression.
+    /// @param[out]      kNode      On success, contains compiled expression,
+    ///                             which evaluates to I64 or F64.
     /// @param[in, out]  kWs        Compilation workspace.
     /// @param[out]      kErr       On error, if non-null, contains error info.
     ///
@@ -195,7 +421,7 @@ private:
     ///
     static Result compileImpl(const Ref<const ExpressionParse> kParse,
                               const Map<String, IElement*>& kBindings,
-                              Ref<IExprNode<F64>>& kNode,
+                              IExpression*& kNode,
                               ExpressionAssembly::Workspace& kWs,
                               ErrorInfo* const kErr);
 };
@@ -23,6 +23,8 @@
 #ifndef SF_EXPRESSION_PARSER_HPP
 #define SF_EXPRESSION_PARSER_HPP
 
+#include <stack>
+
 #include "sf/config/ErrorInfo.hpp"
 #include "sf/config/StlTypes.hpp"
 #include "sf/config/TokenIterator.hpp"
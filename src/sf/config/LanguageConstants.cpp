@@ -57,6 +57,10 @@ const String LangConst::annotationReadOnly = "@read_only";
 
 const String LangConst::annotationStop = "@stop";
 
+const String LangConst::annotationLockGroup = "@lock_group";
+
+const String LangConst::annotationAtomic = "@atomic";
+
 const String LangConst::sectionStateVector = "[state_vector]";
 
 const String LangConst::sectionLocal = "[local]";
@@ -67,6 +71,12 @@ const String LangConst::sectionOptions = "[options]";
 
 const String LangConst::optLock = "lock";
 
+const String LangConst::optSeqLock = "seqlock";
+
+const String LangConst::optAdaptiveLock = "adaptive_lock";
+
+const String LangConst::optRegionLocks = "region_locks";
+
 const String LangConst::keywordIf = "if";
 
 const String LangConst::keywordElse = "else";
@@ -95,6 +95,21 @@ namespace LangConst
     ///
     extern const String optLock;
 
+    ///
+    /// @brief Sequence lock option name.
+    ///
+    extern const String optSeqLock;
+
+    ///
+    /// @brief Adaptive lock option name.
+    ///
+    extern const String optAdaptiveLock;
+
+    ///
+    /// @brief Region locks option name.
+    ///
+    extern const String optRegionLocks;
+
     ///
     /// @brief State entry label.
     ///
@@ -130,6 +145,16 @@ namespace LangConst
     ///
     extern const String annotationStop;
 
+    ///
+    /// @brief Lock group annotation.
+    ///
+    extern const String annotationLockGroup;
+
+    ///
+    /// @brief Atomic annotation.
+    ///
+    extern const String annotationAtomic;
+
     ///
     /// @brief State vector section name.
     ///
@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef SF_PLATFORM_LINUX
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#else
+#    include <fstream>
+#    include <sstream>
+#endif
+
+#include "sf/config/MappedFile.hpp"
+
+namespace Sf
+{
+
+/////////////////////////////////// Public /////////////////////////////////////
+
+Result MappedFile::init(const String kPath, MappedFile& kFile)
+{
+    // Check that file is not already initialized.
+    if (kFile.mInit)
+    {
+        return E_MAP_REINIT;
+    }
+
+#ifdef SF_PLATFORM_LINUX
+
+    // Open file and check that it is a regular file.
+    const I32 fd = open(kPath.c_str(), (O_RDONLY | O_CLOEXEC));
+    if (fd < 0)
+    {
+        return E_MAP_OPEN;
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode))
+    {
+        (void) close(fd);
+        return E_MAP_OPEN;
+    }
+
+    // Map file. An empty file cannot be mapped, so it is represented by a null
+    // pointer and size 0.
+    const U64 size = static_cast<U64>(st.st_size);
+    void* data = nullptr;
+    if (size > 0)
+    {
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            (void) close(fd);
+            return E_MAP_MAP;
+        }
+
+        // Config files are read front to back once.
+        (void) madvise(data, size, MADV_SEQUENTIAL);
+    }
+
+    // The mapping remains valid after the file is closed.
+    (void) close(fd);
+
+    kFile.mInit = true;
+    kFile.mData = static_cast<const char*>(data);
+    kFile.mSize = size;
+
+#else
+
+    // Read file into a buffer.
+    std::ifstream ifs(kPath, std::ios::binary);
+    if (!ifs.is_open())
+    {
+        return E_MAP_OPEN;
+    }
+
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    if (ifs.bad())
+    {
+        return E_MAP_MAP;
+    }
+
+    kFile.mInit = true;
+    kFile.mBuf = ss.str();
+    kFile.mData = (kFile.mBuf.empty() ? nullptr : kFile.mBuf.data());
+    kFile.mSize = kFile.mBuf.size();
+
+#endif
+
+    return SUCCESS;
+}
+
+MappedFile::MappedFile() : mInit(false), mData(nullptr), mSize(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef SF_PLATFORM_LINUX
+    if (mData != nullptr)
+    {
+        (void) munmap(const_cast<char*>(mData), mSize);
+    }
+#endif
+}
+
+const char* MappedFile::data() const
+{
+    return mData;
+}
+
+U64 MappedFile::size() const
+{
+    return mSize;
+}
+
+} // namespace Sf
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/config/MappedFile.hpp
+/// @brief Read-only memory-mapped file.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_MAPPED_FILE_HPP
+#define SF_MAPPED_FILE_HPP
+
+#include "sf/config/StlTypes.hpp"
+#include "sf/core/BasicTypes.hpp"
+#include "sf/core/Result.hpp"
+
+namespace Sf
+{
+
+///
+/// @brief Read-only view of a file's contents mapped into memory. Config
+/// files are read through a MappedFile so that they are tokenized directly out
+/// of memory rather than copied line by line into strings. The mapping is
+/// released when the MappedFile destructs.
+///
+/// @remark Files are only memory-mapped on Linux. On other platforms, the
+/// file contents are read into a buffer owned by the MappedFile.
+///
+class MappedFile final
+{
+public:
+
+    ///
+    /// @brief Maps a file into memory.
+    ///
+    /// @pre  kFile is uninitialized.
+    /// @post On success, kFile is initialized and views the file contents.
+    /// @post On error, preconditions still hold.
+    ///
+    /// @param[in] kPath  Path to file.
+    /// @param[in] kFile  MappedFile to initialize.
+    ///
+    /// @retval SUCCESS       Successfully mapped file.
+    /// @retval E_MAP_REINIT  kFile is already initialized.
+    /// @retval E_MAP_OPEN    Failed to open file, or path is not a regular
+    ///                       file.
+    /// @retval E_MAP_MAP     Failed to map or read file into memory.
+    ///
+    static Result init(const String kPath, MappedFile& kFile);
+
+    ///
+    /// @brief Default constructor.
+    ///
+    /// @post The constructed MappedFile is uninitialized and views no data.
+    ///
+    MappedFile();
+
+    ///
+    /// @brief Destructor.
+    ///
+    /// @post If the MappedFile was initialized, the file was unmapped.
+    ///
+    ~MappedFile();
+
+    ///
+    /// @brief Gets the file contents. The contents are not null-terminated.
+    ///
+    /// @returns Pointer to file contents, or null if the file is empty or the
+    /// MappedFile is uninitialized.
+    ///
+    const char* data() const;
+
+    ///
+    /// @brief Gets the file size.
+    ///
+    /// @returns File size in bytes.
+    ///
+    U64 size() const;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+private:
+
+    ///
+    /// @brief Whether the MappedFile is initialized.
+    ///
+    bool mInit;
+
+    ///
+    /// @brief Start of mapping, or null if none.
+    ///
+    const char* mData;
+
+    ///
+    /// @brief Size of mapping in bytes.
+    ///
+    U64 mSize;
+
+#ifndef SF_PLATFORM_LINUX
+
+    ///
+    /// @brief File contents, which mData points into.
+    ///
+    String mBuf;
+
+#endif
+};
+
+} // namespace Sf
+
+#endif
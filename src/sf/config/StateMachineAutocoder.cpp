@@ -21,6 +21,7 @@
 #include "sf/config/StateMachineAutocoder.hpp"
 #include "sf/core/Assert.hpp"
 #include "sf/core/Expression.hpp"
+#include "sf/core/ExpressionVm.hpp"
 
 namespace Sf
 {
@@ -38,7 +39,7 @@ Result StateMachineAutocoder::code(std::ostream& kOs,
     }
 
     // Initialize a blank workspace for the autocoder.
-    StateMachineAutocoder::Workspace ws{nullptr, {}, 0, 0, 0, 0, 0};
+    StateMachineAutocoder::Workspace ws{nullptr, {}, {}, 0, 0, 0, 0, 0, {}};
     ws.smAsm = kSmAsm;
 
     // Add preamble.
@@ -126,6 +127,66 @@ Result StateMachineAutocoder::code(std::ostream& kOs,
         exprStatsArrAddr = "exprStats";
     }
 
+    // Define expression stats dependencies. Autocoded stats are numbered in
+    // the order they were coded, which may differ from the order of the
+    // compiled config, so each is matched to its compiled dependencies by
+    // address.
+    String statsDepsArrAddr = "nullptr";
+    if ((ws.statsCnt > 0) && (smConfig.statsDeps != nullptr))
+    {
+        Vec<const StateMachine::StatsDeps*> statsDeps;
+        for (const IExpressionStats* const stats : ws.statsObjs)
+        {
+            U32 j = 0;
+            while ((smConfig.stats[j] != nullptr)
+                   && (smConfig.stats[j] != stats))
+            {
+                ++j;
+            }
+            SF_ASSERT(smConfig.stats[j] != nullptr);
+            statsDeps.push_back(&smConfig.statsDeps[j]);
+        }
+
+        for (U32 i = 0; i < statsDeps.size(); ++i)
+        {
+            if (statsDeps[i]->states != nullptr)
+            {
+                String ids = "{";
+                for (const U32* id = statsDeps[i]->states;
+                     *id != StateMachine::NO_STATE;
+                     ++id)
+                {
+                    ids += Autocode::format("%%, ", *id);
+                }
+
+                ids += "StateMachine::NO_STATE}";
+                a("static const U32 stats%%States[] = %%;", i, ids);
+            }
+        }
+
+        a("static StateMachine::StatsDeps statsDeps[] =");
+        a("{");
+        a.increaseIndent();
+
+        for (U32 i = 0; i < statsDeps.size(); ++i)
+        {
+            const String statesAddr =
+                ((statsDeps[i]->states != nullptr)
+                 ? Autocode::format("stats%%States", i)
+                 : "nullptr");
+            a("{%%, %%}%%",
+              statesAddr,
+              (statsDeps[i]->sampleInactive ? "true" : "false"),
+              (((i + 1) < statsDeps.size()) ? "," : ""));
+        }
+
+        a.decreaseIndent();
+        a("};");
+        a();
+
+        statsDepsArrAddr = "statsDeps";
+    }
+
     // Generate code to look up state and global time element if not already.
     const String elemStateName =
         StateMachineAutocoder::elemNameFromAddr(smConfig.elemState, ws);
@@ -144,11 +205,12 @@ Result StateMachineAutocoder::code(std::ostream& kOs,
     a();
 
     // Define state machine config and return to caller.
-    a("static StateMachine::Config smConfig = {elem%%, elem%%, elem%%, stateConfigs, %%};",
+    a("static StateMachine::Config smConfig = {elem%%, elem%%, elem%%, stateConfigs, %%, %%};",
       elemStateName,
       LangConst::elemStateTime,
       elemGlobalTimeName,
-      exprStatsArrAddr);
+      exprStatsArrAddr,
+      statsDepsArrAddr);
     a("kSmConfig = smConfig;");
     a();
 
@@ -199,9 +261,33 @@ const Map<const void*, String> StateMachineAutocoder::opFuncIds =
      "ExprOpFuncs::land<F64>"},
     {reinterpret_cast<const void*>(&ExprOpFuncs::lor<F64>),
      "ExprOpFuncs::lor<F64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::add<I64>),
+     "ExprOpFuncs::add<I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::sub<I64>),
+     "ExprOpFuncs::sub<I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::mult<I64>),
+     "ExprOpFuncs::mult<I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::lt<I64>),
+     "ExprOpFuncs::lt<I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::lte<I64>),
+     "ExprOpFuncs::lte<I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::gt<I64>),
+     "ExprOpFuncs::gt<I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::gte<I64>),
+     "ExprOpFuncs::gte<I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::eq<I64>),
+     "ExprOpFuncs::eq<I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::neq<I64>),
+     "ExprOpFuncs::neq<I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::land<I64>),
+     "ExprOpFuncs::land<I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::lor<I64>),
+     "ExprOpFuncs::lor<I64>"},
     // Unary operators
     {reinterpret_cast<const void*>(&ExprOpFuncs::lnot<F64>),
      "ExprOpFuncs::lnot<F64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::lnot<I64>),
+     "ExprOpFuncs::lnot<I64>"},
     // Cast to F64
     {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<F64, I8>),
      "ExprOpFuncs::safeCast<F64, I8>"},
@@ -247,7 +333,45 @@ const Map<const void*, String> StateMachineAutocoder::opFuncIds =
     {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<F64, F64>),
      "ExprOpFuncs::safeCast<F64, F64>"},
     {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<bool, F64>),
-     "ExprOpFuncs::safeCast<bool, F64>"}
+     "ExprOpFuncs::safeCast<bool, F64>"},
+    // Cast to I64
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<I64, I8>),
+     "ExprOpFuncs::safeCast<I64, I8>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<I64, I16>),
+     "ExprOpFuncs::safeCast<I64, I16>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<I64, I32>),
+     "ExprOpFuncs::safeCast<I64, I32>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<I64, U8>),
+     "ExprOpFuncs::safeCast<I64, U8>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<I64, U16>),
+     "ExprOpFuncs::safeCast<I64, U16>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<I64, U32>),
+     "ExprOpFuncs::safeCast<I64, U32>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<I64, U64>),
+     "ExprOpFuncs::safeCast<I64, U64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<I64, bool>),
+     "ExprOpFuncs::safeCast<I64, bool>"},
+    // Cast from I64
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<I8, I64>),
+     "ExprOpFuncs::safeCast<I8, I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<I16, I64>),
+     "ExprOpFuncs::safeCast<I16, I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<I32, I64>),
+     "ExprOpFuncs::safeCast<I32, I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<I64, I64>),
+     "ExprOpFuncs::safeCast<I64, I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<U8, I64>),
+     "ExprOpFuncs::safeCast<U8, I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<U16, I64>),
+     "ExprOpFuncs::safeCast<U16, I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<U32, I64>),
+     "ExprOpFuncs::safeCast<U32, I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<U64, I64>),
+     "ExprOpFuncs::safeCast<U64, I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<F32, I64>),
+     "ExprOpFuncs::safeCast<F32, I64>"},
+    {reinterpret_cast<const void*>(&ExprOpFuncs::safeCast<bool, I64>),
+     "ExprOpFuncs::safeCast<bool, I64>"}
 };
 
 const Map<IExpression::NodeType, String>
@@ -766,10 +890,11 @@ String StateMachineAutocoder::codeExprStatsNode(
 
     // Define arrays for node ExpressionStats to use.
     a("static %% %%ArrA[%%];", statsTypeInfo.name, nodeId, stats.size());
-    a("static %% %%ArrB[%%];", statsTypeInfo.name, nodeId, stats.size());
+    a("static U32 %%ArrB[%%];", nodeId, (4 * stats.size()));
 
     // Define node ExpressionStats.
     const String statsId = Autocode::format("stats%%", kWs.statsCnt++);
+    kWs.statsObjs.push_back(&stats);
     a("static ExpressionStats<%%> %%(*%%, %%ArrA, %%ArrB, %%);",
       statsTypeInfo.name, statsId, statsExprAddr, nodeId, nodeId, stats.size());
 
@@ -791,25 +916,37 @@ String StateMachineAutocoder::codeExpression(
         return "nullptr";
     }
 
+    // Nodes shared between expressions are only autocoded once.
+    const auto addrIt = kWs.exprNodeAddrs.find(kExpr);
+    if (addrIt != kWs.exprNodeAddrs.end())
+    {
+        return (*addrIt).second;
+    }
+
     Autocode& a = kAutocode;
+    String addr = "(unknown expression node)";
 
     switch (kExpr->nodeType())
     {
         // ConstExprNode
         case IExpression::CONST:
-            return StateMachineAutocoder::codeConstExprNode(kExpr, a, kWs);
+            addr = StateMachineAutocoder::codeConstExprNode(kExpr, a, kWs);
+            break;
 
         // ElementExprNode
         case IExpression::ELEMENT:
-            return StateMachineAutocoder::codeElementExprNode(kExpr, a, kWs);
+            addr = StateMachineAutocoder::codeElementExprNode(kExpr, a, kWs);
+            break;
 
         // BinOpExprNode
         case IExpression::BIN_OP:
-            return StateMachineAutocoder::codeBinOpExprNode(kExpr, a, kWs);
+            addr = StateMachineAutocoder::codeBinOpExprNode(kExpr, a, kWs);
+            break;
 
         // UnaryOpExprNode
         case IExpression::UNARY_OP:
-            return StateMachineAutocoder::codeUnaryOpExprNode(kExpr, a, kWs);
+            addr = StateMachineAutocoder::codeUnaryOpExprNode(kExpr, a, kWs);
+            break;
 
         // IExprStatsNode
         case IExpression::ROLL_AVG:
@@ -817,14 +954,28 @@ String StateMachineAutocoder::codeExpression(
         case IExpression::ROLL_MIN:
         case IExpression::ROLL_MAX:
         case IExpression::ROLL_RANGE:
-            return StateMachineAutocoder::codeExprStatsNode(kExpr, a, kWs);
+            addr = StateMachineAutocoder::codeExprStatsNode(kExpr, a, kWs);
+            break;
+
+        // BytecodeExprNode
+        case IExpression::BYTECODE:
+        {
+            // Autocode the expression tree the bytecode was lowered from.
+            const IBytecodeExprNode* const bcNode =
+                dynamic_cast<const IBytecodeExprNode*>(kExpr);
+            SF_ASSERT(bcNode != nullptr);
+            addr = StateMachineAutocoder::codeExpression(bcNode->src(), a, kWs);
+            break;
+        }
 
         default:
             // Unknown expression node type.
             SF_ASSERT(false);
     }
 
-    return "(unknown expression node)";
+    kWs.exprNodeAddrs[kExpr] = addr;
+
+    return addr;
 }
 
 String StateMachineAutocoder::codeAction(const IAction* const kAction,
@@ -888,47 +1039,74 @@ String StateMachineAutocoder::codeAction(const IAction* const kAction,
     return Autocode::format("&%%", actId);
 }
 
-String StateMachineAutocoder::codeBlock(const StateMachine::Block* const kBlock,
-                                        Autocode& kAutocode,
-                                        StateMachineAutocoder::Workspace& kWs)
+String StateMachineAutocoder::codeLabel(
+    const StateMachine::Instruction* const kLabel,
+    Autocode& kAutocode,
+    StateMachineAutocoder::Workspace& kWs)
 {
-    // Block is null, so represent as a null pointer in the owning structure.
-    if (kBlock == nullptr)
+    // Label is null, so represent as a null pointer in the owning structure.
+    if (kLabel == nullptr)
     {
         return "nullptr";
     }
 
     Autocode& a = kAutocode;
 
-    // Generate a unique ID for the block.
-    const String blockId = Autocode::format("block%%", kWs.blockCnt++);
-
-    // Generate code for the block guard expression.
-    const String guardAddr =
-        StateMachineAutocoder::codeExpression(kBlock->guard, a, kWs);
+    // Generate code for the guards and actions referenced by the label.
+    Vec<String> operandAddrs;
+    for (const StateMachine::Instruction* instr = kLabel;
+         instr->op != StateMachine::Instruction::END;
+         ++instr)
+    {
+        String addr = "nullptr";
+        if (instr->op == StateMachine::Instruction::GUARD)
+        {
+            addr = StateMachineAutocoder::codeExpression(instr->guard, a, kWs);
+        }
+        else if (instr->op == StateMachine::Instruction::ACTION)
+        {
+            addr = StateMachineAutocoder::codeAction(instr->action, a, kWs);
+        }
 
-    // Generate code for if branch block.
-    const String ifAddr =
-        StateMachineAutocoder::codeBlock(kBlock->ifBlock, a, kWs);
+        operandAddrs.push_back(addr);
+    }
 
-    // Generate code for else branch block.
-    const String elseAddr =
-        StateMachineAutocoder::codeBlock(kBlock->elseBlock, a, kWs);
+    // Generate a unique ID for the label.
+    const String labelId = Autocode::format("label%%", kWs.labelCnt++);
 
-    // Generate code for block action.
-    const String actionAddr =
-        StateMachineAutocoder::codeAction(kBlock->action, a, kWs);
+    // Define label instruction array.
+    a("static StateMachine::Instruction %%[] =", labelId);
+    a("{");
+    a.increaseIndent();
 
-    // Generate code for next block.
-    const String nextAddr =
-        StateMachineAutocoder::codeBlock(kBlock->next, a, kWs);
+    for (U32 i = 0; i < operandAddrs.size(); ++i)
+    {
+        const StateMachine::Instruction& instr = kLabel[i];
+        if (instr.op == StateMachine::Instruction::GUARD)
+        {
+            a("{StateMachine::Instruction::GUARD, %%, nullptr, %%},",
+              operandAddrs[i],
+              instr.offset);
+        }
+        else if (instr.op == StateMachine::Instruction::JUMP)
+        {
+            a("{StateMachine::Instruction::JUMP, nullptr, nullptr, %%},",
+              instr.offset);
+        }
+        else
+        {
+            SF_ASSERT(instr.op == StateMachine::Instruction::ACTION);
+            a("{StateMachine::Instruction::ACTION, nullptr, %%, 0},",
+              operandAddrs[i]);
+        }
+    }
 
-    // Define block.
-    a("static StateMachine::Block %%{%%, %%, %%, %%, %%};",
-      blockId, guardAddr, ifAddr, elseAddr, actionAddr, nextAddr);
+    a("{StateMachine::Instruction::END, nullptr, nullptr, 0}");
+    a.decreaseIndent();
+    a("};");
 
-    // Return address of defined block.
-    return Autocode::format("&%%", blockId);
+    // Return address of defined label.
+    return labelId;
 }
 
 void StateMachineAutocoder::codeState(
@@ -942,17 +1120,17 @@ void StateMachineAutocoder::codeState(
 
     a("// State %% config", kState->id);
 
-    // Generate code for entry block.
+    // Generate code for entry label.
     const String entryAddr =
-        StateMachineAutocoder::codeBlock(kState->entry, a, kWs);
+        StateMachineAutocoder::codeLabel(kState->entry, a, kWs);
 
-    // Generate code for step block.
+    // Generate code for step label.
     const String stepAddr =
-        StateMachineAutocoder::codeBlock(kState->step, a, kWs);
+        StateMachineAutocoder::codeLabel(kState->step, a, kWs);
 
-    // Generate code for exit block.
+    // Generate code for exit label.
     const String exitAddr =
-        StateMachineAutocoder::codeBlock(kState->exit, a, kWs);
+        StateMachineAutocoder::codeLabel(kState->exit, a, kWs);
 
     // Define state config.
     a("static StateMachine::StateConfig state%%Config = {%%, %%, %%, %%};",
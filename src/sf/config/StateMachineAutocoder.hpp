@@ -67,11 +67,13 @@ private:
     {
         Ref<const StateMachineAssembly> smAsm; ///< State machine to autocode.
         Set<const IElement*> refElems;         ///< Elements referenced so far.
-        U32 blockCnt;                          ///< Block count.
+        Map<const IExpression*, String> exprNodeAddrs; ///< Coded node addrs.
+        U32 labelCnt;                          ///< Label count.
         U32 exprNodeCnt;                       ///< Expression node count.
         U32 stateCnt;                          ///< State count.
         U32 actCnt;                            ///< Action count.
         U32 statsCnt;                          ///< Expression stats count.
+        Vec<const IExpressionStats*> statsObjs; ///< Coded stats, in order.
     };
 
     ///
@@ -218,15 +220,15 @@ private:
                              StateMachineAutocoder::Workspace& kWs);
 
     ///
-    /// @brief Recursively autocodes a state machine block.
+    /// @brief Autocodes a state machine label as an instruction array.
     ///
-    /// @param[in] kBlock     Block to autocode.
+    /// @param[in] kLabel     Label to autocode, or null if none.
     /// @param[in] kAutocode  Autocode output.
     /// @param[in] kWs        Autocoder workspace.
     ///
     /// @returns Identifier of autocoded object.
     ///
-    static String codeBlock(const StateMachine::Block* const kBlock,
+    static String codeLabel(const StateMachine::Instruction* const kLabel,
                             Autocode& kAutocode,
                             StateMachineAutocoder::Workspace& kWs);
 
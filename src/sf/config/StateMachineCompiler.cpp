@@ -16,10 +16,13 @@
 /// IN THE SOFTWARE.
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
 
 #include "sf/config/ExpressionCompiler.hpp"
 #include "sf/config/LanguageConstants.hpp"
+#include "sf/config/MappedFile.hpp"
 #include "sf/config/StateMachineCompiler.hpp"
 #include "sf/config/StateVectorCompiler.hpp"
 #include "sf/core/Assert.hpp"
@@ -44,11 +47,12 @@ Result StateMachineCompiler::compile(
     Ref<const StateMachineAssembly>& kAsm,
     ErrorInfo* const kErr,
     const String kInitState,
-    const bool kRake)
+    const bool kRake,
+    const ExpressionCompiler::Backend kExprBackend)
 {
-    // Open file input stream.
-    std::ifstream ifs(kFilePath);
-    if (!ifs.is_open())
+    // Map the file into memory.
+    MappedFile file;
+    if (MappedFile::init(kFilePath, file) != SUCCESS)
     {
         if (kErr != nullptr)
         {
@@ -65,13 +69,23 @@ Result StateMachineCompiler::compile(
         kErr->filePath = kFilePath;
     }
 
-    // Send input stream into the next compilation phase.
-    return StateMachineCompiler::compile(ifs,
+    // Tokenize and parse the mapped file.
+    Ref<const StateMachineParse> parse;
+    const Result res = Tokenizer::parse<StateMachineParser>(
+        file.data(), file.size(), parse, kErr, gErrText);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    // Send parse into the next compilation phase.
+    return StateMachineCompiler::compile(parse,
                                          kSvAsm,
                                          kAsm,
                                          kErr,
                                          kInitState,
-                                         kRake);
+                                         kRake,
+                                         kExprBackend);
 }
 
 Result StateMachineCompiler::compile(
@@ -80,29 +94,17 @@ Result StateMachineCompiler::compile(
     Ref<const StateMachineAssembly>& kAsm,
     ErrorInfo* const kErr,
     const String kInitState,
-    const bool kRake)
+    const bool kRake,
+    const ExpressionCompiler::Backend kExprBackend)
 {
-    // Tokenize the input stream.
-    Vec<Token> toks;
-    Result res = Tokenizer::tokenize(kIs, toks, kErr);
-    if (res != SUCCESS)
-    {
-        if (kErr != nullptr)
-        {
-            kErr->text = gErrText;
-        }
-        return res;
-    }
-
-    // Parse the state machine config.
+    // Read the input stream and tokenize and parse it.
+    const String src((std::istreambuf_iterator<char>(kIs)),
+                     std::istreambuf_iterator<char>());
     Ref<const StateMachineParse> parse;
-    res = StateMachineParser::parse(toks, parse, kErr);
+    const Result res = Tokenizer::parse<StateMachineParser>(
+        src.data(), src.size(), parse, kErr, gErrText);
     if (res != SUCCESS)
     {
-        if (kErr != nullptr)
-        {
-            kErr->text = gErrText;
-        }
         return res;
     }
 
@@ -112,7 +114,8 @@ Result StateMachineCompiler::compile(
                                          kAsm,
                                          kErr,
                                          kInitState,
-                                         kRake);
+                                         kRake,
+                                         kExprBackend);
 }
 
 Result StateMachineCompiler::compile(
@@ -121,7 +124,8 @@ Result StateMachineCompiler::compile(
     Ref<const StateMachineAssembly>& kAsm,
     ErrorInfo* const kErr,
     const String kInitState,
-    const bool kRake)
+    const bool kRake,
+    const ExpressionCompiler::Backend kExprBackend)
 {
     // Check that state machine parse is non-null.
     if (kParse == nullptr)
@@ -132,6 +136,9 @@ Result StateMachineCompiler::compile(
     // Initialize a blank workspace for the compilation.
     StateMachineAssembly::Workspace ws;
     ws.raked = false;
+    ws.exprBackend = kExprBackend;
+    ws.arena.reset(new Arena());
+    ws.exprCache.reset(new ExpressionCache(ws.arena));
 
     // Put the state machine parse in the workspace so that it can be recalled
     // later.
@@ -177,22 +184,45 @@ Result StateMachineCompiler::compile(
         ws.stateIds[stateName] = (i + 1);
     }
 
-    // Compile each state machine state.
-    for (const StateMachineParse::StateParse& state : kParse->states)
+    // Compile each state machine state and note which states use each
+    // expression stats.
+    Map<const IExpressionStats*, Vec<U32>> statsStates;
+    for (U32 i = 0; i < kParse->states.size(); ++i)
     {
-        res = StateMachineCompiler::compileState(state, ws, kErr);
+        const U32 exprAsmCnt = ws.exprAsms.size();
+        res = StateMachineCompiler::compileState(kParse->states[i], ws, kErr);
         if (res != SUCCESS)
         {
             return res;
         }
+
+        Set<const IExpressionStats*> stateStats;
+        for (U32 j = exprAsmCnt; j < ws.exprAsms.size(); ++j)
+        {
+            StateMachineCompiler::collectStats(ws.exprAsms[j]->root().get(),
+                                               stateStats);
+        }
+
+        for (const IExpressionStats* const stats : stateStats)
+        {
+            statsStates[stats].push_back(i + 1);
+        }
     }
 
     // Collect expression stats needed by all state machine expressions into a
-    // vector.
+    // vector, along with whether each keeps sampling while inactive.
     Vec<Ref<IExpressionStats>> allExprStats;
+    Map<const IExpressionStats*, bool> statsSampleInactive;
     for (const Ref<const ExpressionAssembly> exprAsm : ws.exprAsms)
     {
         const Vec<Ref<IExpressionStats>> exprAsmStats = exprAsm->stats();
+        const Vec<bool> exprAsmSampleInactive = exprAsm->statsSampleInactive();
+        SF_SAFE_ASSERT(exprAsmStats.size() == exprAsmSampleInactive.size());
+        for (U32 i = 0; i < exprAsmStats.size(); ++i)
+        {
+            statsSampleInactive[exprAsmStats[i].get()] =
+                exprAsmSampleInactive[i];
+        }
         allExprStats.insert(allExprStats.end(),
                             exprAsmStats.begin(),
                             exprAsmStats.end());
@@ -205,6 +235,21 @@ Result StateMachineCompiler::compile(
         ws.exprStatArr->push_back(exprStats.get());
     }
 
+    // Allocate array of expression stats dependencies. By default, stats keep
+    // sampling while inactive so that rolling windows contain the same values
+    // as if they were updated every step; only their aggregation is deferred.
+    // Stats functions may opt out of this with their third argument.
+    ws.statsDeps.reset(new Vec<StateMachine::StatsDeps>());
+    for (const IExpressionStats* const exprStats : *ws.exprStatArr)
+    {
+        const Vec<U32>& statsStateIds = statsStates[exprStats];
+        U32* const states =
+            ws.arena->createArray<U32>(statsStateIds.size() + 1);
+        std::copy(statsStateIds.begin(), statsStateIds.end(), states);
+        states[statsStateIds.size()] = StateMachine::NO_STATE;
+        ws.statsDeps->push_back({states, statsSampleInactive[exprStats]});
+    }
+
     // Add expression stats array null terminator required by state machine.
     ws.exprStatArr->push_back(nullptr);
 
@@ -232,7 +277,8 @@ Result StateMachineCompiler::compile(
         static_cast<Element<U64>*>(ws.elems[LangConst::elemStateTime]),
         static_cast<Element<U64>*>(ws.elems[LangConst::elemGlobalTime]),
         ws.stateConfigs->data(),
-        ws.exprStatArr->data()
+        ws.exprStatArr->data(),
+        ws.statsDeps->data()
     };
 
     // Set initial state as specified.
@@ -300,8 +346,43 @@ Ref<const StateMachineParse> StateMachineAssembly::parse() const
     return mWs.smParse;
 }
 
+Ref<const ExpressionCache> StateMachineAssembly::exprCache() const
+{
+    return mWs.exprCache;
+}
+
 /////////////////////////////////// Private ////////////////////////////////////
 
+void StateMachineCompiler::collectStats(const IExpression* const kNode,
+                                        Set<const IExpressionStats*>& kStats)
+{
+    if (kNode == nullptr)
+    {
+        return;
+    }
+
+    const IOpExprNode* const opNode = dynamic_cast<const IOpExprNode*>(kNode);
+    const IExprStatsNode* const statsNode =
+        dynamic_cast<const IExprStatsNode*>(kNode);
+    const IBytecodeExprNode* const bcNode =
+        dynamic_cast<const IBytecodeExprNode*>(kNode);
+    if (opNode != nullptr)
+    {
+        StateMachineCompiler::collectStats(opNode->lhs(), kStats);
+        StateMachineCompiler::collectStats(opNode->rhs(), kStats);
+    }
+    else if (statsNode != nullptr)
+    {
+        kStats.insert(&statsNode->stats());
+        StateMachineCompiler::collectStats(&statsNode->stats().expr(),
+                                           kStats);
+    }
+    else if (bcNode != nullptr)
+    {
+        StateMachineCompiler::collectStats(bcNode->src(), kStats);
+    }
+}
+
 bool StateMachineCompiler::stateNameReserved(const Token& kTokSection)
 {
     return ((kTokSection.str == LangConst::sectionAllStates)
@@ -793,9 +874,12 @@ Result StateMachineCompiler::compileAssignmentAction(
     const Ref<const StateMachineParse::ActionParse> kParse,
     const Map<String, IElement*>& kBindings,
     const Set<String>& kReadOnlyElems,
-    Ref<IAction>& kAction,
+    Arena& kArena,
+    IAction*& kAction,
     Ref<const ExpressionAssembly>& kRhsAsm,
-    ErrorInfo* const kErr)
+    ErrorInfo* const kErr,
+    const ExpressionCompiler::Backend kExprBackend,
+    const Ref<ExpressionCache> kExprCache)
 {
     SF_SAFE_ASSERT(kParse != nullptr);
 
@@ -824,7 +908,9 @@ Result StateMachineCompiler::compileAssignmentAction(
                                                    kBindings,
                                                    elemObj->type(),
                                                    kRhsAsm,
-                                                   kErr);
+                                                   kErr,
+                                                   kExprBackend,
+                                                   kExprCache);
     if (res != SUCCESS)
     {
         // Override error text set by expression compiler for consistent state
@@ -846,79 +932,79 @@ Result StateMachineCompiler::compileAssignmentAction(
     {
         case ElementType::INT8:
             SF_SAFE_ASSERT(kRhsAsm->root()->type() == ElementType::INT8);
-            kAction.reset(new AssignmentAction<I8>(
+            kAction = kArena.create<AssignmentAction<I8>>(
                 *static_cast<Element<I8>*>(elemObj),
-                *dynamic_cast<IExprNode<I8>*>(kRhsAsm->root().get())));
+                *dynamic_cast<IExprNode<I8>*>(kRhsAsm->root().get()));
             break;
 
         case ElementType::INT16:
             SF_SAFE_ASSERT(kRhsAsm->root()->type() == ElementType::INT16);
-            kAction.reset(new AssignmentAction<I16>(
+            kAction = kArena.create<AssignmentAction<I16>>(
                 *static_cast<Element<I16>*>(elemObj),
-                *dynamic_cast<IExprNode<I16>*>(kRhsAsm->root().get())));
+                *dynamic_cast<IExprNode<I16>*>(kRhsAsm->root().get()));
             break;
 
         case ElementType::INT32:
             SF_SAFE_ASSERT(kRhsAsm->root()->type() == ElementType::INT32);
-            kAction.reset(new AssignmentAction<I32>(
+            kAction = kArena.create<AssignmentAction<I32>>(
                 *static_cast<Element<I32>*>(elemObj),
-                *dynamic_cast<IExprNode<I32>*>(kRhsAsm->root().get())));
+                *dynamic_cast<IExprNode<I32>*>(kRhsAsm->root().get()));
             break;
 
         case ElementType::INT64:
             SF_SAFE_ASSERT(kRhsAsm->root()->type() == ElementType::INT64);
-            kAction.reset(new AssignmentAction<I64>(
+            kAction = kArena.create<AssignmentAction<I64>>(
                 *static_cast<Element<I64>*>(elemObj),
-                *dynamic_cast<IExprNode<I64>*>(kRhsAsm->root().get())));
+                *dynamic_cast<IExprNode<I64>*>(kRhsAsm->root().get()));
             break;
 
         case ElementType::UINT8:
             SF_SAFE_ASSERT(kRhsAsm->root()->type() == ElementType::UINT8);
-            kAction.reset(new AssignmentAction<U8>(
+            kAction = kArena.create<AssignmentAction<U8>>(
                 *static_cast<Element<U8>*>(elemObj),
-                *dynamic_cast<IExprNode<U8>*>(kRhsAsm->root().get())));
+                *dynamic_cast<IExprNode<U8>*>(kRhsAsm->root().get()));
             break;
 
         case ElementType::UINT16:
             SF_SAFE_ASSERT(kRhsAsm->root()->type() == ElementType::UINT16);
-            kAction.reset(new AssignmentAction<U16>(
+            kAction = kArena.create<AssignmentAction<U16>>(
                 *static_cast<Element<U16>*>(elemObj),
-                *dynamic_cast<IExprNode<U16>*>(kRhsAsm->root().get())));
+                *dynamic_cast<IExprNode<U16>*>(kRhsAsm->root().get()));
             break;
 
         case ElementType::UINT32:
             SF_SAFE_ASSERT(kRhsAsm->root()->type() == ElementType::UINT32);
-            kAction.reset(new AssignmentAction<U32>(
+            kAction = kArena.create<AssignmentAction<U32>>(
                 *static_cast<Element<U32>*>(elemObj),
-                *dynamic_cast<IExprNode<U32>*>(kRhsAsm->root().get())));
+                *dynamic_cast<IExprNode<U32>*>(kRhsAsm->root().get()));
             break;
 
         case ElementType::UINT64:
             SF_SAFE_ASSERT(kRhsAsm->root()->type() == ElementType::UINT64);
-            kAction.reset(new AssignmentAction<U64>(
+            kAction = kArena.create<AssignmentAction<U64>>(
                 *static_cast<Element<U64>*>(elemObj),
-                *dynamic_cast<IExprNode<U64>*>(kRhsAsm->root().get())));
+                *dynamic_cast<IExprNode<U64>*>(kRhsAsm->root().get()));
             break;
 
         case ElementType::FLOAT32:
             SF_SAFE_ASSERT(kRhsAsm->root()->type() == ElementType::FLOAT32);
-            kAction.reset(new AssignmentAction<F32>(
+            kAction = kArena.create<AssignmentAction<F32>>(
                 *static_cast<Element<F32>*>(elemObj),
-                *dynamic_cast<IExprNode<F32>*>(kRhsAsm->root().get())));
+                *dynamic_cast<IExprNode<F32>*>(kRhsAsm->root().get()));
             break;
 
         case ElementType::FLOAT64:
             SF_SAFE_ASSERT(kRhsAsm->root()->type() == ElementType::FLOAT64);
-            kAction.reset(new AssignmentAction<F64>(
+            kAction = kArena.create<AssignmentAction<F64>>(
                 *static_cast<Element<F64>*>(elemObj),
-                *dynamic_cast<IExprNode<F64>*>(kRhsAsm->root().get())));
+                *dynamic_cast<IExprNode<F64>*>(kRhsAsm->root().get()));
             break;
 
         case ElementType::BOOL:
             SF_SAFE_ASSERT(kRhsAsm->root()->type() == ElementType::BOOL);
-            kAction.reset(new AssignmentAction<bool>(
+            kAction = kArena.create<AssignmentAction<bool>>(
                 *static_cast<Element<bool>*>(elemObj),
-                *dynamic_cast<IExprNode<bool>*>(kRhsAsm->root().get())));
+                *dynamic_cast<IExprNode<bool>*>(kRhsAsm->root().get()));
             break;
 
         default:
@@ -933,7 +1019,7 @@ Result StateMachineCompiler::compileAction(
     const Ref<const StateMachineParse::ActionParse> kParse,
     StateMachineAssembly::Workspace& kWs,
     const bool kInExitLabel,
-    Ref<IAction>& kAction,
+    IAction*& kAction,
     ErrorInfo* const kErr)
 {
     SF_SAFE_ASSERT(kParse != nullptr);
@@ -947,9 +1033,12 @@ Result StateMachineCompiler::compileAction(
         res = StateMachineCompiler::compileAssignmentAction(kParse,
                                                             kWs.elems,
                                                             kWs.readOnlyElems,
+                                                            *kWs.arena,
                                                             kAction,
                                                             rhsAsm,
-                                                            kErr);
+                                                            kErr,
+                                                            kWs.exprBackend,
+                                                            kWs.exprCache);
         if (res != SUCCESS)
         {
             return res;
@@ -982,12 +1071,9 @@ Result StateMachineCompiler::compileAction(
 
         // Create transition action with destination state.
         const U32 destState = (*stateIdIt).second;
-        kAction.reset(new TransitionAction(destState));
+        kAction = kWs.arena->create<TransitionAction>(destState);
     }
 
-    // Add compiled action to the workspace.
-    kWs.actions.push_back(kAction);
-
     return SUCCESS;
 }
 
@@ -995,7 +1081,7 @@ Result StateMachineCompiler::compileBlock(
     const Ref<const StateMachineParse::BlockParse> kParse,
     StateMachineAssembly::Workspace& kWs,
     const bool kInExitLabel,
-    Ref<StateMachine::Block>& kBlock,
+    Vec<StateMachine::Instruction>& kLabel,
     ErrorInfo* const kErr)
 {
     SF_SAFE_ASSERT(kParse != nullptr);
@@ -1020,14 +1106,6 @@ Result StateMachineCompiler::compileBlock(
         return E_SMC_STOP;
     }
 
-    // Allocate new block and add to workspace.
-    kBlock.reset(new StateMachine::Block{nullptr,
-                                         nullptr,
-                                         nullptr,
-                                         nullptr,
-                                         nullptr});
-    kWs.blocks.push_back(kBlock);
-
     Result res = SUCCESS;
     if (kParse->guard != nullptr)
     {
@@ -1037,7 +1115,9 @@ Result StateMachineCompiler::compileBlock(
                                           kWs.elems,
                                           ElementType::BOOL,
                                           guardAsm,
-                                          kErr);
+                                          kErr,
+                                          kWs.exprBackend,
+                                          kWs.exprCache);
         if (res != SUCCESS)
         {
             // Override error text set by expression compiler for consistent
@@ -1053,55 +1133,68 @@ Result StateMachineCompiler::compileBlock(
         // Add compiled expression to workspace.
         kWs.exprAsms.push_back(guardAsm);
 
-        // Put compiled guard raw pointer in owning block.
+        // Emit guard instruction. Its jump offset is patched once the size
+        // of the if branch is known.
         SF_SAFE_ASSERT(guardAsm != nullptr);
         SF_SAFE_ASSERT(guardAsm->root() != nullptr);
         SF_SAFE_ASSERT(guardAsm->root()->type() == ElementType::BOOL);
-        kBlock->guard = dynamic_cast<IExprNode<bool>*>(guardAsm->root().get());
+        const U32 guardIdx = static_cast<U32>(kLabel.size());
+        kLabel.push_back(
+            {StateMachine::Instruction::GUARD,
+             dynamic_cast<IExprNode<bool>*>(guardAsm->root().get()),
+             nullptr,
+             0});
 
         if (kParse->ifBlock != nullptr)
         {
             // Compile if branch block.
-            Ref<StateMachine::Block> block;
             res = StateMachineCompiler::compileBlock(kParse->ifBlock,
                                                      kWs,
                                                      kInExitLabel,
-                                                     block,
+                                                     kLabel,
                                                      kErr);
             if (res != SUCCESS)
             {
                 return res;
             }
-
-            // Put compiled block raw pointer in owning block.
-            SF_SAFE_ASSERT(block != nullptr);
-            kBlock->ifBlock = block.get();
         }
 
         if (kParse->elseBlock != nullptr)
         {
+            // Emit jump over the else branch at the end of the if branch, so
+            // that a false guard jumps to the start of the else branch.
+            const U32 jumpIdx = static_cast<U32>(kLabel.size());
+            kLabel.push_back(
+                {StateMachine::Instruction::JUMP, nullptr, nullptr, 0});
+            kLabel[guardIdx].offset = (static_cast<U32>(kLabel.size())
+                                       - guardIdx);
+
             // Compile else branch block.
-            Ref<StateMachine::Block> block;
             res = StateMachineCompiler::compileBlock(kParse->elseBlock,
                                                      kWs,
                                                      kInExitLabel,
-                                                     block,
+                                                     kLabel,
                                                      kErr);
             if (res != SUCCESS)
             {
                 return res;
             }
 
-            // Put compiled block raw pointer in owning block.
-            SF_SAFE_ASSERT(block != nullptr);
-            kBlock->elseBlock = block.get();
+            kLabel[jumpIdx].offset = (static_cast<U32>(kLabel.size())
+                                      - jumpIdx);
+        }
+        else
+        {
+            // A false guard jumps past the if branch.
+            kLabel[guardIdx].offset = (static_cast<U32>(kLabel.size())
+                                       - guardIdx);
         }
     }
 
     if (kParse->action != nullptr)
     {
         // Compile action.
-        Ref<IAction> action;
+        IAction* action = nullptr;
         res = StateMachineCompiler::compileAction(kParse->action,
                                                   kWs,
                                                   kInExitLabel,
@@ -1112,30 +1205,54 @@ Result StateMachineCompiler::compileBlock(
             return res;
         }
 
-        // Put compiled action raw pointer in block struct.
+        // Emit action instruction.
         SF_SAFE_ASSERT(action != nullptr);
-        kBlock->action = action.get();
+        kLabel.push_back(
+            {StateMachine::Instruction::ACTION, nullptr, action, 0});
     }
 
     if (kParse->next != nullptr)
     {
         // Compile next block.
-        Ref<StateMachine::Block> block;
         res = StateMachineCompiler::compileBlock(kParse->next,
                                                  kWs,
                                                  kInExitLabel,
-                                                 block,
+                                                 kLabel,
                                                  kErr);
         if (res != SUCCESS)
         {
             return res;
         }
+    }
 
-        // Put compiled block raw pointer in owning block.
-        SF_SAFE_ASSERT(block != nullptr);
-        kBlock->next = block.get();
+    return SUCCESS;
+}
+
+Result StateMachineCompiler::compileLabel(
+    const Ref<const StateMachineParse::BlockParse> kParse,
+    StateMachineAssembly::Workspace& kWs,
+    const bool kInExitLabel,
+    StateMachine::Instruction*& kLabel,
+    ErrorInfo* const kErr)
+{
+    // Compile label blocks.
+    Vec<StateMachine::Instruction> label;
+    const Result res = StateMachineCompiler::compileBlock(kParse,
+                                                          kWs,
+                                                          kInExitLabel,
+                                                          label,
+                                                          kErr);
+    if (res != SUCCESS)
+    {
+        return res;
     }
 
+    // Add END instruction required by state machine, and move the label into
+    // the arena.
+    label.push_back({StateMachine::Instruction::END, nullptr, nullptr, 0});
+    kLabel = kWs.arena->createArray<StateMachine::Instruction>(label.size());
+    std::copy(label.begin(), label.end(), kLabel);
+
     return SUCCESS;
 }
 
@@ -1155,7 +1272,8 @@ Result StateMachineCompiler::compileState(
     }
 
     // State ID is the current number of compiled states + 1 so that state IDs
-    // begin at 1.
+    // begin at 1. IDs are then dense in state config array order, which lets
+    // the state machine look up states in constant time.
     StateMachine::StateConfig stateConfig =
     {
         static_cast<U32>(kWs.stateConfigs->size() + 1),
@@ -1168,58 +1286,43 @@ Result StateMachineCompiler::compileState(
     if (kParse.entry != nullptr)
     {
         // Compile entry label.
-        Ref<StateMachine::Block> entryBlock;
-        res = StateMachineCompiler::compileBlock(kParse.entry,
+        res = StateMachineCompiler::compileLabel(kParse.entry,
                                                  kWs,
                                                  false,
-                                                 entryBlock,
+                                                 stateConfig.entry,
                                                  kErr);
         if (res != SUCCESS)
         {
             return res;
         }
-
-        // Put compiled block raw pointer in owning state.
-        SF_SAFE_ASSERT(entryBlock != nullptr);
-        stateConfig.entry = entryBlock.get();
     }
 
     if (kParse.step != nullptr)
     {
         // Compile step label.
-        Ref<StateMachine::Block> stepBlock;
-        res = StateMachineCompiler::compileBlock(kParse.step,
+        res = StateMachineCompiler::compileLabel(kParse.step,
                                                  kWs,
                                                  false,
-                                                 stepBlock,
+                                                 stateConfig.step,
                                                  kErr);
         if (res != SUCCESS)
         {
             return res;
         }
-
-        // Put compiled block raw pointer in owning state.
-        SF_SAFE_ASSERT(stepBlock != nullptr);
-        stateConfig.step = stepBlock.get();
     }
 
     if (kParse.exit != nullptr)
     {
         // Compile exit label.
-        Ref<StateMachine::Block> exitBlock;
-        res = StateMachineCompiler::compileBlock(kParse.exit,
+        res = StateMachineCompiler::compileLabel(kParse.exit,
                                                  kWs,
                                                  true,
-                                                 exitBlock,
+                                                 stateConfig.exit,
                                                  kErr);
         if (res != SUCCESS)
         {
             return res;
         }
-
-        // Put compiled block raw pointer in owning state.
-        SF_SAFE_ASSERT(exitBlock != nullptr);
-        stateConfig.exit = exitBlock.get();
     }
 
     // Add state config to workspace.
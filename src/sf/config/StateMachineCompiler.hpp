@@ -23,6 +23,7 @@
 #ifndef SF_STATE_MACHINE_COMPILER_HPP
 #define SF_STATE_MACHINE_COMPILER_HPP
 
+#include "sf/config/Arena.hpp"
 #include "sf/config/ExpressionCompiler.hpp"
 #include "sf/config/StateMachineParser.hpp"
 #include "sf/config/StateVectorCompiler.hpp"
@@ -71,16 +72,29 @@ public:
     /// @remark This is mostly for testing purposes and should not be accessed
     /// in production.
     ///
-    /// @returns State machine parse.
+    /// @returns State machine parse, or null if the state machine was loaded
+    /// from an AssemblyImage.
     ///
     Ref<const StateMachineParse> parse() const;
 
+    ///
+    /// @brief Gets the cache used to compile the state machine expressions.
+    ///
+    /// @remark This is mostly for reporting and testing purposes.
+    ///
+    /// @returns Expression cache, or null if the state machine was loaded from
+    /// an AssemblyImage.
+    ///
+    Ref<const ExpressionCache> exprCache() const;
+
 private:
 
     friend class StateMachineCompiler;
 
     friend class StateMachineAutocoder;
 
+    friend class AssemblyImage;
+
     friend class StateScriptCompiler;
 
     friend class StateScriptAssembly;
@@ -90,6 +104,12 @@ private:
     ///
     struct Workspace final
     {
+        ///
+        /// @brief Arena containing actions, labels, expression nodes and other
+        /// small objects making up the state machine.
+        ///
+        Ref<Arena> arena;
+
         ///
         /// @brief Map of variable identifiers to state vector elements.
         ///
@@ -126,19 +146,15 @@ private:
         Ref<Vec<StateMachine::StateConfig>> stateConfigs;
 
         ///
-        /// @brief Blocks in the state machine.
-        ///
-        Vec<Ref<StateMachine::Block>> blocks;
-
-        ///
-        /// @brief Actions in the state machine.
+        /// @brief Expression stats in the state machine.
         ///
-        Vec<Ref<IAction>> actions;
+        Ref<Vec<IExpressionStats*>> exprStatArr;
 
         ///
-        /// @brief Expression stats in the state machine.
+        /// @brief Dependencies of each expression stats, parallel to
+        /// exprStatArr.
         ///
-        Ref<Vec<IExpressionStats*>> exprStatArr;
+        Ref<Vec<StateMachine::StatsDeps>> statsDeps;
 
         ///
         /// @brief Main state machine object.
@@ -159,6 +175,17 @@ private:
         /// @brief If the state machine assembly has been raked.
         ///
         bool raked;
+
+        ///
+        /// @brief Backend used to compile state machine expressions.
+        ///
+        ExpressionCompiler::Backend exprBackend;
+
+        ///
+        /// @brief Cache shared by all state machine guard and action
+        /// expressions.
+        ///
+        Ref<ExpressionCache> exprCache;
     };
 
     ///
@@ -201,6 +228,8 @@ public:
     ///                         meaning all data not needed to run the state
     ///                         machine is deallocated. This should always be
     ///                         true in production.
+    /// @param[in]  kExprBackend  Backend used to compile state machine
+    ///                           expressions.
     ///
     /// @retval SUCCESS           Successfully compiled state machine.
     /// @retval E_SMC_FILE        Failed to open state machine config file.
@@ -227,7 +256,9 @@ public:
                           Ref<const StateMachineAssembly>& kAsm,
                           ErrorInfo* const kErr,
                           const String kInitState = FIRST_STATE,
-                          const bool kRake = true);
+                          const bool kRake = true,
+                          const ExpressionCompiler::Backend kExprBackend =
+                              ExpressionCompiler::TREE);
 
     ///
     /// @brief Compiler entry point, taking an input stream with the state
@@ -240,7 +271,9 @@ public:
                           Ref<const StateMachineAssembly>& kAsm,
                           ErrorInfo* const kErr,
                           const String kInitState = FIRST_STATE,
-                          const bool kRake = true);
+                          const bool kRake = true,
+                          const ExpressionCompiler::Backend kExprBackend =
+                              ExpressionCompiler::TREE);
 
     ///
     /// @brief Compiler entry point, taking a state machine parse.
@@ -252,7 +285,9 @@ public:
                           Ref<const StateMachineAssembly>& kAsm,
                           ErrorInfo* const kErr,
                           const String kInitState = FIRST_STATE,
-                          const bool kRake = true);
+                          const bool kRake = true,
+                          const ExpressionCompiler::Backend kExprBackend =
+                              ExpressionCompiler::TREE);
 
     StateMachineCompiler() = delete;
 
@@ -269,6 +304,16 @@ private:
     ///
     static bool stateNameReserved(const Token& kTokSection);
 
+    ///
+    /// @brief Collects the expression stats evaluated by an expression,
+    /// including stats nested in the expressions of other stats.
+    ///
+    /// @param[in]      kNode   Expression root node, or null.
+    /// @param[in, out] kStats  Set to add stats to.
+    ///
+    static void collectStats(const IExpression* const kNode,
+                             Set<const IExpressionStats*>& kStats);
+
     ///
     /// @brief Validates the state vector section.
     ///
@@ -338,9 +383,13 @@ private:
     /// @param[in]  kParse          Action parse to compile.
     /// @param[in]  kBindings       Element symbol table.
     /// @param[in]  kReadOnlyElems  Set of read-only element names.
+    /// @param[in]  kArena          Arena to allocate action in.
     /// @param[out] kAction         On success, points to compiled action.
     /// @param[in]  kRhsAsm         RHS of assignment.
     /// @param[out] kErr            On error, if non-null, contains error info.
+    /// @param[in]  kExprBackend    Backend used to compile RHS expression.
+    /// @param[in]  kExprCache      Cache used to compile RHS expression, or
+    ///                             null if none.
     ///
     /// @returns See StateMachineCompiler::compile().
     ///
@@ -348,9 +397,13 @@ private:
         const Ref<const StateMachineParse::ActionParse> kParse,
         const Map<String, IElement*>& kBindings,
         const Set<String>& kReadOnlyElems,
-        Ref<IAction>& kAction,
+        Arena& kArena,
+        IAction*& kAction,
         Ref<const ExpressionAssembly>& kRhsAsm,
-        ErrorInfo* const kErr);
+        ErrorInfo* const kErr,
+        const ExpressionCompiler::Backend kExprBackend =
+            ExpressionCompiler::TREE,
+        const Ref<ExpressionCache> kExprCache = nullptr);
 
     ///
     /// @brief Compiles an action.
@@ -367,16 +420,18 @@ private:
         const Ref<const StateMachineParse::ActionParse> kParse,
         StateMachineAssembly::Workspace& kWs,
         const bool kInExitLabel,
-        Ref<IAction>& kAction,
+        IAction*& kAction,
         ErrorInfo* const kErr);
 
     ///
-    /// @brief Recursively compiles a block.
+    /// @brief Recursively compiles a block into instructions appended to a
+    /// label. Guards are compiled to forward jumps over their branches, so the
+    /// block tree is flattened into a contiguous array.
     ///
     /// @param[in]  kParse        Block parse to compile.
     /// @param[in]  kWs           Compiler workspace.
-    /// @param[in]  kInExitLabel  If action is in an exit block.
-    /// @param[out] kAction       On success, points to compiled action.
+    /// @param[in]  kInExitLabel  If block is in an exit label.
+    /// @param[out] kLabel        Label to append compiled instructions to.
     /// @param[out] kErr          On error, if non-null, contains error info.
     ///
     /// @returns See StateMachineCompiler::compile().
@@ -385,7 +440,26 @@ private:
         const Ref<const StateMachineParse::BlockParse> kParse,
         StateMachineAssembly::Workspace& kWs,
         const bool kInExitLabel,
-        Ref<StateMachine::Block>& kBlock,
+        Vec<StateMachine::Instruction>& kLabel,
+        ErrorInfo* const kErr);
+
+    ///
+    /// @brief Compiles a label into an END-terminated instruction array owned
+    /// by the workspace.
+    ///
+    /// @param[in]  kParse        Label root block parse to compile.
+    /// @param[in]  kWs           Compiler workspace.
+    /// @param[in]  kInExitLabel  If label is an exit label.
+    /// @param[out] kLabel        On success, points to first instruction.
+    /// @param[out] kErr          On error, if non-null, contains error info.
+    ///
+    /// @returns See StateMachineCompiler::compile().
+    ///
+    static Result compileLabel(
+        const Ref<const StateMachineParse::BlockParse> kParse,
+        StateMachineAssembly::Workspace& kWs,
+        const bool kInExitLabel,
+        StateMachine::Instruction*& kLabel,
         ErrorInfo* const kErr);
 
     ///
@@ -16,10 +16,12 @@
 /// IN THE SOFTWARE.
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <fstream>
 #include <cstdlib>
 #include <cmath>
+#include <iterator>
+#include <sstream>
 
+#include "sf/config/MappedFile.hpp"
 #include "sf/config/StateScriptCompiler.hpp"
 #include "sf/core/Assert.hpp"
 #include "sf/pal/Clock.hpp"
@@ -43,9 +45,9 @@ Result StateScriptCompiler::compile(
     Ref<StateScriptAssembly>& kAsm,
     ErrorInfo* const kErr)
 {
-    // Open file input stream.
-    std::ifstream ifs(kFilePath);
-    if (!ifs.is_open())
+    // Map the file into memory.
+    MappedFile file;
+    if (MappedFile::init(kFilePath, file) != SUCCESS)
     {
         if (kErr != nullptr)
         {
@@ -62,8 +64,17 @@ Result StateScriptCompiler::compile(
         kErr->filePath = kFilePath;
     }
 
-    // Send input stream into the next compilation phase.
-    return StateScriptCompiler::compile(ifs, kSmAsm, kAsm, kErr);
+    // Tokenize and parse the mapped file.
+    Ref<const StateScriptParse> parse;
+    const Result res = Tokenizer::parse<StateScriptParser>(
+        file.data(), file.size(), parse, kErr, gErrText);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    // Send parse into the next compilation phase.
+    return StateScriptCompiler::compile(parse, kSmAsm, kAsm, kErr);
 }
 
 Result StateScriptCompiler::compile(
@@ -72,29 +83,14 @@ Result StateScriptCompiler::compile(
     Ref<StateScriptAssembly>& kAsm,
     ErrorInfo* const kErr)
 {
-    // Tokenize the input stream.
-    Vec<Token> toks;
-    Result res = Tokenizer::tokenize(kIs, toks, kErr);
-    if (res != SUCCESS)
-    {
-        if (kErr != nullptr)
-        {
-            kErr->text = gErrText;
-        }
-
-        return res;
-    }
-
-    // Parse the state script.
+    // Read the input stream and tokenize and parse it.
+    const String src((std::istreambuf_iterator<char>(kIs)),
+                     std::istreambuf_iterator<char>());
     Ref<const StateScriptParse> parse;
-    res = StateScriptParser::parse(toks, parse, kErr);
+    const Result res = Tokenizer::parse<StateScriptParser>(
+        src.data(), src.size(), parse, kErr, gErrText);
     if (res != SUCCESS)
     {
-        if (kErr != nullptr)
-        {
-            kErr->text = gErrText;
-        }
-
         return res;
     }
 
@@ -138,6 +134,9 @@ Result StateScriptCompiler::compile(
     // Vector to collect expression assemblies in.
     Vec<Ref<const ExpressionAssembly>> exprAsms;
 
+    // Arena to allocate input actions in. Inputs share ownership of it.
+    const Ref<Arena> arena(new Arena());
+
     // Names of states with a section in the state script.
     Set<String> scriptStates;
 
@@ -396,11 +395,13 @@ Result StateScriptCompiler::compile(
                         nullptr
                     };
                     Ref<const ExpressionAssembly> rhsAsm;
+                    IAction* action = nullptr;
                     res = StateMachineCompiler::compileAssignmentAction(
                         innerBlock->action,
                         kSmAsm->mWs.elems,
                         {},
-                        input.action,
+                        *arena,
+                        action,
                         rhsAsm,
                         kErr);
                     if (res != SUCCESS)
@@ -415,6 +416,7 @@ Result StateScriptCompiler::compile(
                         return res;
                     }
 
+                    input.action = Arena::share(arena, action);
                     exprAsms.push_back(rhsAsm);
                     section.inputs.push_back(input);
                 }
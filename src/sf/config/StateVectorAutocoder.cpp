@@ -38,6 +38,37 @@ Result StateVectorAutocoder::code(std::ostream& kOs,
     SF_ASSERT(svConfig.elems != nullptr);
     SF_ASSERT(svConfig.regions != nullptr);
 
+    // Get state vector options from the parse used to compile the assembly.
+    SF_ASSERT(kSvAsm->parse() != nullptr);
+    const StateVectorParse::Options& opts = kSvAsm->parse()->opts;
+
+    // Collect the names of atomic elements.
+    Set<String> atomicElems;
+    for (const StateVectorParse::RegionParse& regionParse :
+         kSvAsm->parse()->regions)
+    {
+        for (const StateVectorParse::ElementParse& elemParse :
+             regionParse.elems)
+        {
+            if (elemParse.atomic)
+            {
+                atomicElems.insert(elemParse.tokName.str);
+            }
+        }
+    }
+
+    // Get the lock group of each region and count the lock groups. The
+    // autocode defines one lock per group.
+    const Vec<U32>& lockGroups = kSvAsm->regionLockGroups();
+    U32 lockCnt = 0;
+    for (const U32 group : lockGroups)
+    {
+        if (group >= lockCnt)
+        {
+            lockCnt = (group + 1);
+        }
+    }
+
     Autocode a(kOs);
 
     // Add preamble.
@@ -53,6 +84,14 @@ Result StateVectorAutocoder::code(std::ostream& kOs,
 
     // Add includes.
     a("#include \"sf/core/StateVector.hpp\"");
+    if (opts.adaptiveLock)
+    {
+        a("#include \"sf/pal/AdaptiveLock.hpp\"");
+    }
+    else if (opts.lock)
+    {
+        a("#include \"sf/pal/Spinlock.hpp\"");
+    }
     a();
 
     // Use Sf namespace to simplify things.
@@ -83,10 +122,12 @@ Result StateVectorAutocoder::code(std::ostream& kOs,
 
     // Define backing storage struct. Use the `pack` pragma to remove padding
     // between adjacent members as required by the state vector. Since this
-    // struct is static, all state vector elements will initially be 0.
+    // struct is static, all state vector elements will initially be 0. If
+    // there are atomic elements, align the struct so that the compiler-checked
+    // element offsets are naturally aligned addresses.
     a("// State vector backing");
     a("#pragma pack(push, 1)");
-    a("static struct");
+    a((atomicElems.size() > 0) ? "static struct alignas(8)" : "static struct");
     a("{");
     a.increaseIndent();
 
@@ -128,13 +169,27 @@ Result StateVectorAutocoder::code(std::ostream& kOs,
         // Define struct member for element.
         a("%% %%;", elemTypeInfo.name, elem->name);
 
+        // Get the constructor argument for the lock shared by the element and
+        // its region, if any.
+        String lockArg;
+        if (lockGroups.size() > 0)
+        {
+            const U32 group = lockGroups[region - svConfig.regions];
+            lockArg = (opts.seqLock
+                       ? Autocode::format(", seqLock%%", group)
+                       : Autocode::format(", &lock%%", group));
+        }
+
         // Create element object definitions for insertion into autocode later.
+        // Atomic elements take no lock.
+        const bool atomic = (atomicElems.count(elem->name) > 0);
         elemDefs.push_back(
-            Autocode::format("static Element<%%> elem%%(backing.%%.%%);",
+            Autocode::format("static Element<%%> elem%%(backing.%%.%%%%);",
                              elemTypeInfo.name,
                              elem->name,
                              region->name,
-                             elem->name));
+                             elem->name,
+                             (atomic ? ", AtomicAccess()" : lockArg)));
 
         // If the end address of the element is equal to the end address of the
         // region, end the region struct definition.
@@ -147,8 +202,12 @@ Result StateVectorAutocoder::code(std::ostream& kOs,
         {
             // Save region object definition for insertion into autocode later.
             regionDefs.push_back(
-                Autocode::format("static Region region%%(&backing.%%, sizeof(backing.%%));",
-                                 region->name, region->name, region->name));
+                Autocode::format("static Region region%%(&backing.%%, "
+                                 "sizeof(backing.%%)%%);",
+                                 region->name,
+                                 region->name,
+                                 region->name,
+                                 lockArg));
 
             // Close region struct definition.
             a.decreaseIndent();
@@ -163,6 +222,44 @@ Result StateVectorAutocoder::code(std::ostream& kOs,
     a("#pragma pack(pop)");
     a();
 
+    // Define locks, one per lock group. Spinlocks and adaptive locks must be
+    // initialized before use.
+    const char* const lockType =
+        (opts.adaptiveLock ? "AdaptiveLock" : "Spinlock");
+    if (lockCnt > 0)
+    {
+        a("// Locks");
+        for (U32 i = 0; i < lockCnt; ++i)
+        {
+            if (opts.seqLock)
+            {
+                a("static SeqLock seqLock%%;", i);
+            }
+            else
+            {
+                a("static %% lock%%;", lockType, i);
+            }
+        }
+
+        if (!opts.seqLock)
+        {
+            a();
+            a("Result res = SUCCESS;");
+            for (U32 i = 0; i < lockCnt; ++i)
+            {
+                a("res = %%::init(lock%%);", lockType, i);
+                a("if (res != SUCCESS)");
+                a("{");
+                a.increaseIndent();
+                a("return res;");
+                a.decreaseIndent();
+                a("}");
+            }
+        }
+
+        a();
+    }
+
     // Define element objects.
     a("// Elements");
     for (const String& elemDef : elemDefs)
@@ -187,11 +284,13 @@ Result StateVectorAutocoder::code(std::ostream& kOs,
     a("{");
     a.increaseIndent();
 
+    U32 elemCnt = 0;
     for (const StateVector::ElementConfig* elem = svConfig.elems;
          elem->name != nullptr;
          ++elem)
     {
         a("{\"%%\", &elem%%},", elem->name, elem->name);
+        ++elemCnt;
     }
 
     a("{nullptr, nullptr}"); // Null terminator
@@ -205,11 +304,13 @@ Result StateVectorAutocoder::code(std::ostream& kOs,
     a("{");
     a.increaseIndent();
 
+    U32 regionCnt = 0;
     for (const StateVector::RegionConfig* region = svConfig.regions;
          region->name != nullptr;
          ++region)
     {
         a("{\"%%\", &region%%},", region->name, region->name);
+        ++regionCnt;
     }
 
     a("{nullptr, nullptr}"); // Null terminator
@@ -217,8 +318,15 @@ Result StateVectorAutocoder::code(std::ostream& kOs,
     a("};");
     a();
 
+    // Define lookup index storage, which is populated when the state vector
+    // is initialized.
+    a("// Lookup indices");
+    a("static const StateVector::ElementConfig* elemIndex[%%];", elemCnt);
+    a("static const StateVector::RegionConfig* regionIndex[%%];", regionCnt);
+    a();
+
     // Define state vector config and return to caller.
-    a("kSvConfig = {elemConfigs, regionConfigs};");
+    a("kSvConfig = {elemConfigs, regionConfigs, elemIndex, regionIndex};");
     a();
 
     // Add return statement.
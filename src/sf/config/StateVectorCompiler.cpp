@@ -16,8 +16,11 @@
 /// IN THE SOFTWARE.
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <fstream>
+#include <cstring>
+#include <iterator>
+#include <sstream>
 
+#include "sf/config/MappedFile.hpp"
 #include "sf/config/StateVectorCompiler.hpp"
 #include "sf/core/Assert.hpp"
 
@@ -31,15 +34,65 @@ namespace Sf
 ///
 extern const char* const gErrText = "state vector config error";
 
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Allocates an element object. An atomic element takes no lock. Other
+/// elements are guarded by a sequence lock if one is provided, or else by a
+/// lock if one is provided.
+///
+/// @param[in] kArena    Arena to allocate element in.
+/// @param[in] kBacking  Element backing.
+/// @param[in] kAtomic   If the element is accessed atomically.
+/// @param[in] kLock     Element lock, or null if none.
+/// @param[in] kSeqLock  Element sequence lock, or null if none.
+///
+/// @return Element object.
+///
+template<typename T>
+static IElement* newElement(Arena& kArena,
+                            T& kBacking,
+                            const bool kAtomic,
+                            ILock* const kLock,
+                            SeqLock* const kSeqLock)
+{
+    if (kAtomic)
+    {
+        return kArena.create<Element<T>>(kBacking, AtomicAccess());
+    }
+
+    if (kSeqLock != nullptr)
+    {
+        return kArena.create<Element<T>>(kBacking, *kSeqLock);
+    }
+
+    return kArena.create<Element<T>>(kBacking, kLock);
+}
+
+///
+/// @brief Copies a string into an arena.
+///
+/// @param[in] kArena  Arena to copy string into.
+/// @param[in] kStr    String to copy.
+///
+/// @returns Null-terminated copy of string.
+///
+static const char* copyString(Arena& kArena, const String& kStr)
+{
+    char* const cpy = kArena.createArray<char>(kStr.size() + 1);
+    std::memcpy(cpy, kStr.c_str(), (kStr.size() + 1));
+    return cpy;
+}
+
 /////////////////////////////////// Public /////////////////////////////////////
 
 Result StateVectorCompiler::compile(const String kFilePath,
                                     Ref<const StateVectorAssembly>& kAsm,
                                     ErrorInfo* const kErr)
 {
-    // Open file input stream.
-    std::ifstream ifs(kFilePath);
-    if (!ifs.is_open())
+    // Map the file into memory.
+    MappedFile file;
+    if (MappedFile::init(kFilePath, file) != SUCCESS)
     {
         if (kErr != nullptr)
         {
@@ -57,37 +110,31 @@ Result StateVectorCompiler::compile(const String kFilePath,
         kErr->filePath = kFilePath;
     }
 
-    // Send input stream into the next compilation phase.
-    return StateVectorCompiler::compile(ifs, kAsm, kErr);
+    // Tokenize and parse the mapped file.
+    Ref<const StateVectorParse> parse;
+    const Result res = Tokenizer::parse<StateVectorParser>(
+        file.data(), file.size(), parse, kErr, gErrText);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    // Send parse into the next compilation phase.
+    return StateVectorCompiler::compile(parse, kAsm, kErr);
 }
 
 Result StateVectorCompiler::compile(std::istream& kIs,
                                     Ref<const StateVectorAssembly>& kAsm,
                                     ErrorInfo* const kErr)
 {
-    // Tokenize the input stream.
-    Vec<Token> toks;
-    Result res = Tokenizer::tokenize(kIs, toks, kErr);
-    if (res != SUCCESS)
-    {
-        if (kErr != nullptr)
-        {
-            kErr->text = gErrText;
-        }
-
-        return res;
-    }
-
-    // Parse the state vector config.
+    // Read the input stream and tokenize and parse it.
+    const String src((std::istreambuf_iterator<char>(kIs)),
+                     std::istreambuf_iterator<char>());
     Ref<const StateVectorParse> parse;
-    res = StateVectorParser::parse(toks, parse, kErr);
+    const Result res = Tokenizer::parse<StateVectorParser>(
+        src.data(), src.size(), parse, kErr, gErrText);
     if (res != SUCCESS)
     {
-        if (kErr != nullptr)
-        {
-            kErr->text = gErrText;
-        }
-
         return res;
     }
 
@@ -176,12 +223,27 @@ Result StateVectorCompiler::compile(const Ref<const StateVectorParse> kParse,
             }
 
             const TypeInfo& typeInfo = (*typeInfoIt).second;
+
+            // Check that atomic elements are naturally aligned. The backing
+            // is allocated with at least 8-byte alignment, so this depends
+            // only on the element's offset in the state vector.
+            if (elem.atomic && ((svSizeBytes % typeInfo.sizeBytes) != 0))
+            {
+                std::stringstream ss;
+                ss << "atomic element is not " << typeInfo.sizeBytes
+                   << "-byte aligned (offset " << svSizeBytes
+                   << "); reorder elements so that it is";
+                ErrorInfo::set(kErr, elem.tokName, gErrText, ss.str());
+                return E_SVC_ALIGN;
+            }
+
             svSizeBytes += typeInfo.sizeBytes;
         }
     }
 
     // Initialize a blank workspace for the compilation.
     StateVectorAssembly::Workspace ws;
+    ws.arena.reset(new Arena());
 
     // Put the state vector parse in the workspace so that it can be recalled
     // later.
@@ -199,6 +261,11 @@ Result StateVectorCompiler::compile(const Ref<const StateVectorParse> kParse,
     // Set null terminator for region config array required by state vector.
     (*ws.regionConfigs)[regionCnt] = {nullptr, nullptr};
 
+    // Allocate storage for the element and region lookup indices, which the
+    // state vector will populate when it is initialized.
+    ws.elemIndex.reset(new Vec<const StateVector::ElementConfig*>(elemCnt));
+    ws.regionIndex.reset(new Vec<const StateVector::RegionConfig*>(regionCnt));
+
     // Allocate backing storage for state vector. This memory will be
     // automatically zeroed out by the vector implementation, ensuring that
     // state vector elements default to zero. (A vector is used instead of a
@@ -206,17 +273,9 @@ Result StateVectorCompiler::compile(const Ref<const StateVectorParse> kParse,
     // arrays.)
     ws.svBacking.reset(new Vec<U8>(svSizeBytes));
 
-    // Before we start creating element and region objects, create a lock for
-    // them if locking was specified.
-    if (kParse->opts.lock)
-    {
-        ws.lock.reset(new Spinlock());
-        const Result res = Spinlock::init(*ws.lock);
-        if (res != SUCCESS)
-        {
-            return res;
-        }
-    }
+    // Lock group indices by group key, populated as regions are allocated if
+    // locking was specified.
+    Map<String, U32> lockGroups;
 
     // Now to initialize the members of the element and region config arrays.
     // This pointer stores the address of the next element's backing storage
@@ -236,6 +295,24 @@ Result StateVectorCompiler::compile(const Ref<const StateVectorParse> kParse,
         // of the region.
         U8* const regionPtr = bumpPtr;
 
+        // Get the lock for the region and its elements if locking was
+        // specified.
+        ILock* lock = nullptr;
+        SeqLock* seqLock = nullptr;
+        if (kParse->opts.lock || kParse->opts.seqLock)
+        {
+            const Result res = StateVectorCompiler::allocateLock(kParse->opts,
+                                                                 regionParse,
+                                                                 ws,
+                                                                 lockGroups,
+                                                                 lock,
+                                                                 seqLock);
+            if (res != SUCCESS)
+            {
+                return res;
+            }
+        }
+
         // Allocate elements in region and populate element config array.
         for (const StateVectorParse::ElementParse& elemParse :
              regionParse.elems)
@@ -243,6 +320,8 @@ Result StateVectorCompiler::compile(const Ref<const StateVectorParse> kParse,
             const Result res = StateVectorCompiler::allocateElement(
                 elemParse,
                 ws,
+                lock,
+                seqLock,
                 (*ws.elemConfigs)[elemIdx],
                 bumpPtr);
             if (res != SUCCESS)
@@ -253,13 +332,9 @@ Result StateVectorCompiler::compile(const Ref<const StateVectorParse> kParse,
             ++elemIdx;
         }
 
-        // Allocate a copy of the region name and put the raw pointer in the
-        // region config.
-        const Ref<String> regionNameCpy(new String(regionParse.plainName));
-        (*ws.regionConfigs)[regionIdx].name = regionNameCpy->c_str();
-
-        // Add region name to workspace.
-        ws.configStrings.push_back(regionNameCpy);
+        // Allocate a copy of the region name in the arena.
+        const char* const regionName =
+            copyString(*ws.arena, regionParse.plainName);
 
         // Compute the size of the region. Since the element allocations will
         // have bumped the bump pointer to the end of the region, we compute the
@@ -268,18 +343,21 @@ Result StateVectorCompiler::compile(const Ref<const StateVectorParse> kParse,
         const U64 regionSizeBytes = (reinterpret_cast<U64>(bumpPtr)
                                      - reinterpret_cast<U64>(regionPtr));
 
-        // Allocate region object, add it to the workspace, and put raw pointers
-        // to the region name and object in the region config array.
-        const Ref<Region> region(new Region(regionPtr,
-                                            regionSizeBytes,
-                                            ws.lock.get()));
-        ws.regions.push_back(region);
-        (*ws.regionConfigs)[regionIdx] = {regionNameCpy->c_str(), region.get()};
+        // Allocate region object in the arena and put raw pointers to the
+        // region name and object in the region config array.
+        Region* const region =
+            ((seqLock != nullptr)
+             ? ws.arena->create<Region>(regionPtr, regionSizeBytes, *seqLock)
+             : ws.arena->create<Region>(regionPtr, regionSizeBytes, lock));
+        (*ws.regionConfigs)[regionIdx] = {regionName, region};
     }
 
     // Config is done- create new state vector with it. Assert that creation
     // succeeds since the state vector config is known correct at this point.
-    ws.svConfig = {ws.elemConfigs->data(), ws.regionConfigs->data()};
+    ws.svConfig = {ws.elemConfigs->data(),
+                   ws.regionConfigs->data(),
+                   ws.elemIndex->data(),
+                   ws.regionIndex->data()};
     ws.sv.reset(new StateVector());
     const Result res = StateVector::init(ws.svConfig, *ws.sv);
     SF_SAFE_ASSERT(res == SUCCESS);
@@ -305,39 +383,42 @@ Ref<const StateVectorParse> StateVectorAssembly::parse() const
     return mWs.svParse;
 }
 
+const Vec<U32>& StateVectorAssembly::regionLockGroups() const
+{
+    return mWs.regionLockGroups;
+}
+
 /////////////////////////////////// Private ////////////////////////////////////
 
 Result StateVectorCompiler::allocateElement(
     const StateVectorParse::ElementParse& kElem,
     StateVectorAssembly::Workspace& kWs,
+    ILock* const kLock,
+    SeqLock* const kSeqLock,
     StateVector::ElementConfig& kElemConfig,
     U8*& kBumpPtr)
 {
     SF_SAFE_ASSERT(kBumpPtr != nullptr);
 
-    // Allocate a copy of the element name, add it to the workspace, and put the
-    // raw pointer in the element config.
-    const Ref<String> elemNameCpy(new String(kElem.tokName.str));
-    kWs.configStrings.push_back(elemNameCpy);
-    kElemConfig.name = elemNameCpy->c_str();
+    // Allocate a copy of the element name in the arena and put the raw pointer
+    // in the element config.
+    kElemConfig.name = copyString(*kWs.arena, kElem.tokName.str);
 
     // Get element type info.
     SF_SAFE_ASSERT(kElem.tokType.typeInfo != nullptr);
     const TypeInfo& typeInfo = *kElem.tokType.typeInfo;
 
-    // Get state vector lock pointer. This will be null if locking was not
-    // specified.
-    ILock* const lock = kWs.lock.get();
-
     // Allocate element object for element based on its type and bump the bump
     // pointer by the element's size.
-    Ref<IElement> elemObj;
+    Arena& arena = *kWs.arena;
+    IElement* elemObj = nullptr;
     switch (typeInfo.enumVal)
     {
         case ElementType::INT8:
         {
             I8& backing = *reinterpret_cast<I8*>(kBumpPtr);
-            elemObj.reset(new Element<I8>(backing, lock));
+            elemObj =
+                newElement(arena, backing, kElem.atomic, kLock, kSeqLock);
             kBumpPtr += sizeof(backing);
             break;
         }
@@ -345,7 +426,8 @@ Result StateVectorCompiler::allocateElement(
         case ElementType::INT16:
         {
             I16& backing = *reinterpret_cast<I16*>(kBumpPtr);
-            elemObj.reset(new Element<I16>(backing, lock));
+            elemObj =
+                newElement(arena, backing, kElem.atomic, kLock, kSeqLock);
             kBumpPtr += sizeof(backing);
             break;
         }
@@ -353,7 +435,8 @@ Result StateVectorCompiler::allocateElement(
         case ElementType::INT32:
         {
             I32& backing = *reinterpret_cast<I32*>(kBumpPtr);
-            elemObj.reset(new Element<I32>(backing, lock));
+            elemObj =
+                newElement(arena, backing, kElem.atomic, kLock, kSeqLock);
             kBumpPtr += sizeof(backing);
             break;
         }
@@ -361,7 +444,8 @@ Result StateVectorCompiler::allocateElement(
         case ElementType::INT64:
         {
             I64& backing = *reinterpret_cast<I64*>(kBumpPtr);
-            elemObj.reset(new Element<I64>(backing, lock));
+            elemObj =
+                newElement(arena, backing, kElem.atomic, kLock, kSeqLock);
             kBumpPtr += sizeof(backing);
             break;
         }
@@ -369,7 +453,8 @@ Result StateVectorCompiler::allocateElement(
         case ElementType::UINT8:
         {
             U8& backing = *reinterpret_cast<U8*>(kBumpPtr);
-            elemObj.reset(new Element<U8>(backing, lock));
+            elemObj =
+                newElement(arena, backing, kElem.atomic, kLock, kSeqLock);
             kBumpPtr += sizeof(backing);
             break;
         }
@@ -377,7 +462,8 @@ Result StateVectorCompiler::allocateElement(
         case ElementType::UINT16:
         {
             U16& backing = *reinterpret_cast<U16*>(kBumpPtr);
-            elemObj.reset(new Element<U16>(backing, lock));
+            elemObj =
+                newElement(arena, backing, kElem.atomic, kLock, kSeqLock);
             kBumpPtr += sizeof(backing);
             break;
         }
@@ -385,7 +471,8 @@ Result StateVectorCompiler::allocateElement(
         case ElementType::UINT32:
         {
             U32& backing = *reinterpret_cast<U32*>(kBumpPtr);
-            elemObj.reset(new Element<U32>(backing, lock));
+            elemObj =
+                newElement(arena, backing, kElem.atomic, kLock, kSeqLock);
             kBumpPtr += sizeof(backing);
             break;
         }
@@ -393,7 +480,8 @@ Result StateVectorCompiler::allocateElement(
         case ElementType::UINT64:
         {
             U64& backing = *reinterpret_cast<U64*>(kBumpPtr);
-            elemObj.reset(new Element<U64>(backing, lock));
+            elemObj =
+                newElement(arena, backing, kElem.atomic, kLock, kSeqLock);
             kBumpPtr += sizeof(backing);
             break;
         }
@@ -401,7 +489,8 @@ Result StateVectorCompiler::allocateElement(
         case ElementType::FLOAT32:
         {
             F32& backing = *reinterpret_cast<F32*>(kBumpPtr);
-            elemObj.reset(new Element<F32>(backing, lock));
+            elemObj =
+                newElement(arena, backing, kElem.atomic, kLock, kSeqLock);
             kBumpPtr += sizeof(backing);
             break;
         }
@@ -409,7 +498,8 @@ Result StateVectorCompiler::allocateElement(
         case ElementType::FLOAT64:
         {
             F64& backing = *reinterpret_cast<F64*>(kBumpPtr);
-            elemObj.reset(new Element<F64>(backing, lock));
+            elemObj =
+                newElement(arena, backing, kElem.atomic, kLock, kSeqLock);
             kBumpPtr += sizeof(backing);
             break;
         }
@@ -417,7 +507,8 @@ Result StateVectorCompiler::allocateElement(
         case ElementType::BOOL:
         {
             bool& backing = *reinterpret_cast<bool*>(kBumpPtr);
-            elemObj.reset(new Element<bool>(backing, lock));
+            elemObj =
+                newElement(arena, backing, kElem.atomic, kLock, kSeqLock);
             kBumpPtr += sizeof(backing);
             break;
         }
@@ -427,10 +518,79 @@ Result StateVectorCompiler::allocateElement(
             SF_SAFE_ASSERT(false);
     }
 
-    // Add allocated element to workspace and put the raw pointer in the element
-    // config.
-    kWs.elems.push_back(elemObj);
-    kElemConfig.elem = elemObj.get();
+    // Put the raw pointer to the allocated element in the element config.
+    kElemConfig.elem = elemObj;
+
+    return SUCCESS;
+}
+
+Result StateVectorCompiler::allocateLock(
+    const StateVectorParse::Options& kOpts,
+    const StateVectorParse::RegionParse& kRegion,
+    StateVectorAssembly::Workspace& kWs,
+    Map<String, U32>& kLockGroups,
+    ILock*& kLock,
+    SeqLock*& kSeqLock)
+{
+    // Determine the key of the region's lock group. Regions that get their own
+    // lock are keyed by their section name, which cannot collide with a lock
+    // group name. The empty key is the lock shared by the whole state vector.
+    String key;
+    if (kRegion.tokLockGroup.str.size() > 0)
+    {
+        key = kRegion.tokLockGroup.str;
+    }
+    else if (kOpts.regionLocks || kOpts.seqLock)
+    {
+        key = kRegion.tokName.str;
+    }
+
+    // Allocate the lock if this is the first region in the lock group.
+    auto groupIt = kLockGroups.find(key);
+    if (groupIt == kLockGroups.end())
+    {
+        if (kOpts.seqLock)
+        {
+            kWs.seqLocks.push_back(kWs.arena->create<SeqLock>());
+        }
+        else if (kOpts.adaptiveLock)
+        {
+            AdaptiveLock* const lock = kWs.arena->create<AdaptiveLock>();
+            const Result res = AdaptiveLock::init(*lock);
+            if (res != SUCCESS)
+            {
+                return res;
+            }
+
+            kWs.locks.push_back(lock);
+        }
+        else
+        {
+            Spinlock* const lock = kWs.arena->create<Spinlock>();
+            const Result res = Spinlock::init(*lock);
+            if (res != SUCCESS)
+            {
+                return res;
+            }
+
+            kWs.locks.push_back(lock);
+        }
+
+        const U32 group = kLockGroups.size();
+        groupIt = kLockGroups.insert({key, group}).first;
+    }
+
+    // Record the region's lock group and return its lock.
+    const U32 group = (*groupIt).second;
+    kWs.regionLockGroups.push_back(group);
+    if (kOpts.seqLock)
+    {
+        kSeqLock = kWs.seqLocks[group];
+    }
+    else
+    {
+        kLock = kWs.locks[group];
+    }
 
     return SUCCESS;
 }
@@ -25,7 +25,10 @@
 
 #include <istream>
 
+#include "sf/config/Arena.hpp"
 #include "sf/config/StateVectorParser.hpp"
+#include "sf/core/SeqLock.hpp"
+#include "sf/pal/AdaptiveLock.hpp"
 #include "sf/pal/Spinlock.hpp"
 
 namespace Sf
@@ -60,6 +63,15 @@ public:
     ///
     Ref<const StateVectorParse> parse() const;
 
+    ///
+    /// @brief Gets the lock group of each region. Regions with the same lock
+    /// group share a lock.
+    ///
+    /// @returns Lock group index of each region in config order, or an empty
+    /// vector if the state vector does not use locks.
+    ///
+    const Vec<U32>& regionLockGroups() const;
+
 private:
 
     friend class StateVectorCompiler;
@@ -69,6 +81,12 @@ private:
     ///
     struct Workspace final
     {
+        ///
+        /// @brief Arena containing element, region and lock objects and the
+        /// strings that appear in element and region configs.
+        ///
+        Ref<Arena> arena;
+
         ///
         /// @brief Element configs.
         ///
@@ -80,29 +98,36 @@ private:
         Ref<Vec<StateVector::RegionConfig>> regionConfigs;
 
         ///
-        /// @brief State vector backing memory.
+        /// @brief Element lookup index storage.
         ///
-        Ref<Vec<U8>> svBacking;
+        Ref<Vec<const StateVector::ElementConfig*>> elemIndex;
+
+        ///
+        /// @brief Region lookup index storage.
+        ///
+        Ref<Vec<const StateVector::RegionConfig*>> regionIndex;
 
         ///
-        /// @brief Strings that appear in element and region configs.
+        /// @brief State vector backing memory.
         ///
-        Vec<Ref<String>> configStrings;
+        Ref<Vec<U8>> svBacking;
 
         ///
-        /// @brief Element objects.
+        /// @brief Locks, indexed by lock group, or empty if none. These are
+        /// adaptive locks if the adaptive lock option is set and spinlocks
+        /// otherwise.
         ///
-        Vec<Ref<IElement>> elems;
+        Vec<ILock*> locks;
 
         ///
-        /// @brief Region objects.
+        /// @brief Sequence locks, indexed by lock group, or empty if none.
         ///
-        Vec<Ref<Region>> regions;
+        Vec<SeqLock*> seqLocks;
 
         ///
-        /// @brief State vector lock, or null if none.
+        /// @brief Lock group of each region, or empty if no locks are used.
         ///
-        Ref<Spinlock> lock;
+        Vec<U32> regionLockGroups;
 
         ///
         /// @brief Main state vector object.
@@ -155,6 +180,7 @@ public:
     /// @retval E_SVC_ELEM_DUPE  Reused element name.
     /// @retval E_SVC_RGN_EMPTY  Region contains no elements.
     /// @retval E_SVC_ELEM_TYPE  Invalid element type.
+    /// @retval E_SVC_ALIGN      Atomic element is not naturally aligned.
     ///
     static Result compile(const String kFilePath,
                           Ref<const StateVectorAssembly>& kAsm,
@@ -188,6 +214,10 @@ private:
     ///
     /// @param[in]       kElem        Element parse to compile.
     /// @param[in]       kWs          Compiler workspace.
+    /// @param[in]       kLock        Lock of the element's region, or null if
+    ///                               none.
+    /// @param[in]       kSeqLock     Sequence lock of the element's region, or
+    ///                               null if none.
     /// @param[out]      kElemConfig  On success, contains element config.
     /// @param[in, out]  kBumpPtr     Address of element backing storage. On
     ///                               success, will be bumped to the address of
@@ -197,8 +227,37 @@ private:
     ///
     static Result allocateElement(const StateVectorParse::ElementParse& kElem,
                                   StateVectorAssembly::Workspace& kWs,
+                                  ILock* const kLock,
+                                  SeqLock* const kSeqLock,
                                   StateVector::ElementConfig& kElemConfig,
                                   U8*& kBumpPtr);
+
+    ///
+    /// @brief Gets the lock for a region, allocating it if the region is the
+    /// first in its lock group.
+    ///
+    /// Regions annotated with a lock group share that group's lock. Other
+    /// regions each get their own lock if the region locks or sequence lock
+    /// option is set, and otherwise share one lock for the whole state vector.
+    ///
+    /// @param[in]      kOpts        State vector options.
+    /// @param[in]      kRegion      Region parse.
+    /// @param[in]      kWs          Compiler workspace.
+    /// @param[in, out] kLockGroups  Lock group indices by group key.
+    /// @param[out]     kLock        On success, contains the region lock, or
+    ///                              null if the region uses a sequence lock.
+    /// @param[out]     kSeqLock     On success, contains the region sequence
+    ///                              lock, or null if the region uses a lock.
+    ///
+    /// @retval SUCCESS  Successfully got region lock.
+    /// @retval [other]  Failed to initialize lock.
+    ///
+    static Result allocateLock(const StateVectorParse::Options& kOpts,
+                               const StateVectorParse::RegionParse& kRegion,
+                               StateVectorAssembly::Workspace& kWs,
+                               Map<String, U32>& kLockGroups,
+                               ILock*& kLock,
+                               SeqLock*& kSeqLock);
 };
 
 } // namespace Sf
@@ -16,6 +16,8 @@
 /// IN THE SOFTWARE.
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include "sf/config/StateVectorParser.hpp"
 #include "sf/core/Assert.hpp"
 
@@ -45,7 +47,7 @@ Result StateVectorParser::parse(const Vec<Token>& kToks,
     Vec<StateVectorParse::RegionParse> regions;
 
     // Parsed state vector options.
-    StateVectorParse::Options opts = {false};
+    StateVectorParse::Options opts = {false, false, false, false};
 
     while (!it.eof())
     {
@@ -144,6 +146,20 @@ Result StateVectorParser::parse(const Vec<Token>& kToks,
         }
     }
 
+    // Lock groups are only meaningful if the state vector uses locks.
+    if (!opts.lock && !opts.seqLock)
+    {
+        for (const StateVectorParse::RegionParse& regionParse : regions)
+        {
+            if (regionParse.tokLockGroup.str.size() > 0)
+            {
+                ErrorInfo::set(kErr, regionParse.tokLockGroup, gErrText,
+                               "lock group requires a lock option");
+                return E_SVP_LOCK_GRP;
+            }
+        }
+    }
+
     // Return final parse.
     kParse.reset(new StateVectorParse(regions, opts));
 
@@ -168,6 +184,47 @@ Result StateVectorParser::parseRegion(TokenIterator& kIt,
     // Take section name.
     kRegion.tokName = kIt.take();
 
+    // Take annotations, which must be on the same line as the section name.
+    while ((kIt.type() == Token::ANNOTATION)
+           && (kIt.tok().lineNum == kRegion.tokName.lineNum))
+    {
+        if (kIt.str() == LangConst::annotationLockGroup)
+        {
+            // Lock group annotation.
+
+            // Check that region is not already in a lock group.
+            if (kRegion.tokLockGroup.str.size() > 0)
+            {
+                ErrorInfo::set(kErr, kIt.tok(), gErrText,
+                               "a region may only be in one lock group");
+                return E_SVP_LOCK_GRP;
+            }
+
+            // Take lock group annotation.
+            const Token& tokAnnot = kIt.take();
+
+            // Check that next token, which should be the lock group name, is
+            // an identifier on the same line.
+            if ((kIt.type() != Token::IDENTIFIER)
+                || (kIt.tok().lineNum != tokAnnot.lineNum))
+            {
+                ErrorInfo::set(kErr, tokAnnot, gErrText,
+                               ("expected lock group name after `"
+                                + tokAnnot.str + "`"));
+                return E_SVP_LOCK_GRP;
+            }
+
+            // Take lock group name.
+            kRegion.tokLockGroup = kIt.take();
+        }
+        else
+        {
+            // Unknown annotation.
+            ErrorInfo::set(kErr, kIt.tok(), gErrText, "unknown annotation");
+            return E_SVP_ANNOT;
+        }
+    }
+
     // Parse elements until EOF or another section.
     while (!kIt.eof() && (kIt.type() != Token::SECTION))
     {
@@ -205,6 +262,34 @@ Result StateVectorParser::parseRegion(TokenIterator& kIt,
 
         // Take element name.
         elem.tokName = kIt.take();
+
+        // Take annotations, which must be on the same line as the element.
+        while ((kIt.type() == Token::ANNOTATION)
+               && (kIt.tok().lineNum == elem.tokName.lineNum))
+        {
+            if (kIt.str() == LangConst::annotationAtomic)
+            {
+                // Atomic annotation.
+
+                // Check that element is not already marked atomic.
+                if (elem.atomic)
+                {
+                    ErrorInfo::set(kErr, kIt.tok(), gErrText,
+                                   "redundant atomic annotation");
+                    return E_SVP_ANNOT;
+                }
+
+                // Take annotation.
+                elem.atomic = true;
+                kIt.take();
+            }
+            else
+            {
+                // Unknown annotation.
+                ErrorInfo::set(kErr, kIt.tok(), gErrText, "unknown annotation");
+                return E_SVP_ANNOT;
+            }
+        }
     }
 
     return SUCCESS;
@@ -217,6 +302,7 @@ Result StateVectorParser::parseOptions(TokenIterator& kIt,
     // Take options section token.
     kIt.take();
 
+    const Token* tokRegionLocks = nullptr;
     while (kIt.type() == Token::IDENTIFIER)
     {
         const Token& tok = kIt.take();
@@ -225,12 +311,46 @@ Result StateVectorParser::parseOptions(TokenIterator& kIt,
             // Lock option.
             kOpts.lock = true;
         }
+        else if (tok.str == LangConst::optSeqLock)
+        {
+            // Sequence lock option.
+            kOpts.seqLock = true;
+        }
+        else if (tok.str == LangConst::optAdaptiveLock)
+        {
+            // Adaptive lock option. This is the lock option with a different
+            // kind of lock.
+            kOpts.lock = true;
+            kOpts.adaptiveLock = true;
+        }
+        else if (tok.str == LangConst::optRegionLocks)
+        {
+            // Region locks option.
+            kOpts.regionLocks = true;
+            tokRegionLocks = &tok;
+        }
         else
         {
             // Unknown option.
             ErrorInfo::set(kErr, tok, gErrText, "unknown option");
             return E_SVP_OPT;
         }
+
+        // A state vector uses at most one kind of lock.
+        if (kOpts.lock && kOpts.seqLock)
+        {
+            ErrorInfo::set(kErr, tok, gErrText, "conflicting lock options");
+            return E_SVP_OPT;
+        }
+    }
+
+    // Region locks are only meaningful if the state vector uses locks. Options
+    // may be given in any order, so this is checked after the whole section.
+    if ((tokRegionLocks != nullptr) && !kOpts.lock && !kOpts.seqLock)
+    {
+        ErrorInfo::set(kErr, *tokRegionLocks, gErrText,
+                       "region locks require a lock option");
+        return E_SVP_OPT;
     }
 
     return SUCCESS;
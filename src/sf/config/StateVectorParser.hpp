@@ -49,6 +49,7 @@ public:
     {
         Token tokType; ///< Element type.
         Token tokName; ///< Element name.
+        bool atomic;   ///< If element is accessed atomically.
     };
 
     ///
@@ -59,6 +60,7 @@ public:
         Token tokName;                             ///< Region section token.
         String plainName;                          ///< Plain region name.
         Vec<StateVectorParse::ElementParse> elems; ///< Elements in region.
+        Token tokLockGroup;                        ///< Lock group, if any.
     };
 
     ///
@@ -66,7 +68,10 @@ public:
     ///
     struct Options final
     {
-        bool lock; ///< If state vector is thread-safe.
+        bool lock;         ///< If state vector is thread-safe.
+        bool seqLock;      ///< If regions are guarded by sequence locks.
+        bool regionLocks;  ///< If ungrouped regions have their own locks.
+        bool adaptiveLock; ///< If locks are adaptive locks, implies lock.
     };
 
     ///
@@ -83,6 +88,8 @@ private:
 
     friend class StateVectorParser;
 
+    friend class AssemblyImage;
+
     ///
     /// @brief Constructor.
     ///
@@ -121,6 +128,8 @@ public:
     /// @retval E_SVP_ELEM_TYPE  Invalid element type.
     /// @retval E_SVP_ELEM_NAME  Expected element name.
     /// @retval E_SVP_OPT        Invalid option.
+    /// @retval E_SVP_ANNOT      Unknown or redundant annotation.
+    /// @retval E_SVP_LOCK_GRP   Invalid lock group.
     ///
     static Result parse(const Vec<Token>& kToks,
                         Ref<const StateVectorParse>& kParse,
@@ -24,7 +24,6 @@
 #define SF_TOKEN_HPP
 
 #include <iostream>
-#include <regex>
 
 #include "sf/config/LanguageConstants.hpp"
 #include "sf/config/StlTypes.hpp"
@@ -69,11 +68,6 @@ struct Token final
     ///
     static const Map<Type, String> names;
 
-    ///
-    /// @brief Map of token types to regexes that match them.
-    ///
-    static const Vec<std::pair<Type, std::regex>> regexes;
-
     ///
     /// @brief Token type.
     ///
@@ -82,6 +76,11 @@ struct Token final
     ///
     /// @brief Token text.
     ///
+    /// @remark Tokens own a copy of their text rather than viewing the buffer
+    /// they were tokenized from. Parses hold tokens after that buffer is
+    /// released, e.g., StateMachineAssembly::parse(), so a view would dangle.
+    /// Most token text fits in the small-string buffer and is not allocated.
+    ///
     String str;
 
     ///
@@ -16,104 +16,400 @@
 /// IN THE SOFTWARE.
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <cctype>
-#include <fstream>
+#include <cstring>
+#include <iterator>
 
+#include "sf/config/MappedFile.hpp"
 #include "sf/config/Tokenizer.hpp"
 
 namespace Sf
 {
 
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Operators in the order they are matched. An operator that is a
+/// prefix of another comes after it.
+///
+static const char* const gOperators[] =
+{
+    "==", "!=", "=", "!", "<=", "<", ">=", ">", "and", "or", "not", "+", "-",
+    "*", "/"
+};
+
+///
+/// @brief View of a line of input. The line is not null-terminated and does
+/// not include the newline.
+///
+struct Line final
+{
+    const char* str; ///< First character of line
+    U32 size;        ///< Number of characters in line
+};
+
 /////////////////////////////////// Helpers ////////////////////////////////////
 
-static Result tokenizeLine(const String& kLine,
-                           const U32 kLineNum,
-                           Vec<Token>& kToks,
-                           ErrorInfo* const kErr)
+///
+/// @brief Gets whether a character is whitespace. This is the same set of
+/// characters as std::isspace() in the C locale.
+///
+/// @param[in] kC  Character.
+///
+/// @returns Whether character is whitespace.
+///
+static bool isSpace(const char kC)
 {
-    // Index at which we'll try to match a token in the line. This index will
-    // be bumped along as we parse tokens.
-    U32 idx = 0;
+    return ((kC == ' ') || ((kC >= '\t') && (kC <= '\r')));
+}
 
-    if (kErr != nullptr)
+///
+/// @brief Gets whether a character is a decimal digit.
+///
+/// @param[in] kC  Character.
+///
+/// @returns Whether character is a digit.
+///
+static bool isDigit(const char kC)
+{
+    return ((kC >= '0') && (kC <= '9'));
+}
+
+///
+/// @brief Gets whether a character can start an identifier.
+///
+/// @param[in] kC  Character.
+///
+/// @returns Whether character is a letter or underscore.
+///
+static bool isIdentStart(const char kC)
+{
+    return (((kC >= 'a') && (kC <= 'z'))
+            || ((kC >= 'A') && (kC <= 'Z'))
+            || (kC == '_'));
+}
+
+///
+/// @brief Gets whether a character can continue an identifier.
+///
+/// @param[in] kC  Character.
+///
+/// @returns Whether character is a letter, digit, or underscore.
+///
+static bool isIdentChar(const char kC)
+{
+    return (isIdentStart(kC) || isDigit(kC));
+}
+
+///
+/// @brief Gets the character at an index in a line, or the null character if
+/// the index is past the end of the line.
+///
+/// @param[in] kLine  Line.
+/// @param[in] kIdx   Index.
+///
+/// @returns Character at index.
+///
+static char charAt(const Line& kLine, const U32 kIdx)
+{
+    return ((kIdx < kLine.size) ? kLine.str[kIdx] : '\0');
+}
+
+///
+/// @brief Gets whether a line contains a string at an index.
+///
+/// @param[in] kLine  Line.
+/// @param[in] kIdx   Index less than the line length.
+/// @param[in] kStr   String to look for.
+///
+/// @returns Whether line contains the string at the index.
+///
+static bool hasAt(const Line& kLine, const U32 kIdx, const char* const kStr)
+{
+    // Check the first character before doing a full comparison, since most
+    // candidates fail on it.
+    const U32 len = std::strlen(kStr);
+    return ((kLine.str[kIdx] == kStr[0])
+            && ((kIdx + len) <= kLine.size)
+            && (std::memcmp(&kLine.str[kIdx], kStr, len) == 0));
+}
+
+///
+/// @brief Gets the length of the run of characters in a class starting at an
+/// index in a line.
+///
+/// @param[in] kLine  Line.
+/// @param[in] kIdx   Index.
+/// @param[in] kPred  Character class predicate.
+///
+/// @returns Length of run.
+///
+static U32 runLength(const Line& kLine,
+                     const U32 kIdx,
+                     bool (*const kPred)(const char))
+{
+    U32 idx = kIdx;
+    while (kPred(charAt(kLine, idx)))
     {
-        // Add line to error info for use in error messages.
-        kErr->lines.push_back(kLine);
+        ++idx;
     }
+    return (idx - kIdx);
+}
 
-    // Jump to the first non-whitespace or newline character in the line.
-    while ((idx < kLine.size())
-           && std::isspace(kLine[idx])
-           && (kLine[idx] != '\n'))
+///
+/// @brief Gets whether a character can appear in a section name.
+///
+/// @param[in] kC  Character.
+///
+/// @returns Whether character can appear in a section name.
+///
+static bool isSectionChar(const char kC)
+{
+    return (isIdentChar(kC) || (kC == '/'));
+}
+
+///
+/// @brief Gets whether a character can appear in a label after the first.
+///
+/// @param[in] kC  Character.
+///
+/// @returns Whether character can appear in a label.
+///
+static bool isLabelChar(const char kC)
+{
+    return (isIdentChar(kC) || (kC == '[') || (kC == ']') || (kC == '-'));
+}
+
+///
+/// @brief Gets whether a character can appear in an annotation after the
+/// first.
+///
+/// @param[in] kC  Character.
+///
+/// @returns Whether character can appear in an annotation.
+///
+static bool isAnnotationChar(const char kC)
+{
+    return (isIdentChar(kC) || (kC == '='));
+}
+
+///
+/// @brief Matches a numeric constant at an index in a line. A numeric constant
+/// is an optional minus sign, optional integer digits, and either a fractional
+/// part with at least 1 digit or at least 1 integer digit.
+///
+/// @param[in] kLine  Line.
+/// @param[in] kIdx   Index.
+///
+/// @returns Length of constant, or 0 if none.
+///
+static U32 matchNumber(const Line& kLine, const U32 kIdx)
+{
+    const U32 signLen = ((charAt(kLine, kIdx) == '-') ? 1 : 0);
+    const U32 intIdx = (kIdx + signLen);
+    const U32 intLen = runLength(kLine, intIdx, isDigit);
+    const U32 dotIdx = (intIdx + intLen);
+    if ((charAt(kLine, dotIdx) == '.') && isDigit(charAt(kLine, (dotIdx + 1))))
     {
-        ++idx;
+        return (signLen + intLen + 1 + runLength(kLine, (dotIdx + 1), isDigit));
+    }
+
+    return ((intLen > 0) ? (signLen + intLen) : 0);
+}
+
+///
+/// @brief Matches a token at an index in a line.
+///
+/// Token types are tried in a fixed order and the first that matches wins,
+/// even if a later type would match a longer string. For example, "iffy"
+/// lexes as the keyword "if" followed by the identifier "fy". Within a type,
+/// alternatives are likewise tried in order rather than by length.
+///
+/// @param[in]  kLine  Line.
+/// @param[in]  kIdx   Index of a non-whitespace character.
+/// @param[out] kType  On match, set to the token type.
+///
+/// @returns Length of token, or 0 if no token matched.
+///
+static U32 matchToken(const Line& kLine, const U32 kIdx, Token::Type& kType)
+{
+    const char c = kLine.str[kIdx];
+
+    // Section, like "[foo/bar]".
+    if (c == '[')
+    {
+        const U32 nameLen = runLength(kLine, (kIdx + 1), isSectionChar);
+        if ((nameLen > 0) && (charAt(kLine, (kIdx + 1 + nameLen)) == ']'))
+        {
+            kType = Token::SECTION;
+            return (nameLen + 2);
+        }
     }
 
-    while (idx < kLine.size())
+    // Label, like ".foo". At least 2 characters follow the dot.
+    if ((c == '.') && isIdentStart(charAt(kLine, (kIdx + 1))))
     {
-        bool matched = false;
+        const U32 restLen = runLength(kLine, (kIdx + 2), isLabelChar);
+        if (restLen > 0)
+        {
+            kType = Token::LABEL;
+            return (restLen + 2);
+        }
+    }
 
-        // Loop across all token types and try to match them at the current
-        // index. The order of this iteration is significant- see
-        // `Token::regexes`.
-        for (const std::pair<Token::Type, std::regex>& tokType : Token::regexes)
+    // Keyword.
+    for (const char* const keyword : {"if", "else", "->"})
+    {
+        if (hasAt(kLine, kIdx, keyword))
         {
-            // Try to match token at the current position.
-            String substr = kLine.substr(idx);
-            std::smatch match;
-            if (std::regex_search(substr,
-                                  match,
-                                  tokType.second,
-                                  std::regex_constants::match_continuous))
+            kType = Token::KEYWORD;
+            return std::strlen(keyword);
+        }
+    }
+
+    // Constant.
+    for (const char* const constant : {"true", "false"})
+    {
+        if (hasAt(kLine, kIdx, constant))
+        {
+            kType = Token::CONSTANT;
+            return std::strlen(constant);
+        }
+    }
+    const U32 numLen = matchNumber(kLine, kIdx);
+    if (numLen > 0)
+    {
+        kType = Token::CONSTANT;
+        return numLen;
+    }
+
+    // Annotation, like "@foo".
+    if ((c == '@') && isIdentStart(charAt(kLine, (kIdx + 1))))
+    {
+        kType = Token::ANNOTATION;
+        return (runLength(kLine, (kIdx + 2), isAnnotationChar) + 2);
+    }
+
+    // Operator.
+    for (const char* const op : gOperators)
+    {
+        if (hasAt(kLine, kIdx, op))
+        {
+            kType = Token::OPERATOR;
+            return std::strlen(op);
+        }
+    }
+
+    // Identifier.
+    if (isIdentStart(c))
+    {
+        kType = Token::IDENTIFIER;
+        return (runLength(kLine, (kIdx + 1), isIdentChar) + 1);
+    }
+
+    // Single-character tokens and comments.
+    switch (c)
+    {
+        case ':':
+            kType = Token::COLON;
+            return 1;
+
+        case '(':
+            kType = Token::LPAREN;
+            return 1;
+
+        case ')':
+            kType = Token::RPAREN;
+            return 1;
+
+        case '#':
+        {
+            // Comment runs to the end of the line or a carriage return.
+            U32 idx = (kIdx + 1);
+            while ((idx < kLine.size)
+                   && (kLine.str[idx] != '\r')
+                   && (kLine.str[idx] != '\n'))
             {
-                // Compute the index of the first non-whitespace character in
-                // the matched string so we can attach a column number to the
-                // token.
-                U32 nonWsIdx = 0;
-                for (; nonWsIdx < match[0].str().size(); ++nonWsIdx)
-                {
-                    if (!std::isspace(match[0].str()[nonWsIdx]))
-                    {
-                        break;
-                    }
-                }
-
-                // Match successful- if not a comment, pack into a token and
-                // append to the return vector.
-                if (tokType.first != Token::COMMENT)
-                {
-                    const Token tok =
-                    {
-                        tokType.first,
-                        match[1].str(),
-                        static_cast<I32>(kLineNum),
-                        static_cast<I32>(idx + nonWsIdx + 1),
-                        nullptr,
-                        nullptr
-                    };
-                    kToks.push_back(tok);
-                }
-
-                // Bump the line index.
-                idx += match[0].str().size();
-                matched = true;
-                break;
+                ++idx;
             }
+            kType = Token::COMMENT;
+            return (idx - kIdx);
         }
 
-        if (!matched)
+        case '{':
+            kType = Token::LBRACE;
+            return 1;
+
+        case '}':
+            kType = Token::RBRACE;
+            return 1;
+
+        case ',':
+            kType = Token::COMMA;
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+///
+/// @brief Tokenizes a line of input.
+///
+/// @param[in]  kLine     Line to tokenize.
+/// @param[in]  kLineNum  Line number.
+/// @param[out] kToks     Vector to append tokens to.
+/// @param[out] kErr      On error, if non-null, contains error info.
+///
+/// @retval SUCCESS        Successfully tokenized line.
+/// @retval E_TOK_INVALID  Line contains an invalid token.
+///
+static Result tokenizeLine(const Line& kLine,
+                           const U32 kLineNum,
+                           Vec<Token>& kToks,
+                           ErrorInfo* const kErr)
+{
+    // Index at which we'll try to match a token in the line. This index will
+    // be bumped along as we parse tokens. Start at the first non-whitespace
+    // character.
+    U32 idx = runLength(kLine, 0, isSpace);
+
+    while (idx < kLine.size)
+    {
+        Token::Type type = Token::NONE;
+        const U32 len = matchToken(kLine, idx, type);
+        if (len == 0)
         {
             // Failed to match a token at the current index, so the input is
             // invalid.
             if (kErr != nullptr)
             {
-                kErr->lineNum = kErr->lines.size();
+                kErr->lineNum = kLineNum;
                 kErr->colNum = (idx + 1);
                 kErr->text = "error";
                 kErr->subtext = "invalid token";
             }
             return E_TOK_INVALID;
         }
+
+        // Match successful- if not a comment, pack into a token and append to
+        // the return vector.
+        if (type != Token::COMMENT)
+        {
+            Token tok =
+            {
+                type,
+                String(&kLine.str[idx], len),
+                static_cast<I32>(kLineNum),
+                static_cast<I32>(idx + 1),
+                nullptr,
+                nullptr
+            };
+            kToks.push_back(std::move(tok));
+        }
+
+        // Bump the line index past the token and any whitespace after it.
+        idx += len;
+        idx += runLength(kLine, idx, isSpace);
     }
 
     // If we get this far, the entire line was valid.
@@ -141,32 +437,13 @@ const Map<Token::Type, String> Token::names =
     {Token::KEYWORD, "keyword"}
 };
 
-const Vec<std::pair<Token::Type, std::regex>> Token::regexes =
-{
-    {Token::SECTION, std::regex("\\s*(\\[[a-zA-Z0-9_/]+\\])\\s*")},
-    {Token::LABEL, std::regex("\\s*([.][a-zA-Z_][a-zA-Z0-9_\\[\\]-]+)\\s*")},
-    {Token::KEYWORD, std::regex("\\s*(if|else|->)\\s*")},
-    {Token::CONSTANT, std::regex("\\s*(true|false|[-]?[0-9]*\\.?[0-9]+)\\s*")},
-    {Token::ANNOTATION, std::regex("\\s*(@[a-zA-Z_][a-zA-Z0-9_=]*)\\s*")},
-    {Token::OPERATOR, std::regex(
-        "\\s*(==|!=|=|!|<=|<|>=|>|and|or|not|\\+|\\-|\\*|/)\\s*")},
-    {Token::IDENTIFIER, std::regex("\\s*([a-zA-Z_][a-zA-Z0-9_]*)\\s*")},
-    {Token::COLON, std::regex("\\s*(:)\\s*")},
-    {Token::LPAREN, std::regex("\\s*(\\()\\s*")},
-    {Token::RPAREN, std::regex("\\s*(\\))\\s*")},
-    {Token::COMMENT, std::regex("\\s*(#.*)\\s*")},
-    {Token::LBRACE, std::regex("\\s*(\\{)\\s*")},
-    {Token::RBRACE, std::regex("\\s*(\\})\\s*")},
-    {Token::COMMA, std::regex("\\s*(,)\\s*")}
-};
-
 Result Tokenizer::tokenize(String kFilePath,
                            Vec<Token>& kToks,
                            ErrorInfo* const kErr)
 {
-    // Open the file input stream.
-    std::ifstream ifs(kFilePath);
-    if (!ifs.is_open())
+    // Map the file into memory.
+    MappedFile file;
+    if (MappedFile::init(kFilePath, file) != SUCCESS)
     {
         if (kErr != nullptr)
         {
@@ -181,22 +458,45 @@ Result Tokenizer::tokenize(String kFilePath,
         kErr->filePath = kFilePath;
     }
 
-    return tokenize(ifs, kToks, kErr);
+    return tokenize(file.data(), file.size(), kToks, kErr);
 }
 
 Result Tokenizer::tokenize(std::istream& kIs,
                            Vec<Token>& kToks,
                            ErrorInfo* const kErr)
 {
-    if ((kErr != nullptr) && (kErr->filePath.size() == 0))
+    // Read the whole stream so that it can be tokenized as one buffer.
+    const String src((std::istreambuf_iterator<char>(kIs)),
+                     std::istreambuf_iterator<char>());
+    return tokenize(src.data(), src.size(), kToks, kErr);
+}
+
+Result Tokenizer::tokenize(const char* const kBuf,
+                           const U64 kSize,
+                           Vec<Token>& kToks,
+                           ErrorInfo* const kErr)
+{
+    if (kErr != nullptr)
     {
-        kErr->filePath = "(no file)";
+        if (kErr->filePath.size() == 0)
+        {
+            kErr->filePath = "(no file)";
+        }
+
+        // Save the source for use in error messages.
+        kErr->source.assign(((kBuf != nullptr) ? kBuf : ""), kSize);
     }
 
-    String line;
+    U64 pos = 0;
     U32 lineNum = 1;
-    while (std::getline(kIs, line))
+    while (pos < kSize)
     {
+        // Find the end of the line.
+        const char* const newline = static_cast<const char*>(
+            std::memchr(&kBuf[pos], '\n', (kSize - pos)));
+        const U64 end = ((newline != nullptr) ? (newline - kBuf) : kSize);
+        const Line line = {&kBuf[pos], static_cast<U32>(end - pos)};
+
         // Tokenize the line.
         Result res = tokenizeLine(line, lineNum, kToks, kErr);
         if (res != SUCCESS)
@@ -208,20 +508,21 @@ Result Tokenizer::tokenize(std::istream& kIs,
 
         // If the line was terminated by a newline, then add a newline token to
         // the token stream so that parsers can use them as delimiters.
-        if (!kIs.eof() && !kIs.fail())
+        if (newline != nullptr)
         {
             const Token newlineTok =
             {
                 Token::NEWLINE,
                 "(newline)",
                 static_cast<I32>(lineNum),
-                static_cast<I32>(line.size() + 1),
+                static_cast<I32>(line.size + 1),
                 nullptr,
                 nullptr
             };
             kToks.push_back(newlineTok);
         }
 
+        pos = (end + 1);
         ++lineNum;
     }
 
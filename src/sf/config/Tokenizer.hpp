@@ -40,6 +40,8 @@ namespace Tokenizer
 {
     ///
     /// @brief Tokenizer entry point, taking a path to the file to tokenize.
+    /// The file is mapped into memory and tokenized without being copied into
+    /// lines.
     ///
     /// @param[in]  kFilePath  Path to file to tokenize.
     /// @param[in]  kToks      On success, contains tokens.
@@ -59,6 +61,62 @@ namespace Tokenizer
     Result tokenize(std::istream& kIs,
                     Vec<Token>& kToks,
                     ErrorInfo* const kErr);
+
+    ///
+    /// @brief Tokenizer entry point, taking a buffer to tokenize. Lines are
+    /// lexed directly out of the buffer, but tokens copy their text, so the
+    /// buffer need not outlive them (see Token::str). The other entry points
+    /// funnel into this one.
+    ///
+    /// @param[in]  kBuf   Buffer to tokenize. Need not be null-terminated.
+    /// @param[in]  kSize  Size of buffer in bytes.
+    ///
+    /// @see Tokenizer::tokenize(String, ...)
+    ///
+    Result tokenize(const char* const kBuf,
+                    const U64 kSize,
+                    Vec<Token>& kToks,
+                    ErrorInfo* const kErr);
+
+    ///
+    /// @brief Tokenizes a config held in a buffer and parses the tokens with
+    /// the given parser. Shared by the config compilers.
+    ///
+    /// @tparam TParser  Parser class with a static parse() taking tokens, a
+    ///                  parse Ref, and error info.
+    ///
+    /// @param[in]  kBuf      Buffer containing config. Need not be
+    ///                       null-terminated.
+    /// @param[in]  kSize     Size of buffer in bytes.
+    /// @param[out] kParse    On success, contains config parse.
+    /// @param[out] kErr      On error, if non-null, contains error info.
+    /// @param[in]  kErrText  Error text to set in kErr on error.
+    ///
+    /// @returns Tokenizer or parser result.
+    ///
+    template<typename TParser, typename TParse>
+    Result parse(const char* const kBuf,
+                 const U64 kSize,
+                 Ref<const TParse>& kParse,
+                 ErrorInfo* const kErr,
+                 const char* const kErrText)
+    {
+        // Tokenize the buffer.
+        Vec<Token> toks;
+        Result res = tokenize(kBuf, kSize, toks, kErr);
+        if (res == SUCCESS)
+        {
+            // Parse the tokens.
+            res = TParser::parse(toks, kParse, kErr);
+        }
+
+        if ((res != SUCCESS) && (kErr != nullptr))
+        {
+            kErr->text = kErrText;
+        }
+
+        return res;
+    }
 }
 
 } // namespace Sf
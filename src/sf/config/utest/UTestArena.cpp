@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/config/utest/UTestArena.cpp
+/// @brief Unit tests for Arena.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+
+#include "sf/config/Arena.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Object that records the order in which objects are destroyed.
+///
+class Tracked final
+{
+public:
+
+    ///
+    /// @brief Constructor.
+    ///
+    /// @param[in] kId     Object ID.
+    /// @param[in] kOrder  Vector to append ID to on destruction.
+    ///
+    Tracked(const U32 kId, Vec<U32>& kOrder) : mId(kId), mOrder(kOrder)
+    {
+    }
+
+    ///
+    /// @brief Destructor.
+    ///
+    ~Tracked()
+    {
+        mOrder.push_back(mId);
+    }
+
+    ///
+    /// @brief Object ID.
+    ///
+    const U32 mId;
+
+private:
+
+    ///
+    /// @brief Vector to append ID to on destruction.
+    ///
+    Vec<U32>& mOrder;
+};
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Unit tests for Arena.
+///
+TEST_GROUP(Arena)
+{
+};
+
+///
+/// @test A new arena owns no memory.
+///
+TEST(Arena, Empty)
+{
+    Arena arena;
+    CHECK_EQUAL(0, arena.bytesUsed());
+    CHECK_EQUAL(0, arena.bytesReserved());
+}
+
+///
+/// @test Objects are constructed with forwarded arguments and destroyed in
+/// reverse order of creation when the arena destructs.
+///
+TEST(Arena, CreateAndDestroy)
+{
+    Vec<U32> order;
+    {
+        Arena arena;
+        for (U32 i = 0; i < 4; ++i)
+        {
+            const Tracked* const obj = arena.create<Tracked>(i, order);
+            CHECK_EQUAL(i, obj->mId);
+        }
+        CHECK_EQUAL(0, order.size());
+    }
+
+    CHECK_EQUAL(4, order.size());
+    CHECK_EQUAL(3, order[0]);
+    CHECK_EQUAL(2, order[1]);
+    CHECK_EQUAL(1, order[2]);
+    CHECK_EQUAL(0, order[3]);
+}
+
+///
+/// @test Allocations are aligned as requested.
+///
+TEST(Arena, Alignment)
+{
+    Arena arena;
+    (void) arena.allocate(1, 1);
+    for (U64 align = 1; align <= 64; align *= 2)
+    {
+        const void* const mem = arena.allocate(3, align);
+        CHECK_EQUAL(0, (reinterpret_cast<std::uintptr_t>(mem) % align));
+    }
+
+    const F64* const f = arena.create<F64>(1.5);
+    CHECK_EQUAL(0, (reinterpret_cast<std::uintptr_t>(f) % alignof(F64)));
+    CHECK_EQUAL(1.5, *f);
+}
+
+///
+/// @test Arrays are value-initialized.
+///
+TEST(Arena, ArrayZeroed)
+{
+    Arena arena;
+    const U32* const arr = arena.createArray<U32>(100);
+    for (U32 i = 0; i < 100; ++i)
+    {
+        CHECK_EQUAL(0, arr[i]);
+    }
+}
+
+///
+/// @test Allocations do not overlap, including across blocks.
+///
+TEST(Arena, NoOverlap)
+{
+    Arena arena;
+    Vec<U32*> arrs;
+    for (U32 i = 0; i < 200; ++i)
+    {
+        U32* const arr = arena.createArray<U32>(16);
+        for (U32 j = 0; j < 16; ++j)
+        {
+            arr[j] = i;
+        }
+        arrs.push_back(arr);
+    }
+
+    for (U32 i = 0; i < arrs.size(); ++i)
+    {
+        for (U32 j = 0; j < 16; ++j)
+        {
+            CHECK_EQUAL(i, arrs[i][j]);
+        }
+    }
+    CHECK_TRUE(arena.bytesReserved() >= arena.bytesUsed());
+    CHECK_TRUE(arena.bytesUsed() >= (200 * 16 * sizeof(U32)));
+}
+
+///
+/// @test Blocks grow geometrically up to the maximum block size.
+///
+TEST(Arena, BlockGrowth)
+{
+    Arena arena;
+    (void) arena.allocate(1, 1);
+    CHECK_EQUAL(Arena::MIN_BLOCK_SIZE, arena.bytesReserved());
+
+    (void) arena.allocate(Arena::MIN_BLOCK_SIZE, 1);
+    CHECK_EQUAL((3 * Arena::MIN_BLOCK_SIZE), arena.bytesReserved());
+
+    // Allocate until blocks stop growing.
+    while (arena.bytesReserved() < (4 * Arena::MAX_BLOCK_SIZE))
+    {
+        (void) arena.allocate(Arena::MIN_BLOCK_SIZE, 1);
+    }
+    const U64 reserved = arena.bytesReserved();
+    U64 delta = 0;
+    while (delta == 0)
+    {
+        (void) arena.allocate(Arena::MIN_BLOCK_SIZE, 1);
+        delta = (arena.bytesReserved() - reserved);
+    }
+    CHECK_EQUAL(Arena::MAX_BLOCK_SIZE, delta);
+}
+
+///
+/// @test An allocation larger than the maximum block size gets its own block.
+///
+TEST(Arena, LargeAllocation)
+{
+    Arena arena;
+    const U64 size = (2 * Arena::MAX_BLOCK_SIZE);
+    U8* const mem = static_cast<U8*>(arena.allocate(size, 8));
+    mem[0] = 1;
+    mem[size - 1] = 1;
+    CHECK_EQUAL(size, arena.bytesUsed());
+    CHECK_TRUE(arena.bytesReserved() >= size);
+}
+
+///
+/// @test A shared Ref to an arena object keeps the arena alive.
+///
+TEST(Arena, ShareKeepsArenaAlive)
+{
+    Vec<U32> order;
+    Ref<const Tracked> obj;
+    {
+        const Ref<Arena> arena(new Arena());
+        obj = Arena::share<const Tracked>(arena,
+                                          arena->create<Tracked>(7, order));
+    }
+
+    CHECK_EQUAL(0, order.size());
+    CHECK_EQUAL(7, obj->mId);
+    obj.reset();
+    CHECK_EQUAL(1, order.size());
+    CHECK_EQUAL(7, order[0]);
+}
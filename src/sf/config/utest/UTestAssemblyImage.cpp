@@ -0,0 +1,578 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/config/utest/UTestAssemblyImage.cpp
+/// @brief Unit tests for AssemblyImage.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "sf/config/AssemblyImage.hpp"
+#include "sf/config/StateScriptCompiler.hpp"
+#include "sf/config/StateVectorCompiler.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Path of image file written and loaded by tests.
+///
+static const char* const gImagePath = "assembly-image.tmp";
+
+///
+/// @brief State vector config used by tests.
+///
+static const char* const gSvSrc =
+    "[Foo]\n"
+    "U64 time\n"
+    "U32 state\n"
+    "I32 foo\n"
+    "F64 bar\n"
+    "\n"
+    "[Bar]\n"
+    "bool baz\n"
+    "U8 qux\n";
+
+///
+/// @brief State machine config used by tests. Uses guards, transitions, exit
+/// labels, stats, local elements and arithmetic in both numeric domains.
+///
+static const char* const gSmSrc =
+    "[state_vector]\n"
+    "U64 time @alias G\n"
+    "U32 state @alias S\n"
+    "I32 foo\n"
+    "F64 bar\n"
+    "bool baz\n"
+    "U8 qux\n"
+    "\n"
+    "[local]\n"
+    "I32 cnt = 10\n"
+    "F64 avg = 1.5\n"
+    "bool flag = true\n"
+    "\n"
+    "[Initial]\n"
+    ".entry\n"
+    "    qux = qux + 1\n"
+    ".step\n"
+    "    cnt = cnt + foo * 2\n"
+    "    avg = roll_avg(bar, 3) + roll_max(foo, 2) / 2\n"
+    "    baz and not flag: -> Done\n"
+    "    cnt > 40 {\n"
+    "        flag = false\n"
+    "    }\n"
+    "    else: bar = bar - 0.25\n"
+    ".exit\n"
+    "    qux = qux + 10\n"
+    "\n"
+    "[Done]\n"
+    ".step\n"
+    "    foo = T + roll_min(foo, 4)\n"
+    "    T >= 2: -> Initial\n";
+
+///
+/// @brief Initial state of state machines compiled by tests.
+///
+static const char* const gInitState = "Initial";
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Checks that all regions of two state vectors with the same layout
+/// have the same contents.
+///
+/// @param[in] kSvA  First state vector.
+/// @param[in] kSvB  Second state vector.
+///
+static void checkSameContents(const StateVector::Config& kSvA,
+                              const StateVector::Config& kSvB)
+{
+    for (U32 i = 0; kSvA.regions[i].name != nullptr; ++i)
+    {
+        CHECK_TRUE(kSvB.regions[i].name != nullptr);
+        const Region& regionA = *kSvA.regions[i].region;
+        const Region& regionB = *kSvB.regions[i].region;
+        CHECK_EQUAL(regionA.size(), regionB.size());
+        CHECK_EQUAL(0, std::memcmp(regionA.addr(),
+                                   regionB.addr(),
+                                   regionA.size()));
+    }
+}
+
+///
+/// @brief Checks that a local element of two state machines has the same
+/// value.
+///
+/// @tparam T  Element type.
+///
+/// @param[in] kSmAsmA  First state machine.
+/// @param[in] kSmAsmB  Second state machine.
+/// @param[in] kName    Element name.
+///
+template<typename T>
+static void checkSameLocal(const StateMachineAssembly& kSmAsmA,
+                           const StateMachineAssembly& kSmAsmB,
+                           const char* const kName)
+{
+    Element<T>* elemA = nullptr;
+    Element<T>* elemB = nullptr;
+    CHECK_SUCCESS(kSmAsmA.localStateVector().getElement(kName, elemA));
+    CHECK_SUCCESS(kSmAsmB.localStateVector().getElement(kName, elemB));
+    CHECK_EQUAL(elemA->read(), elemB->read());
+}
+
+///
+/// @brief Checks that the local elements of two state machines compiled from
+/// the test state machine config have the same values.
+///
+/// @param[in] kSmAsmA  First state machine.
+/// @param[in] kSmAsmB  Second state machine.
+///
+static void checkSameLocals(const StateMachineAssembly& kSmAsmA,
+                            const StateMachineAssembly& kSmAsmB)
+{
+    checkSameLocal<I32>(kSmAsmA, kSmAsmB, "cnt");
+    checkSameLocal<F64>(kSmAsmA, kSmAsmB, "avg");
+    checkSameLocal<bool>(kSmAsmA, kSmAsmB, "flag");
+    checkSameLocal<U64>(kSmAsmA, kSmAsmB, "T");
+}
+
+///
+/// @brief Compiles the test state vector and state machine.
+///
+/// @param[out] kSvAsm  State vector assembly.
+/// @param[out] kSmAsm  State machine assembly.
+/// @param[in]  kRake   Whether to rake the state machine.
+///
+static void compileAssemblies(Ref<const StateVectorAssembly>& kSvAsm,
+                              Ref<const StateMachineAssembly>& kSmAsm,
+                              const bool kRake = true)
+{
+    std::stringstream svSrc(gSvSrc);
+    CHECK_SUCCESS(StateVectorCompiler::compile(svSrc, kSvAsm, nullptr));
+    std::stringstream smSrc(gSmSrc);
+    CHECK_SUCCESS(StateMachineCompiler::compile(smSrc,
+                                                kSvAsm,
+                                                kSmAsm,
+                                                nullptr,
+                                                gInitState,
+                                                kRake));
+}
+
+///
+/// @brief Writes a state machine to an in-memory image.
+///
+/// @param[in] kSmAsm  State machine assembly.
+///
+/// @returns Image.
+///
+static String writeImage(const Ref<const StateMachineAssembly> kSmAsm)
+{
+    std::stringstream ss;
+    CHECK_SUCCESS(AssemblyImage::write(ss, kSmAsm));
+    return ss.str();
+}
+
+///
+/// @brief Steps a compiled state machine and a state machine loaded from its
+/// image side by side with the same inputs, checking that their state vectors
+/// stay the same.
+///
+/// @param[in] kBackend  Expression backend to compile with.
+///
+static void checkLoadedMatchesCompiled(
+    const ExpressionCompiler::Backend kBackend)
+{
+    std::stringstream svSrc(gSvSrc);
+    Ref<const StateVectorAssembly> svAsm;
+    CHECK_SUCCESS(StateVectorCompiler::compile(svSrc, svAsm, nullptr));
+    std::stringstream smSrc(gSmSrc);
+    Ref<const StateMachineAssembly> smAsm;
+    CHECK_SUCCESS(StateMachineCompiler::compile(smSrc,
+                                                svAsm,
+                                                smAsm,
+                                                nullptr,
+                                                gInitState,
+                                                true,
+                                                kBackend));
+
+    const String img = writeImage(smAsm);
+    Ref<const StateVectorAssembly> imgSvAsm;
+    Ref<const StateMachineAssembly> imgSmAsm;
+    CHECK_SUCCESS(AssemblyImage::load(img.data(),
+                                      img.size(),
+                                      imgSvAsm,
+                                      imgSmAsm));
+    checkSameContents(svAsm->config(), imgSvAsm->config());
+    checkSameLocals(*smAsm, *imgSmAsm);
+
+    StateVector* const svs[2] = {&svAsm->get(), &imgSvAsm->get()};
+    U32 rng = 1;
+    for (U64 t = 0; t < 100; ++t)
+    {
+        rng = ((rng * 1103515245) + 12345);
+        for (StateVector* const sv : svs)
+        {
+            Element<U64>* elemTime = nullptr;
+            Element<I32>* elemFoo = nullptr;
+            Element<F64>* elemBar = nullptr;
+            Element<bool>* elemBaz = nullptr;
+            CHECK_SUCCESS(sv->getElement("time", elemTime));
+            CHECK_SUCCESS(sv->getElement("foo", elemFoo));
+            CHECK_SUCCESS(sv->getElement("bar", elemBar));
+            CHECK_SUCCESS(sv->getElement("baz", elemBaz));
+            elemTime->write(t);
+            elemFoo->write(static_cast<I32>((rng >> 16) % 7));
+            elemBar->write(static_cast<F64>((rng >> 8) % 100) / 8.0);
+            elemBaz->write(((rng >> 4) % 3) == 0);
+        }
+
+        CHECK_SUCCESS(smAsm->get().step());
+        CHECK_SUCCESS(imgSmAsm->get().step());
+        CHECK_EQUAL(smAsm->get().currentState(),
+                    imgSmAsm->get().currentState());
+        checkSameContents(svAsm->config(), imgSvAsm->config());
+        checkSameLocals(*smAsm, *imgSmAsm);
+    }
+}
+
+///
+/// @brief Checks that loading an image fails with a certain error.
+///
+/// @param[in] kImg  Image.
+/// @param[in] kRes  Expected error code.
+///
+static void checkLoadError(const String& kImg, const Result kRes)
+{
+    Ref<const StateVectorAssembly> svAsm;
+    Ref<const StateMachineAssembly> smAsm;
+    CHECK_ERROR(kRes,
+                AssemblyImage::load(kImg.data(), kImg.size(), svAsm, smAsm));
+    CHECK_TRUE(svAsm == nullptr);
+    CHECK_TRUE(smAsm == nullptr);
+}
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Unit tests for AssemblyImage.
+///
+TEST_GROUP(AssemblyImage)
+{
+    void teardown()
+    {
+        (void) std::remove(gImagePath);
+    }
+};
+
+///
+/// @test A state machine loaded from the image of a state machine compiled
+/// with tree expressions behaves the same as the compiled state machine.
+///
+TEST(AssemblyImage, LoadedMatchesCompiledTree)
+{
+    checkLoadedMatchesCompiled(ExpressionCompiler::TREE);
+}
+
+///
+/// @test A state machine loaded from the image of a state machine compiled
+/// with bytecode expressions behaves the same as the compiled state machine.
+///
+TEST(AssemblyImage, LoadedMatchesCompiledBytecode)
+{
+    checkLoadedMatchesCompiled(ExpressionCompiler::BYTECODE);
+}
+
+///
+/// @test The loaded state machine has the stats and stats dependencies of the
+/// compiled state machine.
+///
+TEST(AssemblyImage, Stats)
+{
+    Ref<const StateVectorAssembly> svAsm;
+    Ref<const StateMachineAssembly> smAsm;
+    compileAssemblies(svAsm, smAsm);
+    const String img = writeImage(smAsm);
+    Ref<const StateVectorAssembly> imgSvAsm;
+    Ref<const StateMachineAssembly> imgSmAsm;
+    CHECK_SUCCESS(AssemblyImage::load(img.data(),
+                                      img.size(),
+                                      imgSvAsm,
+                                      imgSmAsm));
+
+    const StateMachine::Config config = smAsm->config();
+    const StateMachine::Config imgConfig = imgSmAsm->config();
+    U32 i = 0;
+    for (; config.stats[i] != nullptr; ++i)
+    {
+        CHECK_TRUE(imgConfig.stats[i] != nullptr);
+        CHECK_EQUAL(config.stats[i]->size(), imgConfig.stats[i]->size());
+        CHECK_EQUAL(config.statsDeps[i].sampleInactive,
+                    imgConfig.statsDeps[i].sampleInactive);
+        for (U32 j = 0;
+             config.statsDeps[i].states[j] != StateMachine::NO_STATE;
+             ++j)
+        {
+            CHECK_EQUAL(config.statsDeps[i].states[j],
+                        imgConfig.statsDeps[i].states[j]);
+        }
+    }
+    CHECK_EQUAL(3, i);
+    POINTERS_EQUAL(nullptr, imgConfig.stats[i]);
+}
+
+///
+/// @test Local elements of the loaded state machine have the values they had
+/// when the image was written.
+///
+TEST(AssemblyImage, LocalElementValues)
+{
+    Ref<const StateVectorAssembly> svAsm;
+    Ref<const StateMachineAssembly> smAsm;
+    compileAssemblies(svAsm, smAsm);
+    Element<I32>* elemCnt = nullptr;
+    CHECK_SUCCESS(smAsm->localStateVector().getElement("cnt", elemCnt));
+    elemCnt->write(-7);
+
+    const String img = writeImage(smAsm);
+    Ref<const StateVectorAssembly> imgSvAsm;
+    Ref<const StateMachineAssembly> imgSmAsm;
+    CHECK_SUCCESS(AssemblyImage::load(img.data(),
+                                      img.size(),
+                                      imgSvAsm,
+                                      imgSmAsm));
+
+    StateVector& localSv = imgSmAsm->localStateVector();
+    Element<I32>* imgElemCnt = nullptr;
+    Element<F64>* imgElemAvg = nullptr;
+    Element<bool>* imgElemFlag = nullptr;
+    CHECK_SUCCESS(localSv.getElement("cnt", imgElemCnt));
+    CHECK_SUCCESS(localSv.getElement("avg", imgElemAvg));
+    CHECK_SUCCESS(localSv.getElement("flag", imgElemFlag));
+    CHECK_EQUAL(-7, imgElemCnt->read());
+    CHECK_EQUAL(1.5, imgElemAvg->read());
+    CHECK_EQUAL(true, imgElemFlag->read());
+}
+
+///
+/// @test A state machine loaded from a file is raked by default and has no
+/// parse or expression cache.
+///
+TEST(AssemblyImage, LoadFromFile)
+{
+    Ref<const StateVectorAssembly> svAsm;
+    Ref<const StateMachineAssembly> smAsm;
+    compileAssemblies(svAsm, smAsm, false);
+    {
+        std::ofstream ofs(gImagePath, std::ios::binary);
+        CHECK_SUCCESS(AssemblyImage::write(ofs, smAsm));
+    }
+
+    Ref<const StateVectorAssembly> imgSvAsm;
+    Ref<const StateMachineAssembly> imgSmAsm;
+    CHECK_SUCCESS(AssemblyImage::load(gImagePath, imgSvAsm, imgSmAsm));
+    CHECK_TRUE(imgSvAsm != nullptr);
+    CHECK_TRUE(imgSmAsm != nullptr);
+    CHECK_TRUE(imgSmAsm->parse() == nullptr);
+    CHECK_TRUE(imgSmAsm->exprCache() == nullptr);
+    CHECK_TRUE(imgSmAsm->config().elemState != nullptr);
+    CHECK_EQUAL(1, imgSmAsm->get().currentState());
+
+    // State script cannot be compiled against a raked state machine.
+    std::stringstream ssSrc("[Initial]\n");
+    Ref<StateScriptAssembly> ssAsm;
+    CHECK_ERROR(E_SSC_RAKE,
+                StateScriptCompiler::compile(ssSrc, imgSmAsm, ssAsm, nullptr));
+}
+
+///
+/// @test Symbols of an unraked state machine are kept when loading without
+/// raking, so that state scripts can run against the loaded state machine.
+///
+TEST(AssemblyImage, UnrakedSymbols)
+{
+    Ref<const StateVectorAssembly> svAsm;
+    Ref<const StateMachineAssembly> smAsm;
+    compileAssemblies(svAsm, smAsm, false);
+    const String img = writeImage(smAsm);
+    Ref<const StateVectorAssembly> imgSvAsm;
+    Ref<const StateMachineAssembly> imgSmAsm;
+    CHECK_SUCCESS(AssemblyImage::load(img.data(),
+                                      img.size(),
+                                      imgSvAsm,
+                                      imgSmAsm,
+                                      false));
+
+    std::stringstream ssSrc(
+        "[options]\n"
+        "delta_t 1\n"
+        "\n"
+        "[Initial]\n"
+        "T == 0 {\n"
+        "    foo = 20\n"
+        "    @assert cnt == 50\n"
+        "}\n"
+        "T == 1 {\n"
+        "    baz = true\n"
+        "    @assert cnt == 90 and not flag\n"
+        "}\n"
+        "\n"
+        "[Done]\n"
+        "true {\n"
+        "    @assert qux == 11\n"
+        "    @stop\n"
+        "}\n");
+    Ref<StateScriptAssembly> ssAsm;
+    CHECK_SUCCESS(StateScriptCompiler::compile(ssSrc,
+                                               imgSmAsm,
+                                               ssAsm,
+                                               nullptr));
+    ErrorInfo ssTokInfo;
+    StateScriptAssembly::Report report{};
+    CHECK_SUCCESS(ssAsm->run(ssTokInfo, report));
+    CHECK_TRUE(report.pass);
+}
+
+///
+/// @test A state vector loaded from a state vector image has the same layout
+/// as the compiled state vector.
+///
+TEST(AssemblyImage, StateVector)
+{
+    std::stringstream svSrc(gSvSrc);
+    Ref<const StateVectorAssembly> svAsm;
+    CHECK_SUCCESS(StateVectorCompiler::compile(svSrc, svAsm, nullptr));
+    {
+        std::ofstream ofs(gImagePath, std::ios::binary);
+        CHECK_SUCCESS(AssemblyImage::write(ofs, svAsm));
+    }
+
+    Ref<const StateVectorAssembly> imgSvAsm;
+    CHECK_SUCCESS(AssemblyImage::load(gImagePath, imgSvAsm));
+    const StateVector::Config config = svAsm->config();
+    const StateVector::Config imgConfig = imgSvAsm->config();
+    U32 i = 0;
+    for (; config.elems[i].name != nullptr; ++i)
+    {
+        STRCMP_EQUAL(config.elems[i].name, imgConfig.elems[i].name);
+        CHECK_EQUAL(config.elems[i].elem->type(),
+                    imgConfig.elems[i].elem->type());
+        CHECK_EQUAL(config.elems[i].elem->size(),
+                    imgConfig.elems[i].elem->size());
+    }
+    CHECK_EQUAL(6, i);
+    POINTERS_EQUAL(nullptr, imgConfig.elems[i].name);
+
+    // State machine compiles against the loaded state vector.
+    std::stringstream smSrc(gSmSrc);
+    Ref<const StateMachineAssembly> smAsm;
+    CHECK_SUCCESS(StateMachineCompiler::compile(smSrc,
+                                                imgSvAsm,
+                                                smAsm,
+                                                nullptr));
+}
+
+///
+/// @test State vector and state machine images are not loadable as each
+/// other.
+///
+TEST(AssemblyImage, ErrorWrongImageKind)
+{
+    Ref<const StateVectorAssembly> svAsm;
+    Ref<const StateMachineAssembly> smAsm;
+    compileAssemblies(svAsm, smAsm);
+    std::stringstream svImg;
+    CHECK_SUCCESS(AssemblyImage::write(svImg, svAsm));
+    const String smImg = writeImage(smAsm);
+
+    checkLoadError(svImg.str(), E_IMG_FORMAT);
+    Ref<const StateVectorAssembly> imgSvAsm;
+    CHECK_ERROR(E_IMG_FORMAT,
+                AssemblyImage::load(smImg.data(), smImg.size(), imgSvAsm));
+    CHECK_TRUE(imgSvAsm == nullptr);
+}
+
+///
+/// @test Writing a null state machine or state vector fails.
+///
+TEST(AssemblyImage, ErrorWriteNull)
+{
+    std::stringstream ss;
+    CHECK_ERROR(E_IMG_NULL,
+                AssemblyImage::write(ss, Ref<const StateMachineAssembly>()));
+    CHECK_ERROR(E_IMG_NULL,
+                AssemblyImage::write(ss, Ref<const StateVectorAssembly>()));
+    CHECK_EQUAL(0, ss.str().size());
+}
+
+///
+/// @test Loading an image with the wrong magic number fails.
+///
+TEST(AssemblyImage, ErrorBadMagic)
+{
+    Ref<const StateVectorAssembly> svAsm;
+    Ref<const StateMachineAssembly> smAsm;
+    compileAssemblies(svAsm, smAsm);
+    String img = writeImage(smAsm);
+    img[0] = static_cast<char>(img[0] + 1);
+    checkLoadError(img, E_IMG_FORMAT);
+}
+
+///
+/// @test Loading an image with a corrupted body fails.
+///
+TEST(AssemblyImage, ErrorBadChecksum)
+{
+    Ref<const StateVectorAssembly> svAsm;
+    Ref<const StateMachineAssembly> smAsm;
+    compileAssemblies(svAsm, smAsm);
+    String img = writeImage(smAsm);
+    img[img.size() / 2] = static_cast<char>(img[img.size() / 2] + 1);
+    checkLoadError(img, E_IMG_CHECKSUM);
+}
+
+///
+/// @test Loading a truncated image fails.
+///
+TEST(AssemblyImage, ErrorTruncated)
+{
+    Ref<const StateVectorAssembly> svAsm;
+    Ref<const StateMachineAssembly> smAsm;
+    compileAssemblies(svAsm, smAsm);
+    const String img = writeImage(smAsm);
+    checkLoadError(img.substr(0, (img.size() - 1)), E_IMG_FORMAT);
+    checkLoadError(img.substr(0, 10), E_IMG_FORMAT);
+    checkLoadError("", E_IMG_FORMAT);
+}
+
+///
+/// @test Loading an image from a nonexistent file fails.
+///
+TEST(AssemblyImage, ErrorFileDne)
+{
+    Ref<const StateVectorAssembly> svAsm;
+    Ref<const StateMachineAssembly> smAsm;
+    CHECK_ERROR(E_MAP_OPEN, AssemblyImage::load("foo.img", svAsm, smAsm));
+    CHECK_TRUE(svAsm == nullptr);
+    CHECK_TRUE(smAsm == nullptr);
+}
@@ -0,0 +1,412 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/config/utest/UTestCompileCache.cpp
+/// @brief Unit tests for CompileCache.
+////////////////////////////////////////////////////////////////////////////////
+
+// The compile cache is only available on Linux.
+#ifdef SF_PLATFORM_LINUX
+
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "sf/config/CompileCache.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Cache directory used by tests.
+///
+static const char* const gCacheDir = "compile-cache.tmp";
+
+///
+/// @brief Path of state vector config used by tests.
+///
+static const char* const gSvPath = "compile-cache-sv.tmp";
+
+///
+/// @brief Path of state machine config used by tests.
+///
+static const char* const gSmPath = "compile-cache-sm.tmp";
+
+///
+/// @brief State vector config used by tests.
+///
+static const char* const gSvSrc =
+    "[Foo]\n"
+    "U64 time\n"
+    "U32 state\n"
+    "I32 foo\n";
+
+///
+/// @brief State machine config used by tests.
+///
+static const char* const gSmSrc =
+    "[state_vector]\n"
+    "U64 time @alias G\n"
+    "U32 state @alias S\n"
+    "I32 foo\n"
+    "\n"
+    "[Initial]\n"
+    ".step\n"
+    "    foo = foo + 1\n";
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Writes a file.
+///
+/// @param[in] kPath  File path.
+/// @param[in] kSrc   File contents.
+///
+static void writeFile(const String kPath, const String kSrc)
+{
+    std::ofstream ofs(kPath, std::ios::binary);
+    ofs << kSrc;
+}
+
+///
+/// @brief Reads a file.
+///
+/// @param[in] kPath  File path.
+///
+/// @returns File contents, or empty if the file could not be read.
+///
+static String readFile(const String kPath)
+{
+    std::ifstream ifs(kPath, std::ios::binary);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+
+///
+/// @brief Gets the path of a cache entry.
+///
+/// @param[in] kKey  Entry key.
+///
+/// @returns Entry path.
+///
+static String entryPath(const String kKey)
+{
+    return (String(gCacheDir) + "/" + kKey);
+}
+
+///
+/// @brief Creates a cache in the test cache directory.
+///
+/// @param[in] kArgs  Command arguments passed to the cache.
+///
+/// @returns Cache.
+///
+static Ref<CompileCache> makeCache(Vec<String> kArgs = {})
+{
+    return Ref<CompileCache>(new CompileCache(kArgs));
+}
+
+///
+/// @brief Checks that compiling the test state vector recovers from a damaged
+/// cache entry by recompiling and overwriting the entry.
+///
+/// @param[in] kDamage  Function that damages the entry at the given path.
+///
+static void checkStateVectorRecovers(void (*kDamage)(const String&))
+{
+    const Ref<CompileCache> cache = makeCache();
+    writeFile(gSvPath, gSvSrc);
+
+    // Compile the state vector, which caches it.
+    Ref<const StateVectorAssembly> svAsm;
+    CHECK_SUCCESS(cache->compileStateVector(gSvPath, svAsm, nullptr));
+    String key;
+    CHECK_TRUE(cache->key("sv", {gSvPath}, {}, key));
+    const String entry = readFile(entryPath(key));
+    CHECK_TRUE(entry.size() > 0);
+
+    // Damage the entry. The entry is rejected, so the state vector is
+    // recompiled and the entry is overwritten.
+    kDamage(entryPath(key));
+    CHECK_TRUE(readFile(entryPath(key)) != entry);
+    svAsm.reset();
+    CHECK_SUCCESS(cache->compileStateVector(gSvPath, svAsm, nullptr));
+    CHECK_TRUE(svAsm != nullptr);
+    CHECK_TRUE(readFile(entryPath(key)) == entry);
+}
+
+///
+/// @brief Truncates a file to half its size.
+///
+/// @param[in] kPath  File path.
+///
+static void truncateFile(const String& kPath)
+{
+    const String data = readFile(kPath);
+    writeFile(kPath, data.substr(0, (data.size() / 2)));
+}
+
+///
+/// @brief Flips the bits of a byte in the middle of a file.
+///
+/// @param[in] kPath  File path.
+///
+static void corruptFile(const String& kPath)
+{
+    String data = readFile(kPath);
+    data[data.size() / 2] = static_cast<char>(~data[data.size() / 2]);
+    writeFile(kPath, data);
+}
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Unit tests for CompileCache.
+///
+TEST_GROUP(CompileCache)
+{
+    void setup()
+    {
+        // Point the cache at the test cache directory.
+        CHECK_EQUAL(0, setenv("SF_CACHE_DIR", gCacheDir, 1));
+    }
+
+    void teardown()
+    {
+        CHECK_EQUAL(0, unsetenv("SF_CACHE_DIR"));
+
+        // Remove the cache directory and everything in it.
+        DIR* const dir = opendir(gCacheDir);
+        if (dir != nullptr)
+        {
+            for (dirent* ent = readdir(dir); ent != nullptr;
+                 ent = readdir(dir))
+            {
+                (void) std::remove(entryPath(ent->d_name).c_str());
+            }
+            (void) closedir(dir);
+        }
+        (void) std::remove(gCacheDir);
+        (void) std::remove(gSvPath);
+        (void) std::remove(gSmPath);
+    }
+};
+
+///
+/// @test The option that bypasses the cache is removed from command arguments,
+/// and a bypassed cache neither creates its directory nor reads or writes
+/// entries.
+///
+TEST(CompileCache, NoCacheOpt)
+{
+    Vec<String> args = {"sm", CompileCache::NO_CACHE_OPT, "check", "foo",
+                        CompileCache::NO_CACHE_OPT};
+    const CompileCache cache(args);
+    CHECK_TRUE((args == Vec<String>{"sm", "check", "foo"}));
+
+    writeFile(gSvPath, gSvSrc);
+    String key;
+    CHECK_TRUE(!cache.key("sv", {gSvPath}, {}, key));
+    cache.write("foo", "bar");
+    String data;
+    CHECK_TRUE(!cache.read("foo", data));
+    struct stat st;
+    CHECK_TRUE(stat(gCacheDir, &st) != 0);
+
+    // Compiling still works.
+    Ref<const StateVectorAssembly> svAsm;
+    CHECK_SUCCESS(cache.compileStateVector(gSvPath, svAsm, nullptr));
+    CHECK_TRUE(svAsm != nullptr);
+}
+
+///
+/// @test Command arguments without the option that bypasses the cache are
+/// unchanged.
+///
+TEST(CompileCache, NoCacheOptAbsent)
+{
+    Vec<String> args = {"sm", "check", "foo"};
+    const CompileCache cache(args);
+    CHECK_TRUE((args == Vec<String>{"sm", "check", "foo"}));
+    struct stat st;
+    CHECK_EQUAL(0, stat(gCacheDir, &st));
+}
+
+///
+/// @test Keys are the same for the same inputs, and change when the contents
+/// of a file, the result kind, or a string changes.
+///
+TEST(CompileCache, Key)
+{
+    const Ref<CompileCache> cache = makeCache();
+    writeFile(gSvPath, gSvSrc);
+    writeFile(gSmPath, gSmSrc);
+    String key;
+    CHECK_TRUE(cache->key("sm", {gSvPath, gSmPath}, {"foo"}, key));
+    String key2;
+    CHECK_TRUE(cache->key("sm", {gSvPath, gSmPath}, {"foo"}, key2));
+    CHECK_TRUE(key == key2);
+
+    // Change the file contents.
+    writeFile(gSmPath, (String(gSmSrc) + "\n"));
+    CHECK_TRUE(cache->key("sm", {gSvPath, gSmPath}, {"foo"}, key2));
+    CHECK_TRUE(key != key2);
+    writeFile(gSmPath, gSmSrc);
+    CHECK_TRUE(cache->key("sm", {gSvPath, gSmPath}, {"foo"}, key2));
+    CHECK_TRUE(key == key2);
+
+    // Change the result kind.
+    CHECK_TRUE(cache->key("check", {gSvPath, gSmPath}, {"foo"}, key2));
+    CHECK_TRUE(key != key2);
+
+    // Change a string.
+    CHECK_TRUE(cache->key("sm", {gSvPath, gSmPath}, {"bar"}, key2));
+    CHECK_TRUE(key != key2);
+
+    // Move bytes between adjacent strings.
+    CHECK_TRUE(cache->key("sm", {gSvPath, gSmPath}, {"fo", "o"}, key2));
+    CHECK_TRUE(key != key2);
+}
+
+///
+/// @test Computing a key fails when a file cannot be read.
+///
+TEST(CompileCache, KeyMissingFile)
+{
+    const Ref<CompileCache> cache = makeCache();
+    String key;
+    CHECK_TRUE(!cache->key("sv", {gSvPath}, {}, key));
+}
+
+///
+/// @test A written result is read back, and reading a result that was never
+/// written fails.
+///
+TEST(CompileCache, ReadWrite)
+{
+    const Ref<CompileCache> cache = makeCache();
+    String data;
+    CHECK_TRUE(!cache->read("foo", data));
+
+    const String expect("bar\0baz", 7);
+    cache->write("foo", expect);
+    CHECK_TRUE(cache->read("foo", data));
+    CHECK_TRUE(data == expect);
+
+    // Results persist across caches.
+    const Ref<CompileCache> cache2 = makeCache();
+    data.clear();
+    CHECK_TRUE(cache2->read("foo", data));
+    CHECK_TRUE(data == expect);
+}
+
+///
+/// @test Compiling a state machine caches it, and compiling it again loads it
+/// from the cache. Changing the state machine config invalidates the entry.
+///
+TEST(CompileCache, StateMachine)
+{
+    const Ref<CompileCache> cache = makeCache();
+    writeFile(gSvPath, gSvSrc);
+    writeFile(gSmPath, gSmSrc);
+    Ref<const StateVectorAssembly> svAsm;
+    Ref<const StateMachineAssembly> smAsm;
+    CHECK_SUCCESS(cache->compileStateMachine(gSvPath,
+                                             gSmPath,
+                                             svAsm,
+                                             smAsm,
+                                             nullptr,
+                                             true));
+    String key;
+    CHECK_TRUE(cache->key("sm", {gSvPath, gSmPath}, {}, key));
+    const String entry = readFile(entryPath(key));
+    CHECK_TRUE(entry.size() > 0);
+
+    // Compile again, loading from the cache, and step the state machine.
+    svAsm.reset();
+    smAsm.reset();
+    CHECK_SUCCESS(cache->compileStateMachine(gSvPath,
+                                             gSmPath,
+                                             svAsm,
+                                             smAsm,
+                                             nullptr,
+                                             true));
+    CHECK_TRUE(smAsm->parse() == nullptr);
+    Element<I32>* foo = nullptr;
+    CHECK_SUCCESS(svAsm->get().getElement("foo", foo));
+    CHECK_SUCCESS(smAsm->get().step());
+    CHECK_EQUAL(1, foo->read());
+
+    // Changing the state machine config gives it a new entry.
+    writeFile(gSmPath, (String(gSmSrc) + "    foo = foo + 1\n"));
+    String key2;
+    CHECK_TRUE(cache->key("sm", {gSvPath, gSmPath}, {}, key2));
+    CHECK_TRUE(key != key2);
+    CHECK_SUCCESS(cache->compileStateMachine(gSvPath,
+                                             gSmPath,
+                                             svAsm,
+                                             smAsm,
+                                             nullptr,
+                                             true));
+    CHECK_TRUE(smAsm->parse() != nullptr);
+    CHECK_TRUE(readFile(entryPath(key2)).size() > 0);
+}
+
+///
+/// @test A truncated state vector entry is rejected, recompiled, and
+/// overwritten.
+///
+TEST(CompileCache, TruncatedEntry)
+{
+    checkStateVectorRecovers(truncateFile);
+}
+
+///
+/// @test A corrupt state vector entry is rejected, recompiled, and
+/// overwritten.
+///
+TEST(CompileCache, CorruptEntry)
+{
+    checkStateVectorRecovers(corruptFile);
+}
+
+///
+/// @test Compile errors are reported and not cached.
+///
+TEST(CompileCache, ErrorNotCached)
+{
+    const Ref<CompileCache> cache = makeCache();
+    writeFile(gSvPath, "[Foo]\nU64\n");
+    Ref<const StateVectorAssembly> svAsm;
+    ErrorInfo err;
+    CHECK_ERROR(E_SVP_ELEM_NAME,
+                cache->compileStateVector(gSvPath, svAsm, &err));
+    CHECK_TRUE(svAsm == nullptr);
+    String key;
+    CHECK_TRUE(cache->key("sv", {gSvPath}, {}, key));
+    String data;
+    CHECK_TRUE(!cache->read(key, data));
+}
+
+#endif
@@ -42,7 +42,8 @@ using namespace Sf;
 
 ///
 /// @brief Compiles an expression containing only constants and checks that it
-/// evaluates to some value.
+/// evaluates to some value. The expression is compiled with each backend, with
+/// and without an expression cache.
 ///
 /// @param[in] kExprSrc    Expression to parse.
 /// @param[in] kExpectVal  Expected value of expression.
@@ -51,19 +52,91 @@ static void checkEvalConstExpr(const char* const kExprSrc, const F64 kExpectVal)
 {
     PARSE_EXPR(kExprSrc);
 
-    // Compile expression.
+    for (const ExpressionCompiler::Backend backend :
+         {ExpressionCompiler::TREE, ExpressionCompiler::BYTECODE})
+    for (const bool cached : {false, true})
+    {
+        // Compile expression.
+        Ref<const ExpressionAssembly> exprAsm;
+        const Ref<ExpressionCache> cache(cached ? new ExpressionCache()
+                                                : nullptr);
+        CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
+                                                  {},
+                                                  ElementType::FLOAT64,
+                                                  exprAsm,
+                                                  nullptr,
+                                                  backend,
+                                                  cache));
+
+        // Expression evaluates to expected value.
+        CHECK_EQUAL(ElementType::FLOAT64, exprAsm->root()->type());
+        IExprNode<F64>* const root =
+            dynamic_cast<IExprNode<F64>*>(exprAsm->root().get());
+        CHECK_EQUAL(kExpectVal, root->evaluate());
+    }
+}
+
+///
+/// @brief Compiles an expression with I64 evaluation type and checks that it
+/// evaluates to some value. The expression is compiled with each backend, with
+/// and without an expression cache.
+///
+/// @param[in] kExprSrc    Expression to parse.
+/// @param[in] kBindings   Element symbol table.
+/// @param[in] kExpectVal  Expected value of expression.
+///
+static void checkEvalI64Expr(const char* const kExprSrc,
+                             const Map<String, IElement*>& kBindings,
+                             const I64 kExpectVal)
+{
+    PARSE_EXPR(kExprSrc);
+
+    for (const ExpressionCompiler::Backend backend :
+         {ExpressionCompiler::TREE, ExpressionCompiler::BYTECODE})
+    for (const bool cached : {false, true})
+    {
+        Ref<const ExpressionAssembly> exprAsm;
+        const Ref<ExpressionCache> cache(cached ? new ExpressionCache()
+                                                : nullptr);
+        CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
+                                                  kBindings,
+                                                  ElementType::INT64,
+                                                  exprAsm,
+                                                  nullptr,
+                                                  backend,
+                                                  cache));
+        IExprNode<I64>* const root =
+            dynamic_cast<IExprNode<I64>*>(exprAsm->root().get());
+        CHECK_TRUE(root != nullptr);
+        CHECK_EQUAL(kExpectVal, root->evaluate());
+    }
+}
+
+///
+/// @brief Checks the domain that an expression is evaluated in before being
+/// cast to its evaluation type.
+///
+/// @param[in] kExprSrc   Expression to parse.
+/// @param[in] kBindings  Element symbol table.
+/// @param[in] kDomain    Expected domain, INT64 or FLOAT64.
+///
+static void checkEvalDomain(const char* const kExprSrc,
+                            const Map<String, IElement*>& kBindings,
+                            const ElementType kDomain)
+{
+    PARSE_EXPR(kExprSrc);
     Ref<const ExpressionAssembly> exprAsm;
     CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
-                                              {},
+                                              kBindings,
                                               ElementType::FLOAT64,
                                               exprAsm,
                                               nullptr));
 
-    // Expression evaluates to expected value.
-    CHECK_EQUAL(ElementType::FLOAT64, exprAsm->root()->type());
-    IExprNode<F64>* const root =
-        dynamic_cast<IExprNode<F64>*>(exprAsm->root().get());
-    CHECK_EQUAL(kExpectVal, root->evaluate());
+    // Root node is a cast from the evaluation domain.
+    const IOpExprNode* const root =
+        dynamic_cast<const IOpExprNode*>(exprAsm->root().get());
+    CHECK_TRUE(root != nullptr);
+    CHECK_EQUAL(kDomain, root->rhs()->type());
 }
 
 ///
@@ -901,6 +974,441 @@ TEST(ExpressionCompiler, StatsFunctionExpressionArgs)
     CHECK_EQUAL(2.0, root->evaluate());
 }
 
+///
+/// @test The optional third argument of a stats function, whether the stats
+/// sample while inactive, defaults to true and is evaluated at compile time.
+///
+TEST(ExpressionCompiler, StatsFunctionSampleInactive)
+{
+    // Create element bindings.
+    I32 foo = 0;
+    Element<I32> elemFoo(foo);
+    const Map<String, IElement*> bindings = {{"foo", &elemFoo}};
+
+    // Stats without the third argument sample while inactive.
+    {
+        PARSE_EXPR("roll_avg(foo, 2)");
+        Ref<const ExpressionAssembly> exprAsm;
+        CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
+                                                  bindings,
+                                                  ElementType::FLOAT64,
+                                                  exprAsm,
+                                                  nullptr));
+        const Vec<bool> sampleInactive = exprAsm->statsSampleInactive();
+        CHECK_EQUAL(1, sampleInactive.size());
+        CHECK_TRUE(sampleInactive[0]);
+    }
+
+    // Constant third argument.
+    {
+        PARSE_EXPR("roll_max(foo, 2, false)");
+        Ref<const ExpressionAssembly> exprAsm;
+        CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
+                                                  bindings,
+                                                  ElementType::FLOAT64,
+                                                  exprAsm,
+                                                  nullptr));
+        const Vec<bool> sampleInactive = exprAsm->statsSampleInactive();
+        CHECK_EQUAL(1, sampleInactive.size());
+        CHECK_FALSE(sampleInactive[0]);
+    }
+
+    // Third argument expression that references an element. Like the window
+    // size, it is evaluated with the element's value at compile time.
+    {
+        PARSE_EXPR("roll_avg(foo, 2, foo > 0)");
+        Ref<const ExpressionAssembly> exprAsm;
+        CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
+                                                  bindings,
+                                                  ElementType::FLOAT64,
+                                                  exprAsm,
+                                                  nullptr));
+        const Vec<bool> sampleInactive = exprAsm->statsSampleInactive();
+        CHECK_EQUAL(1, sampleInactive.size());
+        CHECK_FALSE(sampleInactive[0]);
+    }
+
+    // Identical calls that differ only in the third argument do not share
+    // stats.
+    {
+        PARSE_EXPR("roll_avg(foo, 2) + roll_avg(foo, 2, false)");
+        Ref<const ExpressionAssembly> exprAsm;
+        CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
+                                                  bindings,
+                                                  ElementType::FLOAT64,
+                                                  exprAsm,
+                                                  nullptr));
+        CHECK_EQUAL(2, exprAsm->stats().size());
+    }
+}
+
+///
+/// @test The bytecode backend evaluates an expression with elements of all
+/// types the same as the tree backend.
+///
+TEST(ExpressionCompiler, BytecodeAllElementTypes)
+{
+    // Parse expression.
+    PARSE_EXPR("(a + b) * c - d / e > f - g and not (h == i) or j != k");
+
+    // Create element bindings.
+    I8 a = 0;
+    I16 b = 0;
+    I32 c = 0;
+    I64 d = 0;
+    U8 e = 0;
+    U16 f = 0;
+    U32 g = 0;
+    U64 h = 0;
+    F32 i = 0;
+    F64 j = 0;
+    bool k = 0;
+    Element<I8> elemA(a);
+    Element<I16> elemB(b);
+    Element<I32> elemC(c);
+    Element<I64> elemD(d);
+    Element<U8> elemE(e);
+    Element<U16> elemF(f);
+    Element<U32> elemG(g);
+    Element<U64> elemH(h);
+    Element<F32> elemI(i);
+    Element<F64> elemJ(j);
+    Element<bool> elemK(k);
+    const Map<String, IElement*> bindings =
+    {
+        {"a", &elemA},
+        {"b", &elemB},
+        {"c", &elemC},
+        {"d", &elemD},
+        {"e", &elemE},
+        {"f", &elemF},
+        {"g", &elemG},
+        {"h", &elemH},
+        {"i", &elemI},
+        {"j", &elemJ},
+        {"k", &elemK}
+    };
+
+    // Compile expression with both backends.
+    Ref<const ExpressionAssembly> treeAsm;
+    CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
+                                              bindings,
+                                              ElementType::BOOL,
+                                              treeAsm,
+                                              nullptr,
+                                              ExpressionCompiler::TREE));
+    Ref<const ExpressionAssembly> bcAsm;
+    CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
+                                              bindings,
+                                              ElementType::BOOL,
+                                              bcAsm,
+                                              nullptr,
+                                              ExpressionCompiler::BYTECODE));
+    CHECK_EQUAL(IExpression::BYTECODE, bcAsm->root()->nodeType());
+    CHECK_EQUAL(ElementType::BOOL, bcAsm->root()->type());
+    IExprNode<bool>* const treeRoot =
+        dynamic_cast<IExprNode<bool>*>(treeAsm->root().get());
+    IExprNode<bool>* const bcRoot =
+        dynamic_cast<IExprNode<bool>*>(bcAsm->root().get());
+
+    // Backends agree over a range of element values.
+    for (I32 x = -4; x <= 4; ++x)
+    {
+        elemA.write(x);
+        elemB.write(x * 2);
+        elemC.write(x - 1);
+        elemD.write(x * x);
+        elemE.write(x + 4);
+        elemF.write(x + 10);
+        elemG.write(9 - x);
+        elemH.write(x + 5);
+        elemI.write(x * 0.5f);
+        elemJ.write(x * 0.25);
+        elemK.write((x % 2) == 0);
+        CHECK_EQUAL(treeRoot->evaluate(), bcRoot->evaluate());
+    }
+}
+
+///
+/// @test The bytecode backend evaluates a stats function the same as the tree
+/// backend, and the bytecode root node references the expression tree.
+///
+TEST(ExpressionCompiler, BytecodeStatsFunction)
+{
+    // Parse expression.
+    PARSE_EXPR("roll_min(foo + 1, 2) * 2 + roll_range(foo, 3)");
+
+    // Create element bindings.
+    I32 foo = 0;
+    Element<I32> elemFoo(foo);
+    const Map<String, IElement*> bindings =
+    {
+        {"foo", &elemFoo}
+    };
+
+    // Compile expression.
+    Ref<const ExpressionAssembly> exprAsm;
+    CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
+                                              bindings,
+                                              ElementType::FLOAT64,
+                                              exprAsm,
+                                              nullptr,
+                                              ExpressionCompiler::BYTECODE));
+
+    // Get expression stats used by functions.
+    const Vec<Ref<IExpressionStats>> statsVec = exprAsm->stats();
+    CHECK_EQUAL(2, statsVec.size());
+
+    // Get bytecode root and its source tree.
+    CHECK_EQUAL(IExpression::BYTECODE, exprAsm->root()->nodeType());
+    IExprNode<F64>* const root =
+        dynamic_cast<IExprNode<F64>*>(exprAsm->root().get());
+    const IBytecodeExprNode* const bcRoot =
+        dynamic_cast<const IBytecodeExprNode*>(exprAsm->root().get());
+    CHECK_TRUE(bcRoot->src() != nullptr);
+    CHECK_EQUAL(IExpression::UNARY_OP, bcRoot->src()->nodeType());
+    IExprNode<F64>* const src = dynamic_cast<IExprNode<F64>*>(
+        const_cast<IExpression*>(bcRoot->src()));
+
+    // Expression initially evaluates to 0 since stats have not been updated.
+    CHECK_EQUAL(0.0, root->evaluate());
+
+    // Update stats and check expression after each update.
+    const I32 vals[] = {3, -1, 7, 2};
+    const F64 expectVals[] = {8.0, 4.0, 8.0, 14.0};
+    for (U32 i = 0; i < (sizeof(vals) / sizeof(vals[0])); ++i)
+    {
+        elemFoo.write(vals[i]);
+        for (const Ref<IExpressionStats> stats : statsVec)
+        {
+            stats->update();
+        }
+        CHECK_EQUAL(expectVals[i], root->evaluate());
+        CHECK_EQUAL(expectVals[i], src->evaluate());
+    }
+}
+
+///
+/// @test Integer and bool operands other than U64 evaluate in I64, and any U64
+/// or floating operand or division promotes an operator to F64.
+///
+TEST(ExpressionCompiler, EvaluationDomain)
+{
+    I32 a = 0;
+    U32 b = 0;
+    F32 c = 0;
+    bool d = false;
+    U64 e = 0;
+    Element<I32> elemA(a);
+    Element<U32> elemB(b);
+    Element<F32> elemC(c);
+    Element<bool> elemD(d);
+    Element<U64> elemE(e);
+    const Map<String, IElement*> bindings =
+        {{"a", &elemA}, {"b", &elemB}, {"c", &elemC}, {"d", &elemD},
+         {"e", &elemE}};
+
+    checkEvalDomain("1", bindings, ElementType::INT64);
+    checkEvalDomain("-1.5", bindings, ElementType::FLOAT64);
+    checkEvalDomain("true", bindings, ElementType::INT64);
+    checkEvalDomain("a + b * 2 - 1", bindings, ElementType::INT64);
+    checkEvalDomain("a < b and not d", bindings, ElementType::INT64);
+    checkEvalDomain("a + c", bindings, ElementType::FLOAT64);
+    checkEvalDomain("a + 0.5", bindings, ElementType::FLOAT64);
+    checkEvalDomain("not c", bindings, ElementType::FLOAT64);
+    checkEvalDomain("a / 2", bindings, ElementType::FLOAT64);
+    checkEvalDomain("roll_avg(a, 2)", bindings, ElementType::FLOAT64);
+    checkEvalDomain("roll_max(a, 2) > a", bindings, ElementType::FLOAT64);
+    checkEvalDomain("e", bindings, ElementType::FLOAT64);
+    checkEvalDomain("a < e", bindings, ElementType::FLOAT64);
+}
+
+///
+/// @test Integer expressions are exact for values that F64 cannot represent.
+///
+TEST(ExpressionCompiler, IntegerPrecision)
+{
+    I64 n = (1LL << 53);
+    I64 i = ((1LL << 53) + 1);
+    Element<I64> elemN(n);
+    Element<I64> elemI(i);
+    const Map<String, IElement*> bindings = {{"n", &elemN}, {"i", &elemI}};
+
+    checkEvalI64Expr("n + 1", bindings, ((1LL << 53) + 1));
+    checkEvalI64Expr("i - n", bindings, 1);
+    checkEvalI64Expr("i > n", bindings, 1);
+    checkEvalI64Expr("i == n", bindings, 0);
+    checkEvalI64Expr("9007199254740993", bindings, ((1LL << 53) + 1));
+
+    // Integers outside the I64 range are F64 constants.
+    checkEvalI64Expr("99999999999999999999 > 0", bindings, 1);
+}
+
+///
+/// @test U64 values above the I64 maximum do not saturate, so they compare
+/// correctly with each other and with F64 values.
+///
+TEST(ExpressionCompiler, LargeU64)
+{
+    U64 a = (1ULL << 63);
+    U64 b = Limits::max<U64>();
+    Element<U64> elemA(a);
+    Element<U64> elemB(b);
+    const Map<String, IElement*> bindings = {{"a", &elemA}, {"b", &elemB}};
+
+    checkEvalI64Expr("a == b", bindings, 0);
+    checkEvalI64Expr("a != b", bindings, 1);
+    checkEvalI64Expr("a < b", bindings, 1);
+    checkEvalI64Expr("b > a", bindings, 1);
+    checkEvalI64Expr("a == 9223372036854775808", bindings, 1);
+    checkEvalI64Expr("b > 10000000000000000000", bindings, 1);
+    checkEvalI64Expr("b > 1.5 * a", bindings, 1);
+    checkEvalI64Expr("a < 9300000000000000000.0", bindings, 1);
+    checkEvalI64Expr("a > 9223372036854774784", bindings, 1);
+    checkEvalI64Expr("a / 2 == 4611686018427387904", bindings, 1);
+}
+
+///
+/// @test I64 arithmetic saturates instead of overflowing.
+///
+TEST(ExpressionCompiler, IntegerSaturation)
+{
+    I64 n = Limits::max<I64>();
+    I64 m = Limits::min<I64>();
+    Element<I64> elemN(n);
+    Element<I64> elemM(m);
+    const Map<String, IElement*> bindings = {{"n", &elemN}, {"m", &elemM}};
+
+    checkEvalI64Expr("n + 1", bindings, Limits::max<I64>());
+    checkEvalI64Expr("m - 1", bindings, Limits::min<I64>());
+    checkEvalI64Expr("n * 2", bindings, Limits::max<I64>());
+    checkEvalI64Expr("n * -2", bindings, Limits::min<I64>());
+    checkEvalI64Expr("m * -1", bindings, Limits::max<I64>());
+    checkEvalI64Expr("0 - m", bindings, Limits::max<I64>());
+}
+
+///
+/// @test Division of integers is not truncated.
+///
+TEST(ExpressionCompiler, IntegerDivision)
+{
+    checkEvalConstExpr("1 / 2", 0.5);
+    checkEvalConstExpr("7 / 2 * 2", 7.0);
+    checkEvalConstExpr("-7 / 2", -3.5);
+}
+
+///
+/// @test Compiling with a cache folds operators on constants into constants.
+///
+TEST(ExpressionCompiler, ConstantFolding)
+{
+    I32 foo = 3;
+    Element<I32> elemFoo(foo);
+    const Map<String, IElement*> bindings = {{"foo", &elemFoo}};
+    PARSE_EXPR("(1 + 2) * 3 + foo * (4 / 8)");
+    const Ref<ExpressionCache> cache(new ExpressionCache());
+    Ref<const ExpressionAssembly> exprAsm;
+    CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
+                                              bindings,
+                                              ElementType::FLOAT64,
+                                              exprAsm,
+                                              nullptr,
+                                              ExpressionCompiler::TREE,
+                                              cache));
+
+    // Root is a cast of an addition whose LHS was folded into a constant
+    // 9 and whose RHS multiplies `foo` by the folded constant 0.5.
+    const IOpExprNode* const root =
+        dynamic_cast<const IOpExprNode*>(exprAsm->root().get());
+    CHECK_TRUE(root != nullptr);
+    const IOpExprNode* const add =
+        dynamic_cast<const IOpExprNode*>(root->rhs());
+    CHECK_TRUE(add != nullptr);
+    CHECK_EQUAL(IExpression::CONST, add->lhs()->nodeType());
+    CHECK_EQUAL(9.0, dynamic_cast<IExprNode<F64>&>(
+        const_cast<IExpression&>(*add->lhs())).evaluate());
+    const IOpExprNode* const mult =
+        dynamic_cast<const IOpExprNode*>(add->rhs());
+    CHECK_TRUE(mult != nullptr);
+    CHECK_EQUAL(IExpression::CONST, mult->rhs()->nodeType());
+    CHECK_EQUAL(10.5,
+                dynamic_cast<IExprNode<F64>*>(exprAsm->root().get())
+                    ->evaluate());
+
+    // Of the 17 nodes compiled, 8 remain: the root cast, the addition, the
+    // constant 9, the multiplication, the constant 0.5, and `foo` with its 2
+    // casts.
+    CHECK_EQUAL(17, cache->srcNodeCount());
+    CHECK_EQUAL(8, cache->nodeCount());
+}
+
+///
+/// @test Expressions compiled with the same cache share identical
+/// subexpressions, including stats functions.
+///
+TEST(ExpressionCompiler, SharedSubexpressions)
+{
+    I32 foo = 1;
+    F64 bar = 2.0;
+    Element<I32> elemFoo(foo);
+    Element<F64> elemBar(bar);
+    const Map<String, IElement*> bindings = {{"foo", &elemFoo},
+                                             {"bar", &elemBar}};
+    const Ref<ExpressionCache> cache(new ExpressionCache());
+
+    // Compile 2 expressions which share a stats function and an addition
+    // with operands in different orders.
+    Ref<const ExpressionAssembly> exprAsm1;
+    {
+        PARSE_EXPR("roll_max(foo + bar, 2) + (foo + bar)");
+        CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
+                                                  bindings,
+                                                  ElementType::FLOAT64,
+                                                  exprAsm1,
+                                                  nullptr,
+                                                  ExpressionCompiler::TREE,
+                                                  cache));
+    }
+
+    Ref<const ExpressionAssembly> exprAsm2;
+    {
+        PARSE_EXPR("roll_max(bar + foo, 2) + (bar + foo)");
+        CHECK_SUCCESS(ExpressionCompiler::compile(exprParse,
+                                                  bindings,
+                                                  ElementType::FLOAT64,
+                                                  exprAsm2,
+                                                  nullptr,
+                                                  ExpressionCompiler::TREE,
+                                                  cache));
+    }
+
+    // Both root casts cast the same addition node.
+    const IOpExprNode* const root1 =
+        dynamic_cast<const IOpExprNode*>(exprAsm1->root().get());
+    const IOpExprNode* const root2 =
+        dynamic_cast<const IOpExprNode*>(exprAsm2->root().get());
+    CHECK_TRUE(root1 != nullptr);
+    CHECK_TRUE(root2 != nullptr);
+    CHECK_TRUE(root1 != root2);
+    POINTERS_EQUAL(root1->rhs(), root2->rhs());
+
+    // Stats are only created by the first expression, so that they are
+    // updated once per step.
+    CHECK_EQUAL(1, exprAsm1->stats().size());
+    CHECK_EQUAL(0, exprAsm2->stats().size());
+
+    // Both expressions evaluate using the shared stats.
+    exprAsm1->stats()[0]->update();
+    CHECK_EQUAL(6.0, dynamic_cast<IExprNode<F64>*>(exprAsm1->root().get())
+                         ->evaluate());
+    CHECK_EQUAL(6.0, dynamic_cast<IExprNode<F64>*>(exprAsm2->root().get())
+                         ->evaluate());
+
+    // Second expression only added its root cast.
+    CHECK_EQUAL(30, cache->srcNodeCount());
+    CHECK_EQUAL(10, cache->nodeCount());
+}
+
 ///////////////////////////////// Error Tests //////////////////////////////////
 
 ///
@@ -947,6 +1455,15 @@ TEST(ExpressionCompilerErrors, StatsFunctionArity)
     checkCompileError(exprParse, {}, E_EXC_ARITY, 1, 1);
 }
 
+///
+/// @test A stats function call with more than 3 arguments generates an error.
+///
+TEST(ExpressionCompilerErrors, StatsFunctionArityTooMany)
+{
+    PARSE_EXPR("roll_avg(1, 2, true, 4)");
+    checkCompileError(exprParse, {}, E_EXC_ARITY, 1, 1);
+}
+
 ///
 /// @test A stats function call with an erroneous expression as the first
 /// argument generates an error.
@@ -967,6 +1484,16 @@ TEST(ExpressionCompilerErrors, StatsFunctionErrorInArg2)
     checkCompileError(exprParse, {}, E_EXC_ELEM, 1, 13);
 }
 
+///
+/// @test A stats function call with an erroneous expression as the third
+/// argument generates an error.
+///
+TEST(ExpressionCompilerErrors, StatsFunctionErrorInArg3)
+{
+    PARSE_EXPR("roll_avg(4, 2, foo)");
+    checkCompileError(exprParse, {}, E_EXC_ELEM, 1, 16);
+}
+
 ///
 /// @test A stats function call with a zero window size generates an error.
 ///
@@ -933,6 +933,56 @@ TEST(ExpressionParser, FunctionCallThreeArgs)
     CHECK_TRUE(node->right == nullptr);
 }
 
+///
+/// @test A stats function call with the optional third argument, whether the
+/// stats sample while inactive, is parsed correctly.
+///
+TEST(ExpressionParser, StatsFunctionSampleInactiveArg)
+{
+    //      roll_avg
+    //        /
+    //       arg1
+    //      / \
+    //     /   foo
+    //    arg2
+    //   / \
+    //  /   10
+    // arg3
+    //  \
+    //   false
+    TOKENIZE("roll_avg(foo, 10, false)");
+    Ref<const ExpressionParse> parse;
+    CHECK_SUCCESS(ExpressionParser::parse(it, parse, nullptr));
+
+    Ref<const ExpressionParse> node;
+
+    // roll_avg
+    node = parse;
+    CHECK_ARG_CNT(node, 3);
+    CHECK_TRUE(node->data == toks[0]);
+    CHECK_TRUE(node->right == nullptr);
+    CHECK_TRUE(node->func);
+
+    // foo
+    node = parse->left->right;
+    CHECK_TRUE(node->data == toks[2]);
+    CHECK_TRUE(node->left == nullptr);
+    CHECK_TRUE(node->right == nullptr);
+
+    // 10
+    node = parse->left->left->right;
+    CHECK_TRUE(node->data == toks[4]);
+    CHECK_TRUE(node->left == nullptr);
+    CHECK_TRUE(node->right == nullptr);
+
+    // false
+    node = parse->left->left->left->right;
+    CHECK_TRUE(node->data == toks[6]);
+    CHECK_EQUAL(Token::CONSTANT, node->data.type);
+    CHECK_TRUE(node->left == nullptr);
+    CHECK_TRUE(node->right == nullptr);
+}
+
 ///
 /// @test A function call with an argument that is more than a single term is
 /// parsed correctly.
@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/config/utest/UTestMappedFile.cpp
+/// @brief Unit tests for MappedFile.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "sf/config/MappedFile.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Path of file written and mapped by tests.
+///
+static const char* const gMapPath = "mapped-file.tmp";
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Writes a file.
+///
+/// @param[in] kPath  File path.
+/// @param[in] kSrc   File contents.
+///
+static void writeMapFile(const char* const kPath, const String kSrc)
+{
+    std::ofstream ofs(kPath, std::ios::binary);
+    ofs << kSrc;
+}
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Unit tests for MappedFile.
+///
+TEST_GROUP(MappedFile)
+{
+    void teardown()
+    {
+        (void) std::remove(gMapPath);
+    }
+};
+
+///
+/// @test A file is mapped and its contents are viewable.
+///
+TEST(MappedFile, Map)
+{
+    const String src = "foo\nbar\n\nbaz";
+    writeMapFile(gMapPath, src);
+
+    MappedFile file;
+    CHECK_SUCCESS(MappedFile::init(gMapPath, file));
+    CHECK_EQUAL(src.size(), file.size());
+    CHECK_TRUE(file.data() != nullptr);
+    CHECK_EQUAL(0, std::memcmp(src.data(), file.data(), src.size()));
+}
+
+///
+/// @test The mapping remains valid after the file is deleted.
+///
+TEST(MappedFile, MapOutlivesFile)
+{
+    const String src = "foo bar";
+    writeMapFile(gMapPath, src);
+
+    MappedFile file;
+    CHECK_SUCCESS(MappedFile::init(gMapPath, file));
+    CHECK_EQUAL(0, std::remove(gMapPath));
+    CHECK_EQUAL(src.size(), file.size());
+    CHECK_EQUAL(0, std::memcmp(src.data(), file.data(), src.size()));
+}
+
+///
+/// @test An empty file maps to no data.
+///
+TEST(MappedFile, EmptyFile)
+{
+    writeMapFile(gMapPath, "");
+
+    MappedFile file;
+    CHECK_SUCCESS(MappedFile::init(gMapPath, file));
+    CHECK_EQUAL(0, file.size());
+    POINTERS_EQUAL(nullptr, file.data());
+}
+
+///
+/// @test An uninitialized MappedFile views no data.
+///
+TEST(MappedFile, Uninitialized)
+{
+    MappedFile file;
+    CHECK_EQUAL(0, file.size());
+    POINTERS_EQUAL(nullptr, file.data());
+}
+
+///
+/// @test Mapping a nonexistent file fails.
+///
+TEST(MappedFile, ErrorNonexistentFile)
+{
+    MappedFile file;
+    CHECK_ERROR(E_MAP_OPEN, MappedFile::init("foo.bar", file));
+    CHECK_EQUAL(0, file.size());
+    POINTERS_EQUAL(nullptr, file.data());
+}
+
+///
+/// @test Mapping a directory fails.
+///
+TEST(MappedFile, ErrorDirectory)
+{
+    MappedFile file;
+    CHECK_ERROR(E_MAP_OPEN, MappedFile::init(".", file));
+    CHECK_EQUAL(0, file.size());
+    POINTERS_EQUAL(nullptr, file.data());
+}
+
+///
+/// @test Initializing a MappedFile twice fails.
+///
+TEST(MappedFile, ErrorReinitialize)
+{
+    const String src = "foo";
+    writeMapFile(gMapPath, src);
+
+    MappedFile file;
+    CHECK_SUCCESS(MappedFile::init(gMapPath, file));
+    CHECK_ERROR(E_MAP_REINIT, MappedFile::init(gMapPath, file));
+
+    // MappedFile still views the original mapping.
+    CHECK_EQUAL(src.size(), file.size());
+    CHECK_EQUAL(0, std::memcmp(src.data(), file.data(), src.size()));
+}
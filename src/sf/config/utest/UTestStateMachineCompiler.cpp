@@ -348,6 +348,80 @@ TEST(StateMachineCompiler, GuardTakeElseBranch)
     CHECK_LOCAL_ELEM("bar", I32, 1);
 }
 
+///
+/// @test Nested conditionals are compiled to a single contiguous label with
+/// forward jumps over their branches, and execute correctly.
+///
+TEST(StateMachineCompiler, NestedGuardsFlattened)
+{
+    INIT_SV(
+        "[Foo]\n"
+        "U64 time\n"
+        "U32 state\n");
+    INIT_SM(
+        "[state_vector]\n"
+        "U64 time @alias G\n"
+        "U32 state @alias S\n"
+        "\n"
+        "[local]\n"
+        "I32 foo = 0\n"
+        "I32 bar = 0\n"
+        "I32 baz = 0\n"
+        "\n"
+        "[Initial]\n"
+        ".entry\n"
+        "    true {\n"
+        "        foo = 1\n"
+        "        false: bar = 1\n"
+        "        else: bar = 2\n"
+        "    }\n"
+        "    else {\n"
+        "        foo = 2\n"
+        "    }\n"
+        "    baz = 1\n");
+
+    // Entry label is laid out as:
+    //
+    //   0: GUARD true, +7
+    //   1: ACTION foo = 1
+    //   2: GUARD false, +3
+    //   3: ACTION bar = 1
+    //   4: JUMP +2
+    //   5: ACTION bar = 2
+    //   6: JUMP +2
+    //   7: ACTION foo = 2
+    //   8: ACTION baz = 1
+    //   9: END
+    const StateMachine::Instruction* const label =
+        smAsm->config().states[0].entry;
+    CHECK_TRUE(label != nullptr);
+    const StateMachine::Instruction::Opcode ops[] =
+    {
+        StateMachine::Instruction::GUARD,
+        StateMachine::Instruction::ACTION,
+        StateMachine::Instruction::GUARD,
+        StateMachine::Instruction::ACTION,
+        StateMachine::Instruction::JUMP,
+        StateMachine::Instruction::ACTION,
+        StateMachine::Instruction::JUMP,
+        StateMachine::Instruction::ACTION,
+        StateMachine::Instruction::ACTION,
+        StateMachine::Instruction::END
+    };
+    const U32 offsets[] = {7, 0, 3, 0, 2, 0, 2, 0, 0, 0};
+    for (U32 i = 0; i < (sizeof(ops) / sizeof(ops[0])); ++i)
+    {
+        CHECK_EQUAL(ops[i], label[i].op);
+        CHECK_EQUAL(offsets[i], label[i].offset);
+    }
+
+    // Outer if branch and inner else branch are taken.
+    CHECK_SUCCESS(sm.step());
+    CHECK_LOCAL_ELEM("foo", I32, 1);
+    CHECK_LOCAL_ELEM("bar", I32, 2);
+    CHECK_LOCAL_ELEM("baz", I32, 1);
+}
+
 ///
 /// @test Aliases can be used in place of the aliased element name.
 ///
@@ -547,6 +621,154 @@ TEST(StateMachineCompiler, StatsFunctionUsingStateVectorElement)
     CHECK_LOCAL_ELEM("bar", I32, 6);
 }
 
+///
+/// @test Identical stats functions in different expressions share stats which
+/// are updated once per step.
+///
+TEST(StateMachineCompiler, SharedStatsFunction)
+{
+    INIT_SV(
+        "[Foo]\n"
+        "U64 time\n"
+        "U32 state\n"
+        "I32 foo\n");
+    INIT_SM(
+        "[state_vector]\n"
+        "U64 time @alias G\n"
+        "U32 state @alias S\n"
+        "I32 foo\n"
+        "\n"
+        "[local]\n"
+        "I32 bar = 0\n"
+        "I32 baz = 0\n"
+        "\n"
+        "[Initial]\n"
+        ".step\n"
+        "    bar = roll_avg(foo, 2)\n"
+        "    baz = roll_avg(foo, 2) + 1\n");
+
+    // State machine has only 1 expression stats.
+    const StateMachine::Config smConfig = smAsm->config();
+    CHECK_TRUE(smConfig.stats != nullptr);
+    CHECK_TRUE(smConfig.stats[0] != nullptr);
+    POINTERS_EQUAL(nullptr, smConfig.stats[1]);
+
+    SET_SV_ELEM("foo", I32, 3);
+    CHECK_SUCCESS(sm.step());
+    CHECK_LOCAL_ELEM("bar", I32, 3);
+    CHECK_LOCAL_ELEM("baz", I32, 4);
+
+    SET_SV_ELEM("foo", I32, 5);
+    SET_SV_ELEM("time", U64, 1);
+    CHECK_SUCCESS(sm.step());
+    CHECK_LOCAL_ELEM("bar", I32, 4);
+    CHECK_LOCAL_ELEM("baz", I32, 5);
+}
+
+///
+/// @test Each stats is listed as a dependency of the states whose expressions
+/// use it, and stats not used by the current state are sampled so that their
+/// windows are the same as if they were updated.
+///
+TEST(StateMachineCompiler, StatsDependencies)
+{
+    INIT_SV(
+        "[Foo]\n"
+        "U64 time\n"
+        "U32 state\n"
+        "I32 foo\n");
+    INIT_SM(
+        "[state_vector]\n"
+        "U64 time @alias G\n"
+        "U32 state @alias S\n"
+        "I32 foo\n"
+        "\n"
+        "[local]\n"
+        "I32 bar = 0\n"
+        "\n"
+        "[Initial]\n"
+        ".step\n"
+        "    bar = roll_avg(foo, 2)\n"
+        "    -> Foo\n"
+        "\n"
+        "[Foo]\n"
+        ".step\n"
+        "    bar = roll_max(foo, 2) + roll_avg(foo, 2)\n");
+
+    // `roll_avg` stats are used in both states and `roll_max` stats are only
+    // used in state `Foo`.
+    const StateMachine::Config smConfig = smAsm->config();
+    CHECK_TRUE(smConfig.stats[0] != nullptr);
+    CHECK_TRUE(smConfig.stats[1] != nullptr);
+    POINTERS_EQUAL(nullptr, smConfig.stats[2]);
+    CHECK_TRUE(smConfig.statsDeps != nullptr);
+    CHECK_EQUAL(1, smConfig.statsDeps[0].states[0]);
+    CHECK_EQUAL(2, smConfig.statsDeps[0].states[1]);
+    CHECK_EQUAL(StateMachine::NO_STATE, smConfig.statsDeps[0].states[2]);
+    CHECK_TRUE(smConfig.statsDeps[0].sampleInactive);
+    CHECK_EQUAL(2, smConfig.statsDeps[1].states[0]);
+    CHECK_EQUAL(StateMachine::NO_STATE, smConfig.statsDeps[1].states[1]);
+    CHECK_TRUE(smConfig.statsDeps[1].sampleInactive);
+
+    SET_SV_ELEM("foo", I32, 3);
+    CHECK_SUCCESS(sm.step());
+    CHECK_LOCAL_ELEM("bar", I32, 3);
+
+    // `roll_max` window contains the value sampled in the initial state.
+    SET_SV_ELEM("foo", I32, 1);
+    SET_SV_ELEM("time", U64, 1);
+    CHECK_SUCCESS(sm.step());
+    CHECK_LOCAL_ELEM("bar", I32, 5);
+}
+
+///
+/// @test Stats whose function call opts out of sampling while inactive are not
+/// sampled when the current state does not use them.
+///
+TEST(StateMachineCompiler, StatsNotSampledWhileInactive)
+{
+    INIT_SV(
+        "[Foo]\n"
+        "U64 time\n"
+        "U32 state\n"
+        "I32 foo\n");
+    INIT_SM(
+        "[state_vector]\n"
+        "U64 time @alias G\n"
+        "U32 state @alias S\n"
+        "I32 foo\n"
+        "\n"
+        "[local]\n"
+        "I32 bar = 0\n"
+        "\n"
+        "[Initial]\n"
+        ".step\n"
+        "    bar = roll_avg(foo, 2)\n"
+        "    -> Foo\n"
+        "\n"
+        "[Foo]\n"
+        ".step\n"
+        "    bar = roll_max(foo, 2, false) + roll_avg(foo, 2)\n");
+
+    // `roll_max` stats do not sample while inactive.
+    const StateMachine::Config smConfig = smAsm->config();
+    CHECK_TRUE(smConfig.statsDeps != nullptr);
+    CHECK_TRUE(smConfig.statsDeps[0].sampleInactive);
+    CHECK_EQUAL(2, smConfig.statsDeps[1].states[0]);
+    CHECK_EQUAL(StateMachine::NO_STATE, smConfig.statsDeps[1].states[1]);
+    CHECK_FALSE(smConfig.statsDeps[1].sampleInactive);
+
+    SET_SV_ELEM("foo", I32, 3);
+    CHECK_SUCCESS(sm.step());
+    CHECK_LOCAL_ELEM("bar", I32, 3);
+
+    // `roll_max` window contains only the value sampled in state `Foo`.
+    SET_SV_ELEM("foo", I32, 1);
+    SET_SV_ELEM("time", U64, 1);
+    CHECK_SUCCESS(sm.step());
+    CHECK_LOCAL_ELEM("bar", I32, 3);
+}
+
 ///
 /// @test Transitioning to the current state restarts it.
 ///
@@ -176,6 +176,158 @@ TEST(StateVectorAutocoder, SmallStateVector)
         hout.str());
 }
 
+///
+/// @test A state vector with the sequence lock option is autocoded with a
+/// sequence lock per region.
+///
+TEST(StateVectorAutocoder, SeqLockOption)
+{
+    SETUP(
+        "[options]\n"
+        "seqlock\n"
+        "\n"
+        "[Foo]\n"
+        "I32 foo\n"
+        "F64 bar\n"
+        "\n"
+        "[Bar]\n"
+        "bool baz\n");
+    RUN_HARNESS("foo bar baz .Foo .Bar");
+    CHECK_EQUAL(
+        "I32 foo\n"
+        "F64 bar\n"
+        "bool baz\n"
+        "Foo 12\n"
+        "Bar 1\n",
+        hout.str());
+
+    // Autocode defines a sequence lock for each region.
+    std::ifstream autocodeIfs(AUTOCODE_PATH);
+    std::stringstream autocode;
+    autocode << autocodeIfs.rdbuf();
+    CHECK_TRUE(autocode.str().find("static SeqLock seqLock0;")
+               != String::npos);
+    CHECK_TRUE(autocode.str().find("static SeqLock seqLock1;")
+               != String::npos);
+}
+
+///
+/// @test A state vector with the adaptive lock option is autocoded with
+/// adaptive locks.
+///
+TEST(StateVectorAutocoder, AdaptiveLockOption)
+{
+    SETUP(
+        "[options]\n"
+        "adaptive_lock\n"
+        "region_locks\n"
+        "\n"
+        "[Foo]\n"
+        "I32 foo\n"
+        "F64 bar\n"
+        "\n"
+        "[Bar]\n"
+        "bool baz\n");
+    RUN_HARNESS("foo bar baz .Foo .Bar");
+    CHECK_EQUAL(
+        "I32 foo\n"
+        "F64 bar\n"
+        "bool baz\n"
+        "Foo 12\n"
+        "Bar 1\n",
+        hout.str());
+
+    // Autocode defines and initializes an adaptive lock for each region.
+    std::ifstream autocodeIfs(AUTOCODE_PATH);
+    std::stringstream autocode;
+    autocode << autocodeIfs.rdbuf();
+    const String src = autocode.str();
+    CHECK_TRUE(src.find("#include \"sf/pal/AdaptiveLock.hpp\"")
+               != String::npos);
+    CHECK_TRUE(src.find("static AdaptiveLock lock0;") != String::npos);
+    CHECK_TRUE(src.find("static AdaptiveLock lock1;") != String::npos);
+    CHECK_TRUE(src.find("res = AdaptiveLock::init(lock1);") != String::npos);
+    CHECK_TRUE(src.find("Spinlock") == String::npos);
+}
+
+///
+/// @test A state vector with lock groups is autocoded with one lock per lock
+/// group.
+///
+TEST(StateVectorAutocoder, LockGroups)
+{
+    SETUP(
+        "[options]\n"
+        "lock\n"
+        "region_locks\n"
+        "\n"
+        "[Foo] @lock_group nav\n"
+        "I32 foo\n"
+        "\n"
+        "[Bar]\n"
+        "F64 bar\n"
+        "\n"
+        "[Baz] @lock_group nav\n"
+        "bool baz\n");
+    RUN_HARNESS("foo bar baz .Foo .Bar .Baz");
+    CHECK_EQUAL(
+        "I32 foo\n"
+        "F64 bar\n"
+        "bool baz\n"
+        "Foo 4\n"
+        "Bar 8\n"
+        "Baz 1\n",
+        hout.str());
+
+    // Autocode defines 2 locks: one shared by `Foo` and `Baz`, and one for
+    // `Bar`.
+    std::ifstream autocodeIfs(AUTOCODE_PATH);
+    std::stringstream autocode;
+    autocode << autocodeIfs.rdbuf();
+    const String src = autocode.str();
+    CHECK_TRUE(src.find("static Spinlock lock0;") != String::npos);
+    CHECK_TRUE(src.find("static Spinlock lock1;") != String::npos);
+    CHECK_TRUE(src.find("static Spinlock lock2;") == String::npos);
+    CHECK_TRUE(src.find("static Region regionBaz(&backing.Baz, "
+                        "sizeof(backing.Baz), &lock0);")
+               != String::npos);
+}
+
+///
+/// @test Atomic elements are autocoded with atomic access in an aligned
+/// backing.
+///
+TEST(StateVectorAutocoder, AtomicElements)
+{
+    SETUP(
+        "[options]\n"
+        "lock\n"
+        "\n"
+        "[Foo]\n"
+        "U64 foo @atomic\n"
+        "U32 bar @atomic\n"
+        "bool baz\n");
+    RUN_HARNESS("foo bar baz .Foo");
+    CHECK_EQUAL(
+        "U64 foo\n"
+        "U32 bar\n"
+        "bool baz\n"
+        "Foo 13\n",
+        hout.str());
+
+    std::ifstream autocodeIfs(AUTOCODE_PATH);
+    std::stringstream autocode;
+    autocode << autocodeIfs.rdbuf();
+    const String src = autocode.str();
+    CHECK_TRUE(src.find("static struct alignas(8)") != String::npos);
+    CHECK_TRUE(src.find("static Element<U64> elemfoo(backing.Foo.foo, "
+                        "AtomicAccess());")
+               != String::npos);
+    CHECK_TRUE(src.find("static Element<bool> elembaz(backing.Foo.baz, "
+                        "&lock0);")
+               != String::npos);
+}
+
 ///
 /// @test A (relatively) large) state vector is autocoded correctly.
 ///
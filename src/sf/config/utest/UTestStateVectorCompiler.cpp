@@ -485,6 +485,185 @@ TEST(StateVectorCompiler, NewlineAgnostic)
         });
 }
 
+///
+/// @test A state vector with the sequence lock option is compiled correctly,
+/// and its elements and regions access the same backing.
+///
+TEST(StateVectorCompiler, SeqLockOption)
+{
+    TOKENIZE(
+        "[options]\n"
+        "seqlock\n"
+        "[Foo]\n"
+        "I32 foo\n"
+        "[Bar]\n"
+        "F64 bar\n");
+    checkStateVectorConfig(
+        toks,
+        {
+            {"foo", ElementType::INT32},
+            {"bar", ElementType::FLOAT64}
+        },
+        {
+            {"Foo", 4},
+            {"Bar", 8}
+        });
+
+    // Compile state vector again to access it.
+    Ref<const StateVectorParse> parse;
+    CHECK_SUCCESS(StateVectorParser::parse(toks, parse, nullptr));
+    Ref<const StateVectorAssembly> assembly;
+    CHECK_SUCCESS(StateVectorCompiler::compile(parse, assembly, nullptr));
+    StateVector& sv = assembly->get();
+
+    // Element write is visible through the region.
+    Element<I32>* elemFoo = nullptr;
+    CHECK_SUCCESS(sv.getElement("foo", elemFoo));
+    elemFoo->write(42);
+    Region* regionFoo = nullptr;
+    CHECK_SUCCESS(sv.getRegion("Foo", regionFoo));
+    I32 val = 0;
+    CHECK_SUCCESS(regionFoo->read(&val, sizeof(val)));
+    CHECK_EQUAL(42, val);
+
+    // Region write is visible through the element.
+    val = -7;
+    CHECK_SUCCESS(regionFoo->write(&val, sizeof(val)));
+    CHECK_EQUAL(-7, elemFoo->read());
+}
+
+///
+/// @test A state vector with the adaptive lock option is compiled correctly,
+/// and its elements and regions access the same backing.
+///
+TEST(StateVectorCompiler, AdaptiveLockOption)
+{
+    TOKENIZE(
+        "[options]\n"
+        "adaptive_lock region_locks\n"
+        "[Foo]\n"
+        "I32 foo\n"
+        "[Bar]\n"
+        "F64 bar\n");
+    checkStateVectorConfig(
+        toks,
+        {
+            {"foo", ElementType::INT32},
+            {"bar", ElementType::FLOAT64}
+        },
+        {
+            {"Foo", 4},
+            {"Bar", 8}
+        });
+
+    // Compile state vector again to access it.
+    Ref<const StateVectorParse> parse;
+    CHECK_SUCCESS(StateVectorParser::parse(toks, parse, nullptr));
+    Ref<const StateVectorAssembly> assembly;
+    CHECK_SUCCESS(StateVectorCompiler::compile(parse, assembly, nullptr));
+    StateVector& sv = assembly->get();
+
+    // Element write is visible through the region.
+    Element<I32>* elemFoo = nullptr;
+    CHECK_SUCCESS(sv.getElement("foo", elemFoo));
+    elemFoo->write(42);
+    Region* regionFoo = nullptr;
+    CHECK_SUCCESS(sv.getRegion("Foo", regionFoo));
+    I32 val = 0;
+    CHECK_SUCCESS(regionFoo->read(&val, sizeof(val)));
+    CHECK_EQUAL(42, val);
+
+    // Region write is visible through the element.
+    val = -7;
+    CHECK_SUCCESS(regionFoo->write(&val, sizeof(val)));
+    CHECK_EQUAL(-7, elemFoo->read());
+}
+
+///
+/// @test Regions are assigned to lock groups according to the lock options and
+/// lock group annotations.
+///
+TEST(StateVectorCompiler, LockGroups)
+{
+    const String regions =
+        "[A] @lock_group nav\n"
+        "I32 a\n"
+        "[B]\n"
+        "I32 b\n"
+        "[C] @lock_group nav\n"
+        "I32 c\n"
+        "[D]\n"
+        "I32 d\n";
+
+    // Compiles a state vector and checks its region lock groups.
+    auto checkLockGroups = [](const String kSrc, const Vec<U32> kExpect)
+    {
+        std::stringstream ss(kSrc);
+        Ref<const StateVectorAssembly> assembly;
+        CHECK_SUCCESS(StateVectorCompiler::compile(ss, assembly, nullptr));
+        CHECK_TRUE(assembly->regionLockGroups() == kExpect);
+    };
+
+    // Without locks, regions have no lock groups.
+    checkLockGroups("[A]\nI32 a\n[B]\nI32 b\n", {});
+
+    // Ungrouped regions share the state vector lock.
+    checkLockGroups(("[options]\nlock\n" + regions), {0, 1, 0, 1});
+
+    // With region locks, ungrouped regions each get their own lock.
+    checkLockGroups(("[options]\nlock region_locks\n" + regions),
+                    {0, 1, 0, 2});
+
+    // Adaptive locks are grouped the same way as spinlocks.
+    checkLockGroups(("[options]\nadaptive_lock\n" + regions), {0, 1, 0, 1});
+
+    // Sequence locks are per-region by default.
+    checkLockGroups(("[options]\nseqlock\n" + regions), {0, 1, 0, 2});
+}
+
+///
+/// @test Atomic elements are compiled correctly and bypass the state vector
+/// lock.
+///
+TEST(StateVectorCompiler, AtomicElements)
+{
+    TOKENIZE(
+        "[options]\n"
+        "lock\n"
+        "[Foo]\n"
+        "U64 foo @atomic\n"
+        "I32 bar @atomic\n"
+        "U8 baz\n");
+    checkStateVectorConfig(
+        toks,
+        {
+            {"foo", ElementType::UINT64},
+            {"bar", ElementType::INT32},
+            {"baz", ElementType::UINT8}
+        },
+        {
+            {"Foo", 13}
+        });
+
+    Ref<const StateVectorParse> parse;
+    CHECK_SUCCESS(StateVectorParser::parse(toks, parse, nullptr));
+    Ref<const StateVectorAssembly> assembly;
+    CHECK_SUCCESS(StateVectorCompiler::compile(parse, assembly, nullptr));
+    StateVector& sv = assembly->get();
+
+    // Atomic elements are naturally aligned and read and written correctly.
+    Element<U64>* elemFoo = nullptr;
+    CHECK_SUCCESS(sv.getElement("foo", elemFoo));
+    CHECK_EQUAL(0, (reinterpret_cast<uintptr_t>(elemFoo->addr()) % 8));
+    elemFoo->write(23001040778UL);
+    CHECK_EQUAL(23001040778UL, elemFoo->read());
+    Element<I32>* elemBar = nullptr;
+    CHECK_SUCCESS(sv.getElement("bar", elemBar));
+    CHECK_EQUAL(0, (reinterpret_cast<uintptr_t>(elemBar->addr()) % 4));
+    elemBar->write(-7);
+    CHECK_EQUAL(-7, elemBar->read());
+}
+
 ///////////////////////////////// Error Tests //////////////////////////////////
 
 ///
@@ -564,3 +743,16 @@ TEST(StateVectorCompilerErrors, NullParse)
                 StateVectorCompiler::compile(smParse, smAsm, nullptr));
     CHECK_TRUE(smAsm == nullptr);
 }
+
+///
+/// @test An atomic element that is not naturally aligned generates an error.
+///
+TEST(StateVectorCompilerErrors, MisalignedAtomicElement)
+{
+    TOKENIZE(
+        "[Foo]\n"
+        "U8 foo\n"
+        "[Bar]\n"
+        "U32 bar @atomic\n");
+    checkCompileError(toks, E_SVC_ALIGN, 4, 5);
+}
@@ -290,6 +290,129 @@ TEST(StateVectorParser, LockOption)
     CHECK_EQUAL(0, parse->regions[0].elems.size());
 }
 
+///
+/// @test The sequence lock option is parsed correctly.
+///
+TEST(StateVectorParser, SeqLockOption)
+{
+    // Parse state vector.
+    TOKENIZE(
+        "[options]\n"
+        "seqlock\n"
+        "\n"
+        "[Foo]\n");
+    Ref<const StateVectorParse> parse;
+    CHECK_SUCCESS(StateVectorParser::parse(toks, parse, nullptr));
+
+    // Sequence lock option was parsed.
+    CHECK_TRUE(!parse->opts.lock);
+    CHECK_TRUE(parse->opts.seqLock);
+
+    // Foo
+    CHECK_EQUAL(1, parse->regions.size());
+    CHECK_EQUAL("Foo", parse->regions[0].plainName);
+}
+
+///
+/// @test The adaptive lock option is parsed correctly and implies the lock
+/// option.
+///
+TEST(StateVectorParser, AdaptiveLockOption)
+{
+    // Parse state vector.
+    TOKENIZE(
+        "[options]\n"
+        "adaptive_lock\n"
+        "\n"
+        "[Foo]\n");
+    Ref<const StateVectorParse> parse;
+    CHECK_SUCCESS(StateVectorParser::parse(toks, parse, nullptr));
+
+    // Adaptive lock option was parsed.
+    CHECK_TRUE(parse->opts.lock);
+    CHECK_TRUE(parse->opts.adaptiveLock);
+    CHECK_TRUE(!parse->opts.seqLock);
+
+    // Foo
+    CHECK_EQUAL(1, parse->regions.size());
+    CHECK_EQUAL("Foo", parse->regions[0].plainName);
+}
+
+///
+/// @test The region locks option and lock group annotations are parsed
+/// correctly.
+///
+TEST(StateVectorParser, LockGroups)
+{
+    // Parse state vector.
+    TOKENIZE(
+        "[options]\n"
+        "lock\n"
+        "region_locks\n"
+        "\n"
+        "[Foo] @lock_group nav\n"
+        "I32 foo\n"
+        "[Bar]\n"
+        "I32 bar\n");
+    Ref<const StateVectorParse> parse;
+    CHECK_SUCCESS(StateVectorParser::parse(toks, parse, nullptr));
+
+    // Options were parsed.
+    CHECK_TRUE(parse->opts.lock);
+    CHECK_TRUE(parse->opts.regionLocks);
+
+    // Foo is in lock group `nav`.
+    CHECK_EQUAL(2, parse->regions.size());
+    CHECK_EQUAL("Foo", parse->regions[0].plainName);
+    CHECK_EQUAL("nav", parse->regions[0].tokLockGroup.str);
+    CHECK_EQUAL(1, parse->regions[0].elems.size());
+
+    // Bar is not in a lock group.
+    CHECK_EQUAL("Bar", parse->regions[1].plainName);
+    CHECK_EQUAL("", parse->regions[1].tokLockGroup.str);
+    CHECK_EQUAL(1, parse->regions[1].elems.size());
+}
+
+///
+/// @test The region locks option may precede the lock option.
+///
+TEST(StateVectorParser, RegionLocksBeforeLock)
+{
+    TOKENIZE(
+        "[options]\n"
+        "region_locks\n"
+        "adaptive_lock\n"
+        "\n"
+        "[Foo]\n"
+        "I32 foo\n");
+    Ref<const StateVectorParse> parse;
+    CHECK_SUCCESS(StateVectorParser::parse(toks, parse, nullptr));
+    CHECK_TRUE(parse->opts.regionLocks);
+    CHECK_TRUE(parse->opts.adaptiveLock);
+}
+
+///
+/// @test Atomic element annotations are parsed correctly.
+///
+TEST(StateVectorParser, AtomicAnnotation)
+{
+    // Parse state vector.
+    TOKENIZE(
+        "[Foo]\n"
+        "U64 foo @atomic\n"
+        "U32 bar\n");
+    Ref<const StateVectorParse> parse;
+    CHECK_SUCCESS(StateVectorParser::parse(toks, parse, nullptr));
+
+    // `foo` is atomic and `bar` is not.
+    CHECK_EQUAL(1, parse->regions.size());
+    CHECK_EQUAL(2, parse->regions[0].elems.size());
+    CHECK_EQUAL("foo", parse->regions[0].elems[0].tokName.str);
+    CHECK_TRUE(parse->regions[0].elems[0].atomic);
+    CHECK_EQUAL("bar", parse->regions[0].elems[1].tokName.str);
+    CHECK_TRUE(!parse->regions[0].elems[1].atomic);
+}
+
 ///
 /// @test An empty options section is parsed correctly.
 ///
@@ -388,3 +511,115 @@ TEST(StateVectorParserErrors, UnknownOption)
         "foo\n");
     checkParseError(toks, E_SVP_OPT, 2, 1);
 }
+
+///
+/// @test Specifying both the lock and sequence lock options generates an error.
+///
+TEST(StateVectorParserErrors, ConflictingLockOptions)
+{
+    TOKENIZE(
+        "[options]\n"
+        "lock\n"
+        "seqlock\n");
+    checkParseError(toks, E_SVP_OPT, 3, 1);
+}
+
+///
+/// @test Specifying both the adaptive lock and sequence lock options generates
+/// an error.
+///
+TEST(StateVectorParserErrors, ConflictingAdaptiveLockOptions)
+{
+    TOKENIZE(
+        "[options]\n"
+        "seqlock\n"
+        "adaptive_lock\n");
+    checkParseError(toks, E_SVP_OPT, 3, 1);
+}
+
+///
+/// @test The region locks option in a state vector without locks generates an
+/// error.
+///
+TEST(StateVectorParserErrors, RegionLocksWithoutLock)
+{
+    TOKENIZE(
+        "[options]\n"
+        "region_locks\n"
+        "\n"
+        "[Foo]\n"
+        "I32 foo\n");
+    checkParseError(toks, E_SVP_OPT, 2, 1);
+}
+
+///
+/// @test An unknown region annotation generates an error.
+///
+TEST(StateVectorParserErrors, UnknownRegionAnnotation)
+{
+    TOKENIZE(
+        "[options]\n"
+        "lock\n"
+        "[Foo] @foo\n"
+        "I32 foo\n");
+    checkParseError(toks, E_SVP_ANNOT, 3, 7);
+}
+
+///
+/// @test A lock group annotation without a group name generates an error.
+///
+TEST(StateVectorParserErrors, MissingLockGroupName)
+{
+    TOKENIZE(
+        "[options]\n"
+        "lock\n"
+        "[Foo] @lock_group\n"
+        "I32 foo\n");
+    checkParseError(toks, E_SVP_LOCK_GRP, 3, 7);
+}
+
+///
+/// @test Putting a region in multiple lock groups generates an error.
+///
+TEST(StateVectorParserErrors, MultipleLockGroups)
+{
+    TOKENIZE(
+        "[options]\n"
+        "lock\n"
+        "[Foo] @lock_group a @lock_group b\n"
+        "I32 foo\n");
+    checkParseError(toks, E_SVP_LOCK_GRP, 3, 21);
+}
+
+///
+/// @test A lock group in a state vector without locks generates an error.
+///
+TEST(StateVectorParserErrors, LockGroupWithoutLock)
+{
+    TOKENIZE(
+        "[Foo] @lock_group nav\n"
+        "I32 foo\n");
+    checkParseError(toks, E_SVP_LOCK_GRP, 1, 19);
+}
+
+///
+/// @test An unknown element annotation generates an error.
+///
+TEST(StateVectorParserErrors, UnknownElementAnnotation)
+{
+    TOKENIZE(
+        "[Foo]\n"
+        "I32 foo @foo\n");
+    checkParseError(toks, E_SVP_ANNOT, 2, 9);
+}
+
+///
+/// @test A redundant atomic annotation generates an error.
+///
+TEST(StateVectorParserErrors, RedundantAtomicAnnotation)
+{
+    TOKENIZE(
+        "[Foo]\n"
+        "I32 foo @atomic @atomic\n");
+    checkParseError(toks, E_SVP_ANNOT, 2, 17);
+}
@@ -21,6 +21,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <sstream>
 
 #include "sf/config/Tokenizer.hpp"
@@ -336,3 +338,68 @@ TEST(Tokenizer, NonexistentInputFile)
     CHECK_TRUE(err.text.size() > 0);
     CHECK_TRUE(err.subtext.size() > 0);
 }
+
+///
+/// @test Tokenizing a file by path gives the same tokens as tokenizing its
+/// contents from a stream.
+///
+TEST(Tokenizer, InputFile)
+{
+    const char* const path = "tokenizer-input.tmp";
+    const String src = "[foo]\nI32 bar = 1 # baz\n\n.step\nqux = bar == 2";
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << src;
+    }
+
+    Vec<Token> toksFile;
+    ErrorInfo err;
+    const Result res = Tokenizer::tokenize(path, toksFile, &err);
+    (void) std::remove(path);
+    CHECK_SUCCESS(res);
+    CHECK_TRUE(err.filePath == path);
+    CHECK_TRUE(err.source == src);
+
+    std::stringstream ss(src);
+    Vec<Token> toksStream;
+    CHECK_SUCCESS(Tokenizer::tokenize(ss, toksStream, nullptr));
+    CHECK_EQUAL(toksStream, toksFile);
+}
+
+///
+/// @test The buffer entry point stops at the buffer size rather than at a null
+/// terminator.
+///
+TEST(Tokenizer, BufferNotNullTerminated)
+{
+    const char buf[] = {'f', 'o', 'o', '\n', 'b', 'a', 'r'};
+    Vec<Token> toks;
+    CHECK_SUCCESS(Tokenizer::tokenize(buf, 6, toks, nullptr));
+
+    const Vec<Token> toksExpect =
+    {
+        {Token::IDENTIFIER, "foo", 1, 1},
+        {Token::NEWLINE, "(newline)", 1, 4},
+        {Token::IDENTIFIER, "ba", 2, 1}
+    };
+    CHECK_EQUAL(toksExpect, toks);
+}
+
+///
+/// @test An error on a line after the first is pretty-printed with the
+/// offending line.
+///
+TEST(Tokenizer, ErrorPrettified)
+{
+    std::stringstream ss("foo\nbar $ baz\nqux\n");
+    Vec<Token> toks;
+    ErrorInfo err;
+    CHECK_ERROR(E_TOK_INVALID, Tokenizer::tokenize(ss, toks, &err));
+    CHECK_EQUAL(2, err.lineNum);
+    CHECK_EQUAL(5, err.colNum);
+
+    const String msg = err.prettifyError();
+    CHECK_TRUE(msg.find("bar $ baz") != String::npos);
+    CHECK_TRUE(msg.find("foo") == String::npos);
+    CHECK_TRUE(msg.find("qux") == String::npos);
+}
@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/config/utest/UTestTokenizerDifferential.cpp
+/// @brief Differential tests checking Tokenizer against a regex-based
+///        reference tokenizer.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cctype>
+#include <fstream>
+#include <regex>
+#include <sstream>
+
+#include "sf/config/Tokenizer.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Token types and the regexes that match them, in match priority
+/// order. This is the original specification of the config language lexicon
+/// which Tokenizer implements by hand.
+///
+static const Vec<std::pair<Token::Type, std::regex>> gRegexes =
+{
+    {Token::SECTION, std::regex("\\s*(\\[[a-zA-Z0-9_/]+\\])\\s*")},
+    {Token::LABEL, std::regex("\\s*([.][a-zA-Z_][a-zA-Z0-9_\\[\\]-]+)\\s*")},
+    {Token::KEYWORD, std::regex("\\s*(if|else|->)\\s*")},
+    {Token::CONSTANT, std::regex("\\s*(true|false|[-]?[0-9]*\\.?[0-9]+)\\s*")},
+    {Token::ANNOTATION, std::regex("\\s*(@[a-zA-Z_][a-zA-Z0-9_=]*)\\s*")},
+    {Token::OPERATOR, std::regex(
+        "\\s*(==|!=|=|!|<=|<|>=|>|and|or|not|\\+|\\-|\\*|/)\\s*")},
+    {Token::IDENTIFIER, std::regex("\\s*([a-zA-Z_][a-zA-Z0-9_]*)\\s*")},
+    {Token::COLON, std::regex("\\s*(:)\\s*")},
+    {Token::LPAREN, std::regex("\\s*(\\()\\s*")},
+    {Token::RPAREN, std::regex("\\s*(\\))\\s*")},
+    {Token::COMMENT, std::regex("\\s*(#.*)\\s*")},
+    {Token::LBRACE, std::regex("\\s*(\\{)\\s*")},
+    {Token::RBRACE, std::regex("\\s*(\\})\\s*")},
+    {Token::COMMA, std::regex("\\s*(,)\\s*")}
+};
+
+///
+/// @brief Fragments randomly concatenated into fuzz input lines. These are
+/// chosen to hit the boundaries between token types.
+///
+static const char* const gFragments[] =
+{
+    " ", "  ", "\t", "\r", "if", "else", "->", "-", "--", "true", "false",
+    "0", "12", ".", ".5", "3.", "e", "_", "x", "foo", "and", "or", "not",
+    "==", "=", "!", "<", ">", "+", "*", "/", "@", "@a=", "[", "]", "[a/b]",
+    ".a", ".ab", "-]", ":", "(", ")", "{", "}", ",", "#", "# c", "$"
+};
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Reference tokenizer that matches token regexes at each position in
+/// each line. This is the original Tokenizer implementation.
+///
+/// @param[in]  kSrc     Source to tokenize.
+/// @param[out] kToks    Tokens.
+/// @param[out] kErrCol  On error, column of the invalid token.
+///
+/// @returns Result of tokenizing, with the same meaning as for Tokenizer.
+///
+static Result refTokenize(const String& kSrc, Vec<Token>& kToks, I32& kErrCol)
+{
+    std::stringstream ss(kSrc);
+    String line;
+    I32 lineNum = 1;
+    while (std::getline(ss, line))
+    {
+        U32 idx = 0;
+        while ((idx < line.size()) && std::isspace(line[idx]))
+        {
+            ++idx;
+        }
+
+        while (idx < line.size())
+        {
+            bool matched = false;
+            for (const std::pair<Token::Type, std::regex>& tokType : gRegexes)
+            {
+                const String substr = line.substr(idx);
+                std::smatch match;
+                if (std::regex_search(substr,
+                                      match,
+                                      tokType.second,
+                                      std::regex_constants::match_continuous))
+                {
+                    if (tokType.first != Token::COMMENT)
+                    {
+                        kToks.push_back({tokType.first,
+                                         match[1].str(),
+                                         lineNum,
+                                         static_cast<I32>(idx + 1),
+                                         nullptr,
+                                         nullptr});
+                    }
+                    idx += match[0].str().size();
+                    matched = true;
+                    break;
+                }
+            }
+
+            if (!matched)
+            {
+                kToks.clear();
+                kErrCol = (idx + 1);
+                return E_TOK_INVALID;
+            }
+        }
+
+        if (!ss.eof() && !ss.fail())
+        {
+            kToks.push_back({Token::NEWLINE,
+                             "(newline)",
+                             lineNum,
+                             static_cast<I32>(line.size() + 1),
+                             nullptr,
+                             nullptr});
+        }
+
+        ++lineNum;
+    }
+
+    return SUCCESS;
+}
+
+///
+/// @brief Checks that Tokenizer and the reference tokenizer produce the same
+/// result, tokens, and error location for a source.
+///
+/// @param[in] kSrc  Source to tokenize.
+///
+static void checkSameTokens(const String& kSrc)
+{
+    Vec<Token> toksRef;
+    I32 errColRef = 0;
+    const Result resRef = refTokenize(kSrc, toksRef, errColRef);
+
+    std::stringstream ss(kSrc);
+    Vec<Token> toks;
+    ErrorInfo err;
+    const Result res = Tokenizer::tokenize(ss, toks, &err);
+
+    CHECK_EQUAL(resRef, res);
+    CHECK_EQUAL(toksRef, toks);
+    if (res != SUCCESS)
+    {
+        CHECK_EQUAL(errColRef, err.colNum);
+    }
+}
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Differential tests for Tokenizer.
+///
+TEST_GROUP(TokenizerDifferential)
+{
+};
+
+///
+/// @test Config files in the repository tokenize the same.
+///
+TEST(TokenizerDifferential, RepoConfigs)
+{
+    const char* const files[] =
+    {
+        "fib.sm",
+        "fib.sv",
+        "nonsense.sm",
+        "nonsense.sv",
+        "safe-conversion.sm",
+        "safe-conversion.sv"
+    };
+
+    for (const char* const file : files)
+    {
+        const String path = (SF_REPO_PATH PATH_SEP "src" PATH_SEP "sf" PATH_SEP
+                             "config" PATH_SEP "utest" PATH_SEP
+                             "utest-sm-autocoder-harness" PATH_SEP "configs"
+                             PATH_SEP + String(file));
+        std::ifstream ifs(path);
+        CHECK_TRUE(ifs.is_open());
+        std::stringstream src;
+        src << ifs.rdbuf();
+        checkSameTokens(src.str());
+    }
+}
+
+///
+/// @test Inputs on the boundaries between token types tokenize the same.
+///
+TEST(TokenizerDifferential, EdgeCases)
+{
+    const char* const srcs[] =
+    {
+        "", "\n", "\n\n", " \t\r\n", "iffy", "elsewhere", "x_if", "order",
+        "android", "notify", "nota", "truthy", "falsey", "truex", "1.", "1..2",
+        "1.2.3", ".5", "-.5", "-5", "- 5", "x-5", "-x", "->x", "-->", "1e5",
+        "007", ".a", ".ab", ".a-b][", ".5a", "..", "[]", "[a", "[a]]", "[a b]",
+        "@", "@1", "@a==b", "a==b", "a=!b", "a!=b", "a<=>b", "#", "# a\rb",
+        "a # b # c", "foo\r", "foo\r\nbar", "\tfoo \t bar\t", "a$", "$",
+        "a\nb\n", "a\n$\nb", "(x,y){z}:w", "\x80", "a\x80"
+    };
+
+    for (const char* const src : srcs)
+    {
+        checkSameTokens(src);
+    }
+}
+
+///
+/// @test Random concatenations of token fragments tokenize the same.
+///
+TEST(TokenizerDifferential, Fuzz)
+{
+    const U32 fragCnt = (sizeof(gFragments) / sizeof(gFragments[0]));
+    U32 rng = 1;
+    for (U32 i = 0; i < 5000; ++i)
+    {
+        String src;
+        const U32 lineCnt = (1 + (i % 3));
+        for (U32 j = 0; j < lineCnt; ++j)
+        {
+            const U32 len = (1 + (i % 8));
+            for (U32 k = 0; k < len; ++k)
+            {
+                rng = ((rng * 1103515245) + 12345);
+                src += gFragments[(rng >> 16) % fragCnt];
+            }
+            src += '\n';
+        }
+        checkSameTokens(src);
+    }
+}
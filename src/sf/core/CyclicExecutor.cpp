@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/core/Assert.hpp"
+#include "sf/core/CyclicExecutor.hpp"
+#include "sf/core/Diagnostic.hpp"
+#include "sf/pal/Clock.hpp"
+
+namespace Sf
+{
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Computes the greatest common divisor of two numbers.
+///
+/// @param[in] kA  First number.
+/// @param[in] kB  Second number.
+///
+/// @return GCD of kA and kB.
+///
+static U64 gcd(U64 kA, U64 kB)
+{
+    while (kB != 0)
+    {
+        const U64 rem = (kA % kB);
+        kA = kB;
+        kB = rem;
+    }
+
+    return kA;
+}
+
+/////////////////////////////////// Public /////////////////////////////////////
+
+Result CyclicExecutor::init(const Config kConfig, CyclicExecutor& kExe)
+{
+    // Check that executor is not already initialized.
+    if (kExe.mMinorFrameNs != 0)
+    {
+        return E_EXE_REINIT;
+    }
+
+    // Check that tasks array is non-null.
+    if (kConfig.tasks == nullptr)
+    {
+        return E_EXE_NULL;
+    }
+
+    // Compute the minor frame as the GCD of the task periods and the major
+    // frame as their LCM.
+    U64 minorFrameNs = 0;
+    U64 majorFrameNs = 1;
+    for (const TaskConfig* cfg = kConfig.tasks; cfg->task != nullptr; ++cfg)
+    {
+        if (cfg->periodNs == 0)
+        {
+            return E_EXE_PERIOD;
+        }
+
+        minorFrameNs = gcd(minorFrameNs, cfg->periodNs);
+
+        // LCM(a, b) = a / GCD(a, b) * b. Check that the multiplication does
+        // not overflow.
+        const U64 factor = (majorFrameNs / gcd(majorFrameNs, cfg->periodNs));
+        if (factor > (static_cast<U64>(-1) / cfg->periodNs))
+        {
+            return E_EXE_OVFL;
+        }
+        majorFrameNs = (factor * cfg->periodNs);
+    }
+
+    // Check that config contains at least 1 task.
+    if (minorFrameNs == 0)
+    {
+        return E_EXE_EMPTY;
+    }
+
+    // Initialize tasks.
+    for (TaskConfig* cfg = kConfig.tasks; cfg->task != nullptr; ++cfg)
+    {
+        const Result res = cfg->task->init();
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+    }
+
+    // Config is valid- assign executor members so that the interface is
+    // usable.
+    kExe.mConfig = kConfig;
+    kExe.mMinorFrameNs = minorFrameNs;
+    kExe.mFrameCnt = (majorFrameNs / minorFrameNs);
+    kExe.mFrame = 0;
+    kExe.mFrameStartNs = Clock::NO_TIME;
+
+    return SUCCESS;
+}
+
+CyclicExecutor::CyclicExecutor() :
+    mConfig({nullptr}),
+    mMinorFrameNs(0),
+    mFrameCnt(0),
+    mFrame(0),
+    mFrameStartNs(Clock::NO_TIME)
+{
+}
+
+Result CyclicExecutor::step()
+{
+    // Check that executor is initialized.
+    if (mMinorFrameNs == 0)
+    {
+        return E_EXE_UNINIT;
+    }
+
+    SF_SAFE_ASSERT(mConfig.tasks != nullptr);
+
+    // The first step starts the schedule. Subsequent steps sleep until the
+    // start of their frame, which returns immediately if the executor is
+    // running late.
+    if (mFrameStartNs == Clock::NO_TIME)
+    {
+        mFrameStartNs = Clock::nanoTime();
+    }
+    else
+    {
+        Clock::sleepUntil(mFrameStartNs);
+    }
+
+    // Step tasks due in this frame, i.e., tasks whose period divides the
+    // frame's offset into the major frame.
+    const U64 frameOffsetNs = (mFrame * mMinorFrameNs);
+    Result res = SUCCESS;
+    for (TaskConfig* cfg = mConfig.tasks; cfg->task != nullptr; ++cfg)
+    {
+        if ((frameOffsetNs % cfg->periodNs) != 0)
+        {
+            continue;
+        }
+
+        const U64 startNs = Clock::nanoTime();
+        Diag::errsc(cfg->task->step(), res);
+
+        // Update task stats.
+        TaskStats* const stats = cfg->stats;
+        if (stats != nullptr)
+        {
+            const U64 endNs = Clock::nanoTime();
+            const U64 jitterNs =
+                ((startNs > mFrameStartNs) ? (startNs - mFrameStartNs) : 0);
+            ++stats->steps;
+            stats->jitterSumNs += jitterNs;
+            if (jitterNs > stats->jitterMaxNs)
+            {
+                stats->jitterMaxNs = jitterNs;
+            }
+            if (endNs > (mFrameStartNs + cfg->periodNs))
+            {
+                ++stats->overruns;
+            }
+        }
+    }
+
+    // Advance to the next frame.
+    mFrame = ((mFrame + 1) % mFrameCnt);
+    mFrameStartNs += mMinorFrameNs;
+
+    return res;
+}
+
+U64 CyclicExecutor::minorFrameNs() const
+{
+    return mMinorFrameNs;
+}
+
+U64 CyclicExecutor::majorFrameNs() const
+{
+    return (mMinorFrameNs * mFrameCnt);
+}
+
+} // namespace Sf
@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/CyclicExecutor.hpp
+/// @brief Cyclic executive for running tasks at fixed rates.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_CYCLIC_EXECUTOR_HPP
+#define SF_CYCLIC_EXECUTOR_HPP
+
+#include "sf/core/BasicTypes.hpp"
+#include "sf/core/Result.hpp"
+#include "sf/core/Task.hpp"
+
+namespace Sf
+{
+
+///
+/// @brief Deterministic cyclic executive which runs tasks at fixed rates on
+/// the calling thread.
+///
+/// Each task has a period. The minor frame is the greatest common divisor of
+/// the task periods, and the major frame is their least common multiple, after
+/// which the schedule repeats. Each call to step() sleeps until the start of
+/// the next minor frame and then steps every task whose period divides the
+/// frame's offset into the major frame. Tasks due in the same frame run in the
+/// order they appear in the config, so faster tasks should usually be listed
+/// first.
+///
+/// Frame start times are absolute multiples of the minor frame from the first
+/// step, so the schedule does not drift. If a frame runs long, the following
+/// frames start late until the executive catches up; frames are never skipped.
+///
+/// For each task, the executive optionally records overruns and release
+/// jitter. A task overruns when it finishes after its next release. Release
+/// jitter is how late a task started relative to its scheduled release, which
+/// includes the execution time of tasks before it in the same frame.
+///
+/// @remark Basic steps to run tasks with a cyclic executor:
+///
+///   1. Construct tasks
+///   2. Define a null-terminated array of CyclicExecutor::TaskConfig, one per
+///      task
+///   3. Initialize a CyclicExecutor with CyclicExecutor::init(), which also
+///      initializes the tasks
+///   4. Invoke step() on the executor in a loop
+///
+class CyclicExecutor final
+{
+public:
+
+    ///
+    /// @brief Execution stats for a task.
+    ///
+    struct TaskStats final
+    {
+        U64 steps;       ///< Number of times task was stepped.
+        U64 overruns;    ///< Number of steps that finished past the deadline.
+        U64 jitterMaxNs; ///< Max release jitter in nanoseconds.
+        U64 jitterSumNs; ///< Sum of release jitters in nanoseconds.
+    };
+
+    ///
+    /// @brief Task config.
+    ///
+    struct TaskConfig final
+    {
+        ///
+        /// @brief Task, or null to terminate a task config array.
+        ///
+        ITask* task;
+
+        ///
+        /// @brief Task period in nanoseconds.
+        ///
+        U64 periodNs;
+
+        ///
+        /// @brief Stats updated every time the task steps, or null if not
+        /// recording stats.
+        ///
+        TaskStats* stats;
+    };
+
+    ///
+    /// @brief Executor config.
+    ///
+    struct Config final
+    {
+        ///
+        /// @brief Array of task configs terminated by a config with a null
+        /// task.
+        ///
+        TaskConfig* tasks;
+    };
+
+    ///
+    /// @brief Initializes a cyclic executor from a config. The frame sizes
+    /// are computed from the task periods, and then each task is initialized.
+    ///
+    /// @pre  kExe is uninitialized.
+    /// @post On success, kExe is initialized and invoking methods on it may
+    ///       succeed.
+    /// @post On error, kExe is uninitialized. Tasks before the task that
+    ///       failed to initialize may be initialized.
+    ///
+    /// @param[in] kConfig  Executor config.
+    /// @param[in] kExe     Executor to initialize.
+    ///
+    /// @retval SUCCESS       Successfully initialized executor.
+    /// @retval E_EXE_REINIT  Executor is already initialized.
+    /// @retval E_EXE_NULL    Config tasks array is null.
+    /// @retval E_EXE_EMPTY   Config contains no tasks.
+    /// @retval E_EXE_PERIOD  A task has a period of 0.
+    /// @retval E_EXE_OVFL    Major frame is too large to represent.
+    /// @retval [other]       Error returned by a task init().
+    ///
+    static Result init(const Config kConfig, CyclicExecutor& kExe);
+
+    ///
+    /// @brief Default constructor.
+    ///
+    /// @post The constructed CyclicExecutor is uninitialized and invoking any
+    /// of its methods returns an error.
+    ///
+    CyclicExecutor();
+
+    ///
+    /// @brief Sleeps until the start of the next minor frame and steps the
+    /// tasks due in that frame. The first call starts the schedule
+    /// immediately.
+    ///
+    /// @note All tasks due in the frame are stepped even if one of them
+    /// returns an error.
+    ///
+    /// @retval SUCCESS       Successfully stepped all tasks due in the frame.
+    /// @retval E_EXE_UNINIT  Executor is uninitialized.
+    /// @retval [other]       First error returned by a task step().
+    ///
+    Result step();
+
+    ///
+    /// @brief Gets the minor frame size.
+    ///
+    /// @return Minor frame in nanoseconds, or 0 if uninitialized.
+    ///
+    U64 minorFrameNs() const;
+
+    ///
+    /// @brief Gets the major frame size.
+    ///
+    /// @return Major frame in nanoseconds, or 0 if uninitialized.
+    ///
+    U64 majorFrameNs() const;
+
+    CyclicExecutor(const CyclicExecutor&) = delete;
+    CyclicExecutor(CyclicExecutor&&) = delete;
+    CyclicExecutor& operator=(const CyclicExecutor&) = delete;
+    CyclicExecutor& operator=(CyclicExecutor&&) = delete;
+
+private:
+
+    ///
+    /// @brief Executor config.
+    ///
+    Config mConfig;
+
+    ///
+    /// @brief Minor frame in nanoseconds, or 0 if uninitialized.
+    ///
+    U64 mMinorFrameNs;
+
+    ///
+    /// @brief Number of minor frames in the major frame.
+    ///
+    U64 mFrameCnt;
+
+    ///
+    /// @brief Index of the next minor frame in the major frame.
+    ///
+    U64 mFrame;
+
+    ///
+    /// @brief Start time of the next minor frame, or Clock::NO_TIME if the
+    /// executor has not stepped.
+    ///
+    U64 mFrameStartNs;
+};
+
+} // namespace Sf
+
+#endif
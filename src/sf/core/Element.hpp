@@ -25,6 +25,7 @@
 
 #include "sf/core/Assert.hpp"
 #include "sf/core/BasicTypes.hpp"
+#include "sf/core/SeqLock.hpp"
 #include "sf/pal/Lock.hpp"
 
 namespace Sf
@@ -85,6 +86,16 @@ public:
     virtual U32 size() const = 0;
 };
 
+///
+/// @brief Tag type which selects atomic access when passed to the Element
+/// constructor.
+///
+/// @see Element::Element(T&, AtomicAccess)
+///
+struct AtomicAccess final
+{
+};
+
 ///
 /// @brief An element is a strongly-typed variable in a state vector.
 ///
@@ -139,8 +150,55 @@ public:
     /// @param[in] mLock    Lock to be acquired and released on every element
     ///                     access.
     ///
-    Element(T& kBacking, ILock* const kLock) : mBacking(kBacking), mLock(kLock)
+    Element(T& kBacking, ILock* const kLock) :
+        mBacking(kBacking),
+        mLock(kLock),
+        mSeqLock(nullptr),
+        mAccess((kLock != nullptr) ? LOCK : UNSYNCED)
+    {
+    }
+
+    ///
+    /// @brief Constructor for a thread-safe element guarded by a sequence
+    /// lock. Reads never block writes; a read that overlaps a write is retried.
+    ///
+    /// @remark The element backing should be inaccessible to anything which is
+    /// not the element. The backing must live at least as long as the element
+    /// it backs.
+    ///
+    /// @param[in] backing   Element backing. The backing must live at least as
+    ///                      long as the element.
+    /// @param[in] kSeqLock  Sequence lock guarding the element. This is
+    ///                      usually shared by all elements in a region.
+    ///
+    Element(T& kBacking, SeqLock& kSeqLock) :
+        mBacking(kBacking),
+        mLock(nullptr),
+        mSeqLock(&kSeqLock),
+        mAccess(SEQ_LOCK)
+    {
+    }
+
+    ///
+    /// @brief Constructor for a thread-safe element accessed atomically. Writes
+    /// are atomic release stores and reads are atomic acquire loads, so no
+    /// lock is taken. This suits elements with a single writer.
+    ///
+    /// @warning The backing must be naturally aligned, i.e., its address must
+    /// be a multiple of sizeof(T). When asserts are enabled, the constructor
+    /// asserts that this is the case.
+    ///
+    /// @remark Region accesses do not synchronize with atomic element
+    /// accesses, so a region read may observe the element before or after a
+    /// concurrent element write.
+    ///
+    /// @param[in] backing  Element backing. The backing must live at least as
+    ///                     long as the element.
+    ///
+    Element(T& kBacking, const AtomicAccess) :
+        mBacking(kBacking), mLock(nullptr), mSeqLock(nullptr), mAccess(ATOMIC)
     {
+        SF_ASSERT((reinterpret_cast<uintptr_t>(&kBacking) % sizeof(T)) == 0);
     }
 
     ///
@@ -154,22 +212,38 @@ public:
     ///
     void write(const T kVal) const
     {
-        if (mLock != nullptr)
+        switch (mAccess)
         {
-            // Acquire element lock.
-            const Result res = mLock->acquire();
-            (void) res;
-            SF_ASSERT(res == SUCCESS);
-        }
+            case UNSYNCED:
+                mBacking = kVal;
+                break;
 
-        mBacking = kVal;
+            case ATOMIC:
+            {
+                T val = kVal;
+                __atomic_store(&mBacking, &val, __ATOMIC_RELEASE);
+                break;
+            }
 
-        if (mLock != nullptr)
-        {
-            // Release element lock.
-            const Result res = mLock->release();
-            (void) res;
-            SF_ASSERT(res == SUCCESS);
+            case SEQ_LOCK:
+                mSeqLock->writeBegin();
+                mBacking = kVal;
+                mSeqLock->writeEnd();
+                break;
+
+            default:
+            {
+                // Acquire element lock.
+                Result res = mLock->acquire();
+                (void) res;
+                SF_ASSERT(res == SUCCESS);
+
+                mBacking = kVal;
+
+                // Release element lock.
+                res = mLock->release();
+                SF_ASSERT(res == SUCCESS);
+            }
         }
     }
 
@@ -184,22 +258,43 @@ public:
     ///
     T read() const
     {
-        if (mLock != nullptr)
+        T val;
+        switch (mAccess)
         {
-            // Acquire element lock.
-            const Result res = mLock->acquire();
-            (void) res;
-            SF_ASSERT(res == SUCCESS);
-        }
+            case UNSYNCED:
+                val = mBacking;
+                break;
 
-        const T val = mBacking;
+            case ATOMIC:
+                __atomic_load(&mBacking, &val, __ATOMIC_ACQUIRE);
+                break;
 
-        if (mLock != nullptr)
-        {
-            // Release element lock.
-            const Result res = mLock->release();
-            (void) res;
-            SF_ASSERT(res == SUCCESS);
+            case SEQ_LOCK:
+            {
+                // Copy the backing until no write overlaps the copy.
+                U32 seq;
+                do
+                {
+                    seq = mSeqLock->readBegin();
+                    val = mBacking;
+                }
+                while (mSeqLock->readRetry(seq));
+                break;
+            }
+
+            default:
+            {
+                // Acquire element lock.
+                Result res = mLock->acquire();
+                (void) res;
+                SF_ASSERT(res == SUCCESS);
+
+                val = mBacking;
+
+                // Release element lock.
+                res = mLock->release();
+                SF_ASSERT(res == SUCCESS);
+            }
         }
 
         return val;
@@ -233,6 +328,17 @@ public:
 
 private:
 
+    ///
+    /// @brief Element access modes.
+    ///
+    enum Access : U8
+    {
+        UNSYNCED = 0, ///< Unsynchronized access.
+        LOCK = 1,     ///< Access under mLock.
+        SEQ_LOCK = 2, ///< Access under mSeqLock.
+        ATOMIC = 3    ///< Atomic access.
+    };
+
     ///
     /// @brief Element backing.
     ///
@@ -242,6 +348,17 @@ private:
     /// @brief Element lock, or null if none.
     ///
     ILock* const mLock;
+
+    ///
+    /// @brief Element sequence lock, or null if none.
+    ///
+    SeqLock* const mSeqLock;
+
+    ///
+    /// @brief Element access mode, fixed at construction so that accesses
+    /// branch on it once instead of testing each lock pointer.
+    ///
+    const Access mAccess;
 };
 
 } // namespace Sf
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/core/ExecutionTimer.hpp"
+#include "sf/pal/Clock.hpp"
+
+namespace Sf
+{
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Writes an element if it is non-null.
+///
+/// @param[in] kElem  Element to write, or null.
+/// @param[in] kVal   Value to write.
+///
+static void writeIfSet(Element<U64>* const kElem, const U64 kVal)
+{
+    if (kElem != nullptr)
+    {
+        kElem->write(kVal);
+    }
+}
+
+/////////////////////////////////// Public /////////////////////////////////////
+
+Result ExecutionTimer::init(const Config kConfig, ExecutionTimer& kTimer)
+{
+    // Check that timer is not already initialized.
+    if (kTimer.mInit)
+    {
+        return E_ETM_REINIT;
+    }
+
+    // Check histogram config.
+    if (kConfig.bucketCnt > 0)
+    {
+        if ((kConfig.elemBuckets == nullptr) || (kConfig.bucketWidthNs == 0))
+        {
+            return E_ETM_HIST;
+        }
+
+        for (U32 i = 0; i < kConfig.bucketCnt; ++i)
+        {
+            if (kConfig.elemBuckets[i] == nullptr)
+            {
+                return E_ETM_HIST;
+            }
+        }
+    }
+
+    kTimer.mConfig = kConfig;
+    kTimer.mInit = true;
+
+    return SUCCESS;
+}
+
+ExecutionTimer::ExecutionTimer() :
+    mConfig({nullptr, nullptr, nullptr, nullptr, nullptr, 0, nullptr, 0, 0}),
+    mInit(false),
+    mStartNs(0),
+    mCnt(0),
+    mMinNs(0),
+    mMaxNs(0),
+    mSumNs(0),
+    mMisses(0)
+{
+}
+
+void ExecutionTimer::start()
+{
+    mStartNs = Clock::nanoTime();
+}
+
+void ExecutionTimer::stop()
+{
+    this->record(Clock::nanoTime() - mStartNs);
+}
+
+void ExecutionTimer::record(const U64 kNs)
+{
+    if (!mInit)
+    {
+        return;
+    }
+
+    // Update stats.
+    if ((mCnt == 0) || (kNs < mMinNs))
+    {
+        mMinNs = kNs;
+    }
+    if (kNs > mMaxNs)
+    {
+        mMaxNs = kNs;
+    }
+    ++mCnt;
+    mSumNs += kNs;
+    if ((mConfig.deadlineNs != 0) && (kNs > mConfig.deadlineNs))
+    {
+        ++mMisses;
+    }
+
+    // Publish stats to elements.
+    writeIfSet(mConfig.elemCnt, mCnt);
+    writeIfSet(mConfig.elemMinNs, mMinNs);
+    writeIfSet(mConfig.elemMaxNs, mMaxNs);
+    writeIfSet(mConfig.elemMeanNs, (mSumNs / mCnt));
+    writeIfSet(mConfig.elemMisses, mMisses);
+
+    // Increment the histogram bucket containing the sample. Samples past the
+    // last bucket go in the last bucket.
+    if (mConfig.bucketCnt > 0)
+    {
+        U64 bucket = (kNs / mConfig.bucketWidthNs);
+        if (bucket >= mConfig.bucketCnt)
+        {
+            bucket = (mConfig.bucketCnt - 1);
+        }
+
+        Element<U64>* const elemBucket = mConfig.elemBuckets[bucket];
+        elemBucket->write(elemBucket->read() + 1);
+    }
+}
+
+} // namespace Sf
@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/ExecutionTimer.hpp
+/// @brief Execution time instrumentation.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_EXECUTION_TIMER_HPP
+#define SF_EXECUTION_TIMER_HPP
+
+#include "sf/core/BasicTypes.hpp"
+#include "sf/core/Element.hpp"
+#include "sf/core/Result.hpp"
+
+#ifdef SF_ENABLE_TIMING
+///
+/// @brief Starts timing a block of code with an ExecutionTimer. Timing is only
+/// done if SF_ENABLE_TIMING was defined at compile time, otherwise the macro
+/// has no effect and disappears from code entirely.
+///
+/// @param[in] kTimer  ExecutionTimer to start.
+///
+#    define SF_TIMER_START(kTimer) (kTimer).start()
+
+///
+/// @brief Stops timing a block of code with an ExecutionTimer and records the
+/// elapsed time. Has no effect if SF_ENABLE_TIMING was not defined at compile
+/// time.
+///
+/// @param[in] kTimer  ExecutionTimer to stop.
+///
+#    define SF_TIMER_STOP(kTimer) (kTimer).stop()
+#else
+#    define SF_TIMER_START(kTimer)
+#    define SF_TIMER_STOP(kTimer)
+#endif
+
+namespace Sf
+{
+
+///
+/// @brief Records execution time stats for a piece of code into state vector
+/// elements, so that they can be telemetered like any other element.
+///
+/// The timer tracks the number of samples and the min, max, and mean execution
+/// time. It optionally counts samples that exceed a deadline and maintains a
+/// histogram of execution times with fixed-width buckets. All storage is in
+/// the timer and the configured elements; recording a sample never allocates.
+///
+/// @remark ITask and StateMachine time their steps with an ExecutionTimer set
+/// through their setTimer() methods. That instrumentation, like the
+/// SF_TIMER_START and SF_TIMER_STOP macros, is only compiled in when
+/// SF_ENABLE_TIMING is defined.
+///
+class ExecutionTimer final
+{
+public:
+
+    ///
+    /// @brief Timer config. Any element may be null if that stat is not
+    /// needed.
+    ///
+    struct Config final
+    {
+        ///
+        /// @brief Number of samples recorded.
+        ///
+        Element<U64>* elemCnt;
+
+        ///
+        /// @brief Minimum execution time in nanoseconds.
+        ///
+        Element<U64>* elemMinNs;
+
+        ///
+        /// @brief Maximum execution time in nanoseconds.
+        ///
+        Element<U64>* elemMaxNs;
+
+        ///
+        /// @brief Mean execution time in nanoseconds, rounded down.
+        ///
+        Element<U64>* elemMeanNs;
+
+        ///
+        /// @brief Number of samples that exceeded the deadline.
+        ///
+        Element<U64>* elemMisses;
+
+        ///
+        /// @brief Deadline in nanoseconds, or 0 if no deadline.
+        ///
+        U64 deadlineNs;
+
+        ///
+        /// @brief Array of bucketCnt histogram bucket elements, or null if not
+        /// keeping a histogram. Bucket i counts samples in [i * bucketWidthNs,
+        /// (i + 1) * bucketWidthNs). The last bucket also counts all longer
+        /// samples.
+        ///
+        Element<U64>* const* elemBuckets;
+
+        ///
+        /// @brief Number of histogram buckets.
+        ///
+        U32 bucketCnt;
+
+        ///
+        /// @brief Width of a histogram bucket in nanoseconds.
+        ///
+        U64 bucketWidthNs;
+    };
+
+    ///
+    /// @brief Initializes an execution timer from a config.
+    ///
+    /// @pre  kTimer is uninitialized.
+    /// @post On success, kTimer is initialized and records samples.
+    /// @post On error, preconditions still hold.
+    ///
+    /// @param[in] kConfig  Timer config.
+    /// @param[in] kTimer   Timer to initialize.
+    ///
+    /// @retval SUCCESS       Successfully initialized timer.
+    /// @retval E_ETM_REINIT  Timer is already initialized.
+    /// @retval E_ETM_HIST    Histogram config is invalid: the bucket array or
+    ///                       an element in it is null, or the bucket width is
+    ///                       0.
+    ///
+    static Result init(const Config kConfig, ExecutionTimer& kTimer);
+
+    ///
+    /// @brief Default constructor.
+    ///
+    /// @post The constructed ExecutionTimer is uninitialized and does not
+    /// record samples.
+    ///
+    ExecutionTimer();
+
+    ///
+    /// @brief Starts timing.
+    ///
+    void start();
+
+    ///
+    /// @brief Stops timing and records the time since the last start().
+    ///
+    void stop();
+
+    ///
+    /// @brief Records an execution time sample. Does nothing if the timer is
+    /// uninitialized.
+    ///
+    /// @param[in] kNs  Execution time in nanoseconds.
+    ///
+    void record(const U64 kNs);
+
+    ExecutionTimer(const ExecutionTimer&) = delete;
+    ExecutionTimer(ExecutionTimer&&) = delete;
+    ExecutionTimer& operator=(const ExecutionTimer&) = delete;
+    ExecutionTimer& operator=(ExecutionTimer&&) = delete;
+
+private:
+
+    ///
+    /// @brief Timer config.
+    ///
+    Config mConfig;
+
+    ///
+    /// @brief Whether the timer is initialized.
+    ///
+    bool mInit;
+
+    ///
+    /// @brief Time of the last start().
+    ///
+    U64 mStartNs;
+
+    ///
+    /// @brief Number of samples recorded.
+    ///
+    U64 mCnt;
+
+    ///
+    /// @brief Minimum sample.
+    ///
+    U64 mMinNs;
+
+    ///
+    /// @brief Maximum sample.
+    ///
+    U64 mMaxNs;
+
+    ///
+    /// @brief Sum of samples.
+    ///
+    U64 mSumNs;
+
+    ///
+    /// @brief Number of samples that exceeded the deadline.
+    ///
+    U64 mMisses;
+};
+
+} // namespace Sf
+
+#endif
@@ -484,6 +484,260 @@ F64 safeCast<F64, bool>(const bool kRhs)
     return (kRhs ? 1.0 : 0.0);
 }
 
+// The following casts are from I64 to non-I64. For integer types, the I64 is
+// clamped to the integer type's numeric limits. For bool, a nonzero I64 becomes
+// true and zero becomes false.
+
+template<>
+I8 safeCast<I8, I64>(const I64 kRhs)
+{
+    if (kRhs < Limits::min<I8>())
+    {
+        return Limits::min<I8>();
+    }
+
+    if (kRhs > Limits::max<I8>())
+    {
+        return Limits::max<I8>();
+    }
+
+    return static_cast<I8>(kRhs);
+}
+
+template<>
+I16 safeCast<I16, I64>(const I64 kRhs)
+{
+    if (kRhs < Limits::min<I16>())
+    {
+        return Limits::min<I16>();
+    }
+
+    if (kRhs > Limits::max<I16>())
+    {
+        return Limits::max<I16>();
+    }
+
+    return static_cast<I16>(kRhs);
+}
+
+template<>
+I32 safeCast<I32, I64>(const I64 kRhs)
+{
+    if (kRhs < Limits::min<I32>())
+    {
+        return Limits::min<I32>();
+    }
+
+    if (kRhs > Limits::max<I32>())
+    {
+        return Limits::max<I32>();
+    }
+
+    return static_cast<I32>(kRhs);
+}
+
+template<>
+I64 safeCast<I64, I64>(const I64 kRhs)
+{
+    return kRhs;
+}
+
+template<>
+U8 safeCast<U8, I64>(const I64 kRhs)
+{
+    if (kRhs < 0)
+    {
+        return 0;
+    }
+
+    if (kRhs > Limits::max<U8>())
+    {
+        return Limits::max<U8>();
+    }
+
+    return static_cast<U8>(kRhs);
+}
+
+template<>
+U16 safeCast<U16, I64>(const I64 kRhs)
+{
+    if (kRhs < 0)
+    {
+        return 0;
+    }
+
+    if (kRhs > Limits::max<U16>())
+    {
+        return Limits::max<U16>();
+    }
+
+    return static_cast<U16>(kRhs);
+}
+
+template<>
+U32 safeCast<U32, I64>(const I64 kRhs)
+{
+    if (kRhs < 0)
+    {
+        return 0;
+    }
+
+    if (kRhs > Limits::max<U32>())
+    {
+        return Limits::max<U32>();
+    }
+
+    return static_cast<U32>(kRhs);
+}
+
+template<>
+U64 safeCast<U64, I64>(const I64 kRhs)
+{
+    if (kRhs < 0)
+    {
+        return 0;
+    }
+
+    return static_cast<U64>(kRhs);
+}
+
+template<>
+F32 safeCast<F32, I64>(const I64 kRhs)
+{
+    return static_cast<F32>(kRhs);
+}
+
+template<>
+bool safeCast<bool, I64>(const I64 kRhs)
+{
+    return (kRhs != 0);
+}
+
+// The following casts are from non-I64 integers and bool to I64. All values
+// are exactly representable except U64 values above the I64 maximum, which are
+// clamped. For bool, true becomes 1 and false becomes 0.
+
+template<>
+I64 safeCast<I64, I8>(const I8 kRhs)
+{
+    return kRhs;
+}
+
+template<>
+I64 safeCast<I64, I16>(const I16 kRhs)
+{
+    return kRhs;
+}
+
+template<>
+I64 safeCast<I64, I32>(const I32 kRhs)
+{
+    return kRhs;
+}
+
+template<>
+I64 safeCast<I64, U8>(const U8 kRhs)
+{
+    return kRhs;
+}
+
+template<>
+I64 safeCast<I64, U16>(const U16 kRhs)
+{
+    return kRhs;
+}
+
+template<>
+I64 safeCast<I64, U32>(const U32 kRhs)
+{
+    return kRhs;
+}
+
+template<>
+I64 safeCast<I64, U64>(const U64 kRhs)
+{
+    if (kRhs > static_cast<U64>(Limits::max<I64>()))
+    {
+        return Limits::max<I64>();
+    }
+
+    return static_cast<I64>(kRhs);
+}
+
+template<>
+I64 safeCast<I64, bool>(const bool kRhs)
+{
+    return (kRhs ? 1 : 0);
+}
+
+/////////////////////////////// I64 Arithmetic /////////////////////////////////
+
+// The following operators saturate at the I64 limits instead of overflowing,
+// which would be undefined behavior.
+
+template<>
+I64 add<I64>(const I64 kLhs, const I64 kRhs)
+{
+    if ((kRhs > 0) && (kLhs > (Limits::max<I64>() - kRhs)))
+    {
+        return Limits::max<I64>();
+    }
+
+    if ((kRhs < 0) && (kLhs < (Limits::min<I64>() - kRhs)))
+    {
+        return Limits::min<I64>();
+    }
+
+    return (kLhs + kRhs);
+}
+
+template<>
+I64 sub<I64>(const I64 kLhs, const I64 kRhs)
+{
+    if ((kRhs < 0) && (kLhs > (Limits::max<I64>() + kRhs)))
+    {
+        return Limits::max<I64>();
+    }
+
+    if ((kRhs > 0) && (kLhs < (Limits::min<I64>() + kRhs)))
+    {
+        return Limits::min<I64>();
+    }
+
+    return (kLhs - kRhs);
+}
+
+template<>
+I64 mult<I64>(const I64 kLhs, const I64 kRhs)
+{
+    if ((kLhs == 0) || (kRhs == 0))
+    {
+        return 0;
+    }
+
+    // The product is positive if the operand signs match and negative
+    // otherwise. Check the product magnitude against the limit in that
+    // direction using division, which cannot overflow for these operands.
+    if ((kLhs > 0) == (kRhs > 0))
+    {
+        if ((kLhs > 0) ? (kLhs > (Limits::max<I64>() / kRhs))
+                       : (kLhs < (Limits::max<I64>() / kRhs)))
+        {
+            return Limits::max<I64>();
+        }
+    }
+    else
+    {
+        if ((kLhs > 0) ? (kRhs < (Limits::min<I64>() / kLhs))
+                       : (kLhs < (Limits::min<I64>() / kRhs)))
+        {
+            return Limits::min<I64>();
+        }
+    }
+
+    return (kLhs * kRhs);
+}
+
 } // namespace ExprOpFuncs
 
 } // namespace Sf
@@ -61,7 +61,8 @@ public:
         ROLL_MEDIAN = 5,
         ROLL_MIN = 6,
         ROLL_MAX = 7,
-        ROLL_RANGE = 8
+        ROLL_RANGE = 8,
+        BYTECODE = 9
     };
 
     ///
@@ -710,8 +711,8 @@ namespace ExprOpFuncs
     /// accurately represented as a float has the same effect as a static cast
     /// (i.e., the integer is approximated as a float).
     ///
-    /// @remark This is currently only defined to/from F64 since these are the
-    /// only casts required by config library compilers.
+    /// @remark This is currently only defined to/from F64 and I64 since these
+    /// are the only casts required by config library compilers.
     ///
     /// @tparam T         Cast (destination) type.
     /// @tparam TOperand  Operand (source) type.
@@ -722,6 +723,32 @@ namespace ExprOpFuncs
     ///
     template<typename T, typename TOperand>
     T safeCast(const TOperand kRhs);
+
+    ///
+    /// @brief I64 addition saturates at the I64 limits instead of overflowing.
+    ///
+    /// @see ExprOpFuncs::add()
+    ///
+    template<>
+    I64 add<I64>(const I64 kLhs, const I64 kRhs);
+
+    ///
+    /// @brief I64 subtraction saturates at the I64 limits instead of
+    /// overflowing.
+    ///
+    /// @see ExprOpFuncs::sub()
+    ///
+    template<>
+    I64 sub<I64>(const I64 kLhs, const I64 kRhs);
+
+    ///
+    /// @brief I64 multiplication saturates at the I64 limits instead of
+    /// overflowing.
+    ///
+    /// @see ExprOpFuncs::mult()
+    ///
+    template<>
+    I64 mult<I64>(const I64 kLhs, const I64 kRhs);
 }
 
 ///
@@ -60,6 +60,15 @@ public:
     ///
     virtual void update() = 0;
 
+    ///
+    /// @brief Re-evaluate the underlying expression and record the value in
+    /// the rolling window like update(), but defer updating any structures
+    /// used to compute stats until a stat is next queried. This is cheaper
+    /// than update() for stats which are sampled every step but only queried
+    /// occasionally.
+    ///
+    virtual void sample() = 0;
+
     ///
     /// @brief Gets the mean of the rolling window. If the window is not full
     /// (i.e., update() has been called fewer times than the window size), only
@@ -148,28 +157,41 @@ public:
     /// @brief Constructor. The rolling window is initially empty.
     ///
     /// @remark The object requires two storage arrays. The first stores the
-    /// rolling window in chronological order, and the second is used to sort
-    /// the array for calculating the median.
+    /// rolling window in chronological order, and the second stores window
+    /// indices in a pair of heaps maintained for calculating the median and a
+    /// pair of deques maintained for calculating the min and max.
     ///
     /// @param[in] kExpr  Expression which stats are computed on.
     /// @param[in] kArrA  Storage array for exclusive use by the object, kSize
     ///                   elements long. If this array is null, no stats will be
     ///                   computed.
     /// @param[in] kArrB  Additional storage array for exclusive use by the
-    ///                   object, kSize elements long. If this array is null,
-    ///                   all stats but median will be computed.
+    ///                   object, (4 * kSize) elements long. If this array is
+    ///                   null, all stats but median will be computed, and min
+    ///                   and max will be O(n).
     /// @param[in] kSize  Size of the rolling window.
     ///
     ExpressionStats(IExprNode<T>& kExpr,
                     T* const kArrA,
-                    T* const kArrB,
+                    U32* const kArrB,
                     const U32 kSize) :
         mExpr(kExpr),
         mHist(kArrA),
-        mSorted(kArrB),
+        mHeap(kArrB),
+        mHeapPos((kArrB == nullptr) ? nullptr : (kArrB + kSize)),
+        mMinDq((kArrB == nullptr) ? nullptr : (kArrB + (2 * kSize))),
+        mMaxDq((kArrB == nullptr) ? nullptr : (kArrB + (3 * kSize))),
         mSize(kSize),
+        mLoCap((kSize + 1) / 2),
         mUpdates(0),
         mCnt(0),
+        mLoCnt(0),
+        mHiCnt(0),
+        mMinDqHead(0),
+        mMinDqCnt(0),
+        mMaxDqHead(0),
+        mMaxDqCnt(0),
+        mStale(false),
         mSum()
     {
     }
@@ -177,7 +199,8 @@ public:
     ///
     /// @see IExpressionStats::update()
     ///
-    /// @remark This method is O(1).
+    /// @remark This method is O(log n), or O(n log n) if sample() was called
+    /// since the last update or query.
     ///
     void update() final override
     {
@@ -186,32 +209,47 @@ public:
             return;
         }
 
-        // Evaluate expression.
-        T val = mExpr.evaluate();
+        const U32 insertIdx = this->record();
 
-        // A NaN becomes 0, the same behavior as ExprOpFuncs::safeCast().
-        if (val != val)
+        // Update median heaps and min/max deques, or rebuild them if values
+        // were sampled since they were last updated.
+        if (mHeap != nullptr)
         {
-            val = 0;
-        }
-
-        // Insert value into ring buffer and save the old value.
-        const U32 insertIdx = (mUpdates++ % mSize);
-        const T oldVal = mHist[insertIdx];
-        mHist[insertIdx] = val;
+            if (mStale)
+            {
+                this->rebuild();
+                return;
+            }
 
-        // Update size.
-        mCnt = ((mUpdates < mSize) ? mUpdates : mSize);
+            if (mUpdates > mSize)
+            {
+                this->heapReplace(insertIdx);
+            }
+            else
+            {
+                this->heapInsert(insertIdx);
+            }
 
-        // Add value to rolling sum.
-        mSum += val;
+            this->dequePush(insertIdx, mMinDq, mMinDqHead, mMinDqCnt, true);
+            this->dequePush(insertIdx, mMaxDq, mMaxDqHead, mMaxDqCnt, false);
+        }
+    }
 
-        // If an old value was just overwritten, subtract it from the rolling
-        // sum.
-        if (mUpdates > mSize)
+    ///
+    /// @see IExpressionStats::sample()
+    ///
+    /// @remark This method is O(1). The next median(), min(), max(), or
+    /// range() query or update() is O(n log n).
+    ///
+    void sample() final override
+    {
+        if ((mSize == 0) || (mHist == nullptr))
         {
-            mSum -= oldVal;
+            return;
         }
+
+        (void) this->record();
+        mStale = true;
     }
 
     ///
@@ -232,55 +270,39 @@ public:
     ///
     /// @see IExpressionStats::median()
     ///
-    /// @remark This method is O(n^2) in the worst case due to the use of
-    /// insertion sort. The applications targeted by the state machine config
-    /// language typically require small histories of 10s or 100s of values,
-    /// so this performance is acceptable.
+    /// @remark This method is O(1). The window is kept partitioned into a
+    /// max-heap of its lower half and a min-heap of its upper half, so the
+    /// median is at the top of the heaps.
     ///
     F64 median() final override
     {
-        if ((mCnt == 0) || (mHist == nullptr) || (mSorted == nullptr))
+        if ((mCnt == 0) || (mHist == nullptr) || (mHeap == nullptr))
         {
             return 0.0;
         }
 
-        // Copy history into sorted array.
-        for (U32 i = 0; i < mCnt; ++i)
-        {
-            mSorted[i] = mHist[i];
-        }
-
-        // Insertion sort the history copy.
-        for (U32 i = 0; i < mCnt; ++i)
+        if (mStale)
         {
-            for (U32 j = 0; j < i; ++j)
-            {
-                if (mSorted[i] < mSorted[j])
-                {
-                    const T tmp = mSorted[j];
-                    mSorted[j] = mSorted[i];
-                    mSorted[i] = tmp;
-                }
-            }
+            this->rebuild();
         }
 
         // If history size is even, return average of middle two values.
+        const F64 a = ExprOpFuncs::safeCast<F64, T>(mHist[mHeap[0]]);
         if ((mCnt % 2) == 0)
         {
-            const F64 a =
-                ExprOpFuncs::safeCast<F64, T>(mSorted[(mCnt / 2) - 1]);
-            const F64 b = ExprOpFuncs::safeCast<F64, T>(mSorted[mCnt / 2]);
+            const F64 b = ExprOpFuncs::safeCast<F64, T>(mHist[mHeap[mLoCap]]);
             return (a + ((b - a) / 2.0));
         }
 
         // History size is odd, so return the middle element.
-        return ExprOpFuncs::safeCast<F64, T>(mSorted[mCnt / 2]);
+        return a;
     }
 
     ///
     /// @see IExpressionStats::min()
     ///
-    /// @remark This method is O(n).
+    /// @remark This method is O(1), or O(n) if the object was not given a
+    /// second storage array.
     ///
     F64 min() final override
     {
@@ -289,6 +311,16 @@ public:
             return 0.0;
         }
 
+        if (mMinDq != nullptr)
+        {
+            if (mStale)
+            {
+                this->rebuild();
+            }
+
+            return ExprOpFuncs::safeCast<F64, T>(mHist[mMinDq[mMinDqHead]]);
+        }
+
         T minVal = mHist[0];
         for (U32 i = 1; i < mCnt; ++i)
         {
@@ -304,7 +336,8 @@ public:
     ///
     /// @see IExpressionStats::max()
     ///
-    /// @remark This method is O(n).
+    /// @remark This method is O(1), or O(n) if the object was not given a
+    /// second storage array.
     ///
     F64 max() final override
     {
@@ -313,6 +346,16 @@ public:
             return 0.0;
         }
 
+        if (mMaxDq != nullptr)
+        {
+            if (mStale)
+            {
+                this->rebuild();
+            }
+
+            return ExprOpFuncs::safeCast<F64, T>(mHist[mMaxDq[mMaxDqHead]]);
+        }
+
         T maxVal = mHist[0];
         for (U32 i = 1; i < mCnt; ++i)
         {
@@ -328,7 +371,7 @@ public:
     ///
     /// @see IExpressionStats::range()
     ///
-    /// @remark This method is O(1).
+    /// @remark This method has the complexity of min() and max().
     ///
     F64 range() final override
     {
@@ -364,15 +407,41 @@ private:
     T* const mHist;
 
     ///
-    /// @brief Array used to sort the rolling window when computing the median.
+    /// @brief Array of window indices forming the median heaps. The first
+    /// mLoCap slots are a max-heap of the lower half of the window, and the
+    /// remaining slots are a min-heap of the upper half.
+    ///
+    U32* const mHeap;
+
+    ///
+    /// @brief Array which maps each window index to its slot in mHeap.
+    ///
+    U32* const mHeapPos;
+
+    ///
+    /// @brief Ring buffer of window indices forming the min deque. Values at
+    /// the indices increase from the front to the back, so the front is the
+    /// window min.
+    ///
+    U32* const mMinDq;
+
+    ///
+    /// @brief Ring buffer of window indices forming the max deque. Values at
+    /// the indices decrease from the front to the back, so the front is the
+    /// window max.
     ///
-    T* const mSorted;
+    U32* const mMaxDq;
 
     ///
     /// @brief Size of the rolling window.
     ///
     const U32 mSize;
 
+    ///
+    /// @brief Capacity of the lower half heap.
+    ///
+    const U32 mLoCap;
+
     ///
     /// @brief Number of updates performed (calls to update()).
     ///
@@ -384,10 +453,330 @@ private:
     ///
     U32 mCnt;
 
+    ///
+    /// @brief Number of values in the lower half heap. This is always equal
+    /// to or 1 more than mHiCnt.
+    ///
+    U32 mLoCnt;
+
+    ///
+    /// @brief Number of values in the upper half heap.
+    ///
+    U32 mHiCnt;
+
+    ///
+    /// @brief Index of the front of the min deque.
+    ///
+    U32 mMinDqHead;
+
+    ///
+    /// @brief Number of indices in the min deque.
+    ///
+    U32 mMinDqCnt;
+
+    ///
+    /// @brief Index of the front of the max deque.
+    ///
+    U32 mMaxDqHead;
+
+    ///
+    /// @brief Number of indices in the max deque.
+    ///
+    U32 mMaxDqCnt;
+
+    ///
+    /// @brief Whether values were sampled since the median heaps and min/max
+    /// deques were last updated.
+    ///
+    bool mStale;
+
     ///
     /// @brief Sum of the rolling window, updated as calls to update() are made.
     ///
     F64 mSum;
+
+    ///
+    /// @brief Evaluates the expression and inserts its value into the rolling
+    /// window, updating the rolling sum.
+    ///
+    /// @returns Window index of inserted value.
+    ///
+    U32 record()
+    {
+        // Evaluate expression.
+        T val = mExpr.evaluate();
+
+        // A NaN becomes 0, the same behavior as ExprOpFuncs::safeCast().
+        if (val != val)
+        {
+            val = 0;
+        }
+
+        // Insert value into ring buffer and save the old value.
+        const U32 insertIdx = (mUpdates++ % mSize);
+        const T oldVal = mHist[insertIdx];
+        mHist[insertIdx] = val;
+
+        // Update size.
+        mCnt = ((mUpdates < mSize) ? mUpdates : mSize);
+
+        // Add value to rolling sum.
+        mSum += val;
+
+        // If an old value was just overwritten, subtract it from the rolling
+        // sum.
+        if (mUpdates > mSize)
+        {
+            mSum -= oldVal;
+        }
+
+        return insertIdx;
+    }
+
+    ///
+    /// @brief Rebuilds the median heaps and min/max deques from the rolling
+    /// window by inserting its values from oldest to newest.
+    ///
+    void rebuild()
+    {
+        mStale = false;
+        mLoCnt = 0;
+        mHiCnt = 0;
+        mMinDqHead = 0;
+        mMinDqCnt = 0;
+        mMaxDqHead = 0;
+        mMaxDqCnt = 0;
+
+        const U32 oldestIdx = ((mUpdates - mCnt) % mSize);
+        for (U32 i = 0; i < mCnt; ++i)
+        {
+            const U32 idx = ((oldestIdx + i) % mSize);
+            this->heapInsert(idx);
+            this->dequePush(idx, mMinDq, mMinDqHead, mMinDqCnt, true);
+            this->dequePush(idx, mMaxDq, mMaxDqHead, mMaxDqCnt, false);
+        }
+    }
+
+    ///
+    /// @brief Gets whether a heap slot belongs above another in its heap.
+    ///
+    /// @param[in] kA   Heap slot.
+    /// @param[in] kB   Heap slot in the same heap as kA.
+    /// @param[in] kLo  Whether the slots are in the lower half heap.
+    ///
+    /// @returns If the value in kA should be closer to the top than kB.
+    ///
+    bool heapAbove(const U32 kA, const U32 kB, const bool kLo) const
+    {
+        const T a = mHist[mHeap[kA]];
+        const T b = mHist[mHeap[kB]];
+        return (kLo ? (a > b) : (a < b));
+    }
+
+    ///
+    /// @brief Swaps two heap slots.
+    ///
+    /// @param[in] kA  Heap slot.
+    /// @param[in] kB  Heap slot.
+    ///
+    void heapSwap(const U32 kA, const U32 kB)
+    {
+        const U32 tmp = mHeap[kA];
+        mHeap[kA] = mHeap[kB];
+        mHeap[kB] = tmp;
+        mHeapPos[mHeap[kA]] = kA;
+        mHeapPos[mHeap[kB]] = kB;
+    }
+
+    ///
+    /// @brief Moves a heap slot up until its heap is ordered.
+    ///
+    /// @param[in] kSlot  Heap slot.
+    /// @param[in] kLo    Whether the slot is in the lower half heap.
+    ///
+    /// @returns Final heap slot.
+    ///
+    U32 heapSiftUp(U32 kSlot, const bool kLo)
+    {
+        const U32 base = (kLo ? 0 : mLoCap);
+        while (kSlot > base)
+        {
+            const U32 parent = (base + (((kSlot - base) - 1) / 2));
+            if (!this->heapAbove(kSlot, parent, kLo))
+            {
+                break;
+            }
+            this->heapSwap(kSlot, parent);
+            kSlot = parent;
+        }
+
+        return kSlot;
+    }
+
+    ///
+    /// @brief Moves a heap slot down until its heap is ordered.
+    ///
+    /// @param[in] kSlot  Heap slot.
+    /// @param[in] kLo    Whether the slot is in the lower half heap.
+    ///
+    void heapSiftDown(U32 kSlot, const bool kLo)
+    {
+        const U32 base = (kLo ? 0 : mLoCap);
+        const U32 end = (base + (kLo ? mLoCnt : mHiCnt));
+        while (true)
+        {
+            const U32 left = (base + (2 * (kSlot - base)) + 1);
+            const U32 right = (left + 1);
+            U32 top = kSlot;
+            if ((left < end) && this->heapAbove(left, top, kLo))
+            {
+                top = left;
+            }
+            if ((right < end) && this->heapAbove(right, top, kLo))
+            {
+                top = right;
+            }
+            if (top == kSlot)
+            {
+                break;
+            }
+            this->heapSwap(kSlot, top);
+            kSlot = top;
+        }
+    }
+
+    ///
+    /// @brief Adds a window index to a heap.
+    ///
+    /// @param[in] kIdx  Window index.
+    /// @param[in] kLo   Whether to add to the lower half heap.
+    ///
+    void heapPush(const U32 kIdx, const bool kLo)
+    {
+        const U32 slot = (kLo ? mLoCnt++ : (mLoCap + mHiCnt++));
+        mHeap[slot] = kIdx;
+        mHeapPos[kIdx] = slot;
+        this->heapSiftUp(slot, kLo);
+    }
+
+    ///
+    /// @brief Replaces the top of a heap with a window index.
+    ///
+    /// @param[in] kIdx  Window index.
+    /// @param[in] kLo   Whether to replace the top of the lower half heap.
+    ///
+    void heapReplaceTop(const U32 kIdx, const bool kLo)
+    {
+        const U32 slot = (kLo ? 0 : mLoCap);
+        mHeap[slot] = kIdx;
+        mHeapPos[kIdx] = slot;
+        this->heapSiftDown(slot, kLo);
+    }
+
+    ///
+    /// @brief Adds a new window value to the median heaps while the window is
+    /// filling up. The heap sizes are balanced without either heap ever
+    /// exceeding its capacity.
+    ///
+    /// @param[in] kIdx  Window index of new value.
+    ///
+    void heapInsert(const U32 kIdx)
+    {
+        const T val = mHist[kIdx];
+        if (mLoCnt == mHiCnt)
+        {
+            // Lower half grows. If the value belongs in the upper half, the
+            // top of the upper half moves down instead.
+            if ((mHiCnt > 0) && (val > mHist[mHeap[mLoCap]]))
+            {
+                const U32 hiTop = mHeap[mLoCap];
+                this->heapReplaceTop(kIdx, false);
+                this->heapPush(hiTop, true);
+            }
+            else
+            {
+                this->heapPush(kIdx, true);
+            }
+        }
+        else
+        {
+            // Upper half grows. If the value belongs in the lower half, the
+            // top of the lower half moves up instead.
+            if (val < mHist[mHeap[0]])
+            {
+                const U32 loTop = mHeap[0];
+                this->heapReplaceTop(kIdx, true);
+                this->heapPush(loTop, false);
+            }
+            else
+            {
+                this->heapPush(kIdx, false);
+            }
+        }
+    }
+
+    ///
+    /// @brief Updates the median heaps after a window value was overwritten.
+    /// The value is reordered within its heap, and if it crossed into the
+    /// other half of the window, the heap tops are exchanged.
+    ///
+    /// @param[in] kIdx  Window index of new value.
+    ///
+    void heapReplace(const U32 kIdx)
+    {
+        const bool lo = (mHeapPos[kIdx] < mLoCap);
+        const U32 slot = this->heapSiftUp(mHeapPos[kIdx], lo);
+        this->heapSiftDown(slot, lo);
+
+        if ((mHiCnt > 0) && (mHist[mHeap[0]] > mHist[mHeap[mLoCap]]))
+        {
+            this->heapSwap(0, mLoCap);
+            this->heapSiftDown(0, true);
+            this->heapSiftDown(mLoCap, false);
+        }
+    }
+
+    ///
+    /// @brief Adds a new window value to a monotonic deque. Indices whose
+    /// values can no longer be the min (or max) are popped from the back,
+    /// and the index of the evicted value is popped from the front. Each
+    /// index is pushed and popped once, so this is amortized O(1).
+    ///
+    /// @param[in]      kIdx   Window index of new value.
+    /// @param[in, out] kDq    Deque storage.
+    /// @param[in, out] kHead  Index of deque front.
+    /// @param[in, out] kCnt   Number of indices in deque.
+    /// @param[in]      kMin   Whether the deque tracks the min.
+    ///
+    void dequePush(const U32 kIdx,
+                   U32* const kDq,
+                   U32& kHead,
+                   U32& kCnt,
+                   const bool kMin)
+    {
+        // The new value overwrote the oldest value in the window, which is at
+        // the front of the deque if it is in the deque at all.
+        if ((kCnt > 0) && (kDq[kHead] == kIdx))
+        {
+            kHead = ((kHead + 1) % mSize);
+            --kCnt;
+        }
+
+        // Pop values which the new value dominates.
+        const T val = mHist[kIdx];
+        while (kCnt > 0)
+        {
+            const T back = mHist[kDq[(kHead + kCnt - 1) % mSize]];
+            if (kMin ? (back < val) : (back > val))
+            {
+                break;
+            }
+            --kCnt;
+        }
+
+        kDq[(kHead + kCnt) % mSize] = kIdx;
+        ++kCnt;
+    }
 };
 
 ///
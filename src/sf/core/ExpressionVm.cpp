@@ -0,0 +1,432 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/ExpressionVm.cpp
+/// @brief Stack-based interpreter for expression bytecode.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/core/ExpressionVm.hpp"
+
+namespace Sf
+{
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Domain tags stored in stack slots while ExpressionVm::init() checks
+/// the program.
+///
+static constexpr I64 gTagI64 = 0;
+static constexpr I64 gTagF64 = 1;
+
+/////////////////////////////////// Public /////////////////////////////////////
+
+Result ExpressionVm::init(const Config kConfig, ExpressionVm& kVm)
+{
+    // Check that VM is not already initialized.
+    if (kVm.mConfig.instrs != nullptr)
+    {
+        return E_EVM_REINIT;
+    }
+
+    // Check that arrays are non-null.
+    if ((kConfig.instrs == nullptr) || (kConfig.stack == nullptr))
+    {
+        return E_EVM_NULL;
+    }
+
+    // Check each instruction while tracking the stack depth it leaves behind
+    // and the domain of each stack value. Since the program has no branches,
+    // this exactly predicts the stack usage and domains of every run. The
+    // stack storage is used to hold the domain tags.
+    Value* const tags = kConfig.stack;
+    U32 depth = 0;
+    for (U32 i = 0; i < kConfig.instrCnt; ++i)
+    {
+        const Instruction& instr = kConfig.instrs[i];
+        if (instr.op >= OPCODE_CNT)
+        {
+            return E_EVM_OP;
+        }
+
+        // Determine how many values the instruction pops, what domain they
+        // must have, and what domain the value it pushes has.
+        U32 popCnt = 0;
+        I64 popTag = gTagI64;
+        I64 pushTag = gTagI64;
+        if ((instr.op == PUSH_I) || (instr.op == PUSH_F))
+        {
+            // Constant push.
+            pushTag = ((instr.op == PUSH_F) ? gTagF64 : gTagI64);
+        }
+        else if (instr.op <= LOAD_BOOL)
+        {
+            // Element load; check that element has the type implied by the
+            // opcode. Load opcodes have the same values as the element types.
+            if (instr.elem == nullptr)
+            {
+                return E_EVM_NULL;
+            }
+
+            if (static_cast<U32>(instr.elem->type()) != instr.op)
+            {
+                return E_EVM_TYPE;
+            }
+
+            pushTag = (((instr.op == LOAD_U64)
+                        || (instr.op == LOAD_F32)
+                        || (instr.op == LOAD_F64))
+                       ? gTagF64 : gTagI64);
+        }
+        else if (instr.op <= ROLL_RANGE)
+        {
+            // Stats read.
+            if (instr.stats == nullptr)
+            {
+                return E_EVM_NULL;
+            }
+
+            pushTag = gTagF64;
+        }
+        else if (instr.op == I2F_RHS)
+        {
+            // Conversion below the top of the stack; checked here since it
+            // does not pop.
+            if (depth < 2)
+            {
+                return E_EVM_STACK;
+            }
+
+            if (tags[depth - 2].i64 != gTagI64)
+            {
+                return E_EVM_TYPE;
+            }
+
+            tags[depth - 2].i64 = gTagF64;
+            continue;
+        }
+        else
+        {
+            // Operator. Unary operators and conversions pop 1 and binary
+            // operators pop 2. F64 operators have odd opcodes except for
+            // DIV_F, which has no I64 counterpart.
+            popCnt = (((instr.op == I2F_LHS)
+                       || (instr.op == NOT_I)
+                       || (instr.op == NOT_F)) ? 1 : 2);
+            const bool fp = ((instr.op == DIV_F) || ((instr.op % 2) != 0));
+            popTag = (((instr.op == I2F_LHS) || !fp) ? gTagI64 : gTagF64);
+            pushTag = (((instr.op == I2F_LHS) || fp) ? gTagF64 : gTagI64);
+        }
+
+        // Pop operands.
+        if (depth < popCnt)
+        {
+            return E_EVM_STACK;
+        }
+
+        for (U32 j = 0; j < popCnt; ++j)
+        {
+            --depth;
+            if (tags[depth].i64 != popTag)
+            {
+                return E_EVM_TYPE;
+            }
+        }
+
+        // Push result.
+        if (depth >= kConfig.stackSize)
+        {
+            return E_EVM_STACK;
+        }
+
+        tags[depth].i64 = pushTag;
+        ++depth;
+    }
+
+    // Program must evaluate to exactly one value.
+    if (depth != 1)
+    {
+        return E_EVM_STACK;
+    }
+
+    // Config is valid- assign VM members so that the interface is usable.
+    kVm.mResultType = ((tags[0].i64 == gTagF64) ? ElementType::FLOAT64
+                                                : ElementType::INT64);
+    kVm.mConfig = kConfig;
+
+    return SUCCESS;
+}
+
+ExpressionVm::ExpressionVm() :
+    mConfig({nullptr, 0, nullptr, 0}), mResultType(ElementType::NONE)
+{
+}
+
+ExpressionVm::Value ExpressionVm::run()
+{
+    // An uninitialized VM has an empty program and evaluates to 0.
+    if (mConfig.instrs == nullptr)
+    {
+        Value zero;
+        zero.i64 = 0;
+        return zero;
+    }
+
+    // `sp` points one past the top of the stack. Binary operators read their
+    // LHS from `sp[-1]` and their RHS from `sp[-2]`, and write the result over
+    // the RHS.
+    Value* sp = mConfig.stack;
+    const Instruction* const end = (mConfig.instrs + mConfig.instrCnt);
+    for (const Instruction* instr = mConfig.instrs; instr != end; ++instr)
+    {
+        switch (instr->op)
+        {
+            case PUSH_I:
+            case PUSH_F:
+                *sp++ = instr->val;
+                break;
+
+            case LOAD_I8:
+                (sp++)->i64 =
+                    static_cast<const Element<I8>*>(instr->elem)->read();
+                break;
+
+            case LOAD_I16:
+                (sp++)->i64 =
+                    static_cast<const Element<I16>*>(instr->elem)->read();
+                break;
+
+            case LOAD_I32:
+                (sp++)->i64 =
+                    static_cast<const Element<I32>*>(instr->elem)->read();
+                break;
+
+            case LOAD_I64:
+                (sp++)->i64 =
+                    static_cast<const Element<I64>*>(instr->elem)->read();
+                break;
+
+            case LOAD_U8:
+                (sp++)->i64 =
+                    static_cast<const Element<U8>*>(instr->elem)->read();
+                break;
+
+            case LOAD_U16:
+                (sp++)->i64 =
+                    static_cast<const Element<U16>*>(instr->elem)->read();
+                break;
+
+            case LOAD_U32:
+                (sp++)->i64 =
+                    static_cast<const Element<U32>*>(instr->elem)->read();
+                break;
+
+            case LOAD_U64:
+                (sp++)->f64 = static_cast<F64>(
+                    static_cast<const Element<U64>*>(instr->elem)->read());
+                break;
+
+            case LOAD_F32:
+            {
+                // NaNs are loaded as 0, same as ExprOpFuncs::safeCast().
+                const F32 val =
+                    static_cast<const Element<F32>*>(instr->elem)->read();
+                (sp++)->f64 = ((val != val) ? 0.0 : val);
+                break;
+            }
+
+            case LOAD_F64:
+            {
+                const F64 val =
+                    static_cast<const Element<F64>*>(instr->elem)->read();
+                (sp++)->f64 = ((val != val) ? 0.0 : val);
+                break;
+            }
+
+            case LOAD_BOOL:
+                (sp++)->i64 =
+                    (static_cast<const Element<bool>*>(instr->elem)->read()
+                     ? 1 : 0);
+                break;
+
+            case ROLL_AVG:
+                (sp++)->f64 = instr->stats->mean();
+                break;
+
+            case ROLL_MEDIAN:
+                (sp++)->f64 = instr->stats->median();
+                break;
+
+            case ROLL_MIN:
+                (sp++)->f64 = instr->stats->min();
+                break;
+
+            case ROLL_MAX:
+                (sp++)->f64 = instr->stats->max();
+                break;
+
+            case ROLL_RANGE:
+                (sp++)->f64 = instr->stats->range();
+                break;
+
+            case I2F_LHS:
+                sp[-1].f64 = static_cast<F64>(sp[-1].i64);
+                break;
+
+            case I2F_RHS:
+                sp[-2].f64 = static_cast<F64>(sp[-2].i64);
+                break;
+
+            case NOT_I:
+                sp[-1].i64 = (!sp[-1].i64 ? 1 : 0);
+                break;
+
+            case NOT_F:
+                sp[-1].f64 = (!sp[-1].f64 ? 1.0 : 0.0);
+                break;
+
+            case MULT_I:
+                sp[-2].i64 = ExprOpFuncs::mult<I64>(sp[-1].i64, sp[-2].i64);
+                --sp;
+                break;
+
+            case MULT_F:
+                sp[-2].f64 = (sp[-1].f64 * sp[-2].f64);
+                --sp;
+                break;
+
+            case DIV_F:
+                sp[-2].f64 = (sp[-1].f64 / sp[-2].f64);
+                --sp;
+                break;
+
+            case ADD_I:
+                sp[-2].i64 = ExprOpFuncs::add<I64>(sp[-1].i64, sp[-2].i64);
+                --sp;
+                break;
+
+            case ADD_F:
+                sp[-2].f64 = (sp[-1].f64 + sp[-2].f64);
+                --sp;
+                break;
+
+            case SUB_I:
+                sp[-2].i64 = ExprOpFuncs::sub<I64>(sp[-1].i64, sp[-2].i64);
+                --sp;
+                break;
+
+            case SUB_F:
+                sp[-2].f64 = (sp[-1].f64 - sp[-2].f64);
+                --sp;
+                break;
+
+            case LT_I:
+                sp[-2].i64 = ((sp[-1].i64 < sp[-2].i64) ? 1 : 0);
+                --sp;
+                break;
+
+            case LT_F:
+                sp[-2].f64 = ((sp[-1].f64 < sp[-2].f64) ? 1.0 : 0.0);
+                --sp;
+                break;
+
+            case LTE_I:
+                sp[-2].i64 = ((sp[-1].i64 <= sp[-2].i64) ? 1 : 0);
+                --sp;
+                break;
+
+            case LTE_F:
+                sp[-2].f64 = ((sp[-1].f64 <= sp[-2].f64) ? 1.0 : 0.0);
+                --sp;
+                break;
+
+            case GT_I:
+                sp[-2].i64 = ((sp[-1].i64 > sp[-2].i64) ? 1 : 0);
+                --sp;
+                break;
+
+            case GT_F:
+                sp[-2].f64 = ((sp[-1].f64 > sp[-2].f64) ? 1.0 : 0.0);
+                --sp;
+                break;
+
+            case GTE_I:
+                sp[-2].i64 = ((sp[-1].i64 >= sp[-2].i64) ? 1 : 0);
+                --sp;
+                break;
+
+            case GTE_F:
+                sp[-2].f64 = ((sp[-1].f64 >= sp[-2].f64) ? 1.0 : 0.0);
+                --sp;
+                break;
+
+            case EQ_I:
+                sp[-2].i64 = ((sp[-1].i64 == sp[-2].i64) ? 1 : 0);
+                --sp;
+                break;
+
+            case EQ_F:
+                sp[-2].f64 = ((sp[-1].f64 == sp[-2].f64) ? 1.0 : 0.0);
+                --sp;
+                break;
+
+            case NEQ_I:
+                sp[-2].i64 = ((sp[-1].i64 != sp[-2].i64) ? 1 : 0);
+                --sp;
+                break;
+
+            case NEQ_F:
+                sp[-2].f64 = ((sp[-1].f64 != sp[-2].f64) ? 1.0 : 0.0);
+                --sp;
+                break;
+
+            case AND_I:
+                sp[-2].i64 = ((sp[-1].i64 && sp[-2].i64) ? 1 : 0);
+                --sp;
+                break;
+
+            case AND_F:
+                sp[-2].f64 = ((sp[-1].f64 && sp[-2].f64) ? 1.0 : 0.0);
+                --sp;
+                break;
+
+            case OR_I:
+                sp[-2].i64 = ((sp[-1].i64 || sp[-2].i64) ? 1 : 0);
+                --sp;
+                break;
+
+            case OR_F:
+                sp[-2].f64 = ((sp[-1].f64 || sp[-2].f64) ? 1.0 : 0.0);
+                --sp;
+                break;
+
+            default:
+                // Unreachable; opcodes were validated by init().
+                break;
+        }
+    }
+
+    return mConfig.stack[0];
+}
+
+ElementType ExpressionVm::resultType() const
+{
+    return mResultType;
+}
+
+} // namespace Sf
@@ -0,0 +1,341 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/ExpressionVm.hpp
+/// @brief Stack-based interpreter for expression bytecode.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_EXPRESSION_VM_HPP
+#define SF_EXPRESSION_VM_HPP
+
+#include "sf/core/BasicTypes.hpp"
+#include "sf/core/Element.hpp"
+#include "sf/core/Expression.hpp"
+#include "sf/core/ExpressionStats.hpp"
+#include "sf/core/Result.hpp"
+
+namespace Sf
+{
+
+///
+/// @brief An interpreter for expressions that have been lowered to a flat
+/// array of instructions. An ExpressionVm evaluates the same expressions as a
+/// tree of IExprNode, and with the same semantics, but without a virtual call
+/// and function pointer call per node. Values on the VM stack are either I64
+/// or F64, mirroring the config library's evaluation of expressions in those
+/// two domains. Each instruction operates on a fixed domain, so the program is
+/// type-checked once by ExpressionVm::init() and values are never tagged.
+///
+/// @remark The instruction array and stack are provided by the user, so an
+/// ExpressionVm may be statically allocated.
+///
+/// @remark The user is not meant to manually write bytecode; it should be the
+/// product of a compiler in the framework config library.
+///
+class ExpressionVm final
+{
+public:
+
+    ///
+    /// @brief Instruction opcodes. Opcodes suffixed with _I operate on I64
+    /// values and opcodes suffixed with _F operate on F64 values.
+    ///
+    /// @remark Binary operators pop their LHS first and their RHS second, so
+    /// the RHS operand must be pushed before the LHS operand.
+    ///
+    /// @remark Element load opcodes have the same values as the ElementType of
+    /// the element they load. U64 elements are loaded as F64, since I64 cannot
+    /// represent values above the I64 maximum. Floating elements are loaded as
+    /// F64 with NaNs loaded as 0. All other elements are loaded as I64.
+    ///
+    /// @remark Operators other than division come in I64/F64 pairs where the
+    /// F64 opcode is odd. I64 arithmetic saturates at the I64 limits, same as
+    /// the I64 specializations of the ExprOpFuncs operators. There is no I64
+    /// division; division is always evaluated in F64.
+    ///
+    enum Opcode : U8
+    {
+        PUSH_I = 0,       ///< Push I64 constant `val.i64`.
+        LOAD_I8 = 1,      ///< Push value of I8 element `elem`.
+        LOAD_I16 = 2,     ///< Push value of I16 element `elem`.
+        LOAD_I32 = 3,     ///< Push value of I32 element `elem`.
+        LOAD_I64 = 4,     ///< Push value of I64 element `elem`.
+        LOAD_U8 = 5,      ///< Push value of U8 element `elem`.
+        LOAD_U16 = 6,     ///< Push value of U16 element `elem`.
+        LOAD_U32 = 7,     ///< Push value of U32 element `elem`.
+        LOAD_U64 = 8,     ///< Push value of U64 element `elem`.
+        LOAD_F32 = 9,     ///< Push value of F32 element `elem`.
+        LOAD_F64 = 10,    ///< Push value of F64 element `elem`.
+        LOAD_BOOL = 11,   ///< Push value of bool element `elem`.
+        PUSH_F = 12,      ///< Push F64 constant `val.f64`.
+        ROLL_AVG = 13,    ///< Push mean of `stats`.
+        ROLL_MEDIAN = 14, ///< Push median of `stats`.
+        ROLL_MIN = 15,    ///< Push min of `stats`.
+        ROLL_MAX = 16,    ///< Push max of `stats`.
+        ROLL_RANGE = 17,  ///< Push range of `stats`.
+        I2F_LHS = 18,     ///< Convert top of stack from I64 to F64.
+        I2F_RHS = 19,     ///< Convert second from top of stack to F64.
+        NOT_I = 20,       ///< Logical NOT top of stack.
+        NOT_F = 21,       ///< Logical NOT top of stack.
+        MULT_I = 22,      ///< Multiply top two values.
+        MULT_F = 23,      ///< Multiply top two values.
+        ADD_I = 24,       ///< Add top two values.
+        ADD_F = 25,       ///< Add top two values.
+        SUB_I = 26,       ///< Subtract top two values.
+        SUB_F = 27,       ///< Subtract top two values.
+        LT_I = 28,        ///< Compare top two values with <.
+        LT_F = 29,        ///< Compare top two values with <.
+        LTE_I = 30,       ///< Compare top two values with <=.
+        LTE_F = 31,       ///< Compare top two values with <=.
+        GT_I = 32,        ///< Compare top two values with >.
+        GT_F = 33,        ///< Compare top two values with >.
+        GTE_I = 34,       ///< Compare top two values with >=.
+        GTE_F = 35,       ///< Compare top two values with >=.
+        EQ_I = 36,        ///< Compare top two values with ==.
+        EQ_F = 37,        ///< Compare top two values with ==.
+        NEQ_I = 38,       ///< Compare top two values with !=.
+        NEQ_F = 39,       ///< Compare top two values with !=.
+        AND_I = 40,       ///< Logical AND top two values.
+        AND_F = 41,       ///< Logical AND top two values.
+        OR_I = 42,        ///< Logical OR top two values.
+        OR_F = 43,        ///< Logical OR top two values.
+        DIV_F = 44,       ///< Divide top two values.
+        OPCODE_CNT = 45   ///< Number of opcodes.
+    };
+
+    ///
+    /// @brief A value on the VM stack. Which member is valid is determined by
+    /// the instruction that produced the value. Comparison and logical
+    /// operators produce 1 or 0 in their operand domain.
+    ///
+    union Value
+    {
+        I64 i64; ///< I64 value.
+        F64 f64; ///< F64 value.
+    };
+
+    ///
+    /// @brief A single instruction.
+    ///
+    struct Instruction final
+    {
+        ///
+        /// @brief Instruction opcode.
+        ///
+        Opcode op;
+
+        ///
+        /// @brief Instruction operand. Which member is used depends on the
+        /// opcode; operators have no operand.
+        ///
+        union
+        {
+            Value val;               ///< Constant for PUSH_*.
+            const IElement* elem;    ///< Element for LOAD_*.
+            IExpressionStats* stats; ///< Stats for ROLL_*.
+        };
+    };
+
+    ///
+    /// @brief Configuration for an expression VM.
+    ///
+    struct Config final
+    {
+        ///
+        /// @brief Array of instructions to execute, in order.
+        ///
+        const Instruction* instrs;
+
+        ///
+        /// @brief Number of instructions.
+        ///
+        U32 instrCnt;
+
+        ///
+        /// @brief Storage for the VM stack.
+        ///
+        Value* stack;
+
+        ///
+        /// @brief Number of values the stack can hold.
+        ///
+        U32 stackSize;
+    };
+
+    ///
+    /// @brief Initializes an expression VM from a config. The program is
+    /// checked once here so that ExpressionVm::run() can execute it without
+    /// any checks.
+    ///
+    /// @warning The config is not copied. The instruction array and stack must
+    /// live at least as long as the ExpressionVm.
+    ///
+    /// @note The stack storage is used as scratch space while checking the
+    /// program, so its contents are overwritten even if initialization fails.
+    ///
+    /// @param[in] kConfig  VM config.
+    /// @param[in] kVm      VM to initialize.
+    ///
+    /// @retval SUCCESS       Successfully initialized VM.
+    /// @retval E_EVM_REINIT  VM is already initialized.
+    /// @retval E_EVM_NULL    Config contains a null array or a null element or
+    ///                       stats operand.
+    /// @retval E_EVM_OP      Config contains an invalid opcode.
+    /// @retval E_EVM_TYPE    A load instruction references an element of the
+    ///                       wrong type, or an instruction operates on a
+    ///                       value of the wrong domain.
+    /// @retval E_EVM_STACK   The program underflows or overflows the stack, or
+    ///                       does not leave exactly one value on the stack.
+    ///
+    static Result init(const Config kConfig, ExpressionVm& kVm);
+
+    ///
+    /// @brief Default constructor.
+    ///
+    /// @post The constructed ExpressionVm is uninitialized, and
+    /// ExpressionVm::run() returns 0.
+    ///
+    ExpressionVm();
+
+    ///
+    /// @brief Executes the program.
+    ///
+    /// @returns Value of the expression. Which member is valid is given by
+    /// ExpressionVm::resultType().
+    ///
+    Value run();
+
+    ///
+    /// @brief Gets the domain of the value returned by ExpressionVm::run().
+    ///
+    /// @returns ElementType::INT64 or ElementType::FLOAT64, or
+    /// ElementType::NONE if the VM is uninitialized.
+    ///
+    ElementType resultType() const;
+
+    ExpressionVm(const ExpressionVm&) = delete;
+    ExpressionVm(ExpressionVm&&) = delete;
+    ExpressionVm& operator=(const ExpressionVm&) = delete;
+    ExpressionVm& operator=(ExpressionVm&&) = delete;
+
+private:
+
+    ///
+    /// @brief VM config. When the pointers in the config are null, the VM is
+    /// uninitialized.
+    ///
+    ExpressionVm::Config mConfig;
+
+    ///
+    /// @brief Domain of the program result.
+    ///
+    ElementType mResultType;
+};
+
+///
+/// @brief Abstract interface for a BytecodeExprNode.
+///
+/// @remark This interface allows accessing the source expression tree without
+/// knowing the node's evaluation type.
+///
+class IBytecodeExprNode : virtual public IExpression
+{
+public:
+
+    ///
+    /// @brief Gets the expression tree which the bytecode was lowered from.
+    ///
+    /// @returns Source expression tree, or null if none.
+    ///
+    virtual const IExpression* src() const = 0;
+};
+
+///
+/// @brief Expression node that evaluates by running an ExpressionVm. This
+/// allows bytecode to be used anywhere an expression tree is expected.
+///
+/// @tparam T  Evaluation type. The I64 or F64 result of the VM is safe-casted
+///            to T.
+///
+template<typename T>
+class BytecodeExprNode final : public IExprNode<T>, public IBytecodeExprNode
+{
+public:
+
+    ///
+    /// @brief Constructor.
+    ///
+    /// @param[in] kVm   Initialized VM to run.
+    /// @param[in] kSrc  Expression tree which the bytecode was lowered from, or
+    ///                  null if none. This is used by autocoders, which emit
+    ///                  the tree instead of the bytecode.
+    ///
+    BytecodeExprNode(ExpressionVm& kVm, const IExpression* const kSrc) :
+        mVm(kVm),
+        mSrc(kSrc),
+        mFloatResult(kVm.resultType() == ElementType::FLOAT64)
+    {
+    }
+
+    ///
+    /// @see IExprNode<T>::evaluate()
+    ///
+    T evaluate() final override
+    {
+        const ExpressionVm::Value val = mVm.run();
+        return (mFloatResult ? ExprOpFuncs::safeCast<T, F64>(val.f64)
+                             : ExprOpFuncs::safeCast<T, I64>(val.i64));
+    }
+
+    ///
+    /// @see IExpression::nodeType()
+    ///
+    IExpression::NodeType nodeType() const final override
+    {
+        return IExpression::BYTECODE;
+    }
+
+    ///
+    /// @see IBytecodeExprNode::src()
+    ///
+    const IExpression* src() const final override
+    {
+        return mSrc;
+    }
+
+private:
+
+    ///
+    /// @brief VM which runs the expression bytecode.
+    ///
+    ExpressionVm& mVm;
+
+    ///
+    /// @brief Source expression tree.
+    ///
+    const IExpression* const mSrc;
+
+    ///
+    /// @brief Whether the VM result is F64 instead of I64.
+    ///
+    const bool mFloatResult;
+};
+
+} // namespace Sf
+
+#endif
@@ -18,9 +18,54 @@
 
 #include "sf/core/MemOps.hpp"
 
+// Vector instructions are used to copy memory when the target supports them,
+// unless disabled with SF_MEMOPS_NO_SIMD. Both SSE2 and NEON loads and stores
+// tolerate unaligned addresses.
+#if !defined(SF_MEMOPS_NO_SIMD) && defined(__SSE2__)
+#    include <emmintrin.h>
+#    define SF_MEMOPS_SSE2
+#elif !defined(SF_MEMOPS_NO_SIMD) && defined(__ARM_NEON)
+#    include <arm_neon.h>
+#    define SF_MEMOPS_NEON
+#endif
+
 namespace Sf
 {
 
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Machine word used by MemOps::memcpy(). On GCC-compatible compilers,
+/// the type may alias any other type, so that copying words of an object of
+/// a different type is well-defined.
+///
+#ifdef __GNUC__
+typedef uintptr_t __attribute__((__may_alias__)) MemOpsWord;
+#else
+typedef uintptr_t MemOpsWord;
+#endif
+
+///
+/// @brief Number of bytes in a machine word.
+///
+static constexpr U32 gWordSize = sizeof(MemOpsWord);
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Gets whether an address is aligned to a machine word.
+///
+/// @param[in] kAddr  Address.
+///
+/// @returns If address is word-aligned.
+///
+static inline bool wordAligned(const void* const kAddr)
+{
+    return ((reinterpret_cast<uintptr_t>(kAddr) % gWordSize) == 0);
+}
+
+/////////////////////////////////// Public /////////////////////////////////////
+
 I32 MemOps::strcmp(const char* kA, const char* kB)
 {
     I32 ret = 0;
@@ -58,19 +103,59 @@ I32 MemOps::strcmp(const char* kA, const char* kB)
 
 void* MemOps::memcpy(void* kDest, const void* const kSrc, const U32 kBytes)
 {
-    char* const dest = static_cast<char*>(kDest);
-    const char* const src = static_cast<const char*>(kSrc);
+    U8* dest = static_cast<U8*>(kDest);
+    const U8* src = static_cast<const U8*>(kSrc);
+    if ((dest == nullptr) || (src == nullptr))
+    {
+        return kDest;
+    }
+
+    U32 bytes = kBytes;
 
-    // TODO: This could be made more efficient by moving >1 byte at once...
-    if ((dest != nullptr) && (src != nullptr))
+    // Copy bytes until the destination is word-aligned.
+    while ((bytes > 0) && !wordAligned(dest))
     {
-        for (U32 i = 0; i < kBytes; ++i)
+        *dest++ = *src++;
+        --bytes;
+    }
+
+#if defined(SF_MEMOPS_SSE2)
+    // Copy 16-byte vectors.
+    for (; bytes >= 16; bytes -= 16, dest += 16, src += 16)
+    {
+        const __m128i vec =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), vec);
+    }
+#elif defined(SF_MEMOPS_NEON)
+    // Copy 16-byte vectors.
+    for (; bytes >= 16; bytes -= 16, dest += 16, src += 16)
+    {
+        vst1q_u8(dest, vld1q_u8(src));
+    }
+#endif
+
+    // Copy words if the source is also word-aligned. Otherwise, word loads
+    // from the source would be misaligned, which some targets do not support,
+    // so the remainder is copied bytewise.
+    if (wordAligned(src))
+    {
+        for (; bytes >= gWordSize;
+             bytes -= gWordSize, dest += gWordSize, src += gWordSize)
         {
-            *(dest + i) = *(src + i);
+            *reinterpret_cast<MemOpsWord*>(dest) =
+                *reinterpret_cast<const MemOpsWord*>(src);
         }
     }
 
-    return dest;
+    // Copy remaining bytes.
+    while (bytes > 0)
+    {
+        *dest++ = *src++;
+        --bytes;
+    }
+
+    return kDest;
 }
 
 } // namespace Sf
@@ -55,6 +55,12 @@ namespace MemOps
     /// @note The source and destination regions must not overlap for a correct
     /// result.
     ///
+    /// @remark Memory is copied a machine word at a time when the source and
+    /// destination have the same alignment relative to a word boundary. On
+    /// targets with SSE2 or NEON, memory is copied 16 bytes at a time
+    /// regardless of alignment; this can be disabled by defining
+    /// SF_MEMOPS_NO_SIMD at compile time.
+    ///
     /// @param[in] kDest   Destination address.
     /// @param[in] kSrc    Source address.
     /// @param[in] kBytes  Number of bytes to copy from source to destination.
@@ -0,0 +1,278 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/core/Assert.hpp"
+#include "sf/core/Diagnostic.hpp"
+#include "sf/core/RealTimeExecutor.hpp"
+
+namespace Sf
+{
+
+/////////////////////////////////// Public /////////////////////////////////////
+
+Result RealTimeExecutor::analyze(const Config kConfig, Report& kReport)
+{
+    // Check that tasks array is non-null.
+    if (kConfig.tasks == nullptr)
+    {
+        return E_MSE_NULL;
+    }
+
+    // Check core count.
+    if ((kConfig.coreCnt == 0) || (kConfig.coreCnt > MAX_CORES))
+    {
+        return E_MSE_CORE;
+    }
+
+    // Count tasks and check their timing.
+    U32 taskCnt = 0;
+    for (const TaskConfig* cfg = kConfig.tasks; cfg->task != nullptr; ++cfg)
+    {
+        if (taskCnt == MAX_TASKS)
+        {
+            return E_MSE_CNT;
+        }
+
+        if ((cfg->periodNs == 0) || (cfg->wcetNs > cfg->periodNs))
+        {
+            return E_MSE_PERIOD;
+        }
+
+        ++taskCnt;
+    }
+
+    if (taskCnt == 0)
+    {
+        return E_MSE_EMPTY;
+    }
+
+    // Sort task indices into rate-monotonic order, i.e., by increasing period.
+    // Insertion sort is stable, so tasks of equal period stay in config order.
+    U32 order[MAX_TASKS];
+    for (U32 i = 0; i < taskCnt; ++i)
+    {
+        U32 j = i;
+        while ((j > 0)
+               && (kConfig.tasks[order[j - 1]].periodNs
+                   > kConfig.tasks[i].periodNs))
+        {
+            order[j] = order[j - 1];
+            --j;
+        }
+        order[j] = i;
+    }
+
+    // Check that there are enough priorities for the distinct periods.
+    U32 rankCnt = 1;
+    for (U32 i = 1; i < taskCnt; ++i)
+    {
+        if (kConfig.tasks[order[i]].periodNs
+            != kConfig.tasks[order[i - 1]].periodNs)
+        {
+            ++rankCnt;
+        }
+    }
+
+    if ((kConfig.maxPriority > Thread::REALTIME_MAX_PRI)
+        || ((kConfig.maxPriority - static_cast<I32>(rankCnt - 1))
+            < Thread::REALTIME_MIN_PRI))
+    {
+        return E_MSE_PRI;
+    }
+
+    // Assign tasks to cores first-fit in rate-monotonic order. A task fits on
+    // a core if the core still passes the hyperbolic bound with the task
+    // added.
+    F64 coreBounds[MAX_CORES];
+    for (U32 i = 0; i < kConfig.coreCnt; ++i)
+    {
+        coreBounds[i] = 1.0;
+        kReport.coreUtils[i] = 0.0;
+    }
+
+    kReport.taskCnt = taskCnt;
+    kReport.schedulable = true;
+    I32 priority = kConfig.maxPriority;
+    for (U32 i = 0; i < taskCnt; ++i)
+    {
+        const U32 taskIdx = order[i];
+        const TaskConfig& cfg = kConfig.tasks[taskIdx];
+
+        // Tasks with a longer period than the last get the next priority down.
+        if ((i > 0) && (cfg.periodNs != kConfig.tasks[order[i - 1]].periodNs))
+        {
+            --priority;
+        }
+        kReport.taskPriorities[taskIdx] = priority;
+
+        const F64 util = (static_cast<F64>(cfg.wcetNs)
+                          / static_cast<F64>(cfg.periodNs));
+        kReport.taskCores[taskIdx] = Thread::ALL_CORES;
+        for (U32 core = 0; core < kConfig.coreCnt; ++core)
+        {
+            const F64 bound = (coreBounds[core] * (1.0 + util));
+            if (bound <= 2.0)
+            {
+                coreBounds[core] = bound;
+                kReport.coreUtils[core] += util;
+                kReport.taskCores[taskIdx] = static_cast<U8>(core);
+                break;
+            }
+        }
+
+        if (kReport.taskCores[taskIdx] == Thread::ALL_CORES)
+        {
+            kReport.schedulable = false;
+        }
+    }
+
+    return SUCCESS;
+}
+
+Result RealTimeExecutor::init(const Config kConfig, RealTimeExecutor& kExe)
+{
+    // Check that executor is not already initialized.
+    if (kExe.mInit)
+    {
+        return E_MSE_REINIT;
+    }
+
+    // Check that the system has enough cores.
+    if (kConfig.coreCnt > Thread::numCores())
+    {
+        return E_MSE_CORE;
+    }
+
+    // Analyze tasks and check that they are schedulable.
+    Result res = RealTimeExecutor::analyze(kConfig, kExe.mReport);
+    if (res != SUCCESS)
+    {
+        return res;
+    }
+
+    if (!kExe.mReport.schedulable)
+    {
+        return E_MSE_SCHED;
+    }
+
+    // Config is valid. Past this point the executor cannot be reinitialized,
+    // since the per-task executors may be initialized.
+    kExe.mInit = true;
+
+    // Initialize an executor for each task. This also initializes the tasks.
+    for (U32 i = 0; i < kExe.mReport.taskCnt; ++i)
+    {
+        const TaskConfig& cfg = kConfig.tasks[i];
+        TaskThread& taskThread = kExe.mThreads[i];
+        taskThread.exeTasks[0] = {cfg.task, cfg.periodNs, cfg.stats};
+        taskThread.exeTasks[1] = {nullptr, 0, nullptr};
+        taskThread.stop = &kExe.mStop;
+        res = CyclicExecutor::init({taskThread.exeTasks}, taskThread.exe);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+    }
+
+    // Start a thread for each task on its assigned core and priority.
+    __atomic_store_n(&kExe.mStop, 0, __ATOMIC_RELEASE);
+    for (U32 i = 0; i < kExe.mReport.taskCnt; ++i)
+    {
+        res = Thread::init(RealTimeExecutor::taskThread,
+                           &kExe.mThreads[i],
+                           kExe.mReport.taskPriorities[i],
+                           Thread::REALTIME,
+                           kExe.mReport.taskCores[i],
+                           kExe.mThreads[i].thread);
+        if (res != SUCCESS)
+        {
+            // Stop threads that were already started.
+            (void) kExe.stopThreads(i);
+            return res;
+        }
+    }
+
+    kExe.mRunning = true;
+    return SUCCESS;
+}
+
+RealTimeExecutor::RealTimeExecutor() :
+    mInit(false), mRunning(false), mStop(0), mReport()
+{
+}
+
+RealTimeExecutor::~RealTimeExecutor()
+{
+    if (mRunning)
+    {
+        (void) this->stop();
+    }
+}
+
+Result RealTimeExecutor::stop()
+{
+    // Check that threads are running.
+    if (!mRunning)
+    {
+        return E_MSE_UNINIT;
+    }
+
+    mRunning = false;
+    return this->stopThreads(mReport.taskCnt);
+}
+
+const RealTimeExecutor::Report& RealTimeExecutor::report() const
+{
+    return mReport;
+}
+
+/////////////////////////////////// Private ////////////////////////////////////
+
+Result RealTimeExecutor::taskThread(void* kArgs)
+{
+    TaskThread* const taskThread = static_cast<TaskThread*>(kArgs);
+    SF_SAFE_ASSERT(taskThread != nullptr);
+
+    // Step the task until signaled to stop, remembering the first error. A
+    // task error does not stop the task.
+    Result firstErr = SUCCESS;
+    while (__atomic_load_n(taskThread->stop, __ATOMIC_ACQUIRE) == 0)
+    {
+        Diag::errsc(taskThread->exe.step(), firstErr);
+    }
+
+    return firstErr;
+}
+
+Result RealTimeExecutor::stopThreads(const U32 kThreadCnt)
+{
+    __atomic_store_n(&mStop, 1, __ATOMIC_RELEASE);
+
+    // Await all threads even if one fails, and return the first error.
+    Result firstErr = SUCCESS;
+    for (U32 i = 0; i < kThreadCnt; ++i)
+    {
+        Result threadRes = SUCCESS;
+        Diag::errsc(mThreads[i].thread.await(&threadRes), firstErr);
+        Diag::errsc(threadRes, firstErr);
+    }
+
+    return firstErr;
+}
+
+} // namespace Sf
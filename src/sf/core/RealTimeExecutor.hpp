@@ -0,0 +1,322 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/RealTimeExecutor.hpp
+/// @brief Multi-core rate-monotonic task executor.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_REAL_TIME_EXECUTOR_HPP
+#define SF_REAL_TIME_EXECUTOR_HPP
+
+#include "sf/core/BasicTypes.hpp"
+#include "sf/core/CyclicExecutor.hpp"
+#include "sf/core/Result.hpp"
+#include "sf/core/Task.hpp"
+#include "sf/pal/Thread.hpp"
+
+namespace Sf
+{
+
+///
+/// @brief Executor which partitions periodic tasks across cores and runs them
+/// under preemptive rate-monotonic scheduling.
+///
+/// Each task has a period and a worst-case execution time (WCET). Tasks are
+/// assigned to cores first-fit in rate-monotonic order (shortest period
+/// first). A task fits on a core if the core's tasks pass the hyperbolic
+/// bound for rate-monotonic scheduling: the product of (1 + U) over the tasks
+/// is at most 2, where U is a task's WCET divided by its period. This is a
+/// sufficient schedulability test, so a set of tasks that fits is guaranteed
+/// to meet its deadlines if the WCETs hold.
+///
+/// Each task runs in its own REALTIME thread pinned to its core, and stepped
+/// by a single-task CyclicExecutor at its period. Priorities are assigned
+/// rate-monotonically downward from a maximum priority, with tasks of equal
+/// period sharing a priority. Running each task in its own thread is what lets
+/// a faster task preempt a slower one on the same core, which the
+/// rate-monotonic analysis assumes.
+///
+/// @remark Basic steps to run tasks with a real-time executor:
+///
+///   1. Construct tasks
+///   2. Define a null-terminated array of RealTimeExecutor::TaskConfig, one
+///      per task
+///   3. Optionally call RealTimeExecutor::analyze() to check the task set and
+///      inspect the partitioning
+///   4. Initialize a RealTimeExecutor with RealTimeExecutor::init(), which
+///      initializes the tasks and starts their threads
+///   5. Invoke stop() on the executor to stop the threads
+///
+class RealTimeExecutor final
+{
+public:
+
+    ///
+    /// @brief Maximum number of tasks.
+    ///
+    static constexpr U32 MAX_TASKS = 32;
+
+    ///
+    /// @brief Maximum number of cores.
+    ///
+    static constexpr U32 MAX_CORES = 16;
+
+    ///
+    /// @brief Task config.
+    ///
+    struct TaskConfig final
+    {
+        ///
+        /// @brief Task, or null to terminate a task config array.
+        ///
+        ITask* task;
+
+        ///
+        /// @brief Task period in nanoseconds.
+        ///
+        U64 periodNs;
+
+        ///
+        /// @brief Task worst-case execution time in nanoseconds.
+        ///
+        U64 wcetNs;
+
+        ///
+        /// @brief Stats updated every time the task steps, or null if not
+        /// recording stats.
+        ///
+        CyclicExecutor::TaskStats* stats;
+    };
+
+    ///
+    /// @brief Executor config.
+    ///
+    struct Config final
+    {
+        ///
+        /// @brief Array of task configs terminated by a config with a null
+        /// task.
+        ///
+        TaskConfig* tasks;
+
+        ///
+        /// @brief Number of cores to partition tasks across. Tasks are pinned
+        /// to cores 0 through coreCnt - 1.
+        ///
+        U32 coreCnt;
+
+        ///
+        /// @brief REALTIME priority of the tasks with the shortest period.
+        ///
+        I32 maxPriority;
+    };
+
+    ///
+    /// @brief Schedulability report produced by analyze().
+    ///
+    struct Report final
+    {
+        ///
+        /// @brief Number of tasks.
+        ///
+        U32 taskCnt;
+
+        ///
+        /// @brief Core assigned to each task, in config order. Tasks which did
+        /// not fit on any core are assigned Thread::ALL_CORES.
+        ///
+        U8 taskCores[MAX_TASKS];
+
+        ///
+        /// @brief Priority assigned to each task, in config order.
+        ///
+        I32 taskPriorities[MAX_TASKS];
+
+        ///
+        /// @brief Utilization of each core, i.e., the sum of WCET over period
+        /// for the tasks on the core.
+        ///
+        F64 coreUtils[MAX_CORES];
+
+        ///
+        /// @brief Whether every task fit on a core.
+        ///
+        bool schedulable;
+    };
+
+    ///
+    /// @brief Partitions tasks across cores and assigns priorities without
+    /// creating an executor.
+    ///
+    /// @param[in]  kConfig  Executor config.
+    /// @param[out] kReport  On success, contains the schedulability report.
+    ///                      Tasks that do not fit on any core are reported
+    ///                      rather than causing an error.
+    ///
+    /// @retval SUCCESS       Successfully analyzed tasks.
+    /// @retval E_MSE_NULL    Config tasks array is null.
+    /// @retval E_MSE_EMPTY   Config contains no tasks.
+    /// @retval E_MSE_CNT     Config contains more than MAX_TASKS tasks.
+    /// @retval E_MSE_CORE    Core count is 0 or more than MAX_CORES.
+    /// @retval E_MSE_PERIOD  A task has a period of 0 or a WCET longer than
+    ///                       its period.
+    /// @retval E_MSE_PRI     Priorities needed are not all valid REALTIME
+    ///                       priorities.
+    ///
+    static Result analyze(const Config kConfig, Report& kReport);
+
+    ///
+    /// @brief Initializes a real-time executor from a config. Tasks are
+    /// analyzed and initialized, and then a thread is started for each task.
+    ///
+    /// @pre  kExe is uninitialized.
+    /// @post On success, kExe is initialized and the task threads are running.
+    /// @post On error, no threads are running. If the error came from task
+    ///       initialization or thread creation, kExe is left initialized but
+    ///       stopped and cannot be reused; otherwise, preconditions still
+    ///       hold.
+    ///
+    /// @param[in] kConfig  Executor config.
+    /// @param[in] kExe     Executor to initialize.
+    ///
+    /// @retval SUCCESS       Successfully initialized executor.
+    /// @retval E_MSE_REINIT  Executor is already initialized.
+    /// @retval E_MSE_CORE    Core count exceeds the number of cores on the
+    ///                       system.
+    /// @retval E_MSE_SCHED   Tasks are not schedulable.
+    /// @retval [other]       Error returned by analyze(), task
+    ///                       initialization, or thread creation.
+    ///
+    static Result init(const Config kConfig, RealTimeExecutor& kExe);
+
+    ///
+    /// @brief Default constructor.
+    ///
+    /// @post The constructed RealTimeExecutor is uninitialized and invoking
+    /// any of its methods returns an error.
+    ///
+    RealTimeExecutor();
+
+    ///
+    /// @brief Destructor. Stops the task threads if they are running.
+    ///
+    ~RealTimeExecutor();
+
+    ///
+    /// @brief Stops the task threads and waits for them to terminate. Each
+    /// thread stops after its next step, so this may block for up to the
+    /// longest task period.
+    ///
+    /// @retval SUCCESS       Successfully stopped executor, and no task
+    ///                       returned an error.
+    /// @retval E_MSE_UNINIT  Executor is uninitialized or already stopped.
+    /// @retval [other]       First error returned by a task step() or by
+    ///                       awaiting a thread. Remaining threads are still
+    ///                       stopped.
+    ///
+    Result stop();
+
+    ///
+    /// @brief Gets the schedulability report computed at initialization.
+    ///
+    /// @return Schedulability report.
+    ///
+    const Report& report() const;
+
+    RealTimeExecutor(const RealTimeExecutor&) = delete;
+    RealTimeExecutor(RealTimeExecutor&&) = delete;
+    RealTimeExecutor& operator=(const RealTimeExecutor&) = delete;
+    RealTimeExecutor& operator=(RealTimeExecutor&&) = delete;
+
+private:
+
+    ///
+    /// @brief State of a task thread.
+    ///
+    struct TaskThread final
+    {
+        ///
+        /// @brief Executor that steps the task at its period.
+        ///
+        CyclicExecutor exe;
+
+        ///
+        /// @brief Null-terminated executor config for the task.
+        ///
+        CyclicExecutor::TaskConfig exeTasks[2];
+
+        ///
+        /// @brief Nonzero when the thread should stop.
+        ///
+        const U32* stop;
+
+        ///
+        /// @brief Thread running the task.
+        ///
+        Thread thread;
+    };
+
+    ///
+    /// @brief Whether the executor is initialized.
+    ///
+    bool mInit;
+
+    ///
+    /// @brief Whether task threads are running.
+    ///
+    bool mRunning;
+
+    ///
+    /// @brief Nonzero when task threads should stop.
+    ///
+    U32 mStop;
+
+    ///
+    /// @brief Schedulability report.
+    ///
+    Report mReport;
+
+    ///
+    /// @brief Task threads, one per task.
+    ///
+    TaskThread mThreads[MAX_TASKS];
+
+    ///
+    /// @brief Task thread function. Steps the task until signaled to stop.
+    ///
+    /// @param[in] kArgs  Pointer to TaskThread.
+    ///
+    /// @retval SUCCESS  No step returned an error.
+    /// @retval [other]  First error returned by a step.
+    ///
+    static Result taskThread(void* kArgs);
+
+    ///
+    /// @brief Signals task threads to stop and waits for them.
+    ///
+    /// @param[in] kThreadCnt  Number of threads started.
+    ///
+    /// @retval SUCCESS  Successfully stopped threads.
+    /// @retval [other]  First error returned by a thread or by awaiting it.
+    ///
+    Result stopThreads(const U32 kThreadCnt);
+};
+
+} // namespace Sf
+
+#endif
@@ -29,7 +29,12 @@ Region::Region(void* const kAddr, const U32 kSizeBytes) :
 }
 
 Region::Region(void* const kAddr, const U32 kSizeBytes, ILock* const kLock) :
-    mAddr(kAddr), mSizeBytes(kSizeBytes), mLock(kLock)
+    mAddr(kAddr), mSizeBytes(kSizeBytes), mLock(kLock), mSeqLock(nullptr)
+{
+}
+
+Region::Region(void* const kAddr, const U32 kSizeBytes, SeqLock& kSeqLock) :
+    mAddr(kAddr), mSizeBytes(kSizeBytes), mLock(nullptr), mSeqLock(&kSeqLock)
 {
 }
 
@@ -40,6 +45,14 @@ Result Region::write(const void* const kBuf, const U32 kBufSizeBytes)
         return E_RGN_SIZE;
     }
 
+    if (mSeqLock != nullptr)
+    {
+        mSeqLock->writeBegin();
+        MemOps::memcpy(mAddr, kBuf, mSizeBytes);
+        mSeqLock->writeEnd();
+        return SUCCESS;
+    }
+
     if (mLock != nullptr)
     {
         // Acquire region lock.
@@ -72,6 +85,20 @@ Result Region::read(void* const kBuf, const U32 kBufSizeBytes) const
         return E_RGN_SIZE;
     }
 
+    if (mSeqLock != nullptr)
+    {
+        // Copy the region until no write overlaps the copy.
+        U32 seq;
+        do
+        {
+            seq = mSeqLock->readBegin();
+            MemOps::memcpy(kBuf, mAddr, mSizeBytes);
+        }
+        while (mSeqLock->readRetry(seq));
+
+        return SUCCESS;
+    }
+
     if (mLock != nullptr)
     {
         // Acquire region lock.
@@ -25,6 +25,7 @@
 
 #include "sf/core/BasicTypes.hpp"
 #include "sf/core/Result.hpp"
+#include "sf/core/SeqLock.hpp"
 #include "sf/pal/Lock.hpp"
 
 namespace Sf
@@ -70,6 +71,21 @@ public:
     ///
     Region(void* const kAddr, const U32 kSizeBytes, ILock* const kLock);
 
+    ///
+    /// @brief Constructor for a thread-safe region guarded by a sequence lock.
+    /// Reads never block writes; a read that overlaps a write is retried.
+    ///
+    /// @remark The caller assumes responsibility for validating the region
+    /// address and size. Ideally the region exactly spans the backing for some
+    /// number of state vector elements and does not overlap with other regions.
+    ///
+    /// @param[in] kAddr       Region address.
+    /// @param[in] kSizeBytes  Region size in bytes.
+    /// @param[in] kSeqLock    Sequence lock guarding the region. This should be
+    ///                        the same lock used by the region's elements.
+    ///
+    Region(void* const kAddr, const U32 kSizeBytes, SeqLock& kSeqLock);
+
     ///
     /// @brief Overwrites the entire region.
     ///
@@ -129,6 +145,11 @@ private:
     /// @brief Region lock, or null if none.
     ///
     ILock* const mLock;
+
+    ///
+    /// @brief Region sequence lock, or null if none.
+    ///
+    SeqLock* const mSeqLock;
 };
 
 } // namespace Sf
@@ -68,6 +68,15 @@ enum : Result
     E_SV_ELEM_DUPE = 71,
     E_SV_RGN_DUPE = 72,
 
+    // StateVectorSnapshot
+    E_SVS_REINIT = 96,
+    E_SVS_UNINIT = 97,
+    E_SVS_NULL = 98,
+    E_SVS_SIZE = 99,
+    E_SVS_EMPTY = 100,
+    E_SVS_KEY = 101,
+    E_SVS_LAYOUT = 102,
+
     // Task
     E_TSK_UNINIT = 128,
     E_TSK_REINIT = 129,
@@ -82,6 +91,7 @@ enum : Result
     E_SM_TRANS = 165,
     E_SM_TR_EXIT = 166,
     E_SM_EMPTY = 167,
+    E_SM_LABEL = 168,
 
     // RegionTxTask
     E_RTX_SIZE = 192,
@@ -98,10 +108,32 @@ enum : Result
     // Executor
     E_EXE_NULL = 320,
     E_EXE_OVFL = 321,
+    E_EXE_REINIT = 768,
+    E_EXE_UNINIT = 769,
+    E_EXE_EMPTY = 770,
+    E_EXE_PERIOD = 771,
 
     // RealTimeExecutor
-    E_MSE_CORE = 352,
-    E_MSE_CNT = 353,
+    E_MSE_CORE = 800,
+    E_MSE_CNT = 801,
+    E_MSE_REINIT = 802,
+    E_MSE_UNINIT = 803,
+    E_MSE_NULL = 804,
+    E_MSE_EMPTY = 805,
+    E_MSE_PERIOD = 806,
+    E_MSE_PRI = 807,
+    E_MSE_SCHED = 808,
+
+    // ExecutionTimer
+    E_ETM_REINIT = 640,
+    E_ETM_HIST = 641,
+
+    // ExpressionVm
+    E_EVM_REINIT = 736,
+    E_EVM_NULL = 737,
+    E_EVM_OP = 738,
+    E_EVM_TYPE = 739,
+    E_EVM_STACK = 740,
 
 /////////////////////////// Config Library Error Codes /////////////////////////
 
@@ -115,6 +147,8 @@ enum : Result
     E_SVP_RGN = 290,
     E_SVP_TOK = 291,
     E_SVP_OPT = 292,
+    E_SVP_ANNOT = 293,
+    E_SVP_LOCK_GRP = 294,
 
     // StateMachineParser
     E_SMP_SEC = 320,
@@ -165,6 +199,7 @@ enum : Result
     E_SVC_RGN_DUPE = 419,
     E_SVC_ELEM_DUPE = 420,
     E_SVC_NULL = 421,
+    E_SVC_ALIGN = 422,
 
     // StateMachineCompiler
     E_SMC_FILE = 448,
@@ -227,6 +262,18 @@ enum : Result
     // StateMachineAutocoder
     E_SMA_NULL = 608,
 
+    // MappedFile
+    E_MAP_REINIT = 672,
+    E_MAP_OPEN = 673,
+    E_MAP_MAP = 674,
+
+    // AssemblyImage
+    E_IMG_NULL = 704,
+    E_IMG_EXPR = 705,
+    E_IMG_FORMAT = 706,
+    E_IMG_CHECKSUM = 707,
+    E_IMG_REF = 708,
+
 /////////////////////////////// PSL Error Codes ////////////////////////////////
 
     // Socket
@@ -264,6 +311,22 @@ enum : Result
     E_SLK_ACQ = 1091,
     E_SLK_REL = 1092,
 
+    // AdaptiveLock
+    E_ALK_UNINIT = 1152,
+    E_ALK_REINIT = 1153,
+    E_ALK_ACQ = 1154,
+    E_ALK_REL = 1155,
+
+    // SocketPoller
+    E_SKP_UNINIT = 1184,
+    E_SKP_REINIT = 1185,
+    E_SKP_CREATE = 1186,
+    E_SKP_CTL = 1187,
+    E_SKP_WAIT = 1188,
+    E_SKP_NULL = 1189,
+    E_SKP_EMPTY = 1190,
+    E_SKP_CLOSE = 1191,
+
     // DigitalIo
     E_DIO_UNINIT = 1120,
     E_DIO_REINIT = 1121,
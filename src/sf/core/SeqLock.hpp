@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/SeqLock.hpp
+/// @brief Sequence lock for lock-free state vector reads.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_SEQ_LOCK_HPP
+#define SF_SEQ_LOCK_HPP
+
+#include "sf/core/BasicTypes.hpp"
+
+namespace Sf
+{
+
+///
+/// @brief Sequence lock, a versioned lock under which readers never block
+/// writers.
+///
+/// A sequence lock guards data with a sequence number that is odd while a
+/// write is in progress and even otherwise. Writers serialize among
+/// themselves but never wait on readers. Readers never block writers;
+/// instead, a reader copies the data and retries the copy if a write began or
+/// ended while it was copying.
+///
+/// Typical reader usage:
+///
+///     U32 seq;
+///     do
+///     {
+///         seq = lock.readBegin();
+///         // Copy data.
+///     }
+///     while (lock.readRetry(seq));
+///
+/// @note Readers may observe torn data mid-copy, so data read under a sequence
+/// lock must not be used until readRetry() returns false.
+///
+/// @remark A sequence lock is a good fit for short, frequently read data like
+/// state vector elements and regions. A writer that is preempted mid-write
+/// will cause readers to spin until it finishes, so writes should be short.
+///
+/// @remark SeqLock is implemented with compiler atomic builtins and is
+/// available on all platforms. Its methods are defined inline since they sit
+/// on the state vector access path.
+///
+class SeqLock final
+{
+public:
+
+    ///
+    /// @brief Constructor.
+    ///
+    SeqLock() : mSeq(0)
+    {
+    }
+
+    ///
+    /// @brief Begins a write. If another writer is writing, the calling thread
+    /// busy-waits until it finishes.
+    ///
+    void writeBegin()
+    {
+        U32 seq = __atomic_load_n(&mSeq, __ATOMIC_RELAXED);
+        while (true)
+        {
+            // Make the sequence number odd if no other write is in progress.
+            if (((seq & 1) == 0)
+                && __atomic_compare_exchange_n(&mSeq,
+                                               &seq,
+                                               (seq + 1),
+                                               false,
+                                               __ATOMIC_ACQUIRE,
+                                               __ATOMIC_RELAXED))
+            {
+                break;
+            }
+
+            seq = __atomic_load_n(&mSeq, __ATOMIC_RELAXED);
+        }
+
+        // Order the odd sequence number before the writes to guarded data.
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+
+    ///
+    /// @brief Ends a write begun by writeBegin().
+    ///
+    void writeEnd()
+    {
+        __atomic_store_n(&mSeq, (mSeq + 1), __ATOMIC_RELEASE);
+    }
+
+    ///
+    /// @brief Begins a read. If a write is in progress, the calling thread
+    /// busy-waits until it finishes.
+    ///
+    /// @return Sequence number to pass to readRetry().
+    ///
+    U32 readBegin() const
+    {
+        U32 seq = __atomic_load_n(&mSeq, __ATOMIC_ACQUIRE);
+        while ((seq & 1) != 0)
+        {
+            seq = __atomic_load_n(&mSeq, __ATOMIC_ACQUIRE);
+        }
+
+        return seq;
+    }
+
+    ///
+    /// @brief Ends a read and checks if it must be retried.
+    ///
+    /// @param[in] kSeq  Sequence number returned by readBegin().
+    ///
+    /// @retval true   Data was written during the read, so the read must be
+    ///                retried.
+    /// @retval false  Data read is consistent.
+    ///
+    bool readRetry(const U32 kSeq) const
+    {
+        // Order the reads of guarded data before the sequence number check.
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        return (__atomic_load_n(&mSeq, __ATOMIC_RELAXED) != kSeq);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock(SeqLock&&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+    SeqLock& operator=(SeqLock&&) = delete;
+
+private:
+
+    ///
+    /// @brief Sequence number. Odd while a write is in progress.
+    ///
+    U32 mSeq;
+};
+
+} // namespace Sf
+
+#endif
@@ -25,54 +25,37 @@ namespace Sf
 
 /////////////////////////////////// Public /////////////////////////////////////
 
-U32 StateMachine::Block::execute() const
+U32 StateMachine::Instruction::execute() const
 {
-    // Evaluate guard.
-    if (guard != nullptr)
+    const Instruction* instr = this;
+    while (true)
     {
-        if (guard->evaluate())
+        switch (instr->op)
         {
-            // Take if branch.
-            if (ifBlock != nullptr)
-            {
-                const U32 ret = ifBlock->execute();
-                if (ret != 0)
-                {
-                    return ret;
-                }
-            }
-        }
-        else
-        {
-            // Take else branch.
-            if (elseBlock != nullptr)
-            {
-                const U32 ret = elseBlock->execute();
-                if (ret != 0)
+            case GUARD:
+                // Continue to if branch if guard is true, otherwise jump past
+                // it.
+                instr += (instr->guard->evaluate() ? 1 : instr->offset);
+                break;
+
+            case JUMP:
+                instr += instr->offset;
+                break;
+
+            case ACTION:
+                // Execute action and end label if it transitioned.
+                if (instr->action->execute())
                 {
-                    return ret;
+                    return instr->action->destState;
                 }
-            }
-        }
-    }
+                ++instr;
+                break;
 
-    // Execute action for this block.
-    if (action != nullptr)
-    {
-        const bool trans = action->execute();
-        if (trans)
-        {
-            return action->destState;
+            default:
+                // End of label.
+                return StateMachine::NO_STATE;
         }
     }
-
-    // Execute next block.
-    if (next != nullptr)
-    {
-        return next->execute();
-    }
-
-    return StateMachine::NO_STATE;
 }
 
 Result StateMachine::init(const Config kConfig, StateMachine& kSm)
@@ -107,24 +90,18 @@ Result StateMachine::init(const Config kConfig, StateMachine& kSm)
     }
 
     // Find initial state based on state element.
-    const U32 stateInit = kConfig.elemState->read();
-    StateConfig* stateInitConfig = kConfig.states;
-    for (; stateInitConfig->id != StateMachine::NO_STATE; ++stateInitConfig)
-    {
-        if (stateInitConfig->id == stateInit)
-        {
-            break;
-        }
-    }
-
-    if (stateInitConfig->id == StateMachine::NO_STATE)
+    StateConfig* const stateInitConfig =
+        StateMachine::findState(kConfig.states,
+                                numStates,
+                                kConfig.elemState->read());
+    if (stateInitConfig == nullptr)
     {
         // Initial state not found.
         return E_SM_STATE;
     }
 
-    // Check that all transitions are valid.
-    const Result res = StateMachine::checkTransitions(kConfig);
+    // Check that all labels are well-formed and transitions are valid.
+    const Result res = StateMachine::checkLabels(kConfig, numStates);
     if (res != SUCCESS)
     {
         return res;
@@ -134,19 +111,82 @@ Result StateMachine::init(const Config kConfig, StateMachine& kSm)
     // usable.
     kSm.mConfig = kConfig;
     kSm.mStateCur = stateInitConfig;
+    kSm.mStateCnt = numStates;
 
     return SUCCESS;
 }
 
 StateMachine::StateMachine() :
-    mConfig({nullptr, nullptr, nullptr, nullptr, nullptr}),
+    mConfig({nullptr, nullptr, nullptr, nullptr, nullptr, nullptr}),
     mStateCur(nullptr),
     mTimeStateStart(Clock::NO_TIME),
-    mTimeLastStep(Clock::NO_TIME)
+    mTimeLastStep(Clock::NO_TIME),
+    mStateCnt(0),
+    mTimer(nullptr)
 {
 }
 
 Result StateMachine::step()
+{
+#ifdef SF_ENABLE_TIMING
+    if (mTimer != nullptr)
+    {
+        mTimer->start();
+        const Result res = this->stepImpl();
+        mTimer->stop();
+        return res;
+    }
+#endif
+
+    return this->stepImpl();
+}
+
+Result StateMachine::getStateTime(U64& kT) const
+{
+    if (mTimeStateStart == Clock::NO_TIME)
+    {
+        // First step in current state.
+        kT = 0;
+    }
+    else
+    {
+        // Not first step in current state.
+        SF_SAFE_ASSERT(mConfig.elemGlobalTime != nullptr);
+        kT = (mConfig.elemGlobalTime->read() - mTimeStateStart);
+    }
+
+    return SUCCESS;
+}
+
+U32 StateMachine::currentState() const
+{
+    return mStateCur->id;
+}
+
+Result StateMachine::setState(const U32 kStateId)
+{
+    SF_SAFE_ASSERT(mConfig.states != nullptr);
+
+    // Find state config matching destination state ID and assert that it
+    // was found.
+    StateConfig* const state =
+        StateMachine::findState(mConfig.states, mStateCnt, kStateId);
+    SF_SAFE_ASSERT(state != nullptr);
+
+    mStateCur = state;
+    mTimeStateStart = Clock::NO_TIME;
+
+    return SUCCESS;
+}
+
+void StateMachine::setTimer(ExecutionTimer* const kTimer)
+{
+    mTimer = kTimer;
+}
+
+/////////////////////////////////// Private ////////////////////////////////////
+
+Result StateMachine::stepImpl()
 {
     // Check that state machine is initialized.
     if (mStateCur == nullptr)
@@ -176,14 +216,23 @@ Result StateMachine::step()
     const U64 tStateElapsed = (tCur - mTimeStateStart);
     mConfig.elemStateTime->write(tStateElapsed);
 
-    // Update expression stats if provided.
+    // Update expression stats if provided. When dependencies are provided,
+    // only stats used by the current state are updated.
     if (mConfig.stats != nullptr)
     {
-        for (IExpressionStats** stats = mConfig.stats;
-             *stats != nullptr;
-             ++stats)
+        for (U32 i = 0; mConfig.stats[i] != nullptr; ++i)
         {
-            (*stats)->update();
+            IExpressionStats* const stats = mConfig.stats[i];
+            if ((mConfig.statsDeps == nullptr)
+                || StateMachine::statsUsed(mConfig.statsDeps[i],
+                                           mStateCur->id))
+            {
+                stats->update();
+            }
+            else if (mConfig.statsDeps[i].sampleInactive)
+            {
+                stats->sample();
+            }
         }
     }
 
@@ -226,54 +275,57 @@ Result StateMachine::step()
     return SUCCESS;
 }
 
-Result StateMachine::getStateTime(U64& kT) const
+StateMachine::StateConfig* StateMachine::findState(
+    StateMachine::StateConfig* const kStates,
+    const U32 kStateCnt,
+    const U32 kStateId)
 {
-    if (mTimeStateStart == Clock::NO_TIME)
+    if (kStateId == StateMachine::NO_STATE)
     {
-        // First step in current state.
-        kT = 0;
+        return nullptr;
     }
-    else
+
+    // If states have dense IDs in array order, the state is at index ID - 1.
+    if ((kStateId <= kStateCnt) && (kStates[kStateId - 1].id == kStateId))
     {
-        // Not first step in current state.
-        SF_SAFE_ASSERT(mConfig.elemGlobalTime != nullptr);
-        kT = (mConfig.elemGlobalTime->read() - mTimeStateStart);
+        return &kStates[kStateId - 1];
     }
 
-    return SUCCESS;
-}
+    // Otherwise, search for the state.
+    for (U32 i = 0; i < kStateCnt; ++i)
+    {
+        if (kStates[i].id == kStateId)
+        {
+            return &kStates[i];
+        }
+    }
 
-U32 StateMachine::currentState() const
-{
-    return mStateCur->id;
+    return nullptr;
 }
 
-Result StateMachine::setState(const U32 kStateId)
+bool StateMachine::statsUsed(const StateMachine::StatsDeps& kDeps,
+                             const U32 kStateId)
 {
-    SF_SAFE_ASSERT(mConfig.states != nullptr);
+    if (kDeps.states == nullptr)
+    {
+        return true;
+    }
 
-    // Find state config matching destination state ID.
-    for (StateConfig* state = mConfig.states;
-         state->id != StateMachine::NO_STATE;
+    for (const U32* state = kDeps.states;
+         *state != StateMachine::NO_STATE;
          ++state)
     {
-        if (state->id == kStateId)
+        if (*state == kStateId)
         {
-            mStateCur = state;
-            mTimeStateStart = Clock::NO_TIME;
-            break;
+            return true;
         }
     }
 
-    // Assert that the destination state was found.
-    SF_SAFE_ASSERT(mStateCur->id == kStateId);
-
-    return SUCCESS;
+    return false;
 }
 
-/////////////////////////////////// Private ////////////////////////////////////
-
-Result StateMachine::checkTransitions(const StateMachine::Config kConfig)
+Result StateMachine::checkLabels(const StateMachine::Config kConfig,
+                                 const U32 kStateCnt)
 {
     SF_SAFE_ASSERT(kConfig.states != nullptr);
 
@@ -281,28 +333,25 @@ Result StateMachine::checkTransitions(const StateMachine::Config kConfig)
          state->id != StateMachine::NO_STATE;
          ++state)
     {
-        // Check transitions in entry label.
-        Result res = StateMachine::checkBlockTransitions(kConfig,
-                                                         state->entry,
-                                                         false);
+        // Check entry label.
+        Result res = StateMachine::checkLabel(kConfig,
+                                              kStateCnt,
+                                              state->entry,
+                                              false);
         if (res != SUCCESS)
         {
             return res;
         }
 
-        // Check transitions in step label.
-        res = StateMachine::checkBlockTransitions(kConfig,
-                                                  state->step,
-                                                  false);
+        // Check step label.
+        res = StateMachine::checkLabel(kConfig, kStateCnt, state->step, false);
         if (res != SUCCESS)
         {
             return res;
         }
 
-        // Check transitions in exit label.
-        res = StateMachine::checkBlockTransitions(kConfig,
-                                                  state->exit,
-                                                  true);
+        // Check exit label.
+        res = StateMachine::checkLabel(kConfig, kStateCnt, state->exit, true);
         if (res != SUCCESS)
         {
             return res;
@@ -312,70 +361,77 @@ Result StateMachine::checkTransitions(const StateMachine::Config kConfig)
     return SUCCESS;
 }
 
-Result StateMachine::checkBlockTransitions(
-    const StateMachine::Config kConfig,
-    const StateMachine::Block* const kBlock,
-    const bool kExit)
+Result StateMachine::checkLabel(const StateMachine::Config kConfig,
+                                const U32 kStateCnt,
+                                const StateMachine::Instruction* const kLabel,
+                                const bool kExit)
 {
     SF_SAFE_ASSERT(kConfig.states != nullptr);
 
-    // Base case: block is null.
-    if (kBlock == nullptr)
+    // Base case: no label.
+    if (kLabel == nullptr)
     {
         return SUCCESS;
     }
 
-    if ((kBlock->action != nullptr)
-        && (kBlock->action->destState != StateMachine::NO_STATE))
+    // Find the END instruction so that jumps can be checked against it.
+    U32 endIdx = 0;
+    while (kLabel[endIdx].op != Instruction::END)
     {
-        // Block contains a transition action.
+        ++endIdx;
+    }
 
-        if (kExit)
+    for (U32 i = 0; i < endIdx; ++i)
+    {
+        const Instruction& instr = kLabel[i];
+        switch (instr.op)
         {
-            // Transitioning in an exit label is illegal.
-            return E_SM_TR_EXIT;
-        }
+            case Instruction::GUARD:
+            case Instruction::JUMP:
+                if ((instr.op == Instruction::GUARD)
+                    && (instr.guard == nullptr))
+                {
+                    return E_SM_NULL;
+                }
 
-        // Find config of transition destination state.
-        const StateMachine::StateConfig* state = kConfig.states;
-        for (; state->id != StateMachine::NO_STATE; ++state)
-        {
-            if (state->id == kBlock->action->destState)
-            {
+                // Jumps must go forward and land inside the label, which
+                // guarantees that the label terminates.
+                if ((instr.offset == 0) || (instr.offset > (endIdx - i)))
+                {
+                    return E_SM_LABEL;
+                }
                 break;
-            }
-        }
-
-        if (state->id == StateMachine::NO_STATE)
-        {
-            // Destination state not found.
-            return E_SM_TRANS;
-        }
-    }
 
-    // Recurse into linked blocks.
-    Result res = StateMachine::checkBlockTransitions(kConfig,
-                                                     kBlock->ifBlock,
-                                                     kExit);
-    if (res != SUCCESS)
-    {
-        return res;
-    }
+            case Instruction::ACTION:
+                if (instr.action == nullptr)
+                {
+                    return E_SM_NULL;
+                }
 
-    res = StateMachine::checkBlockTransitions(kConfig,
-                                              kBlock->elseBlock,
-                                              kExit);
-    if (res != SUCCESS)
-    {
-        return res;
-    }
+                if (instr.action->destState != StateMachine::NO_STATE)
+                {
+                    // Transitioning in an exit label is illegal.
+                    if (kExit)
+                    {
+                        return E_SM_TR_EXIT;
+                    }
+
+                    // Find config of transition destination state.
+                    if (StateMachine::findState(kConfig.states,
+                                                kStateCnt,
+                                                instr.action->destState)
+                        == nullptr)
+                    {
+                        // Destination state not found.
+                        return E_SM_TRANS;
+                    }
+                }
+                break;
 
-    res = StateMachine::checkBlockTransitions(kConfig,
-                                              kBlock->next,
-                                              kExit);
-    if (res != SUCCESS)
-    {
-        return res;
+            default:
+                // Invalid opcode.
+                return E_SM_LABEL;
+        }
     }
 
     return SUCCESS;
@@ -26,6 +26,7 @@
 #include "sf/core/Action.hpp"
 #include "sf/core/BasicTypes.hpp"
 #include "sf/core/Element.hpp"
+#include "sf/core/ExecutionTimer.hpp"
 #include "sf/core/Expression.hpp"
 #include "sf/core/ExpressionStats.hpp"
 #include "sf/core/Result.hpp"
@@ -37,13 +38,14 @@ namespace Sf
 /// @brief Implements a deterministic finite state machine that interfaces with
 /// StateVector elements.
 ///
-/// A state machine is a set of states, each with three logic "blocks": an
-/// entry block that executes at the start of a state, a step block that
-/// executes every step in the state, and an exit block that executes at the end
-/// of the state. Blocks are represented as syntax trees of conditionals
-/// ("guards") and actions. An action may be a state vector element assignment
-/// or a transition to another state. All the data which a state machine
-/// operates on are state vector elements.
+/// A state machine is a set of states, each with three logic "labels": an
+/// entry label that executes at the start of a state, a step label that
+/// executes every step in the state, and an exit label that executes at the end
+/// of the state. Labels are represented as flat arrays of instructions that
+/// evaluate conditionals ("guards"), execute actions, and jump forward. An
+/// action may be a state vector element assignment or a transition to another
+/// state. All the data which a state machine operates on are state vector
+/// elements.
 ///
 /// @remark The user is not meant to manually create a StateMachine; it should
 /// be the product of an autocoder of compiler in the framework config library.
@@ -62,49 +64,63 @@ public:
     static constexpr U32 NO_STATE = 0;
 
     ///
-    /// @brief A node in a state machine syntax tree.
+    /// @brief An instruction in a state machine label. Each label is a
+    /// contiguous array of instructions terminated by an END instruction, and
+    /// is executed iteratively from its first instruction as follows:
     ///
-    /// Block execution goes as follows:
+    ///   1. GUARD evaluates the guard. If the guard is true, execution
+    ///      continues at the next instruction. Otherwise, execution jumps
+    ///      forward by the instruction offset.
+    ///   2. JUMP jumps forward by the instruction offset.
+    ///   3. ACTION executes the action. If the action triggers a transition,
+    ///      the label ends. Otherwise, execution continues at the next
+    ///      instruction.
+    ///   4. END ends the label.
     ///
-    ///   1. If guard is non-null, evaluate guard
-    ///     1. If guard was true, execute if block
-    ///     2. If guard was false and else block is non-null, execute else block
-    ///   2. If action is non-null, execute action
-    ///   3. If next block is non-null, execute next block
+    /// An if/else statement is a GUARD whose offset skips the if branch,
+    /// followed by the if branch, a JUMP whose offset skips the else branch,
+    /// and the else branch. Since jumps only go forward, a label executes at
+    /// most once per instruction and never recurses.
     ///
-    struct Block final
+    struct Instruction final
     {
         ///
-        /// @brief Pointer to block guard, or null if none.
+        /// @brief Instruction opcodes.
         ///
-        IExprNode<bool>* guard;
+        enum Opcode : U8
+        {
+            END = 0,    ///< End label.
+            GUARD = 1,  ///< Evaluate `guard` and jump by `offset` if false.
+            JUMP = 2,   ///< Jump by `offset`.
+            ACTION = 3  ///< Execute `action` and end label if it transitions.
+        };
 
         ///
-        /// @brief If block is guarded, pointer to if branch root block.
+        /// @brief Instruction opcode.
         ///
-        Block* ifBlock;
+        Opcode op;
 
         ///
-        /// @brief If block is guarded, pointer to else branch root block, or
-        /// null if none.
+        /// @brief Pointer to guard if opcode is GUARD, otherwise null.
         ///
-        Block* elseBlock;
+        IExprNode<bool>* guard;
 
         ///
-        /// @brief Pointer to block action, or null if none.
+        /// @brief Pointer to action if opcode is ACTION, otherwise null.
         ///
         IAction* action;
 
         ///
-        /// @brief Pointer to next block, or null if none.
+        /// @brief Number of instructions to jump forward by if opcode is GUARD
+        /// or JUMP, otherwise 0. Offsets are relative to this instruction.
         ///
-        Block* next;
+        U32 offset;
 
         ///
-        /// @brief Recursively executes the block tree rooted at this block.
+        /// @brief Executes the label that begins with this instruction.
         ///
-        /// @return Destination state if an action in the block tree triggered
-        /// a state machine transition, otherwise StateMachine::NO_STATE.
+        /// @return Destination state if an action in the label triggered a
+        /// state machine transition, otherwise StateMachine::NO_STATE.
         ///
         U32 execute() const;
     };
@@ -124,20 +140,46 @@ public:
         U32 id;
 
         ///
-        /// @brief Pointer to entry block, or null if no entry block.
+        /// @brief Pointer to entry label instructions, or null if no entry
+        /// label.
         ///
-        Block* entry;
+        Instruction* entry;
 
         ///
-        /// @brief Pointer to step block, or null if no step block.
+        /// @brief Pointer to step label instructions, or null if no step
+        /// label.
         ///
-        Block* step;
+        Instruction* step;
 
         ///
-        /// @brief Pointer to exit block, or null if no exit block.
-        /// Transitioning in an exit block is illegal.
+        /// @brief Pointer to exit label instructions, or null if no exit
+        /// label. Transitioning in an exit label is illegal.
         ///
-        Block* exit;
+        Instruction* exit;
+    };
+
+    ///
+    /// @brief Describes which states use an expression stats.
+    ///
+    struct StatsDeps final
+    {
+        ///
+        /// @brief Array of IDs of states whose logic evaluates the stats, or
+        /// null if all states do. The array must be terminated with
+        /// StateMachine::NO_STATE.
+        ///
+        /// @warning Failing to terminate the array has undefined behavior.
+        ///
+        const U32* states;
+
+        ///
+        /// @brief Whether the stats keep sampling while in a state that does
+        /// not use them. If true, the stats are sampled and their rolling
+        /// window is the same as if they were updated every step. If false,
+        /// the stats are not touched and their rolling window only contains
+        /// values from steps in states that use them.
+        ///
+        bool sampleInactive;
     };
 
     ///
@@ -177,6 +219,11 @@ public:
         /// @brief Array of state configs. The array must be terminated with a
         /// null (all-zero) state config.
         ///
+        /// @note State lookups, such as on transitions, are constant time when
+        /// the states have IDs 1 through N in array order, which is how the
+        /// config library generates them. Otherwise, lookups are linear in
+        /// the number of states.
+        ///
         /// @warning Failing to null-terminate the array has undefined behavior.
         ///
         StateConfig* states;
@@ -186,10 +233,20 @@ public:
         /// by expressions in the state machine logic, or null if unused. The
         /// array must be terminated with a null pointer. Each state machine
         /// step, after updating the state and state time elements but before
-        /// executing any blocks, the state machine will invoke update() on each
+        /// executing any labels, the state machine will invoke update() on each
         /// object in the array.
         ///
         IExpressionStats** stats;
+
+        ///
+        /// @brief Array of stats dependencies parallel to the stats array, or
+        /// null if unused. When provided, the state machine only calls
+        /// update() on stats used by the current state. Other stats are
+        /// either sampled with IExpressionStats::sample(), which defers their
+        /// aggregation until they are next evaluated, or skipped, depending on
+        /// StatsDeps::sampleInactive.
+        ///
+        StatsDeps* statsDeps;
     };
 
     ///
@@ -206,10 +263,14 @@ public:
     ///
     /// @retval SUCCESS       Successfully initialized state machine.
     /// @retval E_SM_REINIT   State machine is already initialized.
-    /// @retval E_SM_NULL     A required pointer in the config was null.
+    /// @retval E_SM_NULL     A required pointer in the config was null, or a
+    ///                       label contains a GUARD or ACTION instruction with
+    ///                       a null operand.
     /// @retval E_SM_EMPTY    Config contains no states.
     /// @retval E_SM_STATE    Invalid initial state.
-    /// @retval E_SM_TR_EXIT  Illegal transition in exit block.
+    /// @retval E_SM_LABEL    A label contains an invalid opcode or a jump that
+    ///                       does not land inside the label.
+    /// @retval E_SM_TR_EXIT  Illegal transition in exit label.
     /// @retval E_SM_TRANS    Invalid transition destination state.
     ///
     static Result init(const Config kConfig, StateMachine& kSm);
@@ -264,7 +325,7 @@ public:
 
     ///
     /// @brief Forcibly sets the state machine state, disregarding transitions
-    /// and exit blocks. The next call to step() will execute the first step of
+    /// and exit labels. The next call to step() will execute the first step of
     /// the new state.
     ///
     /// @note This method is used when running the state machine in a state
@@ -277,6 +338,16 @@ public:
     ///
     Result setState(const U32 kStateId);
 
+    ///
+    /// @brief Sets a timer to record the execution time of each step, which
+    /// includes evaluating the guards, actions, and expression stats of the
+    /// current state. Only has an effect if SF_ENABLE_TIMING was defined at
+    /// compile time.
+    ///
+    /// @param[in] kTimer  Timer, or null to stop timing.
+    ///
+    void setTimer(ExecutionTimer* const kTimer);
+
     StateMachine(const StateMachine&) = delete;
     StateMachine(StateMachine&&) = delete;
     StateMachine& operator=(const StateMachine&) = delete;
@@ -308,31 +379,83 @@ private:
     U64 mTimeLastStep;
 
     ///
-    /// @brief Helper function to validate transitions in a state machine
+    /// @brief Number of states in the config.
+    ///
+    U32 mStateCnt;
+
+    ///
+    /// @brief Step execution timer, or null if not timing.
+    ///
+    ExecutionTimer* mTimer;
+
+    ///
+    /// @brief Implements step() minus timing.
+    ///
+    /// @see StateMachine::step()
+    ///
+    Result stepImpl();
+
+    ///
+    /// @brief Finds the config of a state by ID. When state IDs are 1 through
+    /// N in array order, the state config array is its own dense index and the
+    /// lookup is constant time. Otherwise, this falls back to a linear search.
+    ///
+    /// @param[in] kStates    State config array.
+    /// @param[in] kStateCnt  Number of states in array.
+    /// @param[in] kStateId   State ID.
+    ///
+    /// @returns Pointer to state config, or null if not found.
+    ///
+    static StateMachine::StateConfig* findState(
+        StateMachine::StateConfig* const kStates,
+        const U32 kStateCnt,
+        const U32 kStateId);
+
+    ///
+    /// @brief Gets whether a state uses an expression stats.
+    ///
+    /// @param[in] kDeps     Stats dependencies.
+    /// @param[in] kStateId  State ID.
+    ///
+    /// @returns If the state uses the stats.
+    ///
+    static bool statsUsed(const StateMachine::StatsDeps& kDeps,
+                          const U32 kStateId);
+
+    ///
+    /// @brief Helper function to validate the labels in a state machine
     /// config.
     ///
-    /// @param[in] kConfig  Config to validate.
+    /// @param[in] kConfig    Config to validate.
+    /// @param[in] kStateCnt  Number of states in config.
     ///
-    /// @retval SUCCESS       Transitions are valid.
-    /// @retval E_SM_TR_EXIT  Illegal transition in exit block.
+    /// @retval SUCCESS       Labels are valid.
+    /// @retval E_SM_NULL     Null guard or action operand.
+    /// @retval E_SM_LABEL    Invalid opcode or jump.
+    /// @retval E_SM_TR_EXIT  Illegal transition in exit label.
     /// @retval E_SM_TRANS    Invalid transition destination state.
     ///
-    static Result checkTransitions(const StateMachine::Config kConfig);
+    static Result checkLabels(const StateMachine::Config kConfig,
+                              const U32 kStateCnt);
 
     ///
-    /// @brief Helper function to validate transitions in a state config.
+    /// @brief Helper function to validate a single label.
     ///
-    /// @param[in] kConfig  State machine config.
-    /// @param[in] kBlock   Block to validate transitions in.
-    /// @param[in] kExit    Whether block is an exit block.
+    /// @param[in] kConfig    State machine config.
+    /// @param[in] kStateCnt  Number of states in config.
+    /// @param[in] kLabel     Label to validate, or null if none.
+    /// @param[in] kExit      Whether label is an exit label.
     ///
-    /// @retval SUCCESS       Transitions are valid.
-    /// @retval E_SM_TR_EXIT  Illegal transition in exit block.
+    /// @retval SUCCESS       Label is valid.
+    /// @retval E_SM_NULL     Null guard or action operand.
+    /// @retval E_SM_LABEL    Invalid opcode or jump.
+    /// @retval E_SM_TR_EXIT  Illegal transition in exit label.
     /// @retval E_SM_TRANS    Invalid transition destination state.
     ///
-    static Result checkBlockTransitions(const StateMachine::Config kConfig,
-                                        const StateMachine::Block* const kBlock,
-                                        const bool kExit);
+    static Result checkLabel(const StateMachine::Config kConfig,
+                             const U32 kStateCnt,
+                             const StateMachine::Instruction* const kLabel,
+                             const bool kExit);
 };
 
 } // namespace Sf
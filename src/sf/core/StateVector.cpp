@@ -36,46 +36,86 @@ Result StateVector::init(const Config kConfig, StateVector& kSv)
         return E_SV_NULL;
     }
 
-    for (U32 i = 0; kConfig.elems[i].name != nullptr; ++i)
+    U32 elemCnt = 0;
+    for (; kConfig.elems[elemCnt].name != nullptr; ++elemCnt)
     {
         // Check that element pointer is non-null.
-        if (kConfig.elems[i].elem == nullptr)
+        if (kConfig.elems[elemCnt].elem == nullptr)
         {
             return E_SV_NULL;
         }
 
-        // Check that element name is unique.
-        for (U32 j = (i + 1); kConfig.elems[j].name != nullptr; ++j)
+        // If no lookup index was provided, check that element name is unique
+        // by comparing it against every following element.
+        if (kConfig.elemIndex == nullptr)
         {
-            if (MemOps::strcmp(kConfig.elems[i].name, kConfig.elems[j].name)
-                == 0)
+            for (U32 j = (elemCnt + 1); kConfig.elems[j].name != nullptr; ++j)
             {
-                return E_SV_ELEM_DUPE;
+                if (MemOps::strcmp(kConfig.elems[elemCnt].name,
+                                   kConfig.elems[j].name) == 0)
+                {
+                    return E_SV_ELEM_DUPE;
+                }
             }
         }
     }
 
+    // If a lookup index was provided, build it. This also checks that element
+    // names are unique.
+    if (kConfig.elemIndex != nullptr)
+    {
+        const Result res = StateVector::buildIndex(kConfig.elems,
+                                                   elemCnt,
+                                                   kConfig.elemIndex,
+                                                   E_SV_ELEM_DUPE);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+    }
+
+    U32 regionCnt = 0;
     if (kConfig.regions != nullptr)
     {
-        for (U32 i = 0; kConfig.regions[i].name != nullptr; ++i)
+        for (; kConfig.regions[regionCnt].name != nullptr; ++regionCnt)
         {
             // Check that each region config region pointer is non-null.
-            if (kConfig.regions[i].region == nullptr)
+            if (kConfig.regions[regionCnt].region == nullptr)
             {
                 return E_SV_NULL;
             }
 
-            // Check that region name is unique.
-            for (U32 j = (i + 1); kConfig.regions[j].name != nullptr; ++j)
+            // If no lookup index was provided, check that region name is
+            // unique by comparing it against every following region.
+            if (kConfig.regionIndex == nullptr)
             {
-                if (MemOps::strcmp(kConfig.regions[i].name,
-                                   kConfig.regions[j].name) == 0)
+                for (U32 j = (regionCnt + 1);
+                     kConfig.regions[j].name != nullptr;
+                     ++j)
                 {
-                    return E_SV_RGN_DUPE;
+                    if (MemOps::strcmp(kConfig.regions[regionCnt].name,
+                                       kConfig.regions[j].name) == 0)
+                    {
+                        return E_SV_RGN_DUPE;
+                    }
                 }
             }
         }
 
+        // If a lookup index was provided, build it. This also checks that
+        // region names are unique.
+        if (kConfig.regionIndex != nullptr)
+        {
+            const Result res = StateVector::buildIndex(kConfig.regions,
+                                                       regionCnt,
+                                                       kConfig.regionIndex,
+                                                       E_SV_RGN_DUPE);
+            if (res != SUCCESS)
+            {
+                return res;
+            }
+        }
+
         // Check that element memory exactly spans regions memory.
         U32 elemIdx = 0;
         for (U32 i = 0; kConfig.regions[i].name != nullptr; ++i)
@@ -113,11 +153,14 @@ Result StateVector::init(const Config kConfig, StateVector& kSv)
 
     // Config is valid- put config in state vector to initialize it.
     kSv.mConfig = kConfig;
+    kSv.mElemCnt = elemCnt;
+    kSv.mRegionCnt = regionCnt;
 
     return SUCCESS;
 }
 
-StateVector::StateVector() : mConfig({nullptr, nullptr})
+StateVector::StateVector() :
+    mConfig({nullptr, nullptr, nullptr, nullptr}), mElemCnt(0), mRegionCnt(0)
 {
 }
 
@@ -257,7 +300,21 @@ Result StateVector::getElementConfig(const char* const kName,
 {
     SF_SAFE_ASSERT(mConfig.elems != nullptr);
 
-    // Look up element config by name.
+    // If a lookup index was provided, binary search it.
+    if (mConfig.elemIndex != nullptr)
+    {
+        const ElementConfig* const elemConfig =
+            StateVector::searchIndex(mConfig.elemIndex, mElemCnt, kName);
+        if (elemConfig == nullptr)
+        {
+            return E_SV_KEY;
+        }
+
+        kElemConfig = elemConfig;
+        return SUCCESS;
+    }
+
+    // Otherwise, look up element config by name with a linear search.
     for (U32 i = 0; mConfig.elems[i].name != nullptr; ++i)
     {
         if (MemOps::strcmp(mConfig.elems[i].name, kName) == 0)
@@ -276,7 +333,21 @@ Result StateVector::getRegionConfig(const char* const kName,
 {
     SF_SAFE_ASSERT(mConfig.regions != nullptr);
 
-    // Look up region config by name.
+    // If a lookup index was provided, binary search it.
+    if (mConfig.regionIndex != nullptr)
+    {
+        const RegionConfig* const regionConfig =
+            StateVector::searchIndex(mConfig.regionIndex, mRegionCnt, kName);
+        if (regionConfig == nullptr)
+        {
+            return E_SV_KEY;
+        }
+
+        kRegionConfig = regionConfig;
+        return SUCCESS;
+    }
+
+    // Otherwise, look up region config by name with a linear search.
     for (U32 i = 0; mConfig.regions[i].name != nullptr; ++i)
     {
         if (MemOps::strcmp(mConfig.regions[i].name, kName) == 0)
@@ -290,4 +361,108 @@ Result StateVector::getRegionConfig(const char* const kName,
     return E_SV_KEY;
 }
 
+template<typename T>
+Result StateVector::buildIndex(const T* const kConfigs,
+                               const U32 kCnt,
+                               const T** const kIndex,
+                               const Result kDupeErr)
+{
+    SF_SAFE_ASSERT(kConfigs != nullptr);
+    SF_SAFE_ASSERT(kIndex != nullptr);
+
+    // Populate index in config order.
+    for (U32 i = 0; i < kCnt; ++i)
+    {
+        kIndex[i] = &kConfigs[i];
+    }
+
+    // Arrange index into a max heap.
+    for (U32 i = (kCnt / 2); i > 0; --i)
+    {
+        StateVector::siftDown(kIndex, (i - 1), kCnt);
+    }
+
+    // Repeatedly move the largest remaining name to the end of the unsorted
+    // part of the index, leaving the index sorted in ascending order.
+    for (U32 end = kCnt; end > 1; --end)
+    {
+        const T* const tmp = kIndex[0];
+        kIndex[0] = kIndex[end - 1];
+        kIndex[end - 1] = tmp;
+        StateVector::siftDown(kIndex, 0, (end - 1));
+    }
+
+    // Duplicate names are now adjacent in the index.
+    for (U32 i = 1; i < kCnt; ++i)
+    {
+        if (MemOps::strcmp(kIndex[i - 1]->name, kIndex[i]->name) == 0)
+        {
+            return kDupeErr;
+        }
+    }
+
+    return SUCCESS;
+}
+
+template<typename T>
+void StateVector::siftDown(const T** const kIndex, U32 kRoot, const U32 kSize)
+{
+    while (true)
+    {
+        // Pick the child of the root with the larger name, if any.
+        U32 child = ((2 * kRoot) + 1);
+        if (child >= kSize)
+        {
+            break;
+        }
+
+        if (((child + 1) < kSize)
+            && (MemOps::strcmp(kIndex[child]->name, kIndex[child + 1]->name)
+                < 0))
+        {
+            ++child;
+        }
+
+        // Heap property holds if the root is at least as large as the child.
+        if (MemOps::strcmp(kIndex[kRoot]->name, kIndex[child]->name) >= 0)
+        {
+            break;
+        }
+
+        // Swap root with child and continue down the heap.
+        const T* const tmp = kIndex[kRoot];
+        kIndex[kRoot] = kIndex[child];
+        kIndex[child] = tmp;
+        kRoot = child;
+    }
+}
+
+template<typename T>
+const T* StateVector::searchIndex(const T* const* const kIndex,
+                                  const U32 kCnt,
+                                  const char* const kName)
+{
+    U32 lo = 0;
+    U32 hi = kCnt;
+    while (lo < hi)
+    {
+        const U32 mid = (lo + ((hi - lo) / 2));
+        const I32 cmp = MemOps::strcmp(kIndex[mid]->name, kName);
+        if (cmp == 0)
+        {
+            return kIndex[mid];
+        }
+        else if (cmp < 0)
+        {
+            lo = (mid + 1);
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return nullptr;
+}
+
 } // namespace Sf
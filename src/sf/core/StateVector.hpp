@@ -101,6 +101,28 @@ public:
         /// @warning Failing to null-terminate the array has undefined behavior.
         ///
         RegionConfig* regions;
+
+        ///
+        /// @brief Storage for the element lookup index, or null to look up
+        /// elements by linear search. If non-null, the array must have one
+        /// slot for each element config, not counting the null terminator.
+        /// The array is populated by StateVector::init() and afterwards holds
+        /// pointers to the element configs sorted by name, which makes element
+        /// lookups O(log n) and the duplicate name check O(n log n).
+        ///
+        /// @warning Providing an array with too few slots has undefined
+        /// behavior.
+        ///
+        const ElementConfig** elemIndex;
+
+        ///
+        /// @brief Storage for the region lookup index, or null to look up
+        /// regions by linear search. If non-null, the array must have one slot
+        /// for each region config, not counting the null terminator.
+        ///
+        /// @see StateVector::Config::elemIndex
+        ///
+        const RegionConfig** regionIndex;
     };
 
     ///
@@ -124,6 +146,9 @@ public:
     /// @retval E_SV_LAYOUT     Regions are not contiguous or do not exactly
     ///                         span element backing.
     ///
+    /// @note If initialization fails, the contents of any lookup index storage
+    /// in the config are unspecified.
+    ///
     static Result init(const Config kConfig, StateVector& kSv);
 
     ///
@@ -201,6 +226,69 @@ private:
     ///
     StateVector::Config mConfig;
 
+    ///
+    /// @brief Number of elements in the state vector.
+    ///
+    U32 mElemCnt;
+
+    ///
+    /// @brief Number of regions in the state vector.
+    ///
+    U32 mRegionCnt;
+
+    ///
+    /// @brief Populates a lookup index with pointers to element or region
+    /// configs sorted by name, and checks that the names are unique.
+    ///
+    /// @remark The index is sorted with heapsort so that building it takes
+    /// O(n log n) time, constant stack, and no heap.
+    ///
+    /// @tparam T  ElementConfig or RegionConfig.
+    ///
+    /// @param[in]  kConfigs  Configs to index.
+    /// @param[in]  kCnt      Number of configs to index.
+    /// @param[out] kIndex    Index storage with at least kCnt slots.
+    /// @param[in]  kDupeErr  Error to return if a name is duplicated.
+    ///
+    /// @retval SUCCESS   Successfully built index.
+    /// @retval kDupeErr  Duplicate name.
+    ///
+    template<typename T>
+    static Result buildIndex(const T* const kConfigs,
+                             const U32 kCnt,
+                             const T** const kIndex,
+                             const Result kDupeErr);
+
+    ///
+    /// @brief Restores the max-heap property of a lookup index subtree being
+    /// sorted by buildIndex().
+    ///
+    /// @tparam T  ElementConfig or RegionConfig.
+    ///
+    /// @param[in] kIndex  Index being sorted.
+    /// @param[in] kRoot   Index of subtree root.
+    /// @param[in] kSize   Number of index slots in the heap.
+    ///
+    template<typename T>
+    static void siftDown(const T** const kIndex, U32 kRoot, const U32 kSize);
+
+    ///
+    /// @brief Looks up a config by name in a lookup index with binary search.
+    ///
+    /// @tparam T  ElementConfig or RegionConfig.
+    ///
+    /// @param[in] kIndex  Index built by buildIndex().
+    /// @param[in] kCnt    Number of configs in index.
+    /// @param[in] kName   Name to look up.
+    ///
+    /// @returns Pointer to config with the specified name, or null if not
+    /// found.
+    ///
+    template<typename T>
+    static const T* searchIndex(const T* const* const kIndex,
+                                const U32 kCnt,
+                                const char* const kName);
+
     ///
     /// @brief Looks up an element config by name.
     ///
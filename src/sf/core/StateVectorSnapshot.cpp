@@ -0,0 +1,217 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/core/StateVectorSnapshot.hpp"
+
+namespace Sf
+{
+
+/////////////////////////////////// Public /////////////////////////////////////
+
+Result StateVectorSnapshot::init(const Config kConfig,
+                                 StateVectorSnapshot& kSnap)
+{
+    // Check that snapshot is not already initialized.
+    if (kSnap.mConfig.regions != nullptr)
+    {
+        return E_SVS_REINIT;
+    }
+
+    // Check that regions and buffers are non-null.
+    if ((kConfig.regions == nullptr) || (kConfig.regions[0].region == nullptr))
+    {
+        return E_SVS_NULL;
+    }
+
+    for (U32 i = 0; i < BUFFER_CNT; ++i)
+    {
+        if (kConfig.buffers[i] == nullptr)
+        {
+            return E_SVS_NULL;
+        }
+    }
+
+    // Compute the frame size and check that buffers can hold a frame. Frame
+    // offsets are computed from the first region's address, so each region
+    // must start where the previous region ends.
+    const U8* const base =
+        static_cast<const U8*>(kConfig.regions[0].region->addr());
+    U32 frameSizeBytes = 0;
+    for (const StateVector::RegionConfig* region = kConfig.regions;
+         region->name != nullptr;
+         ++region)
+    {
+        if (region->region == nullptr)
+        {
+            return E_SVS_NULL;
+        }
+
+        if (static_cast<const U8*>(region->region->addr())
+            != (base + frameSizeBytes))
+        {
+            return E_SVS_LAYOUT;
+        }
+
+        frameSizeBytes += region->region->size();
+    }
+
+    if (frameSizeBytes > kConfig.bufferSizeBytes)
+    {
+        return E_SVS_SIZE;
+    }
+
+    // Config is valid- initialize snapshot. The producer starts with buffer 0
+    // and the consumer with buffer 2, neither of which holds a frame.
+    kSnap.mConfig = kConfig;
+    kSnap.mFrameSizeBytes = frameSizeBytes;
+    kSnap.mBack = 0;
+    kSnap.mMiddle = 1;
+    kSnap.mFront = 2;
+    kSnap.mFrameCnt = 0;
+    for (U32 i = 0; i < BUFFER_CNT; ++i)
+    {
+        kSnap.mFrameNums[i] = 0;
+    }
+
+    return SUCCESS;
+}
+
+StateVectorSnapshot::StateVectorSnapshot() :
+    mConfig({nullptr, {nullptr, nullptr, nullptr}, 0}),
+    mFrameSizeBytes(0),
+    mBack(0),
+    mMiddle(1),
+    mFront(2),
+    mFrameNums{0, 0, 0},
+    mFrameCnt(0)
+{
+}
+
+Result StateVectorSnapshot::publish()
+{
+    // Check that snapshot is initialized.
+    if (mConfig.regions == nullptr)
+    {
+        return E_SVS_UNINIT;
+    }
+
+    // Copy each region into the back buffer.
+    U8* const buf = mConfig.buffers[mBack];
+    U32 offset = 0;
+    for (const StateVector::RegionConfig* region = mConfig.regions;
+         region->name != nullptr;
+         ++region)
+    {
+        const U32 size = region->region->size();
+        const Result res = region->region->read((buf + offset), size);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        offset += size;
+    }
+
+    // Number the frame and swap it into the middle. The buffer previously in
+    // the middle, which the consumer did not latch, becomes the new back.
+    mFrameNums[mBack] = ++mFrameCnt;
+    const U32 prev =
+        __atomic_exchange_n(&mMiddle, (mBack | FRESH), __ATOMIC_ACQ_REL);
+    mBack = (prev & IDX_MASK);
+
+    return SUCCESS;
+}
+
+Result StateVectorSnapshot::acquire()
+{
+    // Check that snapshot is initialized.
+    if (mConfig.regions == nullptr)
+    {
+        return E_SVS_UNINIT;
+    }
+
+    // If a new frame was published, swap it into the front.
+    if ((__atomic_load_n(&mMiddle, __ATOMIC_ACQUIRE) & FRESH) != 0)
+    {
+        const U32 prev =
+            __atomic_exchange_n(&mMiddle, mFront, __ATOMIC_ACQ_REL);
+        mFront = (prev & IDX_MASK);
+    }
+
+    if (mFrameNums[mFront] == 0)
+    {
+        return E_SVS_EMPTY;
+    }
+
+    return SUCCESS;
+}
+
+const void* StateVectorSnapshot::frame() const
+{
+    if ((mConfig.regions == nullptr) || (mFrameNums[mFront] == 0))
+    {
+        return nullptr;
+    }
+
+    return mConfig.buffers[mFront];
+}
+
+U32 StateVectorSnapshot::frameSizeBytes() const
+{
+    return mFrameSizeBytes;
+}
+
+U64 StateVectorSnapshot::frameNumber() const
+{
+    return mFrameNums[mFront];
+}
+
+Result StateVectorSnapshot::getRegion(const Region& kRegion,
+                                      const void*& kAddr) const
+{
+    return this->frameAddr(kRegion.addr(), kRegion.size(), kAddr);
+}
+
+/////////////////////////////////// Private ////////////////////////////////////
+
+Result StateVectorSnapshot::frameAddr(const void* const kAddr,
+                                      const U32 kSizeBytes,
+                                      const void*& kFrameAddr) const
+{
+    const U8* const frame = static_cast<const U8*>(this->frame());
+    if (frame == nullptr)
+    {
+        return E_SVS_EMPTY;
+    }
+
+    // Since regions are contiguous, the frame is a copy of the state vector
+    // backing starting at the first region.
+    const U8* const base =
+        static_cast<const U8*>(mConfig.regions[0].region->addr());
+    const U8* const addr = static_cast<const U8*>(kAddr);
+    if ((addr < base)
+        || ((addr + kSizeBytes) > (base + mFrameSizeBytes)))
+    {
+        return E_SVS_KEY;
+    }
+
+    kFrameAddr = (frame + (addr - base));
+    return SUCCESS;
+}
+
+} // namespace Sf
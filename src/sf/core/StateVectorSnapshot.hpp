@@ -0,0 +1,268 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/StateVectorSnapshot.hpp
+/// @brief Triple-buffered state vector snapshots.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_STATE_VECTOR_SNAPSHOT_HPP
+#define SF_STATE_VECTOR_SNAPSHOT_HPP
+
+#include "sf/core/BasicTypes.hpp"
+#include "sf/core/MemOps.hpp"
+#include "sf/core/Result.hpp"
+#include "sf/core/StateVector.hpp"
+
+namespace Sf
+{
+
+///
+/// @brief Triple-buffered snapshots of a state vector, which give a consumer
+/// a coherent view of the whole state vector without blocking the producer.
+///
+/// A producer task calls publish() at a frame boundary, i.e., when it has
+/// finished updating the state vector for the current cycle. This copies every
+/// region into a back buffer and makes it the latest frame. A consumer task,
+/// e.g., telemetry or logging, calls acquire() to latch the latest frame and
+/// then reads it in place via frame(), getRegion(), and read(). The latched
+/// frame does not change until the consumer next calls acquire(), no matter
+/// how many frames the producer publishes in the meantime.
+///
+/// Frames are handed between the producer and consumer with a single atomic
+/// exchange, so neither ever waits on the other. Regions are read with
+/// Region::read(), so each region in a frame is consistent with respect to
+/// other writers if the state vector is thread-safe.
+///
+/// @note A snapshot supports one producer thread and one consumer thread.
+/// Multiple consumers should each use their own snapshot.
+///
+/// @remark The frame layout is the state vector backing: the regions in config
+/// order with no padding.
+///
+class StateVectorSnapshot final
+{
+public:
+
+    ///
+    /// @brief Number of frame buffers.
+    ///
+    static constexpr U32 BUFFER_CNT = 3;
+
+    ///
+    /// @brief Snapshot config.
+    ///
+    struct Config final
+    {
+        ///
+        /// @brief Region configs of the state vector to snapshot, as passed to
+        /// StateVector::init(). The array must be null-terminated, and the
+        /// regions must be contiguous.
+        ///
+        const StateVector::RegionConfig* regions;
+
+        ///
+        /// @brief Frame buffers, each at least as large as all regions
+        /// combined.
+        ///
+        U8* buffers[BUFFER_CNT];
+
+        ///
+        /// @brief Size of each frame buffer in bytes.
+        ///
+        U32 bufferSizeBytes;
+    };
+
+    ///
+    /// @brief Initializes a snapshot from a config.
+    ///
+    /// @param[in] kConfig  Snapshot config.
+    /// @param[in] kSnap    Snapshot to initialize.
+    ///
+    /// @retval SUCCESS       Successfully initialized snapshot.
+    /// @retval E_SVS_REINIT  Snapshot is already initialized.
+    /// @retval E_SVS_NULL    Config contains a null pointer, or there are no
+    ///                       regions.
+    /// @retval E_SVS_SIZE    Frame buffers are too small.
+    /// @retval E_SVS_LAYOUT  A region does not start where the previous region
+    ///                       ends.
+    ///
+    static Result init(const Config kConfig, StateVectorSnapshot& kSnap);
+
+    ///
+    /// @brief Default constructor.
+    ///
+    /// @post The constructed snapshot is uninitialized and invoking any of its
+    /// methods returns an error.
+    ///
+    StateVectorSnapshot();
+
+    ///
+    /// @brief Publishes the current state vector contents as the latest frame.
+    /// Called by the producer.
+    ///
+    /// @retval SUCCESS       Successfully published frame.
+    /// @retval E_SVS_UNINIT  Snapshot is uninitialized.
+    /// @retval [other]       Failed to read a region.
+    ///
+    Result publish();
+
+    ///
+    /// @brief Latches the latest published frame for reading. If no frame was
+    /// published since the last acquire, the latched frame is unchanged.
+    /// Called by the consumer.
+    ///
+    /// @retval SUCCESS       Successfully latched a frame.
+    /// @retval E_SVS_UNINIT  Snapshot is uninitialized.
+    /// @retval E_SVS_EMPTY   No frame has been published yet.
+    ///
+    Result acquire();
+
+    ///
+    /// @brief Gets the latched frame.
+    ///
+    /// @return Latched frame, or null if no frame is latched.
+    ///
+    const void* frame() const;
+
+    ///
+    /// @brief Gets the frame size in bytes.
+    ///
+    /// @return Frame size.
+    ///
+    U32 frameSizeBytes() const;
+
+    ///
+    /// @brief Gets the number of the latched frame. Frames are numbered from 1
+    /// in publish order, so the consumer can detect skipped or repeat frames.
+    ///
+    /// @return Latched frame number, or 0 if no frame is latched.
+    ///
+    U64 frameNumber() const;
+
+    ///
+    /// @brief Gets the address of a region in the latched frame.
+    ///
+    /// @param[in]  kRegion  Region in the snapshotted state vector.
+    /// @param[out] kAddr    On success, contains the region address.
+    ///
+    /// @retval SUCCESS      Successfully got region.
+    /// @retval E_SVS_EMPTY  No frame is latched.
+    /// @retval E_SVS_KEY    Region is not in the snapshotted state vector.
+    ///
+    Result getRegion(const Region& kRegion, const void*& kAddr) const;
+
+    ///
+    /// @brief Reads the value of an element in the latched frame.
+    ///
+    /// @param[in]  kElem  Element in the snapshotted state vector.
+    /// @param[out] kVal   On success, contains the element value.
+    ///
+    /// @retval SUCCESS      Successfully read element.
+    /// @retval E_SVS_EMPTY  No frame is latched.
+    /// @retval E_SVS_KEY    Element is not in the snapshotted state vector.
+    ///
+    template<typename T>
+    Result read(const Element<T>& kElem, T& kVal) const
+    {
+        const void* addr = nullptr;
+        const Result res = this->frameAddr(kElem.addr(), sizeof(T), addr);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+
+        MemOps::memcpy(&kVal, addr, sizeof(T));
+        return SUCCESS;
+    }
+
+    StateVectorSnapshot(const StateVectorSnapshot&) = delete;
+    StateVectorSnapshot(StateVectorSnapshot&&) = delete;
+    StateVectorSnapshot& operator=(const StateVectorSnapshot&) = delete;
+    StateVectorSnapshot& operator=(StateVectorSnapshot&&) = delete;
+
+private:
+
+    ///
+    /// @brief Flag set in mMiddle when the middle buffer holds a frame that
+    /// the consumer has not yet latched.
+    ///
+    static constexpr U32 FRESH = 0x4;
+
+    ///
+    /// @brief Mask of the buffer index in mMiddle.
+    ///
+    static constexpr U32 IDX_MASK = 0x3;
+
+    ///
+    /// @brief Gets the address in the latched frame of some state vector
+    /// memory.
+    ///
+    /// @param[in]  kAddr       Address in the state vector backing.
+    /// @param[in]  kSizeBytes  Size of the memory in bytes.
+    /// @param[out] kFrameAddr  On success, contains the frame address.
+    ///
+    /// @retval SUCCESS      Successfully got address.
+    /// @retval E_SVS_EMPTY  No frame is latched.
+    /// @retval E_SVS_KEY    Memory is not in the state vector backing.
+    ///
+    Result frameAddr(const void* const kAddr,
+                     const U32 kSizeBytes,
+                     const void*& kFrameAddr) const;
+
+    ///
+    /// @brief Snapshot config.
+    ///
+    Config mConfig;
+
+    ///
+    /// @brief Frame size in bytes.
+    ///
+    U32 mFrameSizeBytes;
+
+    ///
+    /// @brief Index of the buffer the producer writes next. Owned by the
+    /// producer.
+    ///
+    U32 mBack;
+
+    ///
+    /// @brief Index of the buffer exchanged between the producer and consumer,
+    /// plus the FRESH flag. Accessed atomically.
+    ///
+    U32 mMiddle;
+
+    ///
+    /// @brief Index of the buffer latched by the consumer. Owned by the
+    /// consumer.
+    ///
+    U32 mFront;
+
+    ///
+    /// @brief Number of the frame in each buffer, or 0 if none.
+    ///
+    U64 mFrameNums[BUFFER_CNT];
+
+    ///
+    /// @brief Number of frames published.
+    ///
+    U64 mFrameCnt;
+};
+
+} // namespace Sf
+
+#endif
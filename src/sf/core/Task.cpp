@@ -21,8 +21,10 @@
 namespace Sf
 {
 
+/////////////////////////////////// Public /////////////////////////////////////
+
 ITask::ITask(const Element<U8>* const kElemMode) :
-    mModeElem(kElemMode), mInit(false)
+    mModeElem(kElemMode), mInit(false), mTimer(nullptr)
 {
 }
 
@@ -45,6 +47,33 @@ Result ITask::init()
 }
 
 Result ITask::step()
+{
+#ifdef SF_ENABLE_TIMING
+    if (mTimer != nullptr)
+    {
+        mTimer->start();
+        const Result res = this->stepMode();
+        mTimer->stop();
+        return res;
+    }
+#endif
+
+    return this->stepMode();
+}
+
+void ITask::setTimer(ExecutionTimer* const kTimer)
+{
+    mTimer = kTimer;
+}
+
+Result ITask::stepSafe()
+{
+    return SUCCESS;
+}
+
+/////////////////////////////////// Private ////////////////////////////////////
+
+Result ITask::stepMode()
 {
     // Check that the task initialized successfully.
     if (!mInit)
@@ -77,9 +106,4 @@ Result ITask::step()
     return E_TSK_MODE;
 }
 
-Result ITask::stepSafe()
-{
-    return SUCCESS;
-}
-
 } // namespace Sf
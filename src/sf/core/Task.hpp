@@ -24,6 +24,7 @@
 #define SF_TASK_HPP
 
 #include "sf/core/Element.hpp"
+#include "sf/core/ExecutionTimer.hpp"
 #include "sf/core/Result.hpp"
 #include "sf/core/StateVector.hpp"
 
@@ -68,9 +69,10 @@ enum TaskMode : U8
 ///   4. If the task was configured with a mode state vector element, change the
 ///      task mode by writing this element from other code
 ///
-/// @remark Normally tasks will be used in conjunction with an IExecutor, which
-/// automatically handles task initialization and execution. Additionally, a
-/// StateMachine is a good mechanism for controlling task modes.
+/// @remark Normally tasks will be used in conjunction with an executor like
+/// CyclicExecutor, which automatically handles task initialization and
+/// execution. Additionally, a StateMachine is a good mechanism for controlling
+/// task modes.
 ///
 class ITask
 {
@@ -116,6 +118,14 @@ public:
     ///
     virtual Result step() final;
 
+    ///
+    /// @brief Sets a timer to record the execution time of each step. Only has
+    /// an effect if SF_ENABLE_TIMING was defined at compile time.
+    ///
+    /// @param[in] kTimer  Timer, or null to stop timing.
+    ///
+    void setTimer(ExecutionTimer* const kTimer);
+
     ITask(const ITask&) = delete;
     ITask(ITask&&) = delete;
     ITask& operator=(const ITask&) = delete;
@@ -163,6 +173,18 @@ private:
     /// @brief Whether task has initialized.
     ///
     bool mInit;
+
+    ///
+    /// @brief Step execution timer, or null if not timing.
+    ///
+    ExecutionTimer* mTimer;
+
+    ///
+    /// @brief Implements step() minus timing.
+    ///
+    /// @see ITask::step()
+    ///
+    Result stepMode();
 };
 
 } // namespace Sf
@@ -0,0 +1,360 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/utest/UTestCyclicExecutor.cpp
+/// @brief Unit tests for CyclicExecutor.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/core/CyclicExecutor.hpp"
+#include "sf/pal/Clock.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Number of nanoseconds in a millisecond.
+///
+static constexpr U64 gNsInMs = (Clock::NS_IN_S / Clock::MS_IN_S);
+
+///
+/// @brief Log of task IDs in the order tasks stepped.
+///
+static U32 gStepLog[32];
+
+///
+/// @brief Number of entries in the step log.
+///
+static U32 gStepLogSize;
+
+////////////////////////////////// Test Task ///////////////////////////////////
+
+///
+/// @brief Test task that logs its ID when stepped, optionally busy-waits to
+/// simulate execution time, and returns configurable results.
+///
+class LogTask final : public ITask
+{
+public:
+
+    LogTask(const U32 kId) :
+        ITask(nullptr),
+        id(kId),
+        execNs(0),
+        initRes(SUCCESS),
+        stepRes(SUCCESS),
+        steps(0)
+    {
+    }
+
+    const U32 id;
+
+    U64 execNs;
+
+    Result initRes;
+
+    Result stepRes;
+
+    U32 steps;
+
+private:
+
+    Result initImpl() final override
+    {
+        return initRes;
+    }
+
+    Result stepEnable() final override
+    {
+        if (gStepLogSize < (sizeof(gStepLog) / sizeof(gStepLog[0])))
+        {
+            gStepLog[gStepLogSize++] = id;
+        }
+
+        ++steps;
+        Clock::spinWait(execNs);
+        return stepRes;
+    }
+};
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Unit tests for CyclicExecutor.
+///
+TEST_GROUP(CyclicExecutor)
+{
+    void setup()
+    {
+        gStepLogSize = 0;
+    }
+};
+
+///
+/// @test Frame sizes are computed from task periods, and each task steps once
+/// per period in config order.
+///
+TEST(CyclicExecutor, Schedule)
+{
+    LogTask task1(1);
+    LogTask task2(2);
+    LogTask task3(3);
+    CyclicExecutor::TaskConfig tasks[] =
+    {
+        {&task1, (2 * gNsInMs), nullptr},
+        {&task2, (4 * gNsInMs), nullptr},
+        {&task3, (6 * gNsInMs), nullptr},
+        {nullptr, 0, nullptr}
+    };
+    CyclicExecutor exe;
+    CHECK_SUCCESS(CyclicExecutor::init({tasks}, exe));
+
+    // Minor frame is the GCD of the periods, and major frame is the LCM.
+    CHECK_EQUAL((2 * gNsInMs), exe.minorFrameNs());
+    CHECK_EQUAL((12 * gNsInMs), exe.majorFrameNs());
+
+    // Step through 1 major frame.
+    for (U32 i = 0; i < 6; ++i)
+    {
+        CHECK_SUCCESS(exe.step());
+    }
+
+    // Tasks stepped in the expected frames and order.
+    const U32 expectLog[] =
+    {
+        1, 2, 3, // 0 ms
+        1,       // 2 ms
+        1, 2,    // 4 ms
+        1, 3,    // 6 ms
+        1, 2,    // 8 ms
+        1        // 10 ms
+    };
+    CHECK_EQUAL((sizeof(expectLog) / sizeof(expectLog[0])), gStepLogSize);
+    for (U32 i = 0; i < gStepLogSize; ++i)
+    {
+        CHECK_EQUAL(expectLog[i], gStepLog[i]);
+    }
+
+    // Schedule repeats in the next major frame.
+    CHECK_SUCCESS(exe.step());
+    CHECK_EQUAL(7, task1.steps);
+    CHECK_EQUAL(4, task2.steps);
+    CHECK_EQUAL(3, task3.steps);
+}
+
+///
+/// @test Minor frames start at absolute multiples of the minor frame from the
+/// first step.
+///
+TEST(CyclicExecutor, FrameTiming)
+{
+    LogTask task(1);
+    CyclicExecutor::TaskConfig tasks[] =
+    {
+        {&task, gNsInMs, nullptr},
+        {nullptr, 0, nullptr}
+    };
+    CyclicExecutor exe;
+    CHECK_SUCCESS(CyclicExecutor::init({tasks}, exe));
+
+    // First step starts the schedule immediately. The 10 steps after it each
+    // wait for the start of their frame.
+    const U64 startNs = Clock::nanoTime();
+    for (U32 i = 0; i < 11; ++i)
+    {
+        CHECK_SUCCESS(exe.step());
+    }
+    CHECK_TRUE((Clock::nanoTime() - startNs) >= (10 * gNsInMs));
+    CHECK_EQUAL(11, task.steps);
+}
+
+///
+/// @test Task stats record steps, overruns, and release jitter.
+///
+TEST(CyclicExecutor, TaskStats)
+{
+    // Task 1 takes 3 ms to run but has a 2 ms period, so it overruns every
+    // step. Task 2 runs after task 1 in the same frame, so it always starts
+    // at least 3 ms late.
+    LogTask task1(1);
+    LogTask task2(2);
+    task1.execNs = (3 * gNsInMs);
+    CyclicExecutor::TaskStats stats1 = {};
+    CyclicExecutor::TaskStats stats2 = {};
+    CyclicExecutor::TaskConfig tasks[] =
+    {
+        {&task1, (2 * gNsInMs), &stats1},
+        {&task2, (20 * gNsInMs), &stats2},
+        {nullptr, 0, nullptr}
+    };
+    CyclicExecutor exe;
+    CHECK_SUCCESS(CyclicExecutor::init({tasks}, exe));
+
+    for (U32 i = 0; i < 4; ++i)
+    {
+        CHECK_SUCCESS(exe.step());
+    }
+
+    // Task 1 stepped every frame and overran every time.
+    CHECK_EQUAL(4, stats1.steps);
+    CHECK_EQUAL(4, stats1.overruns);
+
+    // Since task 1 overruns, the executor falls further behind each frame, so
+    // task 1 is released late after the first frame.
+    CHECK_TRUE(stats1.jitterMaxNs >= gNsInMs);
+    CHECK_TRUE(stats1.jitterSumNs >= stats1.jitterMaxNs);
+
+    // Task 2 stepped once without overrunning and was released late.
+    CHECK_EQUAL(1, stats2.steps);
+    CHECK_EQUAL(0, stats2.overruns);
+    CHECK_TRUE(stats2.jitterMaxNs >= (3 * gNsInMs));
+    CHECK_EQUAL(stats2.jitterMaxNs, stats2.jitterSumNs);
+}
+
+///
+/// @test All tasks due in a frame step even if an earlier task fails, and the
+/// first error is returned.
+///
+TEST(CyclicExecutor, TaskStepError)
+{
+    LogTask task1(1);
+    LogTask task2(2);
+    LogTask task3(3);
+    task1.stepRes = -1;
+    task2.stepRes = -2;
+    CyclicExecutor::TaskConfig tasks[] =
+    {
+        {&task1, gNsInMs, nullptr},
+        {&task2, gNsInMs, nullptr},
+        {&task3, gNsInMs, nullptr},
+        {nullptr, 0, nullptr}
+    };
+    CyclicExecutor exe;
+    CHECK_SUCCESS(CyclicExecutor::init({tasks}, exe));
+
+    CHECK_ERROR(-1, exe.step());
+    CHECK_EQUAL(1, task1.steps);
+    CHECK_EQUAL(1, task2.steps);
+    CHECK_EQUAL(1, task3.steps);
+}
+
+///
+/// @test Stepping an uninitialized executor returns an error.
+///
+TEST(CyclicExecutor, ErrorUninitialized)
+{
+    CyclicExecutor exe;
+    CHECK_ERROR(E_EXE_UNINIT, exe.step());
+    CHECK_EQUAL(0, exe.minorFrameNs());
+    CHECK_EQUAL(0, exe.majorFrameNs());
+}
+
+///
+/// @test Initializing an executor twice returns an error.
+///
+TEST(CyclicExecutor, ErrorReinitialize)
+{
+    LogTask task(1);
+    CyclicExecutor::TaskConfig tasks[] =
+    {
+        {&task, gNsInMs, nullptr},
+        {nullptr, 0, nullptr}
+    };
+    CyclicExecutor exe;
+    CHECK_SUCCESS(CyclicExecutor::init({tasks}, exe));
+    CHECK_ERROR(E_EXE_REINIT, CyclicExecutor::init({tasks}, exe));
+}
+
+///
+/// @test Initializing an executor with a null tasks array returns an error.
+///
+TEST(CyclicExecutor, ErrorNullTasks)
+{
+    CyclicExecutor exe;
+    CHECK_ERROR(E_EXE_NULL, CyclicExecutor::init({nullptr}, exe));
+    CHECK_ERROR(E_EXE_UNINIT, exe.step());
+}
+
+///
+/// @test Initializing an executor with no tasks returns an error.
+///
+TEST(CyclicExecutor, ErrorEmpty)
+{
+    CyclicExecutor::TaskConfig tasks[] = {{nullptr, 0, nullptr}};
+    CyclicExecutor exe;
+    CHECK_ERROR(E_EXE_EMPTY, CyclicExecutor::init({tasks}, exe));
+    CHECK_ERROR(E_EXE_UNINIT, exe.step());
+}
+
+///
+/// @test Initializing an executor with a zero task period returns an error.
+///
+TEST(CyclicExecutor, ErrorZeroPeriod)
+{
+    LogTask task1(1);
+    LogTask task2(2);
+    CyclicExecutor::TaskConfig tasks[] =
+    {
+        {&task1, gNsInMs, nullptr},
+        {&task2, 0, nullptr},
+        {nullptr, 0, nullptr}
+    };
+    CyclicExecutor exe;
+    CHECK_ERROR(E_EXE_PERIOD, CyclicExecutor::init({tasks}, exe));
+    CHECK_ERROR(E_EXE_UNINIT, exe.step());
+}
+
+///
+/// @test Initializing an executor whose major frame overflows returns an
+/// error.
+///
+TEST(CyclicExecutor, ErrorMajorFrameOverflow)
+{
+    // Periods are distinct large primes, so their LCM is their product.
+    LogTask task1(1);
+    LogTask task2(2);
+    CyclicExecutor::TaskConfig tasks[] =
+    {
+        {&task1, 4294967291, nullptr},
+        {&task2, 4294967311, nullptr},
+        {nullptr, 0, nullptr}
+    };
+    CyclicExecutor exe;
+    CHECK_ERROR(E_EXE_OVFL, CyclicExecutor::init({tasks}, exe));
+    CHECK_ERROR(E_EXE_UNINIT, exe.step());
+}
+
+///
+/// @test Errors from task initialization are returned by init().
+///
+TEST(CyclicExecutor, ErrorTaskInit)
+{
+    LogTask task1(1);
+    LogTask task2(2);
+    task2.initRes = -1;
+    CyclicExecutor::TaskConfig tasks[] =
+    {
+        {&task1, gNsInMs, nullptr},
+        {&task2, gNsInMs, nullptr},
+        {nullptr, 0, nullptr}
+    };
+    CyclicExecutor exe;
+    CHECK_ERROR(-1, CyclicExecutor::init({tasks}, exe));
+    CHECK_ERROR(E_EXE_UNINIT, exe.step());
+}
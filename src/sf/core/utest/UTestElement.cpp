@@ -69,6 +69,33 @@ static void testReadWrite(const T kInitVal, const T kWriteVal)
     CHECK_EQUAL(kWriteVal, backing);
 }
 
+///
+/// @brief Checks that an atomic element can be read, and writing the element
+/// updates its backing.
+///
+/// @tparam T  Element type.
+///
+/// @param[in] kInitVal   Element initial value.
+/// @param[in] kWriteVal  Value to write to element and then read back.
+///
+template<typename T>
+static void testReadWriteAtomic(const T kInitVal, const T kWriteVal)
+{
+    // Create atomic element with initial value. The backing is naturally
+    // aligned since it is a local variable.
+    T backing = kInitVal;
+    Element<T> elem(backing, AtomicAccess());
+
+    // Reading element returns initial value.
+    CHECK_EQUAL(kInitVal, elem.read());
+
+    // Write new value. Reading element returns the new value, and the element
+    // backing was updated accordingly.
+    elem.write(kWriteVal);
+    CHECK_EQUAL(kWriteVal, elem.read());
+    CHECK_EQUAL(kWriteVal, backing);
+}
+
 ///
 /// @brief Checks that Element::addr() returns the backing address.
 ///
@@ -122,6 +149,24 @@ TEST(Element, ReadWrite)
     testReadWrite<bool>(false, true);
 }
 
+///
+/// @test Atomic elements are read and written correctly.
+///
+TEST(Element, ReadWriteAtomic)
+{
+    testReadWriteAtomic<I8>(-101, 23);
+    testReadWriteAtomic<I16>(12443, -438);
+    testReadWriteAtomic<I32>(1065779324, -996103);
+    testReadWriteAtomic<I64>(-12566034892L, 654223);
+    testReadWriteAtomic<U8>(101, 255);
+    testReadWriteAtomic<U16>(3001, 8888);
+    testReadWriteAtomic<U32>(21903, 3862999091U);
+    testReadWriteAtomic<U64>(12, 23001040778UL);
+    testReadWriteAtomic<F32>(0.000233391f, -415.131313f);
+    testReadWriteAtomic<F64>(-1.522, 903.88854112);
+    testReadWriteAtomic<bool>(false, true);
+}
+
 ///
 /// @test Element::type() returns the correct type enum.
 ///
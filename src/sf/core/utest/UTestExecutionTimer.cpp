@@ -0,0 +1,335 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/utest/UTestExecutionTimer.cpp
+/// @brief Unit tests for ExecutionTimer.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/core/ExecutionTimer.hpp"
+#include "sf/core/StateMachine.hpp"
+#include "sf/core/Task.hpp"
+#include "sf/pal/Clock.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Number of nanoseconds in a millisecond.
+///
+static constexpr U64 gNsInMs = (Clock::NS_IN_S / Clock::MS_IN_S);
+
+////////////////////////////////// Test Task ///////////////////////////////////
+
+///
+/// @brief Test task that busy-waits for a configurable time when stepped.
+///
+class SpinTask final : public ITask
+{
+public:
+
+    SpinTask() : ITask(nullptr), execNs(0)
+    {
+    }
+
+    U64 execNs;
+
+private:
+
+    Result initImpl() final override
+    {
+        return SUCCESS;
+    }
+
+    Result stepEnable() final override
+    {
+        Clock::spinWait(execNs);
+        return SUCCESS;
+    }
+};
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Unit tests for ExecutionTimer.
+///
+TEST_GROUP(ExecutionTimer)
+{
+    U64 cnt;
+    U64 minNs;
+    U64 maxNs;
+    U64 meanNs;
+    U64 misses;
+    U64 buckets[4];
+    Element<U64> elemCnt{cnt};
+    Element<U64> elemMinNs{minNs};
+    Element<U64> elemMaxNs{maxNs};
+    Element<U64> elemMeanNs{meanNs};
+    Element<U64> elemMisses{misses};
+    Element<U64> elemBucket0{buckets[0]};
+    Element<U64> elemBucket1{buckets[1]};
+    Element<U64> elemBucket2{buckets[2]};
+    Element<U64> elemBucket3{buckets[3]};
+    Element<U64>* elemBuckets[4];
+    ExecutionTimer::Config config;
+
+    void setup()
+    {
+        cnt = 0;
+        minNs = 0;
+        maxNs = 0;
+        meanNs = 0;
+        misses = 0;
+        for (U64& bucket : buckets)
+        {
+            bucket = 0;
+        }
+        elemBuckets[0] = &elemBucket0;
+        elemBuckets[1] = &elemBucket1;
+        elemBuckets[2] = &elemBucket2;
+        elemBuckets[3] = &elemBucket3;
+
+        // 4 buckets of 10 ns each and a 25 ns deadline.
+        config = {&elemCnt,
+                  &elemMinNs,
+                  &elemMaxNs,
+                  &elemMeanNs,
+                  &elemMisses,
+                  25,
+                  elemBuckets,
+                  4,
+                  10};
+    }
+};
+
+///
+/// @test Count, min, max, and mean are updated with each sample.
+///
+TEST(ExecutionTimer, Stats)
+{
+    ExecutionTimer timer;
+    CHECK_SUCCESS(ExecutionTimer::init(config, timer));
+
+    timer.record(20);
+    CHECK_EQUAL(1, cnt);
+    CHECK_EQUAL(20, minNs);
+    CHECK_EQUAL(20, maxNs);
+    CHECK_EQUAL(20, meanNs);
+
+    timer.record(10);
+    CHECK_EQUAL(2, cnt);
+    CHECK_EQUAL(10, minNs);
+    CHECK_EQUAL(20, maxNs);
+    CHECK_EQUAL(15, meanNs);
+
+    // Mean is rounded down.
+    timer.record(31);
+    CHECK_EQUAL(3, cnt);
+    CHECK_EQUAL(10, minNs);
+    CHECK_EQUAL(31, maxNs);
+    CHECK_EQUAL(20, meanNs);
+}
+
+///
+/// @test Samples longer than the deadline are counted as misses, and a sample
+/// equal to the deadline is not.
+///
+TEST(ExecutionTimer, DeadlineMisses)
+{
+    ExecutionTimer timer;
+    CHECK_SUCCESS(ExecutionTimer::init(config, timer));
+
+    timer.record(25);
+    CHECK_EQUAL(0, misses);
+    timer.record(26);
+    CHECK_EQUAL(1, misses);
+    timer.record(5);
+    CHECK_EQUAL(1, misses);
+    timer.record(1000);
+    CHECK_EQUAL(2, misses);
+}
+
+///
+/// @test No samples are counted as misses when there is no deadline.
+///
+TEST(ExecutionTimer, NoDeadline)
+{
+    config.deadlineNs = 0;
+    ExecutionTimer timer;
+    CHECK_SUCCESS(ExecutionTimer::init(config, timer));
+
+    timer.record(1000);
+    CHECK_EQUAL(0, misses);
+}
+
+///
+/// @test Samples are counted in the histogram bucket containing them, and
+/// samples past the last bucket are counted in the last bucket.
+///
+TEST(ExecutionTimer, Histogram)
+{
+    ExecutionTimer timer;
+    CHECK_SUCCESS(ExecutionTimer::init(config, timer));
+
+    timer.record(0);
+    timer.record(9);
+    timer.record(10);
+    timer.record(29);
+    timer.record(30);
+    timer.record(39);
+    timer.record(40);
+    timer.record(1000000);
+
+    CHECK_EQUAL(2, buckets[0]);
+    CHECK_EQUAL(1, buckets[1]);
+    CHECK_EQUAL(1, buckets[2]);
+    CHECK_EQUAL(4, buckets[3]);
+}
+
+///
+/// @test A timer with no elements and no histogram records without error.
+///
+TEST(ExecutionTimer, NoElements)
+{
+    ExecutionTimer timer;
+    CHECK_SUCCESS(ExecutionTimer::init(
+        {nullptr, nullptr, nullptr, nullptr, nullptr, 25, nullptr, 0, 0},
+        timer));
+    timer.record(10);
+    timer.record(100);
+}
+
+///
+/// @test Samples taken with start() and stop() measure the elapsed time.
+///
+TEST(ExecutionTimer, StartStop)
+{
+    ExecutionTimer timer;
+    CHECK_SUCCESS(ExecutionTimer::init(config, timer));
+
+    timer.start();
+    Clock::spinWait(gNsInMs);
+    timer.stop();
+    CHECK_EQUAL(1, cnt);
+    CHECK_TRUE(maxNs >= gNsInMs);
+}
+
+///
+/// @test An uninitialized timer does not record samples.
+///
+TEST(ExecutionTimer, Uninitialized)
+{
+    ExecutionTimer timer;
+    timer.record(10);
+    CHECK_SUCCESS(ExecutionTimer::init(config, timer));
+    timer.record(20);
+    CHECK_EQUAL(1, cnt);
+    CHECK_EQUAL(20, minNs);
+}
+
+///
+/// @test Initializing a timer twice fails.
+///
+TEST(ExecutionTimer, ErrorReinitialize)
+{
+    ExecutionTimer timer;
+    CHECK_SUCCESS(ExecutionTimer::init(config, timer));
+    CHECK_ERROR(E_ETM_REINIT, ExecutionTimer::init(config, timer));
+}
+
+///
+/// @test Initializing a timer with a null bucket array fails.
+///
+TEST(ExecutionTimer, ErrorHistogramNullBuckets)
+{
+    config.elemBuckets = nullptr;
+    ExecutionTimer timer;
+    CHECK_ERROR(E_ETM_HIST, ExecutionTimer::init(config, timer));
+
+    // Timer is still uninitialized.
+    timer.record(10);
+    CHECK_EQUAL(0, cnt);
+}
+
+///
+/// @test Initializing a timer with a null bucket element fails.
+///
+TEST(ExecutionTimer, ErrorHistogramNullBucket)
+{
+    elemBuckets[2] = nullptr;
+    ExecutionTimer timer;
+    CHECK_ERROR(E_ETM_HIST, ExecutionTimer::init(config, timer));
+}
+
+///
+/// @test Initializing a timer with a bucket width of 0 fails.
+///
+TEST(ExecutionTimer, ErrorHistogramZeroWidth)
+{
+    config.bucketWidthNs = 0;
+    ExecutionTimer timer;
+    CHECK_ERROR(E_ETM_HIST, ExecutionTimer::init(config, timer));
+}
+
+///
+/// @test Task and state machine steps are only timed when timing is enabled.
+///
+TEST(ExecutionTimer, TaskAndStateMachine)
+{
+    ExecutionTimer taskTimer;
+    CHECK_SUCCESS(ExecutionTimer::init(config, taskTimer));
+    SpinTask task;
+    task.execNs = gNsInMs;
+    task.setTimer(&taskTimer);
+    CHECK_SUCCESS(task.init());
+    CHECK_SUCCESS(task.step());
+
+    U32 state = 1;
+    U64 stateTime = 0;
+    U64 globalTime = 1;
+    Element<U32> elemState(state);
+    Element<U64> elemStateTime(stateTime);
+    Element<U64> elemGlobalTime(globalTime);
+    StateMachine::StateConfig states[] =
+    {
+        {1, nullptr, nullptr, nullptr},
+        {StateMachine::NO_STATE, nullptr, nullptr, nullptr}
+    };
+    U64 smCnt = 0;
+    Element<U64> elemSmCnt(smCnt);
+    ExecutionTimer smTimer;
+    CHECK_SUCCESS(ExecutionTimer::init(
+        {&elemSmCnt, nullptr, nullptr, nullptr, nullptr, 0, nullptr, 0, 0},
+        smTimer));
+    StateMachine sm;
+    CHECK_SUCCESS(StateMachine::init(
+        {&elemState, &elemStateTime, &elemGlobalTime, states, nullptr, nullptr},
+        sm));
+    sm.setTimer(&smTimer);
+    CHECK_SUCCESS(sm.step());
+
+#ifdef SF_ENABLE_TIMING
+    CHECK_EQUAL(1, cnt);
+    CHECK_TRUE(minNs >= gNsInMs);
+    CHECK_EQUAL(1, smCnt);
+#else
+    CHECK_EQUAL(0, cnt);
+    CHECK_EQUAL(0, smCnt);
+#endif
+}
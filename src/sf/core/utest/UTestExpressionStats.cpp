@@ -39,7 +39,7 @@ TEST(ExpressionStats, EmptyHistory)
 {
     ConstExprNode<I32> expr(0);
     I32 arrA[4];
-    I32 arrB[4];
+    U32 arrB[16];
     ExpressionStats<I32> stats(expr, arrA, arrB, 4);
     CHECK_EQUAL(0.0, stats.mean());
     CHECK_EQUAL(0.0, stats.median());
@@ -58,7 +58,7 @@ TEST(ExpressionStats, AllSameValue)
     Element<I32> elem(elemBacking);
     ElementExprNode<I32> expr(elem);
     I32 arrA[4];
-    I32 arrB[4];
+    U32 arrB[16];
     ExpressionStats<I32> stats(expr, arrA, arrB, 4);
 
     elem.write(10);
@@ -84,7 +84,7 @@ TEST(ExpressionStats, ZeroSize)
 {
     ConstExprNode<I32> expr(0);
     I32 arrA[4];
-    I32 arrB[4];
+    U32 arrB[16];
     ExpressionStats<I32> stats(expr, arrA, arrB, 0);
 
     stats.update();
@@ -106,7 +106,7 @@ TEST(ExpressionStats, NullHistoryArray)
     I32 elemBacking = 0;
     Element<I32> elem(elemBacking);
     ElementExprNode<I32> expr(elem);
-    I32 arrB[4];
+    U32 arrB[16];
     ExpressionStats<I32> stats(expr, nullptr, arrB, 4);
 
     elem.write(10);
@@ -166,7 +166,7 @@ TEST(ExpressionStats, Mean)
     Element<I32> elem(elemBacking);
     ElementExprNode<I32> expr(elem);
     I32 arrA[4];
-    I32 arrB[4];
+    U32 arrB[16];
     ExpressionStats<I32> stats(expr, arrA, arrB, 4);
 
     elem.write(1);
@@ -199,7 +199,7 @@ TEST(ExpressionStats, Median)
     Element<I32> elem(elemBacking);
     ElementExprNode<I32> expr(elem);
     I32 arrA[4];
-    I32 arrB[4];
+    U32 arrB[16];
     ExpressionStats<I32> stats(expr, arrA, arrB, 4);
 
     elem.write(1);
@@ -223,6 +223,127 @@ TEST(ExpressionStats, Median)
     CHECK_EQUAL(((-10.0 + 2.0) / (2.0)), stats.median());
 }
 
+///
+/// @test Rolling window median, min, and max match those of the sorted window
+/// over a long sequence of values with duplicates, for even and odd window
+/// sizes.
+///
+TEST(ExpressionStats, LongSequence)
+{
+    static constexpr U32 maxSize = 9;
+    I32 elemBacking = 0;
+    Element<I32> elem(elemBacking);
+    ElementExprNode<I32> expr(elem);
+
+    for (U32 size = 1; size <= maxSize; ++size)
+    {
+        I32 arrA[maxSize];
+        U32 arrB[4 * maxSize];
+        ExpressionStats<I32> stats(expr, arrA, arrB, size);
+        I32 window[maxSize];
+        U32 rng = 1;
+
+        for (U32 i = 0; i < 500; ++i)
+        {
+            // Update stats with a pseudorandom value in [-10, 10].
+            rng = ((rng * 1103515245) + 12345);
+            const I32 val = (static_cast<I32>((rng >> 16) % 21) - 10);
+            elem.write(val);
+            stats.update();
+
+            // Compute median, min, and max of window by sorting it.
+            window[i % size] = val;
+            const U32 cnt = (((i + 1) < size) ? (i + 1) : size);
+            I32 sorted[maxSize];
+            for (U32 j = 0; j < cnt; ++j)
+            {
+                sorted[j] = window[j];
+                for (U32 k = j; (k > 0) && (sorted[k] < sorted[k - 1]); --k)
+                {
+                    const I32 tmp = sorted[k];
+                    sorted[k] = sorted[k - 1];
+                    sorted[k - 1] = tmp;
+                }
+            }
+            const F64 expect =
+                (((cnt % 2) == 0)
+                 ? ((sorted[(cnt / 2) - 1] + sorted[cnt / 2]) / 2.0)
+                 : sorted[cnt / 2]);
+
+            CHECK_EQUAL(expect, stats.median());
+            CHECK_EQUAL(sorted[0], stats.min());
+            CHECK_EQUAL(sorted[cnt - 1], stats.max());
+            CHECK_EQUAL((sorted[cnt - 1] - sorted[0]), stats.range());
+        }
+    }
+}
+
+///
+/// @test Sampling values into the window instead of updating produces the same
+/// stats as updating, whether the next query follows a sample or an update.
+///
+TEST(ExpressionStats, Sample)
+{
+    static constexpr U32 size = 5;
+    I32 elemBacking = 0;
+    Element<I32> elem(elemBacking);
+    ElementExprNode<I32> expr(elem);
+    I32 arrA[size];
+    U32 arrB[4 * size];
+    ExpressionStats<I32> stats(expr, arrA, arrB, size);
+    I32 window[size];
+    U32 rng = 1;
+
+    for (U32 i = 0; i < 200; ++i)
+    {
+        // Sample or update stats with a pseudorandom value in [-10, 10].
+        rng = ((rng * 1103515245) + 12345);
+        const I32 val = (static_cast<I32>((rng >> 16) % 21) - 10);
+        elem.write(val);
+        if ((i % 7) < 4)
+        {
+            stats.sample();
+        }
+        else
+        {
+            stats.update();
+        }
+
+        // Only query stats some of the time so that several samples may
+        // accumulate between queries.
+        window[i % size] = val;
+        if ((i % 3) != 0)
+        {
+            continue;
+        }
+
+        // Compute mean, median, min, and max of window by sorting it.
+        const U32 cnt = (((i + 1) < size) ? (i + 1) : size);
+        I32 sorted[size];
+        F64 sum = 0.0;
+        for (U32 j = 0; j < cnt; ++j)
+        {
+            sum += window[j];
+            sorted[j] = window[j];
+            for (U32 k = j; (k > 0) && (sorted[k] < sorted[k - 1]); --k)
+            {
+                const I32 tmp = sorted[k];
+                sorted[k] = sorted[k - 1];
+                sorted[k - 1] = tmp;
+            }
+        }
+        const F64 expect =
+            (((cnt % 2) == 0)
+             ? ((sorted[(cnt / 2) - 1] + sorted[cnt / 2]) / 2.0)
+             : sorted[cnt / 2]);
+
+        CHECK_EQUAL((sum / cnt), stats.mean());
+        CHECK_EQUAL(expect, stats.median());
+        CHECK_EQUAL(sorted[0], stats.min());
+        CHECK_EQUAL(sorted[cnt - 1], stats.max());
+    }
+}
+
 ///
 /// @test Rolling window min is computed correctly.
 ///
@@ -232,7 +353,7 @@ TEST(ExpressionStats, Min)
     Element<I32> elem(elemBacking);
     ElementExprNode<I32> expr(elem);
     I32 arrA[4];
-    I32 arrB[4];
+    U32 arrB[16];
     ExpressionStats<I32> stats(expr, arrA, arrB, 4);
 
     elem.write(1);
@@ -277,7 +398,7 @@ TEST(ExpressionStats, Max)
     Element<I32> elem(elemBacking);
     ElementExprNode<I32> expr(elem);
     I32 arrA[4];
-    I32 arrB[4];
+    U32 arrB[16];
     ExpressionStats<I32> stats(expr, arrA, arrB, 4);
 
     elem.write(1);
@@ -322,7 +443,7 @@ TEST(ExpressionStats, Range)
     Element<I32> elem(elemBacking);
     ElementExprNode<I32> expr(elem);
     I32 arrA[4];
-    I32 arrB[4];
+    U32 arrB[16];
     ExpressionStats<I32> stats(expr, arrA, arrB, 4);
 
     elem.write(1);
@@ -367,7 +488,7 @@ TEST(ExpressionStats, NaNBecomesZero)
     Element<F64> elem(elemBacking);
     ElementExprNode<F64> expr(elem);
     F64 arrA[4];
-    F64 arrB[4];
+    U32 arrB[16];
     ExpressionStats<F64> stats(expr, arrA, arrB, 4);
 
     // Make the rolling window look like [NaN, 1, NaN].
@@ -0,0 +1,729 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/utest/UTestExpressionVm.cpp
+/// @brief Unit tests for ExpressionVm.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/core/ExpressionVm.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Creates an I64 constant push instruction.
+///
+/// @param[in] kVal  Constant to push.
+///
+/// @returns Instruction.
+///
+static ExpressionVm::Instruction pushI(const I64 kVal)
+{
+    ExpressionVm::Instruction instr;
+    instr.op = ExpressionVm::PUSH_I;
+    instr.val.i64 = kVal;
+    return instr;
+}
+
+///
+/// @brief Creates an F64 constant push instruction.
+///
+/// @param[in] kVal  Constant to push.
+///
+/// @returns Instruction.
+///
+static ExpressionVm::Instruction pushF(const F64 kVal)
+{
+    ExpressionVm::Instruction instr;
+    instr.op = ExpressionVm::PUSH_F;
+    instr.val.f64 = kVal;
+    return instr;
+}
+
+///
+/// @brief Creates an element load instruction.
+///
+/// @param[in] kElem  Element to load.
+///
+/// @returns Instruction.
+///
+static ExpressionVm::Instruction load(const IElement& kElem)
+{
+    ExpressionVm::Instruction instr;
+    instr.op = static_cast<ExpressionVm::Opcode>(kElem.type());
+    instr.elem = &kElem;
+    return instr;
+}
+
+///
+/// @brief Creates a stats read instruction.
+///
+/// @param[in] kOp     Stats opcode.
+/// @param[in] kStats  Stats to read.
+///
+/// @returns Instruction.
+///
+static ExpressionVm::Instruction stat(const ExpressionVm::Opcode kOp,
+                                      IExpressionStats& kStats)
+{
+    ExpressionVm::Instruction instr;
+    instr.op = kOp;
+    instr.stats = &kStats;
+    return instr;
+}
+
+///
+/// @brief Creates an operator instruction.
+///
+/// @param[in] kOp  Operator opcode.
+///
+/// @returns Instruction.
+///
+static ExpressionVm::Instruction op(const ExpressionVm::Opcode kOp)
+{
+    ExpressionVm::Instruction instr;
+    instr.op = kOp;
+    return instr;
+}
+
+///
+/// @brief Initializes a VM with a program and checks that it evaluates to an
+/// expected I64 value.
+///
+/// @param[in] kInstrs     Program.
+/// @param[in] kInstrCnt   Number of instructions in program.
+/// @param[in] kExpectVal  Expected value.
+///
+static void checkRunI(const ExpressionVm::Instruction* const kInstrs,
+                      const U32 kInstrCnt,
+                      const I64 kExpectVal)
+{
+    ExpressionVm::Value stack[16];
+    ExpressionVm vm;
+    CHECK_SUCCESS(ExpressionVm::init({kInstrs, kInstrCnt, stack, 16}, vm));
+    CHECK_EQUAL(ElementType::INT64, vm.resultType());
+    CHECK_EQUAL(kExpectVal, vm.run().i64);
+}
+
+///
+/// @brief Initializes a VM with a program and checks that it evaluates to an
+/// expected F64 value.
+///
+/// @param[in] kInstrs     Program.
+/// @param[in] kInstrCnt   Number of instructions in program.
+/// @param[in] kExpectVal  Expected value.
+///
+static void checkRunF(const ExpressionVm::Instruction* const kInstrs,
+                      const U32 kInstrCnt,
+                      const F64 kExpectVal)
+{
+    ExpressionVm::Value stack[16];
+    ExpressionVm vm;
+    CHECK_SUCCESS(ExpressionVm::init({kInstrs, kInstrCnt, stack, 16}, vm));
+    CHECK_EQUAL(ElementType::FLOAT64, vm.resultType());
+    CHECK_EQUAL(kExpectVal, vm.run().f64);
+}
+
+///
+/// @brief Runs an I64 binary operator on two constants and checks the result.
+///
+/// @param[in] kOp         Operator opcode.
+/// @param[in] kLhs        LHS operand.
+/// @param[in] kRhs        RHS operand.
+/// @param[in] kExpectVal  Expected value.
+///
+static void checkBinOpI(const ExpressionVm::Opcode kOp,
+                        const I64 kLhs,
+                        const I64 kRhs,
+                        const I64 kExpectVal)
+{
+    const ExpressionVm::Instruction instrs[] =
+        {pushI(kRhs), pushI(kLhs), op(kOp)};
+    checkRunI(instrs, 3, kExpectVal);
+}
+
+///
+/// @brief Runs an F64 binary operator on two constants and checks the result.
+///
+/// @param[in] kOp         Operator opcode.
+/// @param[in] kLhs        LHS operand.
+/// @param[in] kRhs        RHS operand.
+/// @param[in] kExpectVal  Expected value.
+///
+static void checkBinOpF(const ExpressionVm::Opcode kOp,
+                        const F64 kLhs,
+                        const F64 kRhs,
+                        const F64 kExpectVal)
+{
+    const ExpressionVm::Instruction instrs[] =
+        {pushF(kRhs), pushF(kLhs), op(kOp)};
+    checkRunF(instrs, 3, kExpectVal);
+}
+
+///////////////////////////// Correct Usage Tests //////////////////////////////
+
+///
+/// @brief Unit tests for ExpressionVm.
+///
+TEST_GROUP(ExpressionVm)
+{
+};
+
+///
+/// @test A program that pushes a constant evaluates to that constant.
+///
+TEST(ExpressionVm, Push)
+{
+    const ExpressionVm::Instruction instrsI[] = {pushI(-3)};
+    checkRunI(instrsI, 1, -3);
+    const ExpressionVm::Instruction instrsF[] = {pushF(3.5)};
+    checkRunF(instrsF, 1, 3.5);
+}
+
+///
+/// @test U64 and floating elements are loaded as F64, and all other elements
+/// are loaded as I64.
+///
+TEST(ExpressionVm, LoadAllElementTypes)
+{
+    I8 a = -1;
+    I16 b = -2;
+    I32 c = -3;
+    I64 d = -4;
+    U8 e = 5;
+    U16 f = 6;
+    U32 g = 7;
+    U64 h = 8;
+    F32 i = 9.5f;
+    F64 j = 10.5;
+    bool k = true;
+    Element<I8> elemA(a);
+    Element<I16> elemB(b);
+    Element<I32> elemC(c);
+    Element<I64> elemD(d);
+    Element<U8> elemE(e);
+    Element<U16> elemF(f);
+    Element<U32> elemG(g);
+    Element<U64> elemH(h);
+    Element<F32> elemI(i);
+    Element<F64> elemJ(j);
+    Element<bool> elemK(k);
+
+    const ExpressionVm::Instruction instrsA[] = {load(elemA)};
+    checkRunI(instrsA, 1, -1);
+    const ExpressionVm::Instruction instrsB[] = {load(elemB)};
+    checkRunI(instrsB, 1, -2);
+    const ExpressionVm::Instruction instrsC[] = {load(elemC)};
+    checkRunI(instrsC, 1, -3);
+    const ExpressionVm::Instruction instrsD[] = {load(elemD)};
+    checkRunI(instrsD, 1, -4);
+    const ExpressionVm::Instruction instrsE[] = {load(elemE)};
+    checkRunI(instrsE, 1, 5);
+    const ExpressionVm::Instruction instrsF[] = {load(elemF)};
+    checkRunI(instrsF, 1, 6);
+    const ExpressionVm::Instruction instrsG[] = {load(elemG)};
+    checkRunI(instrsG, 1, 7);
+    const ExpressionVm::Instruction instrsH[] = {load(elemH)};
+    checkRunF(instrsH, 1, 8.0);
+    const ExpressionVm::Instruction instrsI[] = {load(elemI)};
+    checkRunF(instrsI, 1, 9.5);
+    const ExpressionVm::Instruction instrsJ[] = {load(elemJ)};
+    checkRunF(instrsJ, 1, 10.5);
+    const ExpressionVm::Instruction instrsK[] = {load(elemK)};
+    checkRunI(instrsK, 1, 1);
+}
+
+///
+/// @test I64 elements are loaded exactly, and U64 elements above the I64
+/// maximum are loaded as F64 without saturating.
+///
+TEST(ExpressionVm, Load64BitIntegers)
+{
+    I64 d = ((1LL << 53) + 1);
+    U64 h = Limits::max<U64>();
+    Element<I64> elemD(d);
+    Element<U64> elemH(h);
+
+    const ExpressionVm::Instruction instrsD[] = {load(elemD)};
+    checkRunI(instrsD, 1, ((1LL << 53) + 1));
+    const ExpressionVm::Instruction instrsH[] = {load(elemH)};
+    checkRunF(instrsH, 1, 18446744073709551616.0);
+    elemH.write(1ULL << 63);
+    checkRunF(instrsH, 1, 9223372036854775808.0);
+}
+
+///
+/// @test U64 elements above the I64 maximum compare correctly with each other
+/// and with F64 values.
+///
+TEST(ExpressionVm, CompareLargeU64)
+{
+    U64 a = (1ULL << 63);
+    U64 b = Limits::max<U64>();
+    Element<U64> elemA(a);
+    Element<U64> elemB(b);
+
+    // `a == b`
+    const ExpressionVm::Instruction instrsEq[] =
+        {load(elemB), load(elemA), op(ExpressionVm::EQ_F)};
+    checkRunF(instrsEq, 3, 0.0);
+
+    // `a < b`
+    const ExpressionVm::Instruction instrsLt[] =
+        {load(elemB), load(elemA), op(ExpressionVm::LT_F)};
+    checkRunF(instrsLt, 3, 1.0);
+
+    // `b > 1e19`
+    const ExpressionVm::Instruction instrsGt[] =
+        {pushF(1e19), load(elemB), op(ExpressionVm::GT_F)};
+    checkRunF(instrsGt, 3, 1.0);
+
+    // `a > 1`
+    const ExpressionVm::Instruction instrsMixed[] =
+        {pushI(1), load(elemA), op(ExpressionVm::I2F_RHS),
+         op(ExpressionVm::GT_F)};
+    checkRunF(instrsMixed, 4, 1.0);
+}
+
+///
+/// @test Loading a NaN floating element pushes 0.
+///
+TEST(ExpressionVm, LoadNaN)
+{
+    F32 i = (0.0f / 0.0f);
+    F64 j = (0.0 / 0.0);
+    Element<F32> elemI(i);
+    Element<F64> elemJ(j);
+
+    const ExpressionVm::Instruction instrsI[] = {load(elemI)};
+    checkRunF(instrsI, 1, 0.0);
+    const ExpressionVm::Instruction instrsJ[] = {load(elemJ)};
+    checkRunF(instrsJ, 1, 0.0);
+}
+
+///
+/// @test Element loads read the element each time the program runs.
+///
+TEST(ExpressionVm, LoadUpdatedElement)
+{
+    I32 a = 1;
+    Element<I32> elemA(a);
+    const ExpressionVm::Instruction instrs[] =
+        {pushI(2), load(elemA), op(ExpressionVm::MULT_I)};
+    ExpressionVm::Value stack[2];
+    ExpressionVm vm;
+    CHECK_SUCCESS(ExpressionVm::init({instrs, 3, stack, 2}, vm));
+    CHECK_EQUAL(2, vm.run().i64);
+    elemA.write(-4);
+    CHECK_EQUAL(-8, vm.run().i64);
+}
+
+///
+/// @test Stats reads push the corresponding stat as F64.
+///
+TEST(ExpressionVm, Stats)
+{
+    I32 a = 0;
+    Element<I32> elemA(a);
+    ElementExprNode<I32> nodeA(elemA);
+    I32 arrA[3];
+    U32 arrB[12];
+    ExpressionStats<I32> stats(nodeA, arrA, arrB, 3);
+    const I32 vals[] = {4, -2, 10};
+    for (const I32 val : vals)
+    {
+        elemA.write(val);
+        stats.update();
+    }
+
+    const ExpressionVm::Instruction instrsAvg[] =
+        {stat(ExpressionVm::ROLL_AVG, stats)};
+    checkRunF(instrsAvg, 1, 4.0);
+    const ExpressionVm::Instruction instrsMedian[] =
+        {stat(ExpressionVm::ROLL_MEDIAN, stats)};
+    checkRunF(instrsMedian, 1, 4.0);
+    const ExpressionVm::Instruction instrsMin[] =
+        {stat(ExpressionVm::ROLL_MIN, stats)};
+    checkRunF(instrsMin, 1, -2.0);
+    const ExpressionVm::Instruction instrsMax[] =
+        {stat(ExpressionVm::ROLL_MAX, stats)};
+    checkRunF(instrsMax, 1, 10.0);
+    const ExpressionVm::Instruction instrsRange[] =
+        {stat(ExpressionVm::ROLL_RANGE, stats)};
+    checkRunF(instrsRange, 1, 12.0);
+}
+
+///
+/// @test I64 operands are converted to F64.
+///
+TEST(ExpressionVm, Convert)
+{
+    // 3 + 0.5
+    const ExpressionVm::Instruction instrsLhs[] =
+        {pushF(0.5), pushI(3), op(ExpressionVm::I2F_LHS),
+         op(ExpressionVm::ADD_F)};
+    checkRunF(instrsLhs, 4, 3.5);
+
+    // 0.5 - 3
+    const ExpressionVm::Instruction instrsRhs[] =
+        {pushI(3), pushF(0.5), op(ExpressionVm::I2F_RHS),
+         op(ExpressionVm::SUB_F)};
+    checkRunF(instrsRhs, 4, -2.5);
+}
+
+///
+/// @test Logical NOT operator.
+///
+TEST(ExpressionVm, Not)
+{
+    const ExpressionVm::Instruction instrsFalseI[] =
+        {pushI(0), op(ExpressionVm::NOT_I)};
+    checkRunI(instrsFalseI, 2, 1);
+    const ExpressionVm::Instruction instrsTrueI[] =
+        {pushI(-2), op(ExpressionVm::NOT_I)};
+    checkRunI(instrsTrueI, 2, 0);
+    const ExpressionVm::Instruction instrsFalseF[] =
+        {pushF(0.0), op(ExpressionVm::NOT_F)};
+    checkRunF(instrsFalseF, 2, 1.0);
+    const ExpressionVm::Instruction instrsTrueF[] =
+        {pushF(-2.5), op(ExpressionVm::NOT_F)};
+    checkRunF(instrsTrueF, 2, 0.0);
+}
+
+///
+/// @test Arithmetic operators take their LHS from the top of the stack.
+///
+TEST(ExpressionVm, Arithmetic)
+{
+    checkBinOpI(ExpressionVm::MULT_I, 3, -2, -6);
+    checkBinOpI(ExpressionVm::ADD_I, 1, 2, 3);
+    checkBinOpI(ExpressionVm::SUB_I, 10, 4, 6);
+    checkBinOpF(ExpressionVm::MULT_F, 3.0, -2.0, -6.0);
+    checkBinOpF(ExpressionVm::DIV_F, 10.0, 4.0, 2.5);
+    checkBinOpF(ExpressionVm::ADD_F, 1.5, 2.0, 3.5);
+    checkBinOpF(ExpressionVm::SUB_F, 10.0, 4.0, 6.0);
+}
+
+///
+/// @test I64 arithmetic saturates at the I64 limits.
+///
+TEST(ExpressionVm, ArithmeticSaturation)
+{
+    const I64 max = Limits::max<I64>();
+    const I64 min = Limits::min<I64>();
+    checkBinOpI(ExpressionVm::ADD_I, max, 1, max);
+    checkBinOpI(ExpressionVm::ADD_I, min, -1, min);
+    checkBinOpI(ExpressionVm::SUB_I, min, 1, min);
+    checkBinOpI(ExpressionVm::SUB_I, max, -1, max);
+    checkBinOpI(ExpressionVm::MULT_I, max, 2, max);
+    checkBinOpI(ExpressionVm::MULT_I, min, -1, max);
+    checkBinOpI(ExpressionVm::MULT_I, max, -2, min);
+    checkBinOpI(ExpressionVm::MULT_I, -2, max, min);
+}
+
+///
+/// @test Relational operators take their LHS from the top of the stack.
+///
+TEST(ExpressionVm, Relational)
+{
+    checkBinOpI(ExpressionVm::LT_I, 1, 2, 1);
+    checkBinOpI(ExpressionVm::LT_I, 2, 2, 0);
+    checkBinOpI(ExpressionVm::LTE_I, 2, 2, 1);
+    checkBinOpI(ExpressionVm::LTE_I, 3, 2, 0);
+    checkBinOpI(ExpressionVm::GT_I, 2, 1, 1);
+    checkBinOpI(ExpressionVm::GT_I, 2, 2, 0);
+    checkBinOpI(ExpressionVm::GTE_I, 2, 2, 1);
+    checkBinOpI(ExpressionVm::GTE_I, 1, 2, 0);
+    checkBinOpI(ExpressionVm::EQ_I, 2, 2, 1);
+    checkBinOpI(ExpressionVm::EQ_I, 1, 2, 0);
+    checkBinOpI(ExpressionVm::NEQ_I, 1, 2, 1);
+    checkBinOpI(ExpressionVm::NEQ_I, 2, 2, 0);
+    checkBinOpF(ExpressionVm::LT_F, 1.0, 2.0, 1.0);
+    checkBinOpF(ExpressionVm::LT_F, 2.0, 2.0, 0.0);
+    checkBinOpF(ExpressionVm::LTE_F, 2.0, 2.0, 1.0);
+    checkBinOpF(ExpressionVm::LTE_F, 3.0, 2.0, 0.0);
+    checkBinOpF(ExpressionVm::GT_F, 2.0, 1.0, 1.0);
+    checkBinOpF(ExpressionVm::GT_F, 2.0, 2.0, 0.0);
+    checkBinOpF(ExpressionVm::GTE_F, 2.0, 2.0, 1.0);
+    checkBinOpF(ExpressionVm::GTE_F, 1.0, 2.0, 0.0);
+    checkBinOpF(ExpressionVm::EQ_F, 2.0, 2.0, 1.0);
+    checkBinOpF(ExpressionVm::EQ_F, 1.0, 2.0, 0.0);
+    checkBinOpF(ExpressionVm::NEQ_F, 1.0, 2.0, 1.0);
+    checkBinOpF(ExpressionVm::NEQ_F, 2.0, 2.0, 0.0);
+
+    // I64 comparisons are exact for integers that F64 cannot represent.
+    const I64 big = (1LL << 53);
+    checkBinOpI(ExpressionVm::GT_I, (big + 1), big, 1);
+    checkBinOpI(ExpressionVm::EQ_I, (big + 1), big, 0);
+}
+
+///
+/// @test Logical operators.
+///
+TEST(ExpressionVm, Logical)
+{
+    checkBinOpI(ExpressionVm::AND_I, 1, 2, 1);
+    checkBinOpI(ExpressionVm::AND_I, 1, 0, 0);
+    checkBinOpI(ExpressionVm::AND_I, 0, 0, 0);
+    checkBinOpI(ExpressionVm::OR_I, 0, 3, 1);
+    checkBinOpI(ExpressionVm::OR_I, 0, 0, 0);
+    checkBinOpF(ExpressionVm::AND_F, 1.0, 2.0, 1.0);
+    checkBinOpF(ExpressionVm::AND_F, 1.0, 0.0, 0.0);
+    checkBinOpF(ExpressionVm::AND_F, 0.0, 0.0, 0.0);
+    checkBinOpF(ExpressionVm::OR_F, 0.0, 3.0, 1.0);
+    checkBinOpF(ExpressionVm::OR_F, 0.0, 0.0, 0.0);
+}
+
+///
+/// @test A program that nests operators evaluates correctly.
+///
+/// (1 + 2) * (10 - 4) < 20.5 or not false
+///
+TEST(ExpressionVm, NestedOperators)
+{
+    const ExpressionVm::Instruction instrs[] =
+    {
+        pushI(0),
+        op(ExpressionVm::NOT_I),
+        pushF(20.5),
+        pushI(4),
+        pushI(10),
+        op(ExpressionVm::SUB_I),
+        pushI(2),
+        pushI(1),
+        op(ExpressionVm::ADD_I),
+        op(ExpressionVm::MULT_I),
+        op(ExpressionVm::I2F_LHS),
+        op(ExpressionVm::LT_F),
+        op(ExpressionVm::I2F_RHS),
+        op(ExpressionVm::OR_F)
+    };
+    checkRunF(instrs, 14, 1.0);
+}
+
+///
+/// @test An uninitialized VM evaluates to 0.
+///
+TEST(ExpressionVm, Uninitialized)
+{
+    ExpressionVm vm;
+    CHECK_EQUAL(0, vm.run().i64);
+    CHECK_EQUAL(ElementType::NONE, vm.resultType());
+}
+
+///
+/// @test BytecodeExprNode safe-casts the VM result to its evaluation type.
+///
+TEST(ExpressionVm, BytecodeExprNode)
+{
+    ExpressionVm::Value stack[1];
+    ConstExprNode<F64> src(300.0);
+
+    // I64 result.
+    const ExpressionVm::Instruction instrsI[] = {pushI(300)};
+    ExpressionVm vmI;
+    CHECK_SUCCESS(ExpressionVm::init({instrsI, 1, stack, 1}, vmI));
+    BytecodeExprNode<I8> nodeI8(vmI, &src);
+    CHECK_EQUAL(127, nodeI8.evaluate());
+    CHECK_EQUAL(IExpression::BYTECODE, nodeI8.nodeType());
+    CHECK_EQUAL(ElementType::INT8, nodeI8.type());
+    POINTERS_EQUAL(&src, nodeI8.src());
+    BytecodeExprNode<bool> nodeBool(vmI, nullptr);
+    CHECK_EQUAL(true, nodeBool.evaluate());
+    POINTERS_EQUAL(nullptr, nodeBool.src());
+
+    // F64 result.
+    const ExpressionVm::Instruction instrsF[] = {pushF(-300.5)};
+    ExpressionVm vmF;
+    CHECK_SUCCESS(ExpressionVm::init({instrsF, 1, stack, 1}, vmF));
+    BytecodeExprNode<I8> nodeI8F(vmF, &src);
+    CHECK_EQUAL(-128, nodeI8F.evaluate());
+    BytecodeExprNode<F64> nodeF64(vmF, &src);
+    CHECK_EQUAL(-300.5, nodeF64.evaluate());
+}
+
+///////////////////////////////// Error Tests //////////////////////////////////
+
+///
+/// @brief Unit tests for ExpressionVm errors.
+///
+TEST_GROUP(ExpressionVmErrors)
+{
+};
+
+///
+/// @test Initializing a VM twice returns an error.
+///
+TEST(ExpressionVmErrors, Reinitialize)
+{
+    const ExpressionVm::Instruction instrs[] = {pushI(1)};
+    ExpressionVm::Value stack[1];
+    ExpressionVm vm;
+    CHECK_SUCCESS(ExpressionVm::init({instrs, 1, stack, 1}, vm));
+    CHECK_ERROR(E_EVM_REINIT, ExpressionVm::init({instrs, 1, stack, 1}, vm));
+}
+
+///
+/// @test Initializing a VM with null pointers returns an error.
+///
+TEST(ExpressionVmErrors, Null)
+{
+    const ExpressionVm::Instruction instrs[] = {pushI(1)};
+    ExpressionVm::Value stack[1];
+    ExpressionVm vm;
+    CHECK_ERROR(E_EVM_NULL, ExpressionVm::init({nullptr, 1, stack, 1}, vm));
+    CHECK_ERROR(E_EVM_NULL, ExpressionVm::init({instrs, 1, nullptr, 1}, vm));
+
+    ExpressionVm::Instruction instrsNullElem[] = {pushI(1)};
+    instrsNullElem[0].op = ExpressionVm::LOAD_I32;
+    instrsNullElem[0].elem = nullptr;
+    CHECK_ERROR(E_EVM_NULL,
+                ExpressionVm::init({instrsNullElem, 1, stack, 1}, vm));
+
+    ExpressionVm::Instruction instrsNullStats[] = {pushI(1)};
+    instrsNullStats[0].op = ExpressionVm::ROLL_AVG;
+    instrsNullStats[0].stats = nullptr;
+    CHECK_ERROR(E_EVM_NULL,
+                ExpressionVm::init({instrsNullStats, 1, stack, 1}, vm));
+
+    // VM is still uninitialized.
+    CHECK_EQUAL(0, vm.run().i64);
+}
+
+///
+/// @test Initializing a VM with an invalid opcode returns an error.
+///
+TEST(ExpressionVmErrors, InvalidOpcode)
+{
+    ExpressionVm::Instruction instrs[] = {pushI(1)};
+    instrs[0].op = ExpressionVm::OPCODE_CNT;
+    ExpressionVm::Value stack[1];
+    ExpressionVm vm;
+    CHECK_ERROR(E_EVM_OP, ExpressionVm::init({instrs, 1, stack, 1}, vm));
+}
+
+///
+/// @test Initializing a VM with a load of the wrong element type returns an
+/// error.
+///
+TEST(ExpressionVmErrors, ElementType)
+{
+    I32 a = 0;
+    Element<I32> elemA(a);
+    ExpressionVm::Instruction instrs[] = {load(elemA)};
+    instrs[0].op = ExpressionVm::LOAD_U32;
+    ExpressionVm::Value stack[1];
+    ExpressionVm vm;
+    CHECK_ERROR(E_EVM_TYPE, ExpressionVm::init({instrs, 1, stack, 1}, vm));
+}
+
+///
+/// @test Initializing a VM with an instruction that operates on a value of the
+/// wrong domain returns an error.
+///
+TEST(ExpressionVmErrors, Domain)
+{
+    ExpressionVm::Value stack[2];
+    ExpressionVm vm;
+
+    // I64 operator on F64 operands.
+    const ExpressionVm::Instruction instrsAddI[] =
+        {pushF(1.0), pushF(1.0), op(ExpressionVm::ADD_I)};
+    CHECK_ERROR(E_EVM_TYPE,
+                ExpressionVm::init({instrsAddI, 3, stack, 2}, vm));
+
+    // F64 operator with one I64 operand.
+    const ExpressionVm::Instruction instrsAddF[] =
+        {pushI(1), pushF(1.0), op(ExpressionVm::ADD_F)};
+    CHECK_ERROR(E_EVM_TYPE,
+                ExpressionVm::init({instrsAddF, 3, stack, 2}, vm));
+
+    // F64 unary operator on I64 operand.
+    const ExpressionVm::Instruction instrsNotF[] =
+        {pushI(1), op(ExpressionVm::NOT_F)};
+    CHECK_ERROR(E_EVM_TYPE,
+                ExpressionVm::init({instrsNotF, 2, stack, 2}, vm));
+
+    // Division of I64 operands.
+    const ExpressionVm::Instruction instrsDiv[] =
+        {pushI(1), pushI(1), op(ExpressionVm::DIV_F)};
+    CHECK_ERROR(E_EVM_TYPE,
+                ExpressionVm::init({instrsDiv, 3, stack, 2}, vm));
+
+    // Conversions of F64 values.
+    const ExpressionVm::Instruction instrsLhs[] =
+        {pushF(1.0), op(ExpressionVm::I2F_LHS)};
+    CHECK_ERROR(E_EVM_TYPE,
+                ExpressionVm::init({instrsLhs, 2, stack, 2}, vm));
+    const ExpressionVm::Instruction instrsRhs[] =
+        {pushF(1.0), pushI(1), op(ExpressionVm::I2F_RHS)};
+    CHECK_ERROR(E_EVM_TYPE,
+                ExpressionVm::init({instrsRhs, 3, stack, 2}, vm));
+
+    // VM is still uninitialized.
+    CHECK_EQUAL(ElementType::NONE, vm.resultType());
+}
+
+///
+/// @test Initializing a VM with a program that misuses the stack returns an
+/// error.
+///
+TEST(ExpressionVmErrors, Stack)
+{
+    ExpressionVm::Value stack[2];
+    ExpressionVm vm;
+
+    // Empty program.
+    const ExpressionVm::Instruction instrsEmpty[] = {pushI(1)};
+    CHECK_ERROR(E_EVM_STACK,
+                ExpressionVm::init({instrsEmpty, 0, stack, 2}, vm));
+
+    // Unary operator underflow.
+    const ExpressionVm::Instruction instrsUnary[] = {op(ExpressionVm::NOT_I)};
+    CHECK_ERROR(E_EVM_STACK,
+                ExpressionVm::init({instrsUnary, 1, stack, 2}, vm));
+
+    // Binary operator underflow.
+    const ExpressionVm::Instruction instrsBin[] =
+        {pushI(1), op(ExpressionVm::ADD_I)};
+    CHECK_ERROR(E_EVM_STACK,
+                ExpressionVm::init({instrsBin, 2, stack, 2}, vm));
+
+    // RHS conversion underflow.
+    const ExpressionVm::Instruction instrsRhs[] =
+        {pushI(1), op(ExpressionVm::I2F_RHS)};
+    CHECK_ERROR(E_EVM_STACK,
+                ExpressionVm::init({instrsRhs, 2, stack, 2}, vm));
+
+    // Overflow.
+    const ExpressionVm::Instruction instrsOvfl[] =
+        {pushI(1), pushI(1), pushI(1), op(ExpressionVm::ADD_I),
+         op(ExpressionVm::ADD_I)};
+    CHECK_ERROR(E_EVM_STACK,
+                ExpressionVm::init({instrsOvfl, 5, stack, 2}, vm));
+
+    // More than one value left on the stack.
+    const ExpressionVm::Instruction instrsLeft[] = {pushI(1), pushI(1)};
+    CHECK_ERROR(E_EVM_STACK,
+                ExpressionVm::init({instrsLeft, 2, stack, 2}, vm));
+
+    // VM is still uninitialized.
+    CHECK_EQUAL(0, vm.run().i64);
+}
@@ -98,6 +98,48 @@ TEST(MemOps, MemcpyMultipleBytes)
     CHECK_EQUAL(src, dest);
 }
 
+///
+/// @test MemOps::memcpy() correctly copies every length up to several words
+/// and vectors, for every combination of source and destination alignment,
+/// without writing outside the destination.
+///
+TEST(MemOps, MemcpyAllAlignments)
+{
+    U8 src[128];
+    U8 dest[128];
+    for (U32 i = 0; i < sizeof(src); ++i)
+    {
+        src[i] = static_cast<U8>((i * 7) + 1);
+    }
+
+    for (U32 srcOff = 0; srcOff < 16; ++srcOff)
+    {
+        for (U32 destOff = 0; destOff < 16; ++destOff)
+        {
+            for (U32 bytes = 0; bytes <= 80; ++bytes)
+            {
+                for (U32 i = 0; i < sizeof(dest); ++i)
+                {
+                    dest[i] = 0xAA;
+                }
+
+                POINTERS_EQUAL(&dest[destOff],
+                               MemOps::memcpy(&dest[destOff],
+                                              &src[srcOff],
+                                              bytes));
+
+                for (U32 i = 0; i < sizeof(dest); ++i)
+                {
+                    const bool copied =
+                        ((i >= destOff) && (i < (destOff + bytes)));
+                    CHECK_EQUAL((copied ? src[(i - destOff) + srcOff] : 0xAA),
+                                dest[i]);
+                }
+            }
+        }
+    }
+}
+
 ///
 /// @test MemOps::memcpy() does nothing when the destination pointer is null.
 ///
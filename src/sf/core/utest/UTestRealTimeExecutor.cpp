@@ -0,0 +1,350 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/utest/UTestRealTimeExecutor.cpp
+/// @brief Unit tests for RealTimeExecutor.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/core/RealTimeExecutor.hpp"
+#include "sf/pal/Clock.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Number of nanoseconds in a millisecond.
+///
+static constexpr U64 gNsInMs = (Clock::NS_IN_S / Clock::MS_IN_S);
+
+///
+/// @brief Priority of the fastest tasks in tests.
+///
+static constexpr I32 gMaxPri = 50;
+
+////////////////////////////////// Test Task ///////////////////////////////////
+
+///
+/// @brief Test task that counts its steps and returns a configurable result.
+///
+class CountTask final : public ITask
+{
+public:
+
+    CountTask() : ITask(nullptr), stepRes(SUCCESS), steps(0)
+    {
+    }
+
+    Result stepRes;
+
+    U32 steps;
+
+private:
+
+    Result initImpl() final override
+    {
+        return SUCCESS;
+    }
+
+    Result stepEnable() final override
+    {
+        ++steps;
+        return stepRes;
+    }
+};
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Unit tests for RealTimeExecutor.
+///
+TEST_GROUP(RealTimeExecutor)
+{
+};
+
+///
+/// @test Tasks are partitioned first-fit in rate-monotonic order under the
+/// hyperbolic bound, and priorities are assigned by rate.
+///
+TEST(RealTimeExecutor, Partition)
+{
+    CountTask taskA;
+    CountTask taskB;
+    CountTask taskC;
+    CountTask taskD;
+    RealTimeExecutor::TaskConfig tasks[] =
+    {
+        {&taskA, (10 * gNsInMs), (2 * gNsInMs), nullptr},  // U = 0.2
+        {&taskB, (20 * gNsInMs), (4 * gNsInMs), nullptr},  // U = 0.2
+        {&taskC, (40 * gNsInMs), (20 * gNsInMs), nullptr}, // U = 0.5
+        {&taskD, (5 * gNsInMs), (4 * gNsInMs), nullptr},   // U = 0.8
+        {nullptr, 0, 0, nullptr}
+    };
+    RealTimeExecutor::Report report{};
+    CHECK_SUCCESS(RealTimeExecutor::analyze({tasks, 4, gMaxPri}, report));
+
+    // In rate-monotonic order, D goes on core 0. A does not fit with D since
+    // 1.8 * 1.2 > 2, so it goes on core 1, where B also fits. C fits on
+    // neither core 0 nor core 1, so it goes on core 2. Core 3 is unused.
+    CHECK_TRUE(report.schedulable);
+    CHECK_EQUAL(4, report.taskCnt);
+    CHECK_EQUAL(1, report.taskCores[0]);
+    CHECK_EQUAL(1, report.taskCores[1]);
+    CHECK_EQUAL(2, report.taskCores[2]);
+    CHECK_EQUAL(0, report.taskCores[3]);
+    DOUBLES_EQUAL(0.8, report.coreUtils[0], 1e-9);
+    DOUBLES_EQUAL(0.4, report.coreUtils[1], 1e-9);
+    DOUBLES_EQUAL(0.5, report.coreUtils[2], 1e-9);
+    DOUBLES_EQUAL(0.0, report.coreUtils[3], 1e-9);
+
+    // Shorter periods get higher priorities.
+    CHECK_EQUAL((gMaxPri - 1), report.taskPriorities[0]);
+    CHECK_EQUAL((gMaxPri - 2), report.taskPriorities[1]);
+    CHECK_EQUAL((gMaxPri - 3), report.taskPriorities[2]);
+    CHECK_EQUAL(gMaxPri, report.taskPriorities[3]);
+}
+
+///
+/// @test Tasks with equal periods share a priority.
+///
+TEST(RealTimeExecutor, EqualPeriodsSharePriority)
+{
+    CountTask taskA;
+    CountTask taskB;
+    CountTask taskC;
+    RealTimeExecutor::TaskConfig tasks[] =
+    {
+        {&taskA, (2 * gNsInMs), 0, nullptr},
+        {&taskB, gNsInMs, 0, nullptr},
+        {&taskC, (2 * gNsInMs), 0, nullptr},
+        {nullptr, 0, 0, nullptr}
+    };
+    RealTimeExecutor::Report report{};
+    CHECK_SUCCESS(RealTimeExecutor::analyze({tasks, 1, gMaxPri}, report));
+    CHECK_TRUE(report.schedulable);
+    CHECK_EQUAL((gMaxPri - 1), report.taskPriorities[0]);
+    CHECK_EQUAL(gMaxPri, report.taskPriorities[1]);
+    CHECK_EQUAL((gMaxPri - 1), report.taskPriorities[2]);
+}
+
+///
+/// @test Tasks that do not fit on any core are reported, and initializing an
+/// executor with them returns an error.
+///
+TEST(RealTimeExecutor, Unschedulable)
+{
+    CountTask taskA;
+    CountTask taskB;
+    RealTimeExecutor::TaskConfig tasks[] =
+    {
+        {&taskA, (10 * gNsInMs), (8 * gNsInMs), nullptr},
+        {&taskB, (20 * gNsInMs), (16 * gNsInMs), nullptr},
+        {nullptr, 0, 0, nullptr}
+    };
+    RealTimeExecutor::Report report{};
+    CHECK_SUCCESS(RealTimeExecutor::analyze({tasks, 1, gMaxPri}, report));
+    CHECK_TRUE(!report.schedulable);
+    CHECK_EQUAL(0, report.taskCores[0]);
+    CHECK_EQUAL(Thread::ALL_CORES, report.taskCores[1]);
+
+    RealTimeExecutor exe;
+    CHECK_ERROR(E_MSE_SCHED, RealTimeExecutor::init({tasks, 1, gMaxPri}, exe));
+    CHECK_ERROR(E_MSE_UNINIT, exe.stop());
+    CHECK_EQUAL(0, taskA.steps);
+    CHECK_EQUAL(0, taskB.steps);
+}
+
+///
+/// @test Tasks run in their threads until the executor is stopped.
+///
+TEST(RealTimeExecutor, Run)
+{
+    CountTask taskA;
+    CountTask taskB;
+    CyclicExecutor::TaskStats statsA = {};
+    RealTimeExecutor::TaskConfig tasks[] =
+    {
+        {&taskA, gNsInMs, (gNsInMs / 10), &statsA},
+        {&taskB, (2 * gNsInMs), (gNsInMs / 10), nullptr},
+        {nullptr, 0, 0, nullptr}
+    };
+    RealTimeExecutor exe;
+    CHECK_SUCCESS(RealTimeExecutor::init({tasks, 1, gMaxPri}, exe));
+    CHECK_TRUE(exe.report().schedulable);
+
+    // Let the tasks run for a while.
+    Clock::spinWait(20 * gNsInMs);
+    CHECK_SUCCESS(exe.stop());
+
+    // Both tasks stepped, and stats were recorded.
+    CHECK_TRUE(taskA.steps > 0);
+    CHECK_TRUE(taskB.steps > 0);
+    CHECK_EQUAL(taskA.steps, statsA.steps);
+
+    // Executor cannot be stopped again.
+    CHECK_ERROR(E_MSE_UNINIT, exe.stop());
+}
+
+///
+/// @test Task step errors are returned when the executor is stopped, and do
+/// not stop the task.
+///
+TEST(RealTimeExecutor, TaskStepError)
+{
+    CountTask task;
+    task.stepRes = -1;
+    RealTimeExecutor::TaskConfig tasks[] =
+    {
+        {&task, gNsInMs, 0, nullptr},
+        {nullptr, 0, 0, nullptr}
+    };
+    RealTimeExecutor exe;
+    CHECK_SUCCESS(RealTimeExecutor::init({tasks, 1, gMaxPri}, exe));
+    Clock::spinWait(10 * gNsInMs);
+    CHECK_ERROR(-1, exe.stop());
+    CHECK_TRUE(task.steps > 1);
+}
+
+///
+/// @test Initializing an executor twice returns an error.
+///
+TEST(RealTimeExecutor, ErrorReinitialize)
+{
+    CountTask task;
+    RealTimeExecutor::TaskConfig tasks[] =
+    {
+        {&task, gNsInMs, 0, nullptr},
+        {nullptr, 0, 0, nullptr}
+    };
+    RealTimeExecutor exe;
+    CHECK_SUCCESS(RealTimeExecutor::init({tasks, 1, gMaxPri}, exe));
+    CHECK_ERROR(E_MSE_REINIT, RealTimeExecutor::init({tasks, 1, gMaxPri}, exe));
+    CHECK_SUCCESS(exe.stop());
+}
+
+///
+/// @test Stopping an uninitialized executor returns an error.
+///
+TEST(RealTimeExecutor, ErrorUninitialized)
+{
+    RealTimeExecutor exe;
+    CHECK_ERROR(E_MSE_UNINIT, exe.stop());
+}
+
+///
+/// @test Initializing an executor with more cores than the system has returns
+/// an error.
+///
+TEST(RealTimeExecutor, ErrorTooManyCores)
+{
+    CountTask task;
+    RealTimeExecutor::TaskConfig tasks[] =
+    {
+        {&task, gNsInMs, 0, nullptr},
+        {nullptr, 0, 0, nullptr}
+    };
+    const U32 coreCnt = (Thread::numCores() + 1);
+    RealTimeExecutor exe;
+    CHECK_ERROR(E_MSE_CORE,
+                RealTimeExecutor::init({tasks, coreCnt, gMaxPri}, exe));
+    CHECK_ERROR(E_MSE_UNINIT, exe.stop());
+}
+
+///
+/// @test Analyzing an invalid config returns an error.
+///
+TEST(RealTimeExecutor, ErrorInvalidConfig)
+{
+    CountTask task;
+    RealTimeExecutor::Report report{};
+
+    // Null tasks array.
+    CHECK_ERROR(E_MSE_NULL,
+                RealTimeExecutor::analyze({nullptr, 1, gMaxPri}, report));
+
+    // No tasks.
+    RealTimeExecutor::TaskConfig empty[] = {{nullptr, 0, 0, nullptr}};
+    CHECK_ERROR(E_MSE_EMPTY,
+                RealTimeExecutor::analyze({empty, 1, gMaxPri}, report));
+
+    // Invalid core counts.
+    RealTimeExecutor::TaskConfig tasks[] =
+    {
+        {&task, gNsInMs, 0, nullptr},
+        {nullptr, 0, 0, nullptr}
+    };
+    CHECK_ERROR(E_MSE_CORE,
+                RealTimeExecutor::analyze({tasks, 0, gMaxPri}, report));
+    CHECK_ERROR(E_MSE_CORE,
+                RealTimeExecutor::analyze(
+                    {tasks, (RealTimeExecutor::MAX_CORES + 1), gMaxPri},
+                    report));
+
+    // Zero period.
+    RealTimeExecutor::TaskConfig zeroPeriod[] =
+    {
+        {&task, 0, 0, nullptr},
+        {nullptr, 0, 0, nullptr}
+    };
+    CHECK_ERROR(E_MSE_PERIOD,
+                RealTimeExecutor::analyze({zeroPeriod, 1, gMaxPri}, report));
+
+    // WCET longer than period.
+    RealTimeExecutor::TaskConfig longWcet[] =
+    {
+        {&task, gNsInMs, (gNsInMs + 1), nullptr},
+        {nullptr, 0, 0, nullptr}
+    };
+    CHECK_ERROR(E_MSE_PERIOD,
+                RealTimeExecutor::analyze({longWcet, 1, gMaxPri}, report));
+
+    // Invalid priorities.
+    RealTimeExecutor::TaskConfig twoRates[] =
+    {
+        {&task, gNsInMs, 0, nullptr},
+        {&task, (2 * gNsInMs), 0, nullptr},
+        {nullptr, 0, 0, nullptr}
+    };
+    CHECK_ERROR(E_MSE_PRI,
+                RealTimeExecutor::analyze(
+                    {twoRates, 1, (Thread::REALTIME_MAX_PRI + 1)},
+                    report));
+    CHECK_ERROR(E_MSE_PRI,
+                RealTimeExecutor::analyze(
+                    {twoRates, 1, Thread::REALTIME_MIN_PRI},
+                    report));
+}
+
+///
+/// @test Analyzing a config with too many tasks returns an error.
+///
+TEST(RealTimeExecutor, ErrorTooManyTasks)
+{
+    CountTask task;
+    RealTimeExecutor::TaskConfig tasks[RealTimeExecutor::MAX_TASKS + 2];
+    for (U32 i = 0; i < (RealTimeExecutor::MAX_TASKS + 1); ++i)
+    {
+        tasks[i] = {&task, gNsInMs, 0, nullptr};
+    }
+    tasks[RealTimeExecutor::MAX_TASKS + 1] = {nullptr, 0, 0, nullptr};
+
+    RealTimeExecutor::Report report{};
+    CHECK_ERROR(E_MSE_CNT,
+                RealTimeExecutor::analyze({tasks, 1, gMaxPri}, report));
+}
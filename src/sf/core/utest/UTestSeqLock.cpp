@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/utest/UTestSeqLock.cpp
+/// @brief Unit tests for SeqLock.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/core/Element.hpp"
+#include "sf/core/Region.hpp"
+#include "sf/core/SeqLock.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+///
+/// @brief Unit tests for SeqLock.
+///
+TEST_GROUP(SeqLock)
+{
+};
+
+///
+/// @test A read with no overlapping write does not need to be retried.
+///
+TEST(SeqLock, ReadNoWrite)
+{
+    SeqLock lock;
+    const U32 seq = lock.readBegin();
+    CHECK_EQUAL(0, seq);
+    CHECK_TRUE(!lock.readRetry(seq));
+}
+
+///
+/// @test A read overlapping a write must be retried, and the retry sees the
+/// new sequence number.
+///
+TEST(SeqLock, ReadOverlappingWrite)
+{
+    SeqLock lock;
+    U32 seq = lock.readBegin();
+
+    // Write begins during read.
+    lock.writeBegin();
+    CHECK_TRUE(lock.readRetry(seq));
+
+    // Write ends during read.
+    lock.writeEnd();
+    CHECK_TRUE(lock.readRetry(seq));
+
+    // Read is retried after the write and succeeds.
+    seq = lock.readBegin();
+    CHECK_EQUAL(2, seq);
+    CHECK_TRUE(!lock.readRetry(seq));
+}
+
+///
+/// @test Elements guarded by a sequence lock are correctly read and written.
+///
+TEST(SeqLock, Element)
+{
+    SeqLock lock;
+    F64 backing = 0.0;
+    Element<F64> elem(backing, lock);
+
+    elem.write(1.522);
+    CHECK_EQUAL(1.522, backing);
+    CHECK_EQUAL(1.522, elem.read());
+
+    // Each write advanced the sequence number by 2.
+    CHECK_EQUAL(2, lock.readBegin());
+}
+
+///
+/// @test Regions guarded by a sequence lock are correctly read and written.
+///
+TEST(SeqLock, Region)
+{
+    SeqLock lock;
+    struct
+    {
+        I32 i32;
+        F64 f64;
+    } foo{343, 1.522}, bar{};
+    Region regionBar(&bar, sizeof(bar), lock);
+
+    CHECK_SUCCESS(regionBar.write(&foo, sizeof(foo)));
+    CHECK_EQUAL(343, bar.i32);
+    CHECK_EQUAL(1.522, bar.f64);
+
+    foo = {};
+    CHECK_SUCCESS(regionBar.read(&foo, sizeof(foo)));
+    CHECK_EQUAL(343, foo.i32);
+    CHECK_EQUAL(1.522, foo.f64);
+
+    // Buffer size mismatch does not touch the lock.
+    CHECK_ERROR(E_RGN_SIZE, regionBar.write(&foo, 1));
+    CHECK_EQUAL(2, lock.readBegin());
+}
@@ -76,50 +76,42 @@ static ElementExprNode<bool> gExprBaz(gElemBaz);
 // -> State2
 static TransitionAction gTransToState2(2);
 
-// State 1 blocks
-static StateMachine::Block gState1EntryTransBlock =
-    {nullptr, nullptr, nullptr, &gTransToState2, nullptr};
-
-static StateMachine::Block gState1EntryBlock =
-    {&gExprFoo, &gState1EntryTransBlock, nullptr, nullptr, nullptr};
-
-static StateMachine::Block gState1StepTransBlock =
-    {nullptr, nullptr, nullptr, &gTransToState2, nullptr};
-
-static StateMachine::Block gState1StepBazBlock =
-    {&gExprBaz, &gState1StepTransBlock, nullptr, nullptr, nullptr};
-
-static StateMachine::Block gState1StepBarElseBlock =
-    {nullptr, nullptr, nullptr, &gTransToState2, nullptr};
-
-static StateMachine::Block gState1StepBarBlock =
+// State 1 labels
+static StateMachine::Instruction gState1Entry[] =
 {
-    &gExprBar,
-    &gState1StepBazBlock,
-    &gState1StepBarElseBlock,
-    nullptr,
-    nullptr
+    {StateMachine::Instruction::GUARD, &gExprFoo, nullptr, 2},
+    {StateMachine::Instruction::ACTION, nullptr, &gTransToState2, 0},
+    {StateMachine::Instruction::END, nullptr, nullptr, 0}
 };
 
-static StateMachine::Block gState1StepNextBlock =
-    {nullptr, nullptr, nullptr, &gTransToState2, nullptr};
-
-static StateMachine::Block gState1StepBlock =
-    {&gExprFoo, &gState1StepBarBlock, nullptr, nullptr, &gState1StepNextBlock};
+static StateMachine::Instruction gState1Step[] =
+{
+    {StateMachine::Instruction::GUARD, &gExprFoo, nullptr, 6},
+    {StateMachine::Instruction::GUARD, &gExprBar, nullptr, 4},
+    {StateMachine::Instruction::GUARD, &gExprBaz, nullptr, 2},
+    {StateMachine::Instruction::ACTION, nullptr, &gTransToState2, 0},
+    {StateMachine::Instruction::JUMP, nullptr, nullptr, 2},
+    {StateMachine::Instruction::ACTION, nullptr, &gTransToState2, 0},
+    {StateMachine::Instruction::ACTION, nullptr, &gTransToState2, 0},
+    {StateMachine::Instruction::END, nullptr, nullptr, 0}
+};
 
-static StateMachine::Block gState1ExitBlock =
-    {nullptr, nullptr, nullptr, nullptr, nullptr};
+static StateMachine::Instruction gState1Exit[] =
+{
+    {StateMachine::Instruction::END, nullptr, nullptr, 0},
+    {StateMachine::Instruction::END, nullptr, nullptr, 0}
+};
 
 // State machine config
 static StateMachine::StateConfig gStates[] =
 {
-    {1, &gState1EntryBlock, &gState1StepBlock, &gState1ExitBlock},
+    {1, gState1Entry, gState1Step, gState1Exit},
     {2, nullptr, nullptr, nullptr},
     {0, nullptr, nullptr, nullptr}
 };
 
 static StateMachine::Config gConfig =
-    {&gElemState, &gElemStateTime, &gElemGlobalTime, gStates, nullptr};
+    {&gElemState, &gElemStateTime, &gElemGlobalTime, gStates, nullptr, nullptr};
 
 //////////////////////////////////// Tests /////////////////////////////////////
 
@@ -282,10 +274,10 @@ TEST(StateMachineInit, ErrorInvalidTransitionInEntryLabel)
 
     TransitionAction badTrans(3);
 
-    auto stash = gState1EntryTransBlock.action;
-    gState1EntryTransBlock.action = &badTrans;
+    auto stash = gState1Entry[1].action;
+    gState1Entry[1].action = &badTrans;
     const Result res = StateMachine::init(gConfig, sm);
-    gState1EntryTransBlock.action = stash;
+    gState1Entry[1].action = stash;
 
     CHECK_ERROR(E_SM_TRANS, res);
     CHECK_ERROR(E_SM_UNINIT, sm.step());
@@ -295,17 +287,17 @@ TEST(StateMachineInit, ErrorInvalidTransitionInEntryLabel)
 /// @test A transition to an invalid state in a step label if branch returns an
 /// error on initialization.
 ///
-TEST(StateMachineInit, ErrorInvalidTransitionInStepLabelIfBlock)
+TEST(StateMachineInit, ErrorInvalidTransitionInStepLabelIfBranch)
 {
     StateMachine sm;
     gElemState.write(1);
 
     TransitionAction badTrans(3);
 
-    auto stash = gState1StepTransBlock.action;
-    gState1StepTransBlock.action = &badTrans;
+    auto stash = gState1Step[3].action;
+    gState1Step[3].action = &badTrans;
     const Result res = StateMachine::init(gConfig, sm);
-    gState1StepTransBlock.action = stash;
+    gState1Step[3].action = stash;
 
     CHECK_ERROR(E_SM_TRANS, res);
     CHECK_ERROR(E_SM_UNINIT, sm.step());
@@ -315,17 +307,17 @@ TEST(StateMachineInit, ErrorInvalidTransitionInStepLabelIfBlock)
 /// @test A transition to an invalid state in a step label else branch returns
 /// an error on initialization.
 ///
-TEST(StateMachineInit, ErrorInvalidTransitionInStepLabelElseBlock)
+TEST(StateMachineInit, ErrorInvalidTransitionInStepLabelElseBranch)
 {
     StateMachine sm;
     gElemState.write(1);
 
     TransitionAction badTrans(3);
 
-    auto stash = gState1StepBarElseBlock.action;
-    gState1StepBarElseBlock.action = &badTrans;
+    auto stash = gState1Step[5].action;
+    gState1Step[5].action = &badTrans;
     const Result res = StateMachine::init(gConfig, sm);
-    gState1StepBarElseBlock.action = stash;
+    gState1Step[5].action = stash;
 
     CHECK_ERROR(E_SM_TRANS, res);
     CHECK_ERROR(E_SM_UNINIT, sm.step());
@@ -333,19 +325,19 @@ TEST(StateMachineInit, ErrorInvalidTransitionInStepLabelElseBlock)
 
 ///
 /// @test A transition to an invalid state in the middle of a step label (i.e.,
-/// not the first block) returns an error on initialization.
+/// not the first instruction) returns an error on initialization.
 ///
-TEST(StateMachineInit, ErrorInvalidTransitionInStepLabelNextBlock)
+TEST(StateMachineInit, ErrorInvalidTransitionInStepLabelMiddle)
 {
     StateMachine sm;
     gElemState.write(1);
 
     TransitionAction badTrans(3);
 
-    auto stash = gState1StepNextBlock.action;
-    gState1StepNextBlock.action = &badTrans;
+    auto stash = gState1Step[6].action;
+    gState1Step[6].action = &badTrans;
     const Result res = StateMachine::init(gConfig, sm);
-    gState1StepNextBlock.action = stash;
+    gState1Step[6].action = stash;
 
     CHECK_ERROR(E_SM_TRANS, res);
     CHECK_ERROR(E_SM_UNINIT, sm.step());
@@ -361,11 +353,112 @@ TEST(StateMachineInit, ErrorIllegalTransitionInExitLabel)
 
     TransitionAction trans(2);
 
-    auto stash = gState1ExitBlock.action;
-    gState1ExitBlock.action = &trans;
+    const StateMachine::Instruction stash = gState1Exit[0];
+    gState1Exit[0] = {StateMachine::Instruction::ACTION, nullptr, &trans, 0};
     const Result res = StateMachine::init(gConfig, sm);
-    gState1ExitBlock.action = stash;
+    gState1Exit[0] = stash;
 
     CHECK_ERROR(E_SM_TR_EXIT, res);
     CHECK_ERROR(E_SM_UNINIT, sm.step());
 }
+
+///
+/// @test A guard instruction with a null guard returns an error on
+/// initialization.
+///
+TEST(StateMachineInit, ErrorNullGuard)
+{
+    StateMachine sm;
+    gElemState.write(1);
+
+    auto stash = gState1Step[1].guard;
+    gState1Step[1].guard = nullptr;
+    const Result res = StateMachine::init(gConfig, sm);
+    gState1Step[1].guard = stash;
+
+    CHECK_ERROR(E_SM_NULL, res);
+    CHECK_ERROR(E_SM_UNINIT, sm.step());
+}
+
+///
+/// @test An action instruction with a null action returns an error on
+/// initialization.
+///
+TEST(StateMachineInit, ErrorNullAction)
+{
+    StateMachine sm;
+    gElemState.write(1);
+
+    auto stash = gState1Step[6].action;
+    gState1Step[6].action = nullptr;
+    const Result res = StateMachine::init(gConfig, sm);
+    gState1Step[6].action = stash;
+
+    CHECK_ERROR(E_SM_NULL, res);
+    CHECK_ERROR(E_SM_UNINIT, sm.step());
+}
+
+///
+/// @test An instruction with an invalid opcode returns an error on
+/// initialization.
+///
+TEST(StateMachineInit, ErrorInvalidOpcode)
+{
+    StateMachine sm;
+    gElemState.write(1);
+
+    auto stash = gState1Step[6].op;
+    gState1Step[6].op = static_cast<StateMachine::Instruction::Opcode>(4);
+    const Result res = StateMachine::init(gConfig, sm);
+    gState1Step[6].op = stash;
+
+    CHECK_ERROR(E_SM_LABEL, res);
+    CHECK_ERROR(E_SM_UNINIT, sm.step());
+}
+
+///
+/// @test A jump of 0 instructions, which would loop forever, returns an error
+/// on initialization.
+///
+TEST(StateMachineInit, ErrorZeroJump)
+{
+    StateMachine sm;
+    gElemState.write(1);
+
+    gState1Step[4].offset = 0;
+    const Result res = StateMachine::init(gConfig, sm);
+    gState1Step[4].offset = 2;
+
+    CHECK_ERROR(E_SM_LABEL, res);
+    CHECK_ERROR(E_SM_UNINIT, sm.step());
+}
+
+///
+/// @test A jump or guard past the end of its label returns an error on
+/// initialization.
+///
+TEST(StateMachineInit, ErrorJumpOutOfLabel)
+{
+    StateMachine sm;
+    gElemState.write(1);
+
+    // Jump lands past the END instruction.
+    gState1Step[4].offset = 4;
+    Result res = StateMachine::init(gConfig, sm);
+    gState1Step[4].offset = 2;
+    CHECK_ERROR(E_SM_LABEL, res);
+    CHECK_ERROR(E_SM_UNINIT, sm.step());
+
+    // Guard lands past the END instruction.
+    gState1Entry[0].offset = 3;
+    res = StateMachine::init(gConfig, sm);
+    gState1Entry[0].offset = 2;
+    CHECK_ERROR(E_SM_LABEL, res);
+    CHECK_ERROR(E_SM_UNINIT, sm.step());
+
+    // Jumps that land exactly on the END instruction are allowed.
+    gState1Step[4].offset = 3;
+    res = StateMachine::init(gConfig, sm);
+    gState1Step[4].offset = 2;
+    CHECK_SUCCESS(res);
+}
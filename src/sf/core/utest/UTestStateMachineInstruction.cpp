@@ -16,8 +16,8 @@
 /// IN THE SOFTWARE.
 ///
 ///                             ---------------
-/// @file  sf/core/utest/UTestStateMachineBlock.cpp
-/// @brief Unit tests for StateMachine::Block.
+/// @file  sf/core/utest/UTestStateMachineInstruction.cpp
+/// @brief Unit tests for StateMachine::Instruction.
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "sf/core/StateMachine.hpp"
@@ -26,25 +26,28 @@
 using namespace Sf;
 
 ///
-/// @brief Unit tests for StateMachine::Block.
+/// @brief Unit tests for StateMachine::Instruction.
 ///
-TEST_GROUP(StateMachineBlock)
+TEST_GROUP(StateMachineInstruction)
 {
 };
 
 ///
-/// @test Executing an all-null block is a nop.
+/// @test Executing a label containing only an END instruction is a nop.
 ///
-TEST(StateMachineBlock, BlockNull)
+TEST(StateMachineInstruction, EmptyLabel)
 {
-    StateMachine::Block block = {nullptr, nullptr, nullptr, nullptr, nullptr};
-    CHECK_EQUAL(0, block.execute());
+    const StateMachine::Instruction label[] =
+    {
+        {StateMachine::Instruction::END, nullptr, nullptr, 0}
+    };
+    CHECK_EQUAL(0, label[0].execute());
 }
 
 ///
-/// @test Executing a block executes its action.
+/// @test Executing an action instruction executes its action.
 ///
-TEST(StateMachineBlock, BlockExecuteAction)
+TEST(StateMachineInstruction, ExecuteAction)
 {
     // Action `foo = 10`
     I32 foo = 0;
@@ -52,19 +55,22 @@ TEST(StateMachineBlock, BlockExecuteAction)
     ConstExprNode<I32> expr10(10);
     AssignmentAction<I32> fooGets10(elemFoo, expr10);
 
-    // Create block containing action.
-    StateMachine::Block block =
-        {nullptr, nullptr, nullptr, &fooGets10, nullptr};
+    // Create label containing action.
+    const StateMachine::Instruction label[] =
+    {
+        {StateMachine::Instruction::ACTION, nullptr, &fooGets10, 0},
+        {StateMachine::Instruction::END, nullptr, nullptr, 0}
+    };
 
-    // Execute block. No transition, action executes.
-    CHECK_EQUAL(0, block.execute());
+    // Execute label. No transition, action executes.
+    CHECK_EQUAL(0, label[0].execute());
     CHECK_EQUAL(10, elemFoo.read());
 }
 
 ///
-/// @test Executing a block executes its next block.
+/// @test Executing a label executes its instructions in order.
 ///
-TEST(StateMachineBlock, BlockExecuteLink)
+TEST(StateMachineInstruction, ExecuteSequence)
 {
     // Action `foo = foo + 1`
     I32 foo = 1;
@@ -86,21 +92,24 @@ TEST(StateMachineBlock, BlockExecuteLink)
 
     // foo = foo + 1
     // foo = foo * -1
-    StateMachine::Block block1 =
-        {nullptr, nullptr, nullptr, &fooGetsFooTimesNeg1, nullptr};
-    StateMachine::Block block0 =
-        {nullptr, nullptr, nullptr, &fooGetsFooPlus1, &block1};
-
-    // Execute block. No transition, actions execute in the expected order.
-    CHECK_EQUAL(0, block0.execute());
+    const StateMachine::Instruction label[] =
+    {
+        {StateMachine::Instruction::ACTION, nullptr, &fooGetsFooPlus1, 0},
+        {StateMachine::Instruction::ACTION, nullptr, &fooGetsFooTimesNeg1, 0},
+        {StateMachine::Instruction::END, nullptr, nullptr, 0}
+    };
+
+    // Execute label. No transition, actions execute in the expected order.
+    CHECK_EQUAL(0, label[0].execute());
     CHECK_EQUAL(-2, elemFoo.read());
 }
 
 ///
-/// @test Executing a guarded block executes its if branch if the guard is true,
-/// else branch if the guard is false, and next block in either case.
+/// @test Executing a guard executes the if branch if the guard is true, else
+/// branch if the guard is false, and the instructions after the branches in
+/// either case.
 ///
-TEST(StateMachineBlock, BlockGuard)
+TEST(StateMachineInstruction, Guard)
 {
     // Expression `foo == TRUE`
     bool foo = false;
@@ -134,27 +143,57 @@ TEST(StateMachineBlock, BlockGuard)
     // foo:  bar = 1
     // ELSE: bar = 2
     // baz = NOT baz
-    StateMachine::Block next = {nullptr, nullptr, nullptr, &bazGetsNotBaz};
-    StateMachine::Block ifBlock =
-        {nullptr, nullptr, nullptr, &barGets1, nullptr};
-    StateMachine::Block elseBlock =
-        {nullptr, nullptr, nullptr, &barGets2, nullptr};
-    StateMachine::Block block =
-        {&fooIsTrue, &ifBlock, &elseBlock, nullptr, &next};
+    const StateMachine::Instruction label[] =
+    {
+        {StateMachine::Instruction::GUARD, &fooIsTrue, nullptr, 3},
+        {StateMachine::Instruction::ACTION, nullptr, &barGets1, 0},
+        {StateMachine::Instruction::JUMP, nullptr, nullptr, 2},
+        {StateMachine::Instruction::ACTION, nullptr, &barGets2, 0},
+        {StateMachine::Instruction::ACTION, nullptr, &bazGetsNotBaz, 0},
+        {StateMachine::Instruction::END, nullptr, nullptr, 0}
+    };
 
     // When `foo` is true, if branch is taken.
     elemFoo.write(true);
-    CHECK_EQUAL(0, block.execute());
+    CHECK_EQUAL(0, label[0].execute());
     CHECK_EQUAL(1, elemBar.read());
 
-    // Linked block executes regardless of guard.
+    // Instruction after branches executes regardless of guard.
     CHECK_EQUAL(true, elemBaz.read());
 
     // When `foo` is false, else branch is taken.
     elemFoo.write(false);
-    CHECK_EQUAL(0, block.execute());
+    CHECK_EQUAL(0, label[0].execute());
     CHECK_EQUAL(2, elemBar.read());
 
-    // Linked block executes regardless of guard.
+    // Instruction after branches executes regardless of guard.
     CHECK_EQUAL(false, elemBaz.read());
 }
+
+///
+/// @test A transition ends the label, so later instructions do not execute.
+///
+TEST(StateMachineInstruction, TransitionEndsLabel)
+{
+    // Action `foo = 10`
+    I32 foo = 0;
+    Element<I32> elemFoo(foo);
+    ConstExprNode<I32> expr10(10);
+    AssignmentAction<I32> fooGets10(elemFoo, expr10);
+
+    // -> State 3
+    TransitionAction transToState3(3);
+
+    // -> State 3
+    // foo = 10
+    const StateMachine::Instruction label[] =
+    {
+        {StateMachine::Instruction::ACTION, nullptr, &transToState3, 0},
+        {StateMachine::Instruction::ACTION, nullptr, &fooGets10, 0},
+        {StateMachine::Instruction::END, nullptr, nullptr, 0}
+    };
+
+    // Label returns destination state and `foo` is not assigned.
+    CHECK_EQUAL(3, label[0].execute());
+    CHECK_EQUAL(0, elemFoo.read());
+}
@@ -96,32 +96,37 @@ static TransitionAction gTransToState2(2);
 // foo = 0
 static AssignmentAction<I32> gFooGets0(gElemFoo, g0);
 
-// State 1 blocks
-static StateMachine::Block gState1EntryBlock =
-    {nullptr, nullptr, nullptr, &gFooGets100, nullptr};
-
-static StateMachine::Block gState1TransBlock =
-    {nullptr, nullptr, nullptr, &gTransToState2, nullptr};
-
-static StateMachine::Block gState1StepBlockNext =
-    {&gFooIs200, &gState1TransBlock, nullptr, nullptr, nullptr};
+// State 1 labels
+static StateMachine::Instruction gState1Entry[] =
+{
+    {StateMachine::Instruction::ACTION, nullptr, &gFooGets100, 0},
+    {StateMachine::Instruction::END, nullptr, nullptr, 0}
+};
 
-static StateMachine::Block gState1StepBlock =
-    {nullptr, nullptr, nullptr, &gFooGetsFooPlus1, &gState1StepBlockNext};
+static StateMachine::Instruction gState1Step[] =
+{
+    {StateMachine::Instruction::ACTION, nullptr, &gFooGetsFooPlus1, 0},
+    {StateMachine::Instruction::GUARD, &gFooIs200, nullptr, 2},
+    {StateMachine::Instruction::ACTION, nullptr, &gTransToState2, 0},
+    {StateMachine::Instruction::END, nullptr, nullptr, 0}
+};
 
-static StateMachine::Block gState1ExitBlock =
-    {nullptr, nullptr, nullptr, &gFooGets0, nullptr};
+static StateMachine::Instruction gState1Exit[] =
+{
+    {StateMachine::Instruction::ACTION, nullptr, &gFooGets0, 0},
+    {StateMachine::Instruction::END, nullptr, nullptr, 0}
+};
 
 // State machine config
 static StateMachine::StateConfig gStates[] =
 {
-    {1, &gState1EntryBlock, &gState1StepBlock, &gState1ExitBlock},
+    {1, gState1Entry, gState1Step, gState1Exit},
     {2, nullptr, nullptr, nullptr},
     {0, nullptr, nullptr, nullptr}
 };
 
 static StateMachine::Config gConfig =
-    {&gElemState, &gElemStateTime, &gElemGlobalTime, gStates, nullptr};
+    {&gElemState, &gElemStateTime, &gElemGlobalTime, gStates, nullptr, nullptr};
 
 //////////////////////////////////// Tests /////////////////////////////////////
 
@@ -315,9 +320,9 @@ TEST(StateMachineStep, UpdateExpressionStats)
 {
     // State machine will update stats for elements `bar` and `baz`.
     I32 barArrA[1];
-    I32 barArrB[1];
+    U32 barArrB[4];
     I32 bazArrA[1];
-    I32 bazArrB[1];
+    U32 bazArrB[4];
     ExpressionStats<I32> statsBar(gExprBar, barArrA, barArrB, 1);
     ExpressionStats<I32> statsBaz(gExprBaz, bazArrA, bazArrB, 1);
     IExpressionStats* stats[] = {&statsBar, &statsBaz, nullptr};
@@ -348,3 +353,108 @@ TEST(StateMachineStep, UpdateExpressionStats)
     CHECK_EQUAL(-10.0, statsBar.mean());
     CHECK_EQUAL(3.0, statsBaz.mean());
 }
+
+///
+/// @brief State machine only updates ExpressionStats in the states that use
+/// them, and otherwise samples or skips them as configured.
+///
+TEST(StateMachineStep, ExpressionStatsDeps)
+{
+    // State machine has stats for elements `foo`, `bar`, and `baz`.
+    I32 fooArrA[2];
+    U32 fooArrB[8];
+    I32 barArrA[2];
+    U32 barArrB[8];
+    I32 bazArrA[2];
+    U32 bazArrB[8];
+    ExpressionStats<I32> statsFoo(gExprFoo, fooArrA, fooArrB, 2);
+    ExpressionStats<I32> statsBar(gExprBar, barArrA, barArrB, 2);
+    ExpressionStats<I32> statsBaz(gExprBaz, bazArrA, bazArrB, 2);
+    IExpressionStats* stats[] = {&statsFoo, &statsBar, &statsBaz, nullptr};
+
+    // `foo` stats are used in all states, `bar` stats are only used in state 2
+    // and are sampled otherwise, and `baz` stats are only used in state 2 and
+    // are skipped otherwise.
+    const U32 state2[] = {2, StateMachine::NO_STATE};
+    StateMachine::StatsDeps statsDeps[] =
+    {
+        {nullptr, false},
+        {state2, true},
+        {state2, false}
+    };
+
+    // Initialize the state machine in state 1.
+    gElemState.write(1);
+    StateMachine sm;
+    StateMachine::Config config = gConfig;
+    config.stats = stats;
+    config.statsDeps = statsDeps;
+    CHECK_SUCCESS(StateMachine::init(config, sm));
+
+    // Step state machine twice.
+    gElemBar.write(4);
+    gElemBaz.write(-5);
+    CHECK_SUCCESS(sm.step());
+    gElemBar.write(6);
+    gElemGlobalTime.write(1);
+    CHECK_SUCCESS(sm.step());
+
+    // `foo` stats were updated before each step, when `foo` was 0 and 101.
+    CHECK_EQUAL(50.5, statsFoo.mean());
+    CHECK_EQUAL(101.0, statsFoo.max());
+
+    // `bar` stats were sampled, so their window is the same as if they were
+    // updated.
+    CHECK_EQUAL(5.0, statsBar.mean());
+    CHECK_EQUAL(5.0, statsBar.median());
+    CHECK_EQUAL(4.0, statsBar.min());
+    CHECK_EQUAL(6.0, statsBar.max());
+
+    // `baz` stats were skipped and are still empty.
+    CHECK_EQUAL(0.0, statsBaz.mean());
+    CHECK_EQUAL(0.0, statsBaz.max());
+}
+
+///
+/// @test State machines whose state IDs are not 1 through N in array order
+/// still transition correctly.
+///
+TEST(StateMachineStep, SparseStateIds)
+{
+    // State 7 transitions to state 3 on its first step, and state 3
+    // transitions back to state 7.
+    TransitionAction transToState3(3);
+    TransitionAction transToState7(7);
+    StateMachine::Instruction state7Step[] =
+    {
+        {StateMachine::Instruction::ACTION, nullptr, &transToState3, 0},
+        {StateMachine::Instruction::END, nullptr, nullptr, 0}
+    };
+    StateMachine::Instruction state3Step[] =
+    {
+        {StateMachine::Instruction::ACTION, nullptr, &transToState7, 0},
+        {StateMachine::Instruction::END, nullptr, nullptr, 0}
+    };
+    StateMachine::StateConfig states[] =
+    {
+        {7, nullptr, state7Step, nullptr},
+        {3, nullptr, state3Step, nullptr},
+        {0, nullptr, nullptr, nullptr}
+    };
+
+    // Initialize the state machine in state 7.
+    gElemState.write(7);
+    StateMachine sm;
+    StateMachine::Config config = gConfig;
+    config.states = states;
+    CHECK_SUCCESS(StateMachine::init(config, sm));
+
+    // Step state machine and transition to state 3.
+    CHECK_SUCCESS(sm.step());
+    CHECK_EQUAL(3, sm.currentState());
+
+    // Step again and transition back to state 7.
+    gElemGlobalTime.write(1);
+    CHECK_SUCCESS(sm.step());
+    CHECK_EQUAL(7, sm.currentState());
+}
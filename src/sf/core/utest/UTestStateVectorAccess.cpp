@@ -96,20 +96,31 @@ static StateVector::RegionConfig gRegions[] =
 // Test state vector config.
 static StateVector::Config gConfig = {gElems, gRegions};
 
+// Test state vector lookup index storage.
+static const StateVector::ElementConfig* gElemIndex[11];
+static const StateVector::RegionConfig* gRegionIndex[2];
+
+// Test state vector config that uses lookup indices.
+static StateVector::Config gIndexedConfig =
+    {gElems, gRegions, gElemIndex, gRegionIndex};
+
 /////////////////////////////////// Helpers ////////////////////////////////////
 
 ///
 /// @brief Checks that StateVector::getElement() and StateVector::getIElement()
 /// return the correct pointers.
 ///
-/// @param[in] kName  Element name.
-/// @param[in] kElem  Element object.
+/// @param[in] kConfig  State vector config.
+/// @param[in] kName    Element name.
+/// @param[in] kElem    Element object.
 ///
 template<typename T>
-static void testGetElement(const char* const kName, const Element<T>& kElem)
+static void testGetElement(const StateVector::Config kConfig,
+                           const char* const kName,
+                           const Element<T>& kElem)
 {
     StateVector sv;
-    CHECK_SUCCESS(StateVector::init(gConfig, sv));
+    CHECK_SUCCESS(StateVector::init(kConfig, sv));
     Element<T>* elem = nullptr;
     CHECK_SUCCESS(sv.getElement(kName, elem));
     POINTERS_EQUAL(&kElem, elem);
@@ -132,17 +143,17 @@ TEST_GROUP(StateVectorAccess)
 ///
 TEST(StateVectorAccess, GetElement)
 {
-    testGetElement<I8>("i8", gElemI8);
-    testGetElement<I16>("i16", gElemI16);
-    testGetElement<I32>("i32", gElemI32);
-    testGetElement<I64>("i64", gElemI64);
-    testGetElement<U8>("u8", gElemU8);
-    testGetElement<U16>("u16", gElemU16);
-    testGetElement<U32>("u32", gElemU32);
-    testGetElement<U64>("u64", gElemU64);
-    testGetElement<F32>("f32", gElemF32);
-    testGetElement<F64>("f64", gElemF64);
-    testGetElement<bool>("bool", gElemBool);
+    testGetElement<I8>(gConfig, "i8", gElemI8);
+    testGetElement<I16>(gConfig, "i16", gElemI16);
+    testGetElement<I32>(gConfig, "i32", gElemI32);
+    testGetElement<I64>(gConfig, "i64", gElemI64);
+    testGetElement<U8>(gConfig, "u8", gElemU8);
+    testGetElement<U16>(gConfig, "u16", gElemU16);
+    testGetElement<U32>(gConfig, "u32", gElemU32);
+    testGetElement<U64>(gConfig, "u64", gElemU64);
+    testGetElement<F32>(gConfig, "f32", gElemF32);
+    testGetElement<F64>(gConfig, "f64", gElemF64);
+    testGetElement<bool>(gConfig, "bool", gElemBool);
 }
 
 ///
@@ -199,3 +210,59 @@ TEST(StateVectorAccess, ErrorUnknownRegion)
     CHECK_ERROR(E_SV_KEY, sv.getRegion("baz", region));
     CHECK_TRUE(region == nullptr);
 }
+
+///
+/// @brief Element lookup returns the correct pointer when the state vector uses
+/// a lookup index.
+///
+TEST(StateVectorAccess, GetElementIndexed)
+{
+    testGetElement<I8>(gIndexedConfig, "i8", gElemI8);
+    testGetElement<I16>(gIndexedConfig, "i16", gElemI16);
+    testGetElement<I32>(gIndexedConfig, "i32", gElemI32);
+    testGetElement<I64>(gIndexedConfig, "i64", gElemI64);
+    testGetElement<U8>(gIndexedConfig, "u8", gElemU8);
+    testGetElement<U16>(gIndexedConfig, "u16", gElemU16);
+    testGetElement<U32>(gIndexedConfig, "u32", gElemU32);
+    testGetElement<U64>(gIndexedConfig, "u64", gElemU64);
+    testGetElement<F32>(gIndexedConfig, "f32", gElemF32);
+    testGetElement<F64>(gIndexedConfig, "f64", gElemF64);
+    testGetElement<bool>(gIndexedConfig, "bool", gElemBool);
+}
+
+///
+/// @brief Region lookup returns the correct pointer when the state vector uses
+/// a lookup index.
+///
+TEST(StateVectorAccess, GetRegionIndexed)
+{
+    StateVector sv;
+    CHECK_SUCCESS(StateVector::init(gIndexedConfig, sv));
+    Region* region = nullptr;
+    CHECK_SUCCESS(sv.getRegion("foo", region));
+    POINTERS_EQUAL(region, &gRegionFoo);
+    CHECK_SUCCESS(sv.getRegion("bar", region));
+    POINTERS_EQUAL(region, &gRegionBar);
+}
+
+///
+/// @brief Looking up an element or region that does not exist returns an error
+/// when the state vector uses a lookup index.
+///
+TEST(StateVectorAccess, ErrorUnknownIndexed)
+{
+    StateVector sv;
+    CHECK_SUCCESS(StateVector::init(gIndexedConfig, sv));
+
+    // Try names that sort before, between, and after the configured names.
+    const char* const names[] = {"", "a", "f", "i9", "z", nullptr};
+    for (const char* const name : names)
+    {
+        IElement* ielem = nullptr;
+        CHECK_ERROR(E_SV_KEY, sv.getIElement(name, ielem));
+        CHECK_TRUE(ielem == nullptr);
+        Region* region = nullptr;
+        CHECK_ERROR(E_SV_KEY, sv.getRegion(name, region));
+        CHECK_TRUE(region == nullptr);
+    }
+}
@@ -72,6 +72,14 @@ static StateVector::RegionConfig gRegions[] =
 // Test state vector config.
 static StateVector::Config gConfig = {gElems, gRegions};
 
+// Test state vector lookup index storage.
+static const StateVector::ElementConfig* gElemIndex[3];
+static const StateVector::RegionConfig* gRegionIndex[2];
+
+// Test state vector config that uses lookup indices.
+static StateVector::Config gIndexedConfig =
+    {gElems, gRegions, gElemIndex, gRegionIndex};
+
 /////////////////////////////////// Helpers ////////////////////////////////////
 
 ///
@@ -330,3 +338,58 @@ TEST(StateVectorInit, DupeRegionName)
     // State vector is uninitialized.
     checkStateVectorUninitialized(sv);
 }
+
+///
+/// @test State vector initialization succeeds with a valid config that uses
+/// lookup indices, and the indices are sorted by name.
+///
+TEST(StateVectorInit, SuccessIndexed)
+{
+    StateVector sv;
+    CHECK_SUCCESS(StateVector::init(gIndexedConfig, sv));
+    POINTERS_EQUAL(&gElems[1], gElemIndex[0]);
+    POINTERS_EQUAL(&gElems[2], gElemIndex[1]);
+    POINTERS_EQUAL(&gElems[0], gElemIndex[2]);
+    POINTERS_EQUAL(&gRegions[1], gRegionIndex[0]);
+    POINTERS_EQUAL(&gRegions[0], gRegionIndex[1]);
+}
+
+///
+/// @test Initializing a state vector that uses the same element name twice
+/// returns an error when the config uses lookup indices.
+///
+TEST(StateVectorInit, DupeElementNameIndexed)
+{
+    // Rename element `baz` to `foo`.
+    const char* const tmp = gIndexedConfig.elems[2].name;
+    gIndexedConfig.elems[2].name = "foo";
+
+    // Creating state vector fails.
+    StateVector sv;
+    const Result res = StateVector::init(gIndexedConfig, sv);
+    gIndexedConfig.elems[2].name = tmp;
+    CHECK_ERROR(E_SV_ELEM_DUPE, res);
+
+    // State vector is uninitialized.
+    checkStateVectorUninitialized(sv);
+}
+
+///
+/// @test Initializing a state vector that uses the same region name twice
+/// returns an error when the config uses lookup indices.
+///
+TEST(StateVectorInit, DupeRegionNameIndexed)
+{
+    // Rename region `bar` to `foo`.
+    const char* const tmp = gIndexedConfig.regions[1].name;
+    gIndexedConfig.regions[1].name = "foo";
+
+    // Creating state vector fails.
+    StateVector sv;
+    const Result res = StateVector::init(gIndexedConfig, sv);
+    gIndexedConfig.regions[1].name = tmp;
+    CHECK_ERROR(E_SV_RGN_DUPE, res);
+
+    // State vector is uninitialized.
+    checkStateVectorUninitialized(sv);
+}
@@ -0,0 +1,278 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/core/utest/UTestStateVectorSnapshot.cpp
+/// @brief Unit tests for StateVectorSnapshot.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/core/StateVectorSnapshot.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+// Test state vector backing storage.
+#pragma pack(push, 1)
+static struct
+{
+    struct
+    {
+        I32 i32;
+        F64 f64;
+    } foo;
+    struct
+    {
+        bool b;
+    } bar;
+} gBacking;
+#pragma pack(pop)
+
+// Test state vector elements.
+static Element<I32> gElemI32(gBacking.foo.i32);
+static Element<F64> gElemF64(gBacking.foo.f64);
+static Element<bool> gElemBool(gBacking.bar.b);
+
+// Test state vector regions.
+static Region gRegionFoo(&gBacking.foo, sizeof(gBacking.foo));
+static Region gRegionBar(&gBacking.bar, sizeof(gBacking.bar));
+
+// Test state vector region configs.
+static StateVector::RegionConfig gRegions[] =
+{
+    {"foo", &gRegionFoo},
+    {"bar", &gRegionBar},
+    {nullptr, nullptr}
+};
+
+// Frame buffers.
+static U8 gBufs[StateVectorSnapshot::BUFFER_CNT][sizeof(gBacking)];
+
+// Snapshot config.
+static const StateVectorSnapshot::Config gConfig =
+{
+    gRegions,
+    {gBufs[0], gBufs[1], gBufs[2]},
+    sizeof(gBacking)
+};
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Unit tests for StateVectorSnapshot.
+///
+TEST_GROUP(StateVectorSnapshot)
+{
+    void setup()
+    {
+        gBacking = {};
+    }
+};
+
+///
+/// @test The consumer reads the latest published frame, and the latched frame
+/// does not change until the consumer acquires again.
+///
+TEST(StateVectorSnapshot, PublishAcquire)
+{
+    StateVectorSnapshot snap;
+    CHECK_SUCCESS(StateVectorSnapshot::init(gConfig, snap));
+    CHECK_EQUAL(sizeof(gBacking), snap.frameSizeBytes());
+
+    // No frame before first publish.
+    CHECK_ERROR(E_SVS_EMPTY, snap.acquire());
+    POINTERS_EQUAL(nullptr, snap.frame());
+    CHECK_EQUAL(0, snap.frameNumber());
+
+    // Publish frame 1 and acquire it.
+    gElemI32.write(1);
+    CHECK_SUCCESS(snap.publish());
+    CHECK_SUCCESS(snap.acquire());
+    CHECK_EQUAL(1, snap.frameNumber());
+    I32 i32 = 0;
+    CHECK_SUCCESS(snap.read(gElemI32, i32));
+    CHECK_EQUAL(1, i32);
+
+    // Publish frames 2 and 3. Latched frame is unchanged.
+    gElemI32.write(2);
+    CHECK_SUCCESS(snap.publish());
+    gElemI32.write(3);
+    gElemF64.write(1.522);
+    gElemBool.write(true);
+    CHECK_SUCCESS(snap.publish());
+    CHECK_SUCCESS(snap.read(gElemI32, i32));
+    CHECK_EQUAL(1, i32);
+
+    // Writes after the last publish are not in any frame.
+    gElemI32.write(4);
+
+    // Acquire latches the latest frame, skipping frame 2.
+    CHECK_SUCCESS(snap.acquire());
+    CHECK_EQUAL(3, snap.frameNumber());
+    CHECK_SUCCESS(snap.read(gElemI32, i32));
+    CHECK_EQUAL(3, i32);
+    F64 f64 = 0.0;
+    CHECK_SUCCESS(snap.read(gElemF64, f64));
+    CHECK_EQUAL(1.522, f64);
+    bool b = false;
+    CHECK_SUCCESS(snap.read(gElemBool, b));
+    CHECK_EQUAL(true, b);
+
+    // Acquiring again without a publish keeps the same frame.
+    CHECK_SUCCESS(snap.acquire());
+    CHECK_EQUAL(3, snap.frameNumber());
+}
+
+///
+/// @test Regions are viewed in place in the latched frame.
+///
+TEST(StateVectorSnapshot, GetRegion)
+{
+    StateVectorSnapshot snap;
+    CHECK_SUCCESS(StateVectorSnapshot::init(gConfig, snap));
+    gElemI32.write(343);
+    gElemBool.write(true);
+    CHECK_SUCCESS(snap.publish());
+    CHECK_SUCCESS(snap.acquire());
+
+    // Regions are at their backing offsets in the frame.
+    const void* addr = nullptr;
+    CHECK_SUCCESS(snap.getRegion(gRegionFoo, addr));
+    POINTERS_EQUAL(snap.frame(), addr);
+    I32 i32 = 0;
+    MemOps::memcpy(&i32, addr, sizeof(i32));
+    CHECK_EQUAL(343, i32);
+    CHECK_SUCCESS(snap.getRegion(gRegionBar, addr));
+    POINTERS_EQUAL((static_cast<const U8*>(snap.frame())
+                    + sizeof(gBacking.foo)),
+                   addr);
+    CHECK_EQUAL(true, *static_cast<const bool*>(addr));
+}
+
+///
+/// @test Accessing memory outside the state vector returns an error.
+///
+TEST(StateVectorSnapshot, ErrorKey)
+{
+    StateVectorSnapshot snap;
+    CHECK_SUCCESS(StateVectorSnapshot::init(gConfig, snap));
+    CHECK_SUCCESS(snap.publish());
+    CHECK_SUCCESS(snap.acquire());
+
+    I32 backing = 0;
+    Element<I32> elem(backing);
+    I32 val = 0;
+    CHECK_ERROR(E_SVS_KEY, snap.read(elem, val));
+
+    Region region(&backing, sizeof(backing));
+    const void* addr = nullptr;
+    CHECK_ERROR(E_SVS_KEY, snap.getRegion(region, addr));
+}
+
+///
+/// @test Reading before a frame is latched returns an error.
+///
+TEST(StateVectorSnapshot, ErrorEmpty)
+{
+    StateVectorSnapshot snap;
+    CHECK_SUCCESS(StateVectorSnapshot::init(gConfig, snap));
+    I32 val = 0;
+    CHECK_ERROR(E_SVS_EMPTY, snap.read(gElemI32, val));
+    const void* addr = nullptr;
+    CHECK_ERROR(E_SVS_EMPTY, snap.getRegion(gRegionFoo, addr));
+}
+
+///
+/// @test Using an uninitialized snapshot returns an error.
+///
+TEST(StateVectorSnapshot, ErrorUninitialized)
+{
+    StateVectorSnapshot snap;
+    CHECK_ERROR(E_SVS_UNINIT, snap.publish());
+    CHECK_ERROR(E_SVS_UNINIT, snap.acquire());
+    POINTERS_EQUAL(nullptr, snap.frame());
+}
+
+///
+/// @test Initializing a snapshot twice returns an error.
+///
+TEST(StateVectorSnapshot, ErrorReinitialize)
+{
+    StateVectorSnapshot snap;
+    CHECK_SUCCESS(StateVectorSnapshot::init(gConfig, snap));
+    CHECK_ERROR(E_SVS_REINIT, StateVectorSnapshot::init(gConfig, snap));
+}
+
+///
+/// @test Initializing a snapshot with null pointers returns an error.
+///
+TEST(StateVectorSnapshot, ErrorNull)
+{
+    StateVectorSnapshot snap;
+
+    StateVectorSnapshot::Config config = gConfig;
+    config.regions = nullptr;
+    CHECK_ERROR(E_SVS_NULL, StateVectorSnapshot::init(config, snap));
+
+    config = gConfig;
+    config.buffers[1] = nullptr;
+    CHECK_ERROR(E_SVS_NULL, StateVectorSnapshot::init(config, snap));
+
+    // Snapshot is still uninitialized.
+    CHECK_ERROR(E_SVS_UNINIT, snap.publish());
+}
+
+///
+/// @test Initializing a snapshot with buffers too small for a frame returns an
+/// error.
+///
+TEST(StateVectorSnapshot, ErrorSize)
+{
+    StateVectorSnapshot snap;
+    StateVectorSnapshot::Config config = gConfig;
+    config.bufferSizeBytes = (sizeof(gBacking) - 1);
+    CHECK_ERROR(E_SVS_SIZE, StateVectorSnapshot::init(config, snap));
+}
+
+///
+/// @test Initializing a snapshot with regions that are not contiguous in
+/// memory returns an error.
+///
+TEST(StateVectorSnapshot, ErrorLayout)
+{
+    // Regions are out of order.
+    StateVector::RegionConfig regions[] =
+    {
+        {"bar", &gRegionBar},
+        {"foo", &gRegionFoo},
+        {nullptr, nullptr}
+    };
+    StateVectorSnapshot snap;
+    StateVectorSnapshot::Config config = gConfig;
+    config.regions = regions;
+    CHECK_ERROR(E_SVS_LAYOUT, StateVectorSnapshot::init(config, snap));
+
+    // Regions have a gap between them.
+    Region regionI32(&gBacking.foo.i32, sizeof(gBacking.foo.i32));
+    regions[0] = {"i32", &regionI32};
+    regions[1] = {"bar", &gRegionBar};
+    CHECK_ERROR(E_SVS_LAYOUT, StateVectorSnapshot::init(config, snap));
+
+    // Snapshot is still uninitialized.
+    CHECK_ERROR(E_SVS_UNINIT, snap.publish());
+}
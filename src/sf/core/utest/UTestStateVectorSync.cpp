@@ -22,6 +22,7 @@
 
 #include "sf/core/Element.hpp"
 #include "sf/core/Region.hpp"
+#include "sf/core/SeqLock.hpp"
 #include "sf/pal/Clock.hpp"
 #include "sf/pal/Spinlock.hpp"
 #include "sf/pal/Thread.hpp"
@@ -76,6 +77,22 @@ static Result readRegionThread(void* kArgs)
     return static_cast<Result>(val);
 }
 
+// Number of writes done by the sequence lock writer thread.
+static constexpr I32 gSeqLockWriteCnt = 100000;
+
+// Thread which repeatedly writes a region of 2 I32s with equal values.
+static Result writeRegionPairThread(void* kArgs)
+{
+    Region* const region = reinterpret_cast<Region*>(kArgs);
+    for (I32 i = 1; i <= gSeqLockWriteCnt; ++i)
+    {
+        const I32 pair[2] = {i, i};
+        (void) region->write(pair, sizeof(pair));
+    }
+
+    return SUCCESS;
+}
+
 //////////////////////////////////// Tests /////////////////////////////////////
 
 ///
@@ -280,3 +297,38 @@ TEST(StateVectorSync, RegionReadSync)
     CHECK_SUCCESS(region.read(&val, sizeof(val)));
     CHECK_EQUAL(100, val);
 }
+
+///
+/// @test Reads of a region guarded by a sequence lock never observe a torn
+/// write, even while another thread is continuously writing the region.
+///
+TEST(StateVectorSync, RegionSeqLockConsistency)
+{
+    // Create region with sequence lock.
+    SeqLock lock;
+    I32 backing[2] = {0, 0};
+    Region region(backing, sizeof(backing), lock);
+
+    // Create thread to continuously write region.
+    Thread thread;
+    CHECK_SUCCESS(Thread::init(writeRegionPairThread,
+                               &region,
+                               Thread::REALTIME_MIN_PRI,
+                               Thread::REALTIME,
+                               1,
+                               thread));
+
+    // Read region until the writer finishes. Every read is consistent, and
+    // values never go backwards.
+    I32 last = 0;
+    while (last != gSeqLockWriteCnt)
+    {
+        I32 pair[2] = {0, 0};
+        CHECK_SUCCESS(region.read(pair, sizeof(pair)));
+        CHECK_EQUAL(pair[0], pair[1]);
+        CHECK_TRUE(pair[0] >= last);
+        last = pair[0];
+    }
+
+    CHECK_SUCCESS(thread.await(nullptr));
+}
@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/pal/AdaptiveLock.hpp
+/// @brief Platform-agnostic adaptive lock interface.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_ADAPTIVE_LOCK_HPP
+#define SF_ADAPTIVE_LOCK_HPP
+
+#include "sf/core/BasicTypes.hpp"
+#include "sf/core/Result.hpp"
+#include "sf/pal/Lock.hpp"
+
+namespace Sf
+{
+
+///
+/// @brief Lock which spins briefly on contention and then blocks in the
+/// kernel. Unlike Spinlock, a thread waiting on an AdaptiveLock held by a
+/// preempted thread does not burn its core, and the holder inherits the
+/// priority of the highest priority waiter. This prevents the unbounded
+/// priority inversion and livelock that a spinlock can cause between
+/// real-time threads sharing a core.
+///
+/// @note Linux: Implemented with a priority-inheriting futex. Uncontended
+/// acquires and releases do not enter the kernel.
+///
+/// @remark Contended throughput is far lower than with Spinlock. The kernel
+/// hands ownership directly to the woken waiter, so every contended handoff
+/// costs a context switch, and contending threads are serialized at that
+/// rate. E.g., with 8 threads contending on one core, a write/read pair took
+/// about 2.8 us with an AdaptiveLock and 91 ns with a Spinlock. Use an
+/// AdaptiveLock for bounded blocking between real-time threads, not for
+/// throughput.
+///
+class AdaptiveLock final : public ILock
+{
+public:
+
+    ///
+    /// @brief Number of times a contended acquire polls the lock before
+    /// blocking on a multicore platform. On a single core, a contended
+    /// acquire blocks immediately, since the holder cannot run and release
+    /// the lock while the caller spins.
+    ///
+    static constexpr U32 SPIN_CNT = 100;
+
+    ///
+    /// @brief Initializes an adaptive lock.
+    ///
+    /// @pre  kLock is uninitialized.
+    /// @post On success, kLock is initialized and invoking methods on it may
+    ///       succeed.
+    /// @post On error, preconditions still hold.
+    ///
+    /// @param[in] kLock  Adaptive lock to initialize.
+    ///
+    /// @retval SUCCESS       Successfully initialized lock.
+    /// @retval E_ALK_REINIT  Lock is already initialized.
+    ///
+    static Result init(AdaptiveLock& kLock);
+
+    ///
+    /// @brief Default constructor.
+    ///
+    /// @post The constructed AdaptiveLock is uninitialized and invoking any of
+    /// its methods returns an error.
+    ///
+    AdaptiveLock();
+
+    ///
+    /// @brief Acquires the lock. If another thread holds the lock, the calling
+    /// thread spins up to SPIN_CNT times on a multicore platform and then
+    /// blocks until the lock is available.
+    ///
+    /// @retval SUCCESS       Successfully acquired lock.
+    /// @retval E_ALK_UNINIT  Lock is uninitialized.
+    /// @retval E_ALK_ACQ     Failed to acquire lock. This usually indicates
+    ///                       that the calling thread already holds the lock,
+    ///                       or the underlying platform API failed in some
+    ///                       way.
+    ///
+    Result acquire() final override;
+
+    ///
+    /// @brief Releases the lock, waking the highest priority waiter if any.
+    ///
+    /// @retval SUCCESS       Successfully released lock.
+    /// @retval E_ALK_UNINIT  Lock is uninitialized.
+    /// @retval E_ALK_REL     Failed to release lock. This usually indicates
+    ///                       the lock was not held by the calling thread, or
+    ///                       the underlying platform API failed in some way.
+    ///
+    Result release() final override;
+
+    AdaptiveLock(const AdaptiveLock&) = delete;
+    AdaptiveLock(AdaptiveLock&&) = delete;
+    AdaptiveLock& operator=(const AdaptiveLock&) = delete;
+    AdaptiveLock& operator=(AdaptiveLock&&) = delete;
+
+private:
+
+    ///
+    /// @brief Whether the lock is initialized.
+    ///
+    bool mInit;
+
+#ifdef SF_PLATFORM_LINUX
+
+    ///
+    /// @brief Futex word. Contains the thread ID of the holder, or 0 if the
+    /// lock is free, plus a kernel-managed bit indicating there are waiters.
+    ///
+    U32 mFutex;
+
+    ///
+    /// @brief Number of times a contended acquire polls the lock before
+    /// blocking. SPIN_CNT on a multicore platform, and 0 otherwise.
+    ///
+    U32 mSpinCnt;
+
+#endif
+};
+
+} // namespace Sf
+
+#endif
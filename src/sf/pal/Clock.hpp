@@ -24,6 +24,10 @@
 #ifndef SF_CLOCK_HPP
 #define SF_CLOCK_HPP
 
+#ifdef SF_PLATFORM_LINUX
+#    include <time.h>
+#endif
+
 #include "sf/core/BasicTypes.hpp"
 
 namespace Sf
@@ -57,27 +61,71 @@ namespace Clock
     ///
     constexpr U64 NO_TIME = 0xFFFFFFFFFFFFFFFF;
 
+#ifdef SF_PLATFORM_LINUX
+    ///
+    /// @brief Linux clock used by Clock::nanoTime() and Clock::sleepUntil().
+    ///
+    /// By default this is CLOCK_MONOTONIC, which never jumps; NTP may only
+    /// slew its rate. This keeps time values monotonic for consumers like
+    /// StateMachine, which rejects global times that do not increase. Defining
+    /// SF_CLOCK_REALTIME selects CLOCK_REALTIME instead, which yields wall
+    /// clock time but may jump backwards when the system clock is set.
+    ///
+    /// @note CLOCK_MONOTONIC_RAW is not used because clock_nanosleep() does
+    /// not support it, and it is not read through the vDSO on older kernels.
+    ///
+#    ifdef SF_CLOCK_REALTIME
+    constexpr clockid_t LINUX_CLOCK_ID = CLOCK_REALTIME;
+#    else
+    constexpr clockid_t LINUX_CLOCK_ID = CLOCK_MONOTONIC;
+#    endif
+#endif
+
     ///
     /// @brief Gets the system clock time in nanoseconds.
     ///
-    /// @warning Linux: The real-time system clock is used so that time values
-    /// reflect adjustments made by sync protocols like NTP. This means that
-    /// time may not be monotonic if the real-time clock is adjusted between
-    /// calls to Clock::nanoTime(). Care should also be taken that the system
-    /// does not automatically adjust the real-time clock, e.g., for Daylight
-    /// Saving Time.
-    ///
-    /// @note Linux: The Linux implementation of this function uses
-    /// clock_gettime(). Since Clock::nanoTime() cannot surface errors, the
-    /// return value of clock_gettime() is disregarded. Errors are not expected;
-    /// EFAULT cannot occur since the timespec pointer passed to the function
-    /// is always valid, and EINVAL cannot occur since CLOCK_REALTIME should
-    /// always be a valid clock ID. If by some chance clock_gettime() does fail,
-    /// Clock::nanoTime() returns 0.
+    /// @note Linux: The clock read is Clock::LINUX_CLOCK_ID, which is
+    /// monotonic by default. Monotonic time counts from an arbitrary point
+    /// (usually boot), so it is only meaningful relative to other time values.
+    ///
+    /// @note Linux: This function is inline and uses clock_gettime(), which
+    /// the vDSO services in userspace without a system call. Since
+    /// Clock::nanoTime() cannot surface errors, the return value of
+    /// clock_gettime() is disregarded. Errors are not expected; EFAULT cannot
+    /// occur since the timespec pointer passed to the function is always
+    /// valid, and EINVAL cannot occur since the clock ID is always valid. If by
+    /// some chance clock_gettime() does fail, Clock::nanoTime() returns 0.
     ///
     /// @return System time in nanoseconds.
     ///
+#ifdef SF_PLATFORM_LINUX
+    inline U64 nanoTime()
+    {
+        timespec ts = {0, 0};
+        (void) clock_gettime(LINUX_CLOCK_ID, &ts);
+        return ((static_cast<U64>(ts.tv_sec) * NS_IN_S)
+                + static_cast<U64>(ts.tv_nsec));
+    }
+#else
     U64 nanoTime();
+#endif
+
+    ///
+    /// @brief Sleeps until the system clock reaches an absolute time. Returns
+    /// immediately if the time has already passed. Unlike sleeping for a
+    /// relative duration, sleeping until successive absolute deadlines does
+    /// not accumulate drift in periodic loops.
+    ///
+    /// @note Linux: The Linux implementation uses clock_nanosleep() with
+    /// TIMER_ABSTIME on the same clock as Clock::nanoTime(), and resumes the
+    /// sleep if interrupted by a signal. Periodic loops should prefer this to
+    /// Clock::spinWait(), which burns the CPU for the entire wait.
+    ///
+    /// @note Arduino: The Arduino implementation spinwaits.
+    ///
+    /// @param[in] kNs  System time in nanoseconds to sleep until.
+    ///
+    void sleepUntil(const U64 kNs);
 
     ///
     /// @brief Spinwaits until some number of nanoseconds have passed according
@@ -65,6 +65,25 @@ public:
         UDP = 0 ///< UDP/IP
     };
 
+    ///
+    /// @brief A datagram sent or received by a batch operation.
+    ///
+    struct Datagram final
+    {
+        Ipv4Address ip;   ///< Destination IP if sending, source IP if receiving
+        U16 port;         ///< Destination port if sending, source port if
+                          ///< receiving
+        void* buf;        ///< Data to send, or buffer to receive into
+        U32 numBytes;     ///< Size of data to send, or size of buffer
+        U32 numBytesXfer; ///< Set to number of bytes sent or received
+    };
+
+    ///
+    /// @brief Maximum number of datagrams transferred by one underlying
+    /// platform call in a batch operation. Larger batches are split.
+    ///
+    static constexpr U32 MAX_BATCH = 64;
+
     ///
     /// @brief Initializes a socket.
     ///
@@ -188,6 +207,61 @@ public:
                 const U32 kNumBytes,
                 U32* const kNumBytesRecvd);
 
+    ///
+    /// @brief Sends a batch of datagrams, each to its own address.
+    ///
+    /// @note Linux: The Linux implementation uses sendmmsg() to send up to
+    /// Socket::MAX_BATCH datagrams per system call, rather than 1 system call
+    /// per datagram as with Socket::send().
+    ///
+    /// @param[in, out] kDgrams     Datagrams to send. On return, the
+    ///                             numBytesXfer of each sent datagram is set.
+    /// @param[in]      kNumDgrams  Number of datagrams to send. If 0, returns
+    ///                             immediately, and kDgrams may be null.
+    /// @param[out]     kNumSent    Set to the number of datagrams sent, which
+    ///                             are always the first kNumSent datagrams.
+    ///                             On error, this may be less than kNumDgrams.
+    ///
+    /// @retval SUCCESS       Successfully sent all datagrams.
+    /// @retval E_SOK_UNINIT  Socket is uninitialized.
+    /// @retval E_SOK_NULL    kDgrams is null or a datagram buffer is null,
+    ///                       and kNumDgrams is nonzero.
+    /// @retval E_SOK_SEND    Send failed.
+    ///
+    Result sendBatch(Datagram* const kDgrams,
+                     const U32 kNumDgrams,
+                     U32& kNumSent);
+
+    ///
+    /// @brief Receives a batch of datagrams addressed to the socket from any
+    /// address. Blocks until at least 1 datagram is received, then receives
+    /// any others already waiting without blocking, up to kNumDgrams.
+    ///
+    /// @note Linux: The Linux implementation uses recvmmsg() to receive up to
+    /// Socket::MAX_BATCH datagrams per system call. As with Socket::recv(),
+    /// the numBytesXfer of a datagram larger than its buffer is the full
+    /// datagram size, and the datagram is truncated to fit the buffer.
+    ///
+    /// @param[in, out] kDgrams     Datagram buffers to receive into. On
+    ///                             return, the source address, port, and
+    ///                             numBytesXfer of each received datagram are
+    ///                             set.
+    /// @param[in]      kNumDgrams  Number of datagram buffers. If 0, returns
+    ///                             immediately, and kDgrams may be null.
+    /// @param[out]     kNumRecvd   Set to the number of datagrams received,
+    ///                             which are always the first kNumRecvd
+    ///                             datagrams.
+    ///
+    /// @retval SUCCESS       Successfully received datagrams.
+    /// @retval E_SOK_UNINIT  Socket is uninitialized.
+    /// @retval E_SOK_NULL    kDgrams is null or a datagram buffer is null,
+    ///                       and kNumDgrams is nonzero.
+    /// @retval E_SOK_RECV    Receive failed.
+    ///
+    Result recvBatch(Datagram* const kDgrams,
+                     const U32 kNumDgrams,
+                     U32& kNumRecvd);
+
     ///
     /// @brief Closes the socket, releasing any acquired resources. The Socket
     /// may be initialized again afterwards.
@@ -204,6 +278,8 @@ public:
 
 private:
 
+    friend class SocketPoller;
+
     ///
     /// @brief Whether the socket is initialized.
     ///
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/pal/SocketPoller.hpp
+/// @brief Platform-agnostic interface for waiting on many sockets.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SF_SOCKET_POLLER_HPP
+#define SF_SOCKET_POLLER_HPP
+
+#include "sf/core/BasicTypes.hpp"
+#include "sf/core/Result.hpp"
+#include "sf/pal/Socket.hpp"
+
+namespace Sf
+{
+
+///
+/// @brief Waits for any of a registered set of sockets to have data available.
+///
+/// Unlike Socket::select(), which takes the full socket array on every call,
+/// a SocketPoller is given its sockets once and the cost of a wait scales with
+/// the number of ready sockets rather than the number of registered sockets.
+/// This suits applications that service many sockets each cycle.
+///
+/// @note Linux: Implemented with epoll. Closing a registered socket removes
+/// it from the poller.
+///
+class SocketPoller final
+{
+public:
+
+    ///
+    /// @brief Initializes a socket poller with no sockets.
+    ///
+    /// @pre  kPoller is uninitialized.
+    /// @post On success, kPoller is initialized and invoking methods on it may
+    ///       succeed.
+    /// @post On error, preconditions still hold.
+    ///
+    /// @param[in] kPoller  Poller to initialize.
+    ///
+    /// @retval SUCCESS       Successfully initialized poller.
+    /// @retval E_SKP_REINIT  Poller is already initialized.
+    /// @retval E_SKP_CREATE  Failed to create underlying poller.
+    ///
+    static Result init(SocketPoller& kPoller);
+
+    ///
+    /// @brief Default constructor.
+    ///
+    /// @post The constructed SocketPoller is uninitialized and invoking any of
+    /// its methods returns an error.
+    ///
+    SocketPoller();
+
+    ///
+    /// @brief Destructor.
+    ///
+    /// @post If the SocketPoller was initialized, the underlying poller was
+    /// closed.
+    ///
+    ~SocketPoller();
+
+    ///
+    /// @brief Registers a socket with the poller.
+    ///
+    /// @param[in] kSock  Socket to register. The socket must outlive its
+    ///                   registration.
+    ///
+    /// @retval SUCCESS       Successfully registered socket.
+    /// @retval E_SKP_UNINIT  Poller is uninitialized.
+    /// @retval E_SOK_UNINIT  Socket is uninitialized.
+    /// @retval E_SKP_CTL     Failed to register socket, e.g., because it is
+    ///                       already registered.
+    ///
+    Result add(Socket& kSock);
+
+    ///
+    /// @brief Unregisters a socket from the poller.
+    ///
+    /// @param[in] kSock  Socket to unregister.
+    ///
+    /// @retval SUCCESS       Successfully unregistered socket.
+    /// @retval E_SKP_UNINIT  Poller is uninitialized.
+    /// @retval E_SOK_UNINIT  Socket is uninitialized.
+    /// @retval E_SKP_CTL     Failed to unregister socket, e.g., because it is
+    ///                       not registered.
+    ///
+    Result remove(Socket& kSock);
+
+    ///
+    /// @brief Waits for registered sockets to have data available with a
+    /// timeout, returning once at least one socket is ready or the timeout
+    /// expires.
+    ///
+    /// @note Linux: The timeout is rounded up to the nearest millisecond. A
+    /// wait interrupted by a signal returns success with no ready sockets.
+    ///
+    /// @param[out] kReady      Array to fill with ready sockets.
+    /// @param[in]  kMaxReady   Size of kReady. If more sockets are ready, the
+    ///                         rest are returned by the next wait.
+    /// @param[in]  kTimeoutUs  Timeout in microseconds. A timeout of 0 will
+    ///                         poll.
+    /// @param[out] kNumReady   Set to the number of ready sockets written to
+    ///                         kReady, or 0 on timeout.
+    ///
+    /// @retval SUCCESS       Wait successful. This does not necessarily mean
+    ///                       a socket became ready.
+    /// @retval E_SKP_UNINIT  Poller is uninitialized.
+    /// @retval E_SKP_NULL    kReady is null.
+    /// @retval E_SKP_EMPTY   kMaxReady is 0.
+    /// @retval E_SKP_WAIT    Failed to wait on underlying poller.
+    ///
+    Result wait(Socket** const kReady,
+                const U32 kMaxReady,
+                const U32 kTimeoutUs,
+                U32& kNumReady);
+
+    ///
+    /// @brief Closes the poller, releasing any acquired resources. Registered
+    /// sockets are unaffected. The SocketPoller may be initialized again
+    /// afterwards.
+    ///
+    /// @retval SUCCESS       Successfully closed.
+    /// @retval E_SKP_UNINIT  Poller is uninitialized.
+    /// @retval E_SKP_CLOSE   Failed to close underlying poller.
+    ///
+    Result close();
+
+    SocketPoller(const SocketPoller&) = delete;
+    SocketPoller(SocketPoller&&) = delete;
+    SocketPoller& operator=(const SocketPoller&) = delete;
+    SocketPoller& operator=(SocketPoller&&) = delete;
+
+private:
+
+    ///
+    /// @brief Whether the poller is initialized.
+    ///
+    bool mInit;
+
+#ifdef SF_PLATFORM_LINUX
+
+    ///
+    /// @brief epoll file descriptor.
+    ///
+    I32 mFd;
+
+#endif
+};
+
+} // namespace Sf
+
+#endif
@@ -0,0 +1,237 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/pal/utest/UTestAdaptiveLock.cpp
+/// @brief Unit tests for AdaptiveLock.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "UTestThreadCommon.hpp"
+#include "sf/pal/Clock.hpp"
+#include "sf/pal/AdaptiveLock.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Test thread arguments.
+///
+struct LockThreadArgs
+{
+    AdaptiveLock lock; ///< Lock protecting counter access.
+    U64 increments;    ///< Number of times to increment counter.
+    U64 counter;       ///< Counter.
+};
+
+///
+/// @brief Thread that atomically increments a counter some number of times.
+///
+/// @param[in] kArgs  Thread arguments.
+///
+/// @retval SUCCESS  Successfully incremented.
+/// @retval [other]  Error from acquiring or releasing adaptive lock.
+///
+static Result atomicIncrement(void* kArgs)
+{
+    LockThreadArgs* const args = static_cast<LockThreadArgs*>(kArgs);
+
+    for (U64 i = 0; i < args->increments; ++i)
+    {
+        // Acquire lock.
+        Result lockRes = args->lock.acquire();
+        if (lockRes != SUCCESS)
+        {
+            return lockRes;
+        }
+
+        ++args->counter;
+
+        // Release lock.
+        lockRes = args->lock.release();
+        if (lockRes != SUCCESS)
+        {
+            return lockRes;
+        }
+    }
+
+    return SUCCESS;
+}
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Unit tests for AdaptiveLock.
+///
+TEST_GROUP(AdaptiveLock)
+{
+    void teardown()
+    {
+        threadTestTeardown();
+    }
+};
+
+///
+/// @test Acquiring or releasing an uninitialized adaptive lock returns an
+/// error.
+///
+TEST(AdaptiveLock, Uninitialized)
+{
+    AdaptiveLock lock;
+    CHECK_ERROR(E_ALK_UNINIT, lock.acquire());
+    CHECK_ERROR(E_ALK_UNINIT, lock.release());
+}
+
+///
+/// @test Initializing an adaptive lock twice returns an error.
+///
+TEST(AdaptiveLock, ErrorReinitialize)
+{
+    AdaptiveLock lock;
+    CHECK_SUCCESS(AdaptiveLock::init(lock));
+    CHECK_ERROR(E_ALK_REINIT, AdaptiveLock::init(lock));
+}
+
+///
+/// @test Acquiring an adaptive lock already held by the calling thread returns
+/// an error instead of deadlocking.
+///
+TEST(AdaptiveLock, ErrorRecursiveAcquire)
+{
+    AdaptiveLock lock;
+    CHECK_SUCCESS(AdaptiveLock::init(lock));
+    CHECK_SUCCESS(lock.acquire());
+    CHECK_ERROR(E_ALK_ACQ, lock.acquire());
+
+    // Lock is still held and can be released normally.
+    CHECK_SUCCESS(lock.release());
+    CHECK_SUCCESS(lock.acquire());
+    CHECK_SUCCESS(lock.release());
+}
+
+///
+/// @test Releasing an adaptive lock not held by the calling thread returns an
+/// error.
+///
+TEST(AdaptiveLock, ErrorReleaseNotHeld)
+{
+    AdaptiveLock lock;
+    CHECK_SUCCESS(AdaptiveLock::init(lock));
+    CHECK_ERROR(E_ALK_REL, lock.release());
+
+    // Lock is still usable.
+    CHECK_SUCCESS(lock.acquire());
+    CHECK_SUCCESS(lock.release());
+}
+
+///
+/// @test AdaptiveLock provides mutual exclusion.
+///
+TEST(AdaptiveLock, MutualExclusion)
+{
+    // Thread will increment the counter once.
+    LockThreadArgs args{};
+    args.increments = 1;
+
+    // Create adaptive lock and acquire it.
+    CHECK_SUCCESS(AdaptiveLock::init(args.lock));
+    CHECK_SUCCESS(args.lock.acquire());
+
+    // Create thread to increment counter. It will block on the lock without
+    // incrementing the counter since the unit test thread holds the lock.
+    CHECK_SUCCESS(Thread::init(atomicIncrement,
+                               &args,
+                               Thread::REALTIME_MIN_PRI,
+                               Thread::Policy::REALTIME,
+                               0,
+                               gTestThreads[0]));
+
+    // Wait a relatively long time to avoid racing thread creation.
+    Clock::spinWait(0.1 * Clock::NS_IN_S);
+
+    // Counter is still 0.
+    CHECK_EQUAL(0, args.counter);
+
+    // Release lock.
+    CHECK_SUCCESS(args.lock.release());
+
+    // Wait for thread to finish.
+    Result threadRes = -1;
+    CHECK_SUCCESS(gTestThreads[0].await(&threadRes));
+    CHECK_SUCCESS(threadRes);
+
+    // Counter is now 1.
+    CHECK_EQUAL(1, args.counter);
+}
+
+///
+/// @test Updates made atomic via an adaptive lock around a contended critical
+/// section.
+///
+/// @note This test is only valid if the platform is multicore, so that
+/// real-time threads can contend for the counter. It is skipped on a single
+/// core, where every handoff of the lock costs a context switch and the test
+/// would starve the machine for minutes.
+///
+TEST(AdaptiveLock, AtomicUpdates)
+{
+    if (Thread::numCores() == 1)
+    {
+        return;
+    }
+
+    // Each thread will increment the counter 10000 times. This is fewer than
+    // in the Spinlock test since a contended handoff is a futex round trip.
+    LockThreadArgs args{};
+    args.increments = 10000;
+
+    // Create adaptive lock and acquire it.
+    CHECK_SUCCESS(AdaptiveLock::init(args.lock));
+    CHECK_SUCCESS(args.lock.acquire());
+
+    // Create threads. They will block on the lock without updating the counter
+    // since the unit test thread holds the lock. Threads are spread out across
+    // cores to maximize contention of the counter.
+    for (U32 i = 0; i < gTestMaxThreads; ++i)
+    {
+        CHECK_SUCCESS(Thread::init(atomicIncrement,
+                                   &args,
+                                   Thread::REALTIME_MIN_PRI,
+                                   Thread::Policy::REALTIME,
+                                   (i % Thread::numCores()),
+                                   gTestThreads[i]));
+    }
+
+    // Wait a relatively long time to avoid racing thread creation.
+    Clock::spinWait(0.1 * Clock::NS_IN_S);
+
+    // At this point no threads have run, so the counter is still 0.
+    CHECK_EQUAL(0, args.counter);
+
+    // Release threads.
+    CHECK_SUCCESS(args.lock.release());
+
+    // Wait for threads to finish.
+    for (U32 i = 0; i < gTestMaxThreads; ++i)
+    {
+        CHECK_SUCCESS(gTestThreads[i].await(nullptr));
+    }
+
+    // Counter had no lost updates.
+    const U64 expectCounter = (gTestMaxThreads * args.increments);
+    CHECK_EQUAL(expectCounter, args.counter);
+}
@@ -75,3 +75,18 @@ TEST(Clock, MonotonicNanoTime)
         lastTimeNs = curTimeNs;
     }
 }
+
+///
+/// @test Clock::sleepUntil() returns no earlier than the requested time, and
+/// returns immediately for a time in the past.
+///
+TEST(Clock, SleepUntil)
+{
+    const U64 wakeNs = (Clock::nanoTime() + (10 * Clock::NS_IN_S / 1000));
+    Clock::sleepUntil(wakeNs);
+    CHECK_TRUE(Clock::nanoTime() >= wakeNs);
+
+    const U64 startNs = Clock::nanoTime();
+    Clock::sleepUntil(startNs - Clock::NS_IN_S);
+    CHECK_TRUE((Clock::nanoTime() - startNs) < (Clock::NS_IN_S / 10));
+}
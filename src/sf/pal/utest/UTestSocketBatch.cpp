@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/pal/utest/UTestSocketBatch.cpp
+/// @brief Unit tests for Socket::sendBatch() and Socket::recvBatch().
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/pal/Socket.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+// IPs used by test sockets.
+static const Ipv4Address gTestIp1 = {127, 0, 0, 1};
+static const Ipv4Address gTestIp2 = {127, 0, 0, 2};
+
+// Port used by all test sockets.
+static const U16 gTestPort = 7798;
+
+// Number of datagrams sent by tests, chosen to span multiple batches.
+static constexpr U32 gDgramCnt = ((2 * Socket::MAX_BATCH) + 3);
+
+// Test sockets.
+static Socket gSock1;
+static Socket gSock2;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Points each datagram at its own U64 buffer and addresses it to
+/// socket 2.
+///
+/// @param[out] kDgrams  Datagrams to set up.
+/// @param[in]  kBufs    Datagram buffers.
+/// @param[in]  kCnt     Number of datagrams.
+///
+static void makeDatagrams(Socket::Datagram* const kDgrams,
+                          U64* const kBufs,
+                          const U32 kCnt)
+{
+    for (U32 i = 0; i < kCnt; ++i)
+    {
+        kDgrams[i] = {gTestIp2, gTestPort, &kBufs[i], sizeof(kBufs[i]), 0};
+    }
+}
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Unit tests for Socket::sendBatch() and Socket::recvBatch().
+///
+TEST_GROUP(SocketBatch)
+{
+    void setup()
+    {
+        CHECK_SUCCESS(Socket::init(gTestIp1, gTestPort, Socket::UDP, gSock1));
+        CHECK_SUCCESS(Socket::init(gTestIp2, gTestPort, Socket::UDP, gSock2));
+    }
+
+    void teardown()
+    {
+        // Close test sockets.
+        (void) gSock1.close();
+        (void) gSock2.close();
+    }
+};
+
+///
+/// @test A batch larger than Socket::MAX_BATCH is sent and received in order
+/// with correct sizes and source addresses.
+///
+TEST(SocketBatch, SendAndRecv)
+{
+    U64 sendBufs[gDgramCnt];
+    Socket::Datagram sendDgrams[gDgramCnt];
+    for (U32 i = 0; i < gDgramCnt; ++i)
+    {
+        sendBufs[i] = i;
+    }
+    makeDatagrams(sendDgrams, sendBufs, gDgramCnt);
+    U32 numSent = 0;
+    CHECK_SUCCESS(gSock1.sendBatch(sendDgrams, gDgramCnt, numSent));
+    CHECK_EQUAL(gDgramCnt, numSent);
+    for (U32 i = 0; i < gDgramCnt; ++i)
+    {
+        CHECK_EQUAL(sizeof(U64), sendDgrams[i].numBytesXfer);
+    }
+
+    // Receive until all datagrams arrive. Loopback delivers them all before
+    // sendBatch() returns, so this should take 1 call.
+    U64 recvBufs[gDgramCnt] = {};
+    Socket::Datagram recvDgrams[gDgramCnt];
+    makeDatagrams(recvDgrams, recvBufs, gDgramCnt);
+    U32 numRecvd = 0;
+    while (numRecvd < gDgramCnt)
+    {
+        U32 n = 0;
+        CHECK_SUCCESS(gSock2.recvBatch(&recvDgrams[numRecvd],
+                                       (gDgramCnt - numRecvd),
+                                       n));
+        CHECK_TRUE(n > 0);
+        numRecvd += n;
+    }
+
+    for (U32 i = 0; i < gDgramCnt; ++i)
+    {
+        CHECK_EQUAL(i, recvBufs[i]);
+        CHECK_EQUAL(sizeof(U64), recvDgrams[i].numBytesXfer);
+        CHECK_EQUAL(gTestIp1.oct1, recvDgrams[i].ip.oct1);
+        CHECK_EQUAL(gTestIp1.oct2, recvDgrams[i].ip.oct2);
+        CHECK_EQUAL(gTestIp1.oct3, recvDgrams[i].ip.oct3);
+        CHECK_EQUAL(gTestIp1.oct4, recvDgrams[i].ip.oct4);
+        CHECK_EQUAL(gTestPort, recvDgrams[i].port);
+    }
+}
+
+///
+/// @test Receiving a batch returns the datagrams already waiting without
+/// blocking for the full batch.
+///
+TEST(SocketBatch, RecvReturnsWaitingDatagrams)
+{
+    U64 sendBufs[3] = {1, 2, 3};
+    Socket::Datagram sendDgrams[3];
+    makeDatagrams(sendDgrams, sendBufs, 3);
+    U32 numSent = 0;
+    CHECK_SUCCESS(gSock1.sendBatch(sendDgrams, 3, numSent));
+    CHECK_EQUAL(3, numSent);
+
+    U64 recvBufs[10] = {};
+    Socket::Datagram recvDgrams[10];
+    makeDatagrams(recvDgrams, recvBufs, 10);
+    U32 numRecvd = 0;
+    CHECK_SUCCESS(gSock2.recvBatch(recvDgrams, 10, numRecvd));
+    CHECK_EQUAL(3, numRecvd);
+    CHECK_EQUAL(1, recvBufs[0]);
+    CHECK_EQUAL(2, recvBufs[1]);
+    CHECK_EQUAL(3, recvBufs[2]);
+}
+
+///
+/// @test A datagram larger than its receive buffer is truncated, and its full
+/// size is reported.
+///
+TEST(SocketBatch, RecvTruncated)
+{
+    U64 sendBuf = 0x0102030405060708;
+    Socket::Datagram sendDgram;
+    makeDatagrams(&sendDgram, &sendBuf, 1);
+    U32 numSent = 0;
+    CHECK_SUCCESS(gSock1.sendBatch(&sendDgram, 1, numSent));
+
+    U32 recvBuf = 0;
+    Socket::Datagram recvDgram = {gTestIp1, 0, &recvBuf, sizeof(recvBuf), 0};
+    U32 numRecvd = 0;
+    CHECK_SUCCESS(gSock2.recvBatch(&recvDgram, 1, numRecvd));
+    CHECK_EQUAL(1, numRecvd);
+    CHECK_EQUAL(sizeof(U64), recvDgram.numBytesXfer);
+}
+
+///
+/// @test Receiving a batch of 0 datagrams returns immediately.
+///
+TEST(SocketBatch, RecvEmpty)
+{
+    U64 buf = 0;
+    Socket::Datagram dgram;
+    makeDatagrams(&dgram, &buf, 1);
+    U32 numRecvd = 1;
+    CHECK_SUCCESS(gSock2.recvBatch(&dgram, 0, numRecvd));
+    CHECK_EQUAL(0, numRecvd);
+}
+
+///
+/// @test Batch operations on 0 datagrams return immediately without checking
+/// the datagram array, even if it is null.
+///
+TEST(SocketBatch, EmptyNull)
+{
+    U32 n = 1;
+    CHECK_SUCCESS(gSock1.sendBatch(nullptr, 0, n));
+    CHECK_EQUAL(0, n);
+    n = 1;
+    CHECK_SUCCESS(gSock2.recvBatch(nullptr, 0, n));
+    CHECK_EQUAL(0, n);
+}
+
+///
+/// @test Batch operations on a null datagram array or null buffer return an
+/// error.
+///
+TEST(SocketBatch, ErrorNull)
+{
+    U32 n = 0;
+    CHECK_ERROR(E_SOK_NULL, gSock1.sendBatch(nullptr, 1, n));
+    CHECK_ERROR(E_SOK_NULL, gSock2.recvBatch(nullptr, 1, n));
+
+    U64 bufs[2] = {};
+    Socket::Datagram dgrams[2];
+    makeDatagrams(dgrams, bufs, 2);
+    dgrams[1].buf = nullptr;
+    CHECK_ERROR(E_SOK_NULL, gSock1.sendBatch(dgrams, 2, n));
+    CHECK_EQUAL(0, n);
+    CHECK_ERROR(E_SOK_NULL, gSock2.recvBatch(dgrams, 2, n));
+    CHECK_EQUAL(0, n);
+}
@@ -0,0 +1,241 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/pal/utest/UTestSocketPoller.cpp
+/// @brief Unit tests for SocketPoller.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sf/pal/Clock.hpp"
+#include "sf/pal/SocketPoller.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+// IPs used by test sockets.
+static const Ipv4Address gTestIp1 = {127, 0, 0, 1};
+static const Ipv4Address gTestIp2 = {127, 0, 0, 2};
+static const Ipv4Address gTestIp3 = {127, 0, 0, 3};
+static const Ipv4Address gTestIp4 = {127, 0, 0, 4};
+
+// Port used by all test sockets.
+static const U16 gTestPort = 7799;
+
+// Test sockets.
+static Socket gSock1;
+static Socket gSock2;
+static Socket gSock3;
+static Socket gSock4;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Sends a message from socket 4 to an address.
+///
+/// @param[in] kIp  Destination IP.
+///
+static void sendTo(const Ipv4Address kIp)
+{
+    const U64 msg = 0;
+    CHECK_SUCCESS(gSock4.send(kIp, gTestPort, &msg, sizeof(msg), nullptr));
+}
+
+///
+/// @brief Checks whether a socket is in a ready array.
+///
+/// @param[in] kReady     Ready array.
+/// @param[in] kNumReady  Number of ready sockets.
+/// @param[in] kSock      Socket to look for.
+///
+/// @returns Whether the socket is in the array.
+///
+static bool isReady(Socket* const* const kReady,
+                    const U32 kNumReady,
+                    const Socket* const kSock)
+{
+    for (U32 i = 0; i < kNumReady; ++i)
+    {
+        if (kReady[i] == kSock)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Unit tests for SocketPoller.
+///
+TEST_GROUP(SocketPoller)
+{
+    SocketPoller poller;
+
+    void setup()
+    {
+        CHECK_SUCCESS(Socket::init(gTestIp1, gTestPort, Socket::UDP, gSock1));
+        CHECK_SUCCESS(Socket::init(gTestIp2, gTestPort, Socket::UDP, gSock2));
+        CHECK_SUCCESS(Socket::init(gTestIp3, gTestPort, Socket::UDP, gSock3));
+        CHECK_SUCCESS(Socket::init(gTestIp4, gTestPort, Socket::UDP, gSock4));
+        CHECK_SUCCESS(SocketPoller::init(poller));
+        CHECK_SUCCESS(poller.add(gSock1));
+        CHECK_SUCCESS(poller.add(gSock2));
+        CHECK_SUCCESS(poller.add(gSock3));
+    }
+
+    void teardown()
+    {
+        // Close test sockets.
+        (void) gSock1.close();
+        (void) gSock2.close();
+        (void) gSock3.close();
+        (void) gSock4.close();
+    }
+};
+
+///
+/// @test Only sockets with data available are returned.
+///
+TEST(SocketPoller, ReadySockets)
+{
+    sendTo(gTestIp1);
+    sendTo(gTestIp3);
+
+    Socket* ready[4] = {};
+    U32 numReady = 0;
+    CHECK_SUCCESS(poller.wait(ready, 4, 100000, numReady));
+    CHECK_EQUAL(2, numReady);
+    CHECK_TRUE(isReady(ready, numReady, &gSock1));
+    CHECK_TRUE(isReady(ready, numReady, &gSock3));
+
+    // Reading a socket's data makes it no longer ready.
+    U64 buf = 0;
+    CHECK_SUCCESS(gSock1.recv(&buf, sizeof(buf), nullptr));
+    CHECK_SUCCESS(poller.wait(ready, 4, 0, numReady));
+    CHECK_EQUAL(1, numReady);
+    CHECK_TRUE(ready[0] == &gSock3);
+}
+
+///
+/// @test Waiting with no data available times out after at least the timeout.
+///
+TEST(SocketPoller, Timeout)
+{
+    Socket* ready[4] = {};
+    U32 numReady = 1;
+    const U64 startNs = Clock::nanoTime();
+    CHECK_SUCCESS(poller.wait(ready, 4, 1500, numReady));
+    CHECK_EQUAL(0, numReady);
+    CHECK_TRUE((Clock::nanoTime() - startNs) >= (1500 * 1000));
+}
+
+///
+/// @test At most the ready array size of sockets are returned by a wait.
+///
+TEST(SocketPoller, MaxReady)
+{
+    sendTo(gTestIp1);
+    sendTo(gTestIp2);
+    sendTo(gTestIp3);
+
+    Socket* ready[1] = {};
+    U32 numReady = 0;
+    CHECK_SUCCESS(poller.wait(ready, 1, 100000, numReady));
+    CHECK_EQUAL(1, numReady);
+}
+
+///
+/// @test A removed socket is not returned by waits.
+///
+TEST(SocketPoller, Remove)
+{
+    CHECK_SUCCESS(poller.remove(gSock1));
+    sendTo(gTestIp1);
+
+    Socket* ready[4] = {};
+    U32 numReady = 1;
+    CHECK_SUCCESS(poller.wait(ready, 4, 1000, numReady));
+    CHECK_EQUAL(0, numReady);
+}
+
+///
+/// @test Invoking methods on an uninitialized poller returns an error.
+///
+TEST(SocketPoller, ErrorUninitialized)
+{
+    SocketPoller uninitPoller;
+    Socket* ready[1] = {};
+    U32 numReady = 0;
+    CHECK_ERROR(E_SKP_UNINIT, uninitPoller.add(gSock1));
+    CHECK_ERROR(E_SKP_UNINIT, uninitPoller.remove(gSock1));
+    CHECK_ERROR(E_SKP_UNINIT, uninitPoller.wait(ready, 1, 0, numReady));
+    CHECK_ERROR(E_SKP_UNINIT, uninitPoller.close());
+}
+
+///
+/// @test Initializing a poller twice returns an error.
+///
+TEST(SocketPoller, ErrorReinitialize)
+{
+    CHECK_ERROR(E_SKP_REINIT, SocketPoller::init(poller));
+}
+
+///
+/// @test A poller can be closed and initialized again.
+///
+TEST(SocketPoller, CloseAndReuse)
+{
+    CHECK_SUCCESS(poller.close());
+    CHECK_ERROR(E_SKP_UNINIT, poller.close());
+    CHECK_SUCCESS(SocketPoller::init(poller));
+    CHECK_SUCCESS(poller.add(gSock1));
+}
+
+///
+/// @test Registering an uninitialized socket returns an error.
+///
+TEST(SocketPoller, ErrorAddUninitializedSocket)
+{
+    Socket sock;
+    CHECK_ERROR(E_SOK_UNINIT, poller.add(sock));
+    CHECK_ERROR(E_SOK_UNINIT, poller.remove(sock));
+}
+
+///
+/// @test Registering a socket twice or removing an unregistered socket returns
+/// an error.
+///
+TEST(SocketPoller, ErrorCtl)
+{
+    CHECK_ERROR(E_SKP_CTL, poller.add(gSock1));
+    CHECK_ERROR(E_SKP_CTL, poller.remove(gSock4));
+}
+
+///
+/// @test Waiting with a null or empty ready array returns an error.
+///
+TEST(SocketPoller, ErrorWaitReadyArray)
+{
+    Socket* ready[1] = {};
+    U32 numReady = 0;
+    CHECK_ERROR(E_SKP_NULL, poller.wait(nullptr, 1, 0, numReady));
+    CHECK_ERROR(E_SKP_EMPTY, poller.wait(ready, 0, 0, numReady));
+}
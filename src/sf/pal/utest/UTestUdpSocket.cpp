@@ -49,6 +49,10 @@ inline void checkSocketUninitialized(Socket& kSock)
     CHECK_ERROR(E_SOK_UNINIT,
                 kSock.send(gTestIp1, gTestPort, &buf, sizeof(buf), nullptr));
     CHECK_ERROR(E_SOK_UNINIT, kSock.recv(&buf, sizeof(buf), nullptr));
+    Socket::Datagram dgram = {gTestIp1, gTestPort, &buf, sizeof(buf), 0};
+    U32 numDgrams = 0;
+    CHECK_ERROR(E_SOK_UNINIT, kSock.sendBatch(&dgram, 1, numDgrams));
+    CHECK_ERROR(E_SOK_UNINIT, kSock.recvBatch(&dgram, 1, numDgrams));
     CHECK_ERROR(E_SOK_UNINIT, kSock.close());
 }
 
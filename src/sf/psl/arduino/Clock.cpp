@@ -28,4 +28,9 @@ U64 Clock::nanoTime()
     return (micros() * static_cast<U64>(1000));
 }
 
+void Clock::sleepUntil(const U64 kNs)
+{
+    while (nanoTime() < kNs);
+}
+
 } // namespace Sf
@@ -156,6 +156,84 @@ Result Socket::recv(void* const kBuf,
     return SUCCESS;
 }
 
+Result Socket::sendBatch(Datagram* const kDgrams,
+                         const U32 kNumDgrams,
+                         U32& kNumSent)
+{
+    kNumSent = 0;
+
+    // Check that datagram array is non-null.
+    if (kDgrams == nullptr)
+    {
+        return E_SOK_NULL;
+    }
+
+    // The Ethernet library has no batch send, so send datagrams one at a time.
+    for (U32 i = 0; i < kNumDgrams; ++i)
+    {
+        Datagram& dgram = kDgrams[i];
+        const Result res = this->send(dgram.ip,
+                                      dgram.port,
+                                      dgram.buf,
+                                      dgram.numBytes,
+                                      &dgram.numBytesXfer);
+        if (res != SUCCESS)
+        {
+            return res;
+        }
+        ++kNumSent;
+    }
+
+    return SUCCESS;
+}
+
+Result Socket::recvBatch(Datagram* const kDgrams,
+                         const U32 kNumDgrams,
+                         U32& kNumRecvd)
+{
+    kNumRecvd = 0;
+
+    // Check that socket is initialized.
+    if (!mInit)
+    {
+        return E_SOK_UNINIT;
+    }
+
+    // Check that datagram array is non-null.
+    if (kDgrams == nullptr)
+    {
+        return E_SOK_NULL;
+    }
+
+    // Receive datagrams one at a time. Only the first receive blocks.
+    for (U32 i = 0; i < kNumDgrams; ++i)
+    {
+        Datagram& dgram = kDgrams[i];
+        if (dgram.buf == nullptr)
+        {
+            return E_SOK_NULL;
+        }
+
+        if (i == 0)
+        {
+            while (mUdp.parsePacket() == 0);
+        }
+        else if (mUdp.parsePacket() == 0)
+        {
+            break;
+        }
+
+        const IPAddress srcIp = mUdp.remoteIP();
+        dgram.ip = {srcIp[0], srcIp[1], srcIp[2], srcIp[3]};
+        dgram.port = mUdp.remotePort();
+        dgram.numBytesXfer =
+            mUdp.read(static_cast<char*>(dgram.buf), dgram.numBytes);
+        ++kNumRecvd;
+    }
+
+    return SUCCESS;
+}
+
 Result Socket::close()
 {
     mUdp.stop();
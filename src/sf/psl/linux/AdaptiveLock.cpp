@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "sf/pal/AdaptiveLock.hpp"
+#include "sf/pal/Thread.hpp"
+
+namespace Sf
+{
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Gets the kernel thread ID of the calling thread. The ID is cached
+/// per thread since it is needed on every acquire and release.
+///
+/// @return Calling thread ID.
+///
+static U32 threadId()
+{
+    static thread_local U32 tid = 0;
+    if (tid == 0)
+    {
+        tid = static_cast<U32>(syscall(SYS_gettid));
+    }
+
+    return tid;
+}
+
+///
+/// @brief Invokes a priority-inheritance futex operation on a futex word.
+///
+/// @param[in] kFutex  Futex word.
+/// @param[in] kOp     Futex operation.
+///
+/// @return Return value of the futex syscall.
+///
+static long futexPi(U32* const kFutex, const int kOp)
+{
+    return syscall(SYS_futex, kFutex, kOp, 0, nullptr, nullptr, 0);
+}
+
+///
+/// @brief Takes a lock if it looks free. The CAS is only attempted when the
+/// lock looks free so that polling does not bounce the cache line between
+/// cores.
+///
+/// @param[in] kFutex  Futex word of lock.
+/// @param[in] kTid    Calling thread ID.
+///
+/// @return Whether the lock was taken.
+///
+static bool tryTake(U32* const kFutex, const U32 kTid)
+{
+    U32 expect = 0;
+    return ((__atomic_load_n(kFutex, __ATOMIC_RELAXED) == 0)
+            && __atomic_compare_exchange_n(kFutex,
+                                           &expect,
+                                           kTid,
+                                           false,
+                                           __ATOMIC_ACQUIRE,
+                                           __ATOMIC_RELAXED));
+}
+
+///
+/// @brief Hints to the CPU that the caller is in a spin-wait loop. This keeps
+/// the spinning thread from starving a sibling hyperthread, which may be the
+/// lock holder.
+///
+static inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+/////////////////////////////////// Public /////////////////////////////////////
+
+Result AdaptiveLock::init(AdaptiveLock& kLock)
+{
+    // Check that lock is not already initialized.
+    if (kLock.mInit)
+    {
+        return E_ALK_REINIT;
+    }
+
+    // Only spin on contention if the holder can run at the same time as the
+    // caller.
+    kLock.mSpinCnt = ((Thread::numCores() > 1) ? SPIN_CNT : 0);
+
+    __atomic_store_n(&kLock.mFutex, 0, __ATOMIC_RELEASE);
+    kLock.mInit = true;
+    return SUCCESS;
+}
+
+AdaptiveLock::AdaptiveLock() : mInit(false), mFutex(0), mSpinCnt(0)
+{
+}
+
+Result AdaptiveLock::acquire()
+{
+    if (!mInit)
+    {
+        return E_ALK_UNINIT;
+    }
+
+    const U32 tid = threadId();
+
+    // Take the lock if it is free.
+    if (tryTake(&mFutex, tid))
+    {
+        return SUCCESS;
+    }
+
+    // Spin for a bounded time in case the holder is running on another core
+    // and about to release. On a single core this is skipped, since the holder
+    // cannot run while we spin.
+    for (U32 i = 0; i < mSpinCnt; ++i)
+    {
+        cpuRelax();
+        if (tryTake(&mFutex, tid))
+        {
+            return SUCCESS;
+        }
+    }
+
+    // Block in the kernel. The kernel takes the lock on our behalf when it
+    // becomes free and boosts the holder to our priority in the meantime.
+    while (futexPi(&mFutex, FUTEX_LOCK_PI_PRIVATE) != 0)
+    {
+        if (errno != EINTR)
+        {
+            // Most likely EDEADLK, i.e., the calling thread already holds the
+            // lock.
+            return E_ALK_ACQ;
+        }
+    }
+
+    return SUCCESS;
+}
+
+Result AdaptiveLock::release()
+{
+    if (!mInit)
+    {
+        return E_ALK_UNINIT;
+    }
+
+    // If there are no waiters, the futex word is exactly our thread ID and
+    // the lock can be released without entering the kernel.
+    const U32 tid = threadId();
+    U32 expect = tid;
+    if (__atomic_compare_exchange_n(&mFutex,
+                                    &expect,
+                                    0,
+                                    false,
+                                    __ATOMIC_RELEASE,
+                                    __ATOMIC_RELAXED))
+    {
+        return SUCCESS;
+    }
+
+    // Check that the calling thread holds the lock.
+    if ((expect & FUTEX_TID_MASK) != tid)
+    {
+        return E_ALK_REL;
+    }
+
+    // There are waiters, so have the kernel hand off the lock.
+    if (futexPi(&mFutex, FUTEX_UNLOCK_PI_PRIVATE) != 0)
+    {
+        return E_ALK_REL;
+    }
+
+    return SUCCESS;
+}
+
+} // namespace Sf
@@ -16,6 +16,7 @@
 /// IN THE SOFTWARE.
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <errno.h>
 #include <time.h>
 
 #include "sf/pal/Clock.hpp"
@@ -23,11 +24,15 @@
 namespace Sf
 {
 
-U64 Clock::nanoTime()
+void Clock::sleepUntil(const U64 kNs)
 {
     timespec ts = {0, 0};
-    (void) clock_gettime(CLOCK_REALTIME, &ts);
-    return ((ts.tv_sec * NS_IN_S) + ts.tv_nsec);
+    ts.tv_sec = static_cast<time_t>(kNs / NS_IN_S);
+    ts.tv_nsec = static_cast<long>(kNs % NS_IN_S);
+    while (clock_nanosleep(LINUX_CLOCK_ID, TIMER_ABSTIME, &ts, nullptr)
+           == EINTR)
+    {
+    }
 }
 
 } // namespace Sf
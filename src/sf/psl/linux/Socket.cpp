@@ -18,6 +18,7 @@
 
 #include <arpa/inet.h>
 #include <cstring>
+#include <errno.h>
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -28,6 +29,74 @@
 namespace Sf
 {
 
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Converts an IP address and port to a socket address.
+///
+/// @param[in]  kIp    IP address.
+/// @param[in]  kPort  Port.
+/// @param[out] kAddr  Socket address to set.
+///
+static void toSockAddr(const Ipv4Address kIp,
+                       const U16 kPort,
+                       sockaddr_in& kAddr)
+{
+    std::memset(&kAddr, 0, sizeof(kAddr));
+    kAddr.sin_family = AF_INET;
+    kAddr.sin_addr.s_addr = ((static_cast<U32>(kIp.oct4) << 24) |
+                             (static_cast<U32>(kIp.oct3) << 16) |
+                             (static_cast<U32>(kIp.oct2) <<  8) |
+                             (static_cast<U32>(kIp.oct1) <<  0));
+    kAddr.sin_port = htons(kPort);
+}
+
+///
+/// @brief Converts a socket address to an IP address and port.
+///
+/// @param[in]  kAddr  Socket address.
+/// @param[out] kIp    IP address to set.
+/// @param[out] kPort  Port to set.
+///
+static void fromSockAddr(const sockaddr_in& kAddr, Ipv4Address& kIp, U16& kPort)
+{
+    const U32 ipNetOrder = kAddr.sin_addr.s_addr;
+    kIp.oct1 = static_cast<U8>(ipNetOrder >>  0);
+    kIp.oct2 = static_cast<U8>(ipNetOrder >>  8);
+    kIp.oct3 = static_cast<U8>(ipNetOrder >> 16);
+    kIp.oct4 = static_cast<U8>(ipNetOrder >> 24);
+    kPort = ntohs(kAddr.sin_port);
+}
+
+///
+/// @brief Checks that a datagram array and all of its buffers are non-null.
+///
+/// @param[in] kDgrams     Datagram array.
+/// @param[in] kNumDgrams  Number of datagrams.
+///
+/// @returns Whether all pointers are non-null.
+///
+static bool datagramsValid(const Socket::Datagram* const kDgrams,
+                           const U32 kNumDgrams)
+{
+    if (kDgrams == nullptr)
+    {
+        return false;
+    }
+
+    for (U32 i = 0; i < kNumDgrams; ++i)
+    {
+        if (kDgrams[i].buf == nullptr)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/////////////////////////////////// Public /////////////////////////////////////
+
 Result Socket::init(const Ipv4Address kIp,
                     const U16 kPort,
                     const Protocol kProto,
@@ -60,14 +129,7 @@ Result Socket::init(const Ipv4Address kIp,
 
     // Bind socket to specified address.
     sockaddr_in addr;
-    std::memset(&addr, 0, sizeof(addr));
-    addr.sin_family = AF_INET;
-    const U32 ipNetOrder = ((static_cast<U32>(kIp.oct4) << 24) |
-                            (static_cast<U32>(kIp.oct3) << 16) |
-                            (static_cast<U32>(kIp.oct2) <<  8) |
-                            (static_cast<U32>(kIp.oct1) <<  0));
-    addr.sin_addr.s_addr = ipNetOrder;
-    addr.sin_port = htons(kPort);
+    toSockAddr(kIp, kPort, addr);
     if (bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
     {
         return E_SOK_BIND;
@@ -182,14 +244,7 @@ Result Socket::send(const Ipv4Address kDestIp,
 
     // Create destination address.
     sockaddr_in destAddr;
-    std::memset(&destAddr, 0, sizeof(destAddr));
-    destAddr.sin_family = AF_INET;
-    const U32 ipNetOrder = ((static_cast<U32>(kDestIp.oct4) << 24) |
-                            (static_cast<U32>(kDestIp.oct3) << 16) |
-                            (static_cast<U32>(kDestIp.oct2) <<  8) |
-                            (static_cast<U32>(kDestIp.oct1) <<  0));
-    destAddr.sin_addr.s_addr = ipNetOrder;
-    destAddr.sin_port = htons(kDestPort);
+    toSockAddr(kDestIp, kDestPort, destAddr);
 
     // Send buffer.
     const I32 bytesSent = sendto(mFd,
@@ -249,6 +304,153 @@ Result Socket::recv(void* const kBuf,
     return SUCCESS;
 }
 
+Result Socket::sendBatch(Datagram* const kDgrams,
+                         const U32 kNumDgrams,
+                         U32& kNumSent)
+{
+    kNumSent = 0;
+
+    // Check that socket is initialized.
+    if (!mInit)
+    {
+        return E_SOK_UNINIT;
+    }
+
+    // Nothing to do for an empty batch. The datagram array is not checked in
+    // this case, so it may be null.
+    if (kNumDgrams == 0)
+    {
+        return SUCCESS;
+    }
+
+    // Check that datagrams and their buffers are non-null.
+    if (!datagramsValid(kDgrams, kNumDgrams))
+    {
+        return E_SOK_NULL;
+    }
+
+    mmsghdr msgs[MAX_BATCH];
+    iovec iovs[MAX_BATCH];
+    sockaddr_in addrs[MAX_BATCH];
+    while (kNumSent < kNumDgrams)
+    {
+        // Build message headers for the next chunk of datagrams.
+        const U32 remaining = (kNumDgrams - kNumSent);
+        const U32 chunk = ((remaining < MAX_BATCH) ? remaining : MAX_BATCH);
+        std::memset(msgs, 0, (chunk * sizeof(msgs[0])));
+        for (U32 i = 0; i < chunk; ++i)
+        {
+            Datagram& dgram = kDgrams[kNumSent + i];
+            toSockAddr(dgram.ip, dgram.port, addrs[i]);
+            iovs[i].iov_base = dgram.buf;
+            iovs[i].iov_len = dgram.numBytes;
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        // Send chunk. The kernel may send fewer datagrams than requested, in
+        // which case the rest are sent in the next chunk.
+        const I32 sent = sendmmsg(mFd, msgs, chunk, 0);
+        if (sent <= 0)
+        {
+            // Send failed.
+            return E_SOK_SEND;
+        }
+
+        for (I32 i = 0; i < sent; ++i)
+        {
+            kDgrams[kNumSent + i].numBytesXfer = msgs[i].msg_len;
+        }
+        kNumSent += sent;
+    }
+
+    return SUCCESS;
+}
+
+Result Socket::recvBatch(Datagram* const kDgrams,
+                         const U32 kNumDgrams,
+                         U32& kNumRecvd)
+{
+    kNumRecvd = 0;
+
+    // Check that socket is initialized.
+    if (!mInit)
+    {
+        return E_SOK_UNINIT;
+    }
+
+    // Nothing to do for an empty batch. The datagram array is not checked in
+    // this case, so it may be null.
+    if (kNumDgrams == 0)
+    {
+        return SUCCESS;
+    }
+
+    // Check that datagrams and their buffers are non-null.
+    if (!datagramsValid(kDgrams, kNumDgrams))
+    {
+        return E_SOK_NULL;
+    }
+
+    mmsghdr msgs[MAX_BATCH];
+    iovec iovs[MAX_BATCH];
+    sockaddr_in addrs[MAX_BATCH];
+    while (kNumRecvd < kNumDgrams)
+    {
+        // Build message headers for the next chunk of datagrams.
+        const U32 remaining = (kNumDgrams - kNumRecvd);
+        const U32 chunk = ((remaining < MAX_BATCH) ? remaining : MAX_BATCH);
+        std::memset(msgs, 0, (chunk * sizeof(msgs[0])));
+        for (U32 i = 0; i < chunk; ++i)
+        {
+            Datagram& dgram = kDgrams[kNumRecvd + i];
+            iovs[i].iov_base = dgram.buf;
+            iovs[i].iov_len = dgram.numBytes;
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        // Receive chunk. The first chunk blocks until a datagram arrives and
+        // then takes whatever else is waiting. Later chunks only take what is
+        // already waiting.
+        const I32 waitFlag = ((kNumRecvd == 0) ? MSG_WAITFORONE : MSG_DONTWAIT);
+        const I32 flags = (MSG_TRUNC | waitFlag);
+        const I32 recvd = recvmmsg(mFd, msgs, chunk, flags, nullptr);
+        if (recvd < 0)
+        {
+            if ((kNumRecvd > 0)
+                && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+            {
+                // Nothing more waiting.
+                break;
+            }
+
+            // Receive failed.
+            return E_SOK_RECV;
+        }
+
+        for (I32 i = 0; i < recvd; ++i)
+        {
+            Datagram& dgram = kDgrams[kNumRecvd + i];
+            fromSockAddr(addrs[i], dgram.ip, dgram.port);
+            dgram.numBytesXfer = msgs[i].msg_len;
+        }
+        kNumRecvd += recvd;
+
+        // A short chunk means nothing more is waiting.
+        if (static_cast<U32>(recvd) < chunk)
+        {
+            break;
+        }
+    }
+
+    return SUCCESS;
+}
+
 Result Socket::close()
 {
     // Check that socket is initialized.
@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <errno.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "sf/pal/Clock.hpp"
+#include "sf/pal/SocketPoller.hpp"
+
+namespace Sf
+{
+
+/////////////////////////////////// Global /////////////////////////////////////
+
+///
+/// @brief Maximum number of events taken from epoll per wait.
+///
+static constexpr U32 gMaxEvents = 64;
+
+/////////////////////////////////// Public /////////////////////////////////////
+
+Result SocketPoller::init(SocketPoller& kPoller)
+{
+    // Check that poller is not already initialized.
+    if (kPoller.mInit)
+    {
+        return E_SKP_REINIT;
+    }
+
+    // Create epoll instance.
+    const I32 fd = epoll_create1(EPOLL_CLOEXEC);
+    if (fd < 0)
+    {
+        return E_SKP_CREATE;
+    }
+
+    kPoller.mInit = true;
+    kPoller.mFd = fd;
+
+    return SUCCESS;
+}
+
+SocketPoller::SocketPoller() : mInit(false), mFd(-1)
+{
+}
+
+SocketPoller::~SocketPoller()
+{
+    (void) this->close();
+}
+
+Result SocketPoller::add(Socket& kSock)
+{
+    // Check that poller and socket are initialized.
+    if (!mInit)
+    {
+        return E_SKP_UNINIT;
+    }
+
+    if (!kSock.mInit)
+    {
+        return E_SOK_UNINIT;
+    }
+
+    // Register socket for read readiness. The event carries the socket pointer
+    // so that waits can return it directly.
+    epoll_event event = {0, {nullptr}};
+    event.events = EPOLLIN;
+    event.data.ptr = &kSock;
+    if (epoll_ctl(mFd, EPOLL_CTL_ADD, kSock.mFd, &event) != 0)
+    {
+        return E_SKP_CTL;
+    }
+
+    return SUCCESS;
+}
+
+Result SocketPoller::remove(Socket& kSock)
+{
+    // Check that poller and socket are initialized.
+    if (!mInit)
+    {
+        return E_SKP_UNINIT;
+    }
+
+    if (!kSock.mInit)
+    {
+        return E_SOK_UNINIT;
+    }
+
+    // Unregister socket.
+    epoll_event event = {0, {nullptr}};
+    if (epoll_ctl(mFd, EPOLL_CTL_DEL, kSock.mFd, &event) != 0)
+    {
+        return E_SKP_CTL;
+    }
+
+    return SUCCESS;
+}
+
+Result SocketPoller::wait(Socket** const kReady,
+                          const U32 kMaxReady,
+                          const U32 kTimeoutUs,
+                          U32& kNumReady)
+{
+    kNumReady = 0;
+
+    // Check that poller is initialized.
+    if (!mInit)
+    {
+        return E_SKP_UNINIT;
+    }
+
+    // Check that ready array is non-null and non-empty.
+    if (kReady == nullptr)
+    {
+        return E_SKP_NULL;
+    }
+
+    if (kMaxReady == 0)
+    {
+        return E_SKP_EMPTY;
+    }
+
+    // Round timeout up to milliseconds so that the wait is never shorter than
+    // requested.
+    const U64 usInMs = (Clock::US_IN_S / Clock::MS_IN_S);
+    const I32 timeoutMs =
+        static_cast<I32>((static_cast<U64>(kTimeoutUs) + usInMs - 1) / usInMs);
+
+    // Wait for events.
+    epoll_event events[gMaxEvents];
+    const U32 maxEvents = ((kMaxReady < gMaxEvents) ? kMaxReady : gMaxEvents);
+    const I32 eventCnt = epoll_wait(mFd, events, maxEvents, timeoutMs);
+    if (eventCnt < 0)
+    {
+        // An interrupted wait is treated like a timeout.
+        return ((errno == EINTR) ? SUCCESS : E_SKP_WAIT);
+    }
+
+    // Return ready sockets.
+    for (I32 i = 0; i < eventCnt; ++i)
+    {
+        kReady[i] = static_cast<Socket*>(events[i].data.ptr);
+    }
+    kNumReady = eventCnt;
+
+    return SUCCESS;
+}
+
+Result SocketPoller::close()
+{
+    // Check that poller is initialized.
+    if (!mInit)
+    {
+        return E_SKP_UNINIT;
+    }
+
+    // Close epoll FD.
+    if (::close(mFd) != 0)
+    {
+        return E_SKP_CLOSE;
+    }
+
+    mFd = -1;
+    mInit = false;
+
+    return SUCCESS;
+}
+
+} // namespace Sf
@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+///                             S U R E F I R E
+///                             ---------------
+/// This file is part of Surefire, a C++ framework for building flight software
+/// applications. Surefire is open-source under the Apache License 2.0 - a copy
+/// of the license may be obtained at www.apache.org/licenses/LICENSE-2.0.
+///
+/// Copyright (c) 2022 the Surefire authors. All rights reserved.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///                             ---------------
+/// @file  sf/psl/linux/utest/UTestLinuxClock.cpp
+/// @brief Unit tests for the clock on Linux platforms.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <time.h>
+
+#include "sf/pal/Clock.hpp"
+#include "sf/utest/UTest.hpp"
+
+using namespace Sf;
+
+/////////////////////////////////// Helpers ////////////////////////////////////
+
+///
+/// @brief Reads a Linux clock in nanoseconds.
+///
+/// @param[in] kClockId  Clock ID.
+///
+/// @returns Clock time in nanoseconds.
+///
+static U64 readClock(const clockid_t kClockId)
+{
+    timespec ts = {0, 0};
+    CHECK_EQUAL(0, clock_gettime(kClockId, &ts));
+    return ((static_cast<U64>(ts.tv_sec) * Clock::NS_IN_S)
+            + static_cast<U64>(ts.tv_nsec));
+}
+
+//////////////////////////////////// Tests /////////////////////////////////////
+
+///
+/// @brief Unit tests for the clock on Linux platforms.
+///
+TEST_GROUP(LinuxClock)
+{
+};
+
+///
+/// @test The monotonic clock is used unless SF_CLOCK_REALTIME is defined.
+///
+TEST(LinuxClock, ClockId)
+{
+#ifdef SF_CLOCK_REALTIME
+    CHECK_EQUAL(CLOCK_REALTIME, Clock::LINUX_CLOCK_ID);
+#else
+    CHECK_EQUAL(CLOCK_MONOTONIC, Clock::LINUX_CLOCK_ID);
+#endif
+}
+
+///
+/// @test Clock::nanoTime() reads the clock identified by Clock::LINUX_CLOCK_ID.
+///
+TEST(LinuxClock, NanoTimeReadsClock)
+{
+    const U64 beforeNs = readClock(Clock::LINUX_CLOCK_ID);
+    const U64 ns = Clock::nanoTime();
+    const U64 afterNs = readClock(Clock::LINUX_CLOCK_ID);
+    CHECK_TRUE(ns >= beforeNs);
+    CHECK_TRUE(ns <= afterNs);
+}